@@ -0,0 +1,610 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+     Channel models with kernels dispatched like the reliability matrix kernels
+
+ */
+
+#include "CC_ChannelModel.h"
+#include "CC_ReliabilityKernels.h"
+#include "CC_ReliabilityMatrix.h"
+#include "CCSoft_Exception.h"
+#include <cstring>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CC_CHANNEL_X86
+#endif
+
+#define CC_CHANNEL_INLINE static inline __attribute__((always_inline))
+
+#pragma GCC diagnostic ignored "-Wpsabi" // blocks are only returned by always inlined helpers
+
+namespace ccsoft
+{
+
+namespace
+{
+
+typedef float BlockF __attribute__((vector_size(64)));    //!< Block of 16 floats
+typedef int BlockI __attribute__((vector_size(64)));      //!< Block of 16 ints or comparison mask
+typedef uint32_t BlockU __attribute__((vector_size(64))); //!< Block of 16 generator words
+static const unsigned int block_size = CC_RandomStream::nb_lanes;
+
+CC_CHANNEL_INLINE BlockF splat(float value)
+{
+    BlockF zero = {};
+    return zero + value;
+}
+
+/**
+ * Generator state of the 16 lanes held in registers during a kernel
+ */
+struct LaneState
+{
+    BlockU x, y, z, w;
+};
+
+CC_CHANNEL_INLINE void load_state(LaneState& lanes, const uint32_t *state)
+{
+    memcpy(&lanes.x, &state[0], sizeof(BlockU));
+    memcpy(&lanes.y, &state[block_size], sizeof(BlockU));
+    memcpy(&lanes.z, &state[2*block_size], sizeof(BlockU));
+    memcpy(&lanes.w, &state[3*block_size], sizeof(BlockU));
+}
+
+CC_CHANNEL_INLINE void store_state(const LaneState& lanes, uint32_t *state)
+{
+    memcpy(&state[0], &lanes.x, sizeof(BlockU));
+    memcpy(&state[block_size], &lanes.y, sizeof(BlockU));
+    memcpy(&state[2*block_size], &lanes.z, sizeof(BlockU));
+    memcpy(&state[3*block_size], &lanes.w, sizeof(BlockU));
+}
+
+// ================================================================================================
+// Marsaglia xorshift128 on each lane
+CC_CHANNEL_INLINE BlockU next_words(LaneState& lanes)
+{
+    BlockU t = lanes.x ^ (lanes.x << 11);
+    lanes.x = lanes.y;
+    lanes.y = lanes.z;
+    lanes.z = lanes.w;
+    lanes.w = lanes.w ^ (lanes.w >> 19) ^ t ^ (t >> 8);
+    return lanes.w;
+}
+
+// ================================================================================================
+// 24 most significant bits centered in (0,1). The conversion is exact.
+CC_CHANNEL_INLINE BlockF next_uniform(LaneState& lanes)
+{
+    BlockI mantissa = (BlockI) (next_words(lanes) >> 8);
+    return (__builtin_convertvector(mantissa, BlockF) + 0.5f) * (float) (1.0/16777216.0);
+}
+
+// ================================================================================================
+// Same log2 approximation as the reliability matrix kernels. Only used on (0,1) normal numbers.
+CC_CHANNEL_INLINE BlockF log2_block(const BlockF& x)
+{
+    BlockI bits = (BlockI) x;
+    BlockI exponent = ((bits >> 23) & 0xff) - 127;
+    BlockF mantissa = (BlockF) ((bits & 0x7fffff) | 0x3f800000);
+    BlockI above = (mantissa > splat(M_SQRT2)); // -1 where true
+    mantissa = (above ? mantissa * 0.5f : mantissa);
+    exponent -= above;
+    BlockF s = (mantissa - 1.0f) / (mantissa + 1.0f);
+    BlockF s2 = s * s;
+    BlockF poly = splat(2.0*M_LOG2E/9.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/7.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/5.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/3.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E);
+    return __builtin_convertvector(exponent, BlockF) + poly * s;
+}
+
+// ================================================================================================
+// Box-Muller on a pair of uniform blocks. The angle is taken in (-pi,pi) and its sine and cosine
+// come from those of the half angle in (-pi/2,pi/2) expanded up to the 10th power.
+CC_CHANNEL_INLINE void next_gaussians(LaneState& lanes, BlockF& g_cos, BlockF& g_sin)
+{
+    BlockF u1 = next_uniform(lanes);
+    BlockF u2 = next_uniform(lanes);
+    BlockF r = log2_block(u1) * (float) (-2.0*M_LN2);
+
+    for (unsigned int j = 0; j < block_size; j++)
+    {
+        r[j] = __builtin_sqrtf(r[j]);
+    }
+
+    BlockF h = (u2 - 0.5f) * (float) M_PI;
+    BlockF h2 = h * h;
+    BlockF s = splat(1.0/362880.0);
+    s = s * h2 - (float) (1.0/5040.0);
+    s = s * h2 + (float) (1.0/120.0);
+    s = s * h2 - (float) (1.0/6.0);
+    s = (s * h2 + 1.0f) * h;
+    BlockF c = splat(-1.0/3628800.0);
+    c = c * h2 + (float) (1.0/40320.0);
+    c = c * h2 - (float) (1.0/720.0);
+    c = c * h2 + (float) (1.0/24.0);
+    c = c * h2 - 0.5f;
+    c = c * h2 + 1.0f;
+    g_cos = r * (c * c - s * s);
+    g_sin = r * (2.0f * s * c);
+}
+
+// ================================================================================================
+CC_CHANNEL_INLINE void uniform_body(uint32_t *state, float *values, unsigned int nb_values)
+{
+    LaneState lanes;
+    load_state(lanes, state);
+
+    for (unsigned int i = 0; i < nb_values; i += block_size)
+    {
+        BlockF block = next_uniform(lanes);
+        memcpy(&values[i], &block, (nb_values - i < block_size ? nb_values - i : block_size)*sizeof(float));
+    }
+
+    store_state(lanes, state);
+}
+
+// ================================================================================================
+CC_CHANNEL_INLINE void gaussian_body(uint32_t *state, float *values, unsigned int nb_values)
+{
+    LaneState lanes;
+    load_state(lanes, state);
+    BlockF pair[2];
+    unsigned int i = 0;
+
+    for (; i + 2*block_size <= nb_values; i += 2*block_size)
+    {
+        next_gaussians(lanes, pair[0], pair[1]);
+        memcpy(&values[i], pair, sizeof(pair));
+    }
+
+    if (i < nb_values)
+    {
+        next_gaussians(lanes, pair[0], pair[1]);
+        memcpy(&values[i], pair, (nb_values - i)*sizeof(float));
+    }
+
+    store_state(lanes, state);
+}
+
+// ================================================================================================
+// v = (scale*v)^2: noise amplitudes to powers
+CC_CHANNEL_INLINE void scale_square_body(float *values, unsigned int nb_values, float scale)
+{
+    BlockF scale_block = splat(scale);
+    BlockF block;
+    unsigned int i = 0;
+
+    for (; i + block_size <= nb_values; i += block_size)
+    {
+        memcpy(&block, &values[i], sizeof(BlockF));
+        block *= scale_block;
+        block *= block;
+        memcpy(&values[i], &block, sizeof(BlockF));
+    }
+
+    for (; i < nb_values; i++)
+    {
+        values[i] *= scale;
+        values[i] *= values[i];
+    }
+}
+
+// ================================================================================================
+// LLR of y = gain*x + sigma*g is 2*gain*y/sigma^2 = a*x + b*g with x = +1 for bit 0
+CC_CHANNEL_INLINE void bpsk_llrs_body(const unsigned int *rows, const float *gains, unsigned int nb_symbols, unsigned int nb_bits, float sigma, float *values)
+{
+    for (unsigned int ic = 0; ic < nb_symbols; ic++)
+    {
+        float a = 2.0f * gains[ic] * gains[ic] / (sigma * sigma);
+        float b = 2.0f * gains[ic] / sigma;
+        float *llrs = &values[ic*nb_bits];
+
+        for (unsigned int ib = 0; ib < nb_bits; ib++)
+        {
+            llrs[ib] = b * llrs[ib] + ((rows[ic] >> ib) & 1 ? -a : a);
+        }
+    }
+}
+
+/**
+ * Channel kernels compiled for one instruction set
+ */
+struct ChannelKernels
+{
+    CC_ReliabilityKernels::InstructionSet instruction_set;
+    const char *name;
+    void (*uniform)(uint32_t *state, float *values, unsigned int nb_values);
+    void (*gaussian)(uint32_t *state, float *values, unsigned int nb_values);
+    void (*scale_square)(float *values, unsigned int nb_values, float scale);
+    void (*bpsk_llrs)(const unsigned int *rows, const float *gains, unsigned int nb_symbols, unsigned int nb_bits, float sigma, float *values);
+};
+
+// ================================================================================================
+// Instantiates the kernels for one instruction set
+#define CC_CHANNEL_SET(suffix, target_attribute) \
+    static target_attribute void uniform_##suffix(uint32_t *state, float *values, unsigned int nb_values) \
+    { uniform_body(state, values, nb_values); } \
+    static target_attribute void gaussian_##suffix(uint32_t *state, float *values, unsigned int nb_values) \
+    { gaussian_body(state, values, nb_values); } \
+    static target_attribute void scale_square_##suffix(float *values, unsigned int nb_values, float scale) \
+    { scale_square_body(values, nb_values, scale); } \
+    static target_attribute void bpsk_llrs_##suffix(const unsigned int *rows, const float *gains, unsigned int nb_symbols, unsigned int nb_bits, float sigma, float *values) \
+    { bpsk_llrs_body(rows, gains, nb_symbols, nb_bits, sigma, values); }
+
+#define CC_CHANNEL_ENTRY(instruction_set, name, suffix) \
+    { instruction_set, name, uniform_##suffix, gaussian_##suffix, scale_square_##suffix, bpsk_llrs_##suffix }
+
+CC_CHANNEL_SET(generic, )
+
+#ifdef CC_CHANNEL_X86
+CC_CHANNEL_SET(sse2, __attribute__((target("sse2"))))
+CC_CHANNEL_SET(avx2, __attribute__((target("avx2"))))
+CC_CHANNEL_SET(avx512, __attribute__((target("avx512f"))))
+#endif
+
+const ChannelKernels kernel_sets[] = {
+    CC_CHANNEL_ENTRY(CC_ReliabilityKernels::CC_Kernels_Generic, "generic", generic),
+#ifdef CC_CHANNEL_X86
+    CC_CHANNEL_ENTRY(CC_ReliabilityKernels::CC_Kernels_SSE2, "sse2", sse2),
+    CC_CHANNEL_ENTRY(CC_ReliabilityKernels::CC_Kernels_AVX2, "avx2", avx2),
+    CC_CHANNEL_ENTRY(CC_ReliabilityKernels::CC_Kernels_AVX512, "avx512", avx512),
+#endif
+};
+
+// ================================================================================================
+// same instruction set as the reliability matrix kernels
+const ChannelKernels *select_kernels()
+{
+    CC_ReliabilityKernels::InstructionSet instruction_set = CC_ReliabilityKernels::get().instruction_set;
+
+    for (unsigned int i = 0; i < sizeof(kernel_sets)/sizeof(ChannelKernels); i++)
+    {
+        if (kernel_sets[i].instruction_set == instruction_set)
+        {
+            return &kernel_sets[i];
+        }
+    }
+
+    return &kernel_sets[0];
+}
+
+// ================================================================================================
+const ChannelKernels& get_kernels()
+{
+    static const ChannelKernels *kernels = select_kernels();
+    return *kernels;
+}
+
+// ================================================================================================
+uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+// ================================================================================================
+CC_RandomStream::CC_RandomStream(uint64_t seed, unsigned int stream_index)
+{
+    uint64_t x = seed ^ (0xD1B54A32D192ED03ULL * (stream_index + 1ULL));
+
+    for (unsigned int lane = 0; lane < nb_lanes; lane++)
+    {
+        uint32_t lane_or = 0;
+
+        for (unsigned int word = 0; word < 4; word++)
+        {
+            state[word*nb_lanes + lane] = (uint32_t) (splitmix64(x) >> 32);
+            lane_or |= state[word*nb_lanes + lane];
+        }
+
+        if (lane_or == 0) // all zero state is a fixed point
+        {
+            state[lane] = 1;
+        }
+    }
+}
+
+// ================================================================================================
+void CC_RandomStream::uniform(float *values, unsigned int nb_values)
+{
+    get_kernels().uniform(state, values, nb_values);
+}
+
+// ================================================================================================
+void CC_RandomStream::gaussian(float *values, unsigned int nb_values)
+{
+    get_kernels().gaussian(state, values, nb_values);
+}
+
+// ================================================================================================
+CC_ChannelModel::CC_ChannelModel(Modulation _modulation, float snr_dB, Fading _fading) :
+        modulation(_modulation),
+        fading(_fading),
+        std_dev(1.0 / pow(10.0, (snr_dB/10.0))),
+        rician_factor(4.0),
+        fading_block(1),
+        burst(CC_Burst_None),
+        p_good_to_bad(0.0),
+        p_bad_to_good(1.0)
+{}
+
+// ================================================================================================
+void CC_ChannelModel::set_fading_block(unsigned int _fading_block)
+{
+    if (_fading_block == 0)
+    {
+        throw CCSoft_Exception("Fading block must be at least one symbol");
+    }
+
+    fading_block = _fading_block;
+}
+
+// ================================================================================================
+void CC_ChannelModel::set_burst(Burst _burst, float _p_good_to_bad, float _p_bad_to_good)
+{
+    if ((_p_good_to_bad < 0.0) || (_p_good_to_bad > 1.0) || (_p_bad_to_good < 0.0) || (_p_bad_to_good > 1.0))
+    {
+        throw CCSoft_Exception("Burst transition probabilities must be in [0,1]");
+    }
+
+    burst = _burst;
+    p_good_to_bad = _p_good_to_bad;
+    p_bad_to_good = _p_bad_to_good;
+}
+
+// ================================================================================================
+unsigned int CC_ChannelModel::run(const unsigned int *rows, unsigned int nb_symbols, unsigned int nb_symbols_log2, float *values,
+        CC_RandomStream& stream, unsigned char *bad_symbols) const
+{
+    const ChannelKernels& kernels = get_kernels();
+    unsigned int nb_rows = 1<<nb_symbols_log2;
+    unsigned int column_size = (modulation == CC_Modulation_MFSK ? nb_rows : nb_symbols_log2);
+    std::vector<unsigned int> sent(rows, rows + nb_symbols);
+    std::vector<unsigned char> bad(nb_symbols, 0);
+    std::vector<float> gains(nb_symbols, 1.0);
+    unsigned int nb_bad = 0;
+
+    if ((burst != CC_Burst_None) && (nb_symbols > 0))
+    {
+        std::vector<float> draws(2*nb_symbols); // state transitions then replacement symbols
+        stream.uniform(&draws[0], 2*nb_symbols);
+        bool bad_state = false;
+
+        for (unsigned int i = 0; i < nb_symbols; i++)
+        {
+            if (bad_state)
+            {
+                bad[i] = 1;
+                nb_bad++;
+
+                if (burst == CC_Burst_Error)
+                {
+                    sent[i] = (unsigned int) (draws[nb_symbols + i] * nb_rows) & (nb_rows - 1);
+                }
+            }
+
+            bad_state = (bad_state ? draws[i] >= p_bad_to_good : draws[i] < p_good_to_bad);
+        }
+    }
+
+    if ((fading != CC_Fading_None) && (nb_symbols > 0))
+    {
+        unsigned int nb_blocks = (nb_symbols + fading_block - 1) / fading_block;
+        std::vector<float> scatter(2*nb_blocks);
+        stream.gaussian(&scatter[0], 2*nb_blocks);
+        float line_of_sight = (fading == CC_Fading_Rician ? sqrt(rician_factor / (rician_factor + 1.0)) : 0.0);
+        float scatter_std_dev = (fading == CC_Fading_Rician ? sqrt(0.5 / (rician_factor + 1.0)) : sqrt(0.5));
+
+        for (unsigned int i = 0; i < nb_symbols; i++)
+        {
+            unsigned int ib = i / fading_block;
+            float re = line_of_sight + scatter_std_dev * scatter[2*ib];
+            float im = scatter_std_dev * scatter[2*ib + 1];
+            gains[i] = sqrt(re*re + im*im);
+        }
+    }
+
+    // noiseless channel when the noise vanishes: unit noise scale without noise samples
+    float sigma = (std_dev > 0.0 ? std_dev : 1.0);
+
+    if (std_dev > 0.0)
+    {
+        kernels.gaussian(stream.get_state(), values, nb_symbols*column_size);
+    }
+    else
+    {
+        CC_ReliabilityKernels::get().fill(values, nb_symbols*column_size, 0.0);
+    }
+
+    if (modulation == CC_Modulation_MFSK)
+    {
+        for (unsigned int i = 0; i < nb_symbols; i++)
+        {
+            values[i*nb_rows + sent[i]] += gains[i] / sigma;
+        }
+
+        kernels.scale_square(values, nb_symbols*column_size, sigma);
+    }
+    else
+    {
+        kernels.bpsk_llrs(&sent[0], &gains[0], nb_symbols, nb_symbols_log2, sigma, values);
+    }
+
+    for (unsigned int i = 0; i < nb_symbols; i++)
+    {
+        if (bad[i] && (burst == CC_Burst_Erasure))
+        {
+            CC_ReliabilityKernels::get().fill(&values[i*column_size], column_size, 0.0);
+        }
+
+        if (bad_symbols)
+        {
+            bad_symbols[i] = bad[i];
+        }
+    }
+
+    return nb_bad;
+}
+
+// ================================================================================================
+unsigned int CC_ChannelModel::transmit(const std::vector<unsigned int>& rows, CC_ReliabilityMatrix& relmat, CC_RandomStream& stream,
+        std::vector<unsigned char> *bad_symbols) const
+{
+    if (rows.size() != relmat.get_message_length())
+    {
+        throw CCSoft_Exception("Number of symbols sent does not match the reliability matrix");
+    }
+
+    if ((modulation == CC_Modulation_MFSK) && relmat.is_bit_metric())
+    {
+        throw CCSoft_Exception("MFSK powers cannot fill a bit metric reliability matrix");
+    }
+
+    unsigned int nb_symbols = rows.size();
+    unsigned int column_size = (modulation == CC_Modulation_MFSK ? relmat.get_nb_symbols() : relmat.get_nb_symbols_log2());
+    std::vector<float> values(nb_symbols*column_size);
+    std::vector<unsigned char> bad(nb_symbols);
+    unsigned int nb_bad = run(&rows[0], nb_symbols, relmat.get_nb_symbols_log2(), &values[0], stream, &bad[0]);
+    enter_columns(&values[0], &bad[0], relmat);
+
+    if (bad_symbols)
+    {
+        bad_symbols->swap(bad);
+    }
+
+    return nb_bad;
+}
+
+// ================================================================================================
+unsigned int CC_ChannelModel::transmit(const std::vector<unsigned int>& rows, const std::vector<CC_ReliabilityMatrix*>& relmats, CC_RandomStream& stream) const
+{
+    unsigned int nb_symbols = 0;
+
+    for (unsigned int i = 0; i < relmats.size(); i++)
+    {
+        if ((relmats[i]->get_nb_symbols_log2() != relmats[0]->get_nb_symbols_log2()) || (relmats[i]->is_bit_metric() != relmats[0]->is_bit_metric())
+            || (relmats[i]->is_hard_decision() != relmats[0]->is_hard_decision()))
+        {
+            throw CCSoft_Exception("Reliability matrices of a series of frames must have the same kind of columns");
+        }
+
+        nb_symbols += relmats[i]->get_message_length();
+    }
+
+    if ((relmats.size() == 0) || (rows.size() != nb_symbols))
+    {
+        throw CCSoft_Exception("Number of symbols sent does not match the reliability matrices");
+    }
+
+    if ((modulation == CC_Modulation_MFSK) && relmats[0]->is_bit_metric())
+    {
+        throw CCSoft_Exception("MFSK powers cannot fill a bit metric reliability matrix");
+    }
+
+    unsigned int nb_symbols_log2 = relmats[0]->get_nb_symbols_log2();
+    unsigned int column_size = (modulation == CC_Modulation_MFSK ? relmats[0]->get_nb_symbols() : nb_symbols_log2);
+    std::vector<float> values(nb_symbols*column_size);
+    std::vector<unsigned char> bad(nb_symbols);
+    unsigned int nb_bad = run(&rows[0], nb_symbols, nb_symbols_log2, &values[0], stream, &bad[0]);
+    unsigned int first_symbol = 0;
+
+    for (unsigned int i = 0; i < relmats.size(); i++)
+    {
+        enter_columns(&values[first_symbol*column_size], &bad[first_symbol], *relmats[i]);
+        first_symbol += relmats[i]->get_message_length();
+    }
+
+    return nb_bad;
+}
+
+// ================================================================================================
+void CC_ChannelModel::enter_columns(const float *values, const unsigned char *bad, CC_ReliabilityMatrix& relmat) const
+{
+    unsigned int nb_symbols_log2 = relmat.get_nb_symbols_log2();
+    std::vector<float> column(relmat.get_nb_symbols());
+
+    for (unsigned int ic = 0; ic < relmat.get_message_length(); ic++)
+    {
+        if (bad[ic] && (burst == CC_Burst_Erasure))
+        {
+            relmat.enter_erasure(ic);
+        }
+        else if (modulation == CC_Modulation_MFSK)
+        {
+            memcpy(&column[0], &values[ic*column.size()], column.size()*sizeof(float));
+            relmat.enter_symbol_data(ic, &column[0]);
+        }
+        else if (relmat.is_hard_decision()) // sign decisions on the bits
+        {
+            unsigned int symbol = 0;
+
+            for (unsigned int ib = 0; ib < nb_symbols_log2; ib++)
+            {
+                symbol |= (values[ic*nb_symbols_log2 + ib] < 0.0 ? 1 : 0) << ib;
+            }
+
+            relmat.enter_hard_symbol(ic, symbol);
+        }
+        else if (relmat.is_bit_metric())
+        {
+            memcpy(&column[0], &values[ic*nb_symbols_log2], nb_symbols_log2*sizeof(float));
+            relmat.enter_symbol_data(ic, &column[0]);
+        }
+        else
+        {
+            llrs_to_probabilities(&values[ic*nb_symbols_log2], nb_symbols_log2, &column[0]);
+            relmat.enter_symbol_data(ic, &column[0]);
+        }
+    }
+}
+
+// ================================================================================================
+void CC_ChannelModel::llrs_to_probabilities(const float *llrs, unsigned int nb_symbols_log2, float *probabilities) const
+{
+    probabilities[0] = 1.0;
+
+    for (unsigned int ib = 0; ib < nb_symbols_log2; ib++)
+    {
+        float p0 = 1.0 / (1.0 + exp(-llrs[ib])); // probability of bit 0
+        float p1 = 1.0 - p0;
+
+        for (unsigned int j = 0; j < (1u<<ib); j++)
+        {
+            probabilities[j | (1<<ib)] = probabilities[j] * p1;
+            probabilities[j] *= p0;
+        }
+    }
+}
+
+// ================================================================================================
+const char *CC_ChannelModel::get_kernels_name()
+{
+    return get_kernels().name;
+}
+
+} // namespace ccsoft
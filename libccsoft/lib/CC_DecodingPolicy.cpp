@@ -0,0 +1,248 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Decoding policy: sequential decoding parameters by SNR bucket.
+
+ */
+
+#include "CC_DecodingPolicy.h"
+#include "CC_ReliabilityMatrix.h"
+#include "CCSoft_Exception.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace ccsoft
+{
+
+// ================================================================================================
+CC_DecodingPolicy::CC_DecodingPolicy()
+{}
+
+// ================================================================================================
+CC_DecodingPolicy::~CC_DecodingPolicy()
+{}
+
+// ================================================================================================
+void CC_DecodingPolicy::add_entry(const CC_PolicyEntry& entry)
+{
+    std::vector<CC_PolicyEntry>::iterator e_it = std::lower_bound(entries.begin(), entries.end(), entry);
+
+    if ((e_it != entries.end()) && (e_it->snr_dB == entry.snr_dB))
+    {
+        *e_it = entry;
+    }
+    else
+    {
+        entries.insert(e_it, entry);
+    }
+}
+
+// ================================================================================================
+void CC_DecodingPolicy::load(const std::string& filename)
+{
+    std::ifstream policy_file(filename.c_str());
+
+    if (!policy_file.is_open())
+    {
+        throw CCSoft_Exception("Cannot open policy file " + filename);
+    }
+
+    load(policy_file);
+}
+
+// ================================================================================================
+void CC_DecodingPolicy::load(std::istream& is)
+{
+    std::string line;
+    bool header_seen = false;
+
+    entries.clear();
+
+    while (std::getline(is, line))
+    {
+        std::istringstream line_stream(line);
+        std::string first_word;
+
+        if (!(line_stream >> first_word) || (first_word[0] == '#')) // blank or comment
+        {
+            continue;
+        }
+
+        if (!header_seen)
+        {
+            unsigned int file_version;
+
+            if ((first_word != "ccsoft-policy") || !(line_stream >> file_version) || (file_version != version))
+            {
+                throw CCSoft_Exception("Not a supported decoding policy file");
+            }
+
+            header_seen = true;
+        }
+        else
+        {
+            CC_PolicyEntry entry;
+            std::istringstream snr_stream(first_word);
+            std::string algorithm_str;
+
+            if (!(snr_stream >> entry.snr_dB)
+                || !(line_stream >> algorithm_str >> entry.edge_bias >> entry.fano_init_metric >> entry.fano_delta_metric
+                    >> entry.fano_delta_init_threshold >> entry.node_limit))
+            {
+                throw CCSoft_Exception("Invalid decoding policy line: " + line);
+            }
+
+            if (algorithm_str == "stack")
+            {
+                entry.algorithm_type = CC_PolicyEntry::Algorithm_Stack;
+            }
+            else if (algorithm_str == "fano")
+            {
+                entry.algorithm_type = CC_PolicyEntry::Algorithm_Fano;
+            }
+            else
+            {
+                throw CCSoft_Exception("Invalid decoding policy algorithm: " + algorithm_str);
+            }
+
+            add_entry(entry);
+        }
+    }
+
+    if (entries.size() == 0)
+    {
+        throw CCSoft_Exception("Decoding policy has no entries");
+    }
+}
+
+// ================================================================================================
+void CC_DecodingPolicy::save(const std::string& filename) const
+{
+    std::ofstream policy_file(filename.c_str());
+
+    if (!policy_file.is_open())
+    {
+        throw CCSoft_Exception("Cannot create policy file " + filename);
+    }
+
+    save(policy_file);
+}
+
+// ================================================================================================
+void CC_DecodingPolicy::save(std::ostream& os) const
+{
+    std::vector<CC_PolicyEntry>::const_iterator e_it = entries.begin();
+
+    os << "ccsoft-policy " << version << std::endl;
+    os << "# snr_dB algorithm edge_bias fano_init_metric fano_delta_metric fano_delta_init_threshold node_limit" << std::endl;
+
+    for (; e_it != entries.end(); ++e_it)
+    {
+        os << e_it->snr_dB << " "
+           << (e_it->algorithm_type == CC_PolicyEntry::Algorithm_Fano ? "fano" : "stack") << " "
+           << e_it->edge_bias << " "
+           << e_it->fano_init_metric << " "
+           << e_it->fano_delta_metric << " "
+           << e_it->fano_delta_init_threshold << " "
+           << e_it->node_limit << std::endl;
+    }
+}
+
+// ================================================================================================
+const CC_PolicyEntry& CC_DecodingPolicy::lookup(float snr_dB) const
+{
+    if (entries.size() == 0)
+    {
+        throw CCSoft_Exception("Decoding policy has no entries");
+    }
+
+    std::vector<CC_PolicyEntry>::const_iterator e_it = std::upper_bound(entries.begin(), entries.end(), CC_PolicyEntry(snr_dB));
+
+    if (e_it == entries.begin()) // below first bucket
+    {
+        return *e_it;
+    }
+    else
+    {
+        return *(e_it-1);
+    }
+}
+
+// ================================================================================================
+float CC_DecodingPolicy::estimate_snr_dB(const CC_ReliabilityMatrix& relmat)
+{
+    if (relmat.is_bit_metric())
+    {
+        throw CCSoft_Exception("Cannot estimate SNR from a bit metric reliability matrix");
+    }
+
+    if (relmat.is_hard_decision())
+    {
+        throw CCSoft_Exception("Cannot estimate SNR from a hard decision reliability matrix");
+    }
+
+    double signal_sum = 0.0;
+    double noise_sum = 0.0;
+    unsigned int nb_columns = 0;
+
+    for (unsigned int ic = 0; ic < relmat.get_message_length(); ic++)
+    {
+        float col_max = 0.0;
+        double col_sum = 0.0;
+
+        for (unsigned int ir = 0; ir < relmat.get_nb_symbols(); ir++)
+        {
+            col_sum += relmat(ir, ic);
+            col_max = (relmat(ir, ic) > col_max ? relmat(ir, ic) : col_max);
+        }
+
+        if (col_sum != 0.0) // not erased
+        {
+            signal_sum += col_max;
+            noise_sum += col_sum - col_max;
+            nb_columns++;
+        }
+    }
+
+    if ((nb_columns == 0) || (relmat.get_nb_symbols() < 2))
+    {
+        throw CCSoft_Exception("Cannot estimate SNR without non erased symbols");
+    }
+
+    double noise = noise_sum / (nb_columns*(relmat.get_nb_symbols()-1));
+    double signal = signal_sum / nb_columns - noise;
+
+    if (noise <= 0.0) // noiseless
+    {
+        return 99.0;
+    }
+    else if (signal <= noise*1e-6) // nothing but noise
+    {
+        return -30.0;
+    }
+    else
+    {
+        return 5.0 * log10(signal / noise); // power AWGN standard deviation is 10^(-SNR/10)
+    }
+}
+
+} // namespace ccsoft
@@ -0,0 +1,114 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+ Decoding trace ring buffer
+
+ */
+
+#include "CC_DecodingTrace.h"
+#include "CCSoft_Exception.h"
+#include <cstring>
+
+namespace ccsoft
+{
+
+static const char trace_magic[4] = {'C', 'C', 'T', 'R'};
+
+// ================================================================================================
+CC_DecodingTrace::CC_DecodingTrace(unsigned int capacity) :
+        nb_records(0)
+{
+    if (capacity == 0)
+    {
+        throw CCSoft_Exception("Decoding trace capacity must be at least one record");
+    }
+
+    records.resize(capacity);
+}
+
+// ================================================================================================
+CC_DecodingTrace::~CC_DecodingTrace()
+{}
+
+// ================================================================================================
+bool CC_DecodingTrace::write(std::ostream& os) const
+{
+    uint32_t header[3] = {version, sizeof(CC_TraceRecord), size()};
+    uint64_t nb_dropped = get_nb_dropped();
+
+    os.write(trace_magic, sizeof(trace_magic));
+    os.write((const char *) header, sizeof(header));
+    os.write((const char *) &nb_dropped, sizeof(nb_dropped));
+
+    for (unsigned int i = 0; i < size(); i++)
+    {
+        os.write((const char *) &(*this)[i], sizeof(CC_TraceRecord));
+    }
+
+    return os.good();
+}
+
+// ================================================================================================
+bool CC_DecodingTrace::read(std::istream& is, std::vector<CC_TraceRecord>& trace_records, uint64_t& nb_dropped)
+{
+    char magic[4];
+    uint32_t header[3];
+
+    is.read(magic, sizeof(magic));
+    is.read((char *) header, sizeof(header));
+    is.read((char *) &nb_dropped, sizeof(nb_dropped));
+
+    if (!is.good() || (memcmp(magic, trace_magic, sizeof(magic)) != 0) || (header[0] != version) || (header[1] != sizeof(CC_TraceRecord)))
+    {
+        return false;
+    }
+
+    trace_records.resize(header[2]);
+
+    if (header[2] > 0)
+    {
+        is.read((char *) &trace_records[0], header[2]*sizeof(CC_TraceRecord));
+    }
+
+    return !is.fail();
+}
+
+// ================================================================================================
+const char *CC_DecodingTrace::get_type_name(uint8_t type)
+{
+    switch (type)
+    {
+        case CC_Trace_Expand:
+            return "expand";
+        case CC_Trace_Backtrack:
+            return "backtrack";
+        case CC_Trace_Threshold:
+            return "threshold";
+        case CC_Trace_CachePurge:
+            return "purge";
+        case CC_Trace_Eviction:
+            return "eviction";
+        case CC_Trace_Solution:
+            return "solution";
+        default:
+            return "unknown";
+    }
+}
+
+} // namespace ccsoft
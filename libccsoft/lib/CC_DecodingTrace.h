@@ -0,0 +1,165 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+ Decoding trace: ring buffer of fixed size records of the events of a
+ sequential decoder (expansions, back moves, threshold changes, tree cache
+ purges, stack evictions).
+
+ Recording does not keep any reference to the code tree so the decoder
+ memory behaviour is unchanged and only the last records are kept when the
+ ring is full. The binary dump can be turned into a Graphviz file or depth
+ summaries offline with the CC_TraceTool program.
+
+ Binary dump layout (native endianness):
+ - magic "CCTR", uint32 version, uint32 record size, uint32 number of records
+ - uint64 number of records dropped because the ring was full
+ - the records oldest first
+
+ */
+#ifndef __CC_DECODING_TRACE_H__
+#define __CC_DECODING_TRACE_H__
+
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+
+namespace ccsoft
+{
+
+/**
+ * Type of a trace event
+ */
+typedef enum
+{
+    CC_Trace_Expand = 1, //!< Successors of the node are visited. related_id is the first successor created and nb_children the number created (0 when cached).
+    CC_Trace_Backtrack,  //!< Fano: moves back from the node to its predecessor given by related_id
+    CC_Trace_Threshold,  //!< Fano: threshold changes at the node. metric is the new threshold.
+    CC_Trace_CachePurge, //!< Fano: tree cache purged from the node. related_id is the number of nodes left.
+    CC_Trace_Eviction,   //!< Stack: worst entry evicted from the stack
+    CC_Trace_Solution    //!< Terminal node of the decoded path
+} CC_TraceEventType;
+
+/**
+ * \brief Fixed size trace record
+ */
+struct CC_TraceRecord
+{
+    uint8_t type;         //!< Event type (CC_TraceEventType)
+    uint8_t reserved[3];  //!< Padding
+    uint32_t nb_children; //!< Number of successors created by an expansion. Up to 2^k.
+    uint32_t node_id;     //!< Node concerned
+    uint32_t related_id;  //!< Meaning depends on the event type
+    int32_t depth;        //!< Depth of the node
+    float metric;         //!< Path metric of the node or new threshold
+};
+
+/**
+ * \brief Ring buffer of decoding trace records
+ */
+class CC_DecodingTrace
+{
+public:
+    static const uint32_t version = 2; //!< Version of the binary dump. Version 2 widened nb_children to 32 bits.
+
+    /**
+     * Constructor
+     * \param capacity Number of records kept. Older records are overwritten.
+     */
+    CC_DecodingTrace(unsigned int capacity = 65536);
+
+    ~CC_DecodingTrace();
+
+    /**
+     * Removes all records. Typically called before decoding a frame.
+     */
+    void clear()
+    {
+        nb_records = 0;
+    }
+
+    /**
+     * Appends a record overwriting the oldest one if the ring is full
+     */
+    void record(CC_TraceEventType type, uint32_t node_id, int depth, float metric, uint32_t related_id = 0, unsigned int nb_children = 0)
+    {
+        CC_TraceRecord& trace_record = records[nb_records % records.size()];
+        trace_record.type = type;
+        trace_record.nb_children = nb_children;
+        trace_record.reserved[0] = 0;
+        trace_record.reserved[1] = 0;
+        trace_record.reserved[2] = 0;
+        trace_record.node_id = node_id;
+        trace_record.related_id = related_id;
+        trace_record.depth = depth;
+        trace_record.metric = metric;
+        nb_records++;
+    }
+
+    /**
+     * Number of records kept
+     */
+    unsigned int size() const
+    {
+        return (nb_records < records.size() ? nb_records : records.size());
+    }
+
+    /**
+     * Number of records overwritten since the last clear
+     */
+    uint64_t get_nb_dropped() const
+    {
+        return nb_records - size();
+    }
+
+    /**
+     * Record kept at index i, 0 being the oldest
+     */
+    const CC_TraceRecord& operator[](unsigned int i) const
+    {
+        return records[(nb_records - size() + i) % records.size()];
+    }
+
+    /**
+     * Writes the binary dump of the records kept
+     * \return false on output error
+     */
+    bool write(std::ostream& os) const;
+
+    /**
+     * Reads a binary dump
+     * \param is Input stream
+     * \param trace_records Receives the records oldest first
+     * \param nb_dropped Receives the number of records that were dropped at recording
+     * \return false if the stream is not a valid dump
+     */
+    static bool read(std::istream& is, std::vector<CC_TraceRecord>& trace_records, uint64_t& nb_dropped);
+
+    /**
+     * Name of an event type
+     */
+    static const char *get_type_name(uint8_t type);
+
+protected:
+    std::vector<CC_TraceRecord> records; //!< Ring storage
+    uint64_t nb_records;                 //!< Number of records since the last clear
+};
+
+} // namespace ccsoft
+
+#endif // __CC_DECODING_TRACE_H__
@@ -40,6 +40,7 @@
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 
 namespace ccsoft
 {
@@ -83,7 +84,11 @@ public:
                 nb_moves(0),
                 tree_cache_size(_tree_cache_size),
                 unloop(_delta_init_threshold < 0.0),
-                delta_init_threshold(_delta_init_threshold)
+                delta_init_threshold(_delta_init_threshold),
+                step_relmat(0),
+                step_status(CC_Decode_Failed),
+                step_node_edge(0),
+                terminal_node_edge(0)
     {}
 
     /**
@@ -121,8 +126,49 @@ public:
      */
     virtual bool decode(const CC_ReliabilityMatrix& relmat, std::vector<T_IOSymbol>& decoded_message)
     {
-        FanoNodeEdge *node_edge_current, *node_edge_successor;
+        FanoNodeEdge *terminal_node_edge = search(relmat);
 
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Decodes given the reliability matrix writing the decoded message directly in a caller owned buffer
+     * of packed symbols e.g. uint8_t or uint16_t. With a stride greater than one the message symbols can
+     * be interleaved with other frames in the same buffer.
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Buffer receiving the relmat message length symbols of the retrieved message
+     * \param stride Distance in symbols between two successive message symbols in the buffer
+     */
+    template<typename T_OutSymbol>
+    bool decode(const CC_ReliabilityMatrix& relmat, T_OutSymbol *decoded_message, unsigned int stride = 1)
+    {
+        FanoNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, stride, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Starts a decoding to be run step by step so that several decoders can share a thread.
+     * \param relmat Reference to the reliability matrix. It must be kept unchanged until the decoding has ended.
+     */
+    void start(const CC_ReliabilityMatrix& relmat)
+    {
         if (relmat.get_message_length() < Parent::encoding.get_m())
         {
             throw CCSoft_Exception("Reliability Matrix should have a number of columns at least equal to the code constraint");
@@ -137,20 +183,39 @@ public:
         ParentInternal::init_root(); // initialize root node
         Parent::node_count++;
         effective_node_count++;
-        node_edge_current = ParentInternal::root_node;
         nb_moves = 0;
+        step_node_edge = ParentInternal::root_node;
+        visit_node_forward(step_node_edge, relmat);
+        step_relmat = &relmat;
+        step_status = CC_Decode_Pending;
+        terminal_node_edge = 0;
+    }
 
-#ifdef _DEBUG
-        timespec time1, time2;
-        int time_option = CLOCK_REALTIME;
-        clock_gettime(time_option, &time1);
-#endif
+    /**
+     * Continues the decoding started with start() for at most a number of moves in the code tree.
+     * Algorithm reproduced from Sequential Decoding of Convolutional Codes by Yunghsiang S. Han and Po-Ning Chen p.26
+     * \param budget Maximum number of moves
+     * \return Status of the decoding. Once it is no longer pending further steps return the same status.
+     */
+    CC_DecodeStatus step(unsigned int budget)
+    {
+        if (step_status != CC_Decode_Pending)
+        {
+            return step_status;
+        }
 
-        visit_node_forward(node_edge_current, relmat);
+        const CC_ReliabilityMatrix& relmat = *step_relmat;
+        FanoNodeEdge *node_edge_current = step_node_edge;
+        FanoNodeEdge *node_edge_successor;
 
-        while (continue_process(node_edge_current, relmat))
+        for (unsigned int i = 0; i < budget; i++)
         {
-            //std::cout << "T=" << cur_threshold << " depth=" << node_current->get_depth() << " node #" << node_current->get_id() << " Mc=" << node_current->get_path_metric() << std::endl;
+            if (!continue_process(node_edge_current, relmat))
+            {
+                step_status = CC_Decode_Failed;
+                break;
+            }
+
             DEBUG_OUT(Parent::verbosity > 1, "T=" << cur_threshold << " depth=" << node_edge_current->get_depth() << " node #" << node_edge_current->get_id() << " Mc=" << node_edge_current->get_path_metric() << std::endl);
 
             if (node_edge_current->get_depth() > Parent::max_depth)
@@ -198,14 +263,12 @@ public:
                 if (node_edge_current->get_depth() == relmat.get_message_length() - 1)
                 {
                 	Parent::codeword_score = node_edge_current->get_path_metric();
-                    ParentInternal::back_track(node_edge_current, decoded_message, true); // back track from terminal node to retrieve decoded message
+                    trace_event(CC_Trace_Solution, node_edge_current);
                     solution_found = true;
                     Parent::max_depth++;
-#ifdef _DEBUG
-                    clock_gettime(time_option, &time2);
-                    DEBUG_OUT(Parent::verbosity > 0, std::cout << "Decoding time: " << std::setw(12) << std::setprecision(9) << debug_get_time_difference(time2,time1) << " s" << std::endl);
-#endif
-                    return true;
+                    terminal_node_edge = node_edge_current;
+                    step_status = CC_Decode_Done;
+                    break;
                 }
 
                 // threshold tightening for the new current node
@@ -222,6 +285,7 @@ public:
                     	cur_threshold = (nb_delta * delta_threshold) + init_threshold;
                     }
 
+                    trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
                     DEBUG_OUT(Parent::verbosity > 2, "tightening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
                 }
 
@@ -234,7 +298,26 @@ public:
             }
         }
 
-        return false;
+        step_node_edge = node_edge_current;
+        return step_status;
+    }
+
+    /**
+     * Retrieves the decoded message of a decoding run step by step once it is done
+     * \param decoded_message Vector of symbols of retrieved message
+     * \return true if the decoding is done
+     */
+    bool get_decoded_message(std::vector<T_IOSymbol>& decoded_message)
+    {
+        if (step_status == CC_Decode_Done)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
     }
 
     /**
@@ -282,6 +365,36 @@ protected:
     typedef CC_SequentialDecodingInternal<T_Register, T_IOSymbol, bool> ParentInternal; //!< Parent class this class inherits from
     typedef CC_TreeNodeEdge<T_IOSymbol, T_Register, bool> FanoNodeEdge;   //!< Class of code tree nodes in the Fano algorithm
 
+    /**
+     * Searches the code tree given the reliability matrix. Algorithm reproduced from Sequential Decoding of Convolutional Codes
+     * by Yunghsiang S. Han and Po-Ning Chen p.26
+     * \parm relmat Reference to the reliability matrix
+     * \return Terminal node of the path found or 0 if none
+     */
+    FanoNodeEdge *search(const CC_ReliabilityMatrix& relmat)
+    {
+#ifdef _DEBUG
+        timespec time1, time2;
+        int time_option = CLOCK_REALTIME;
+        clock_gettime(time_option, &time1);
+#endif
+
+        start(relmat);
+
+        while (step(std::numeric_limits<unsigned int>::max()) == CC_Decode_Pending)
+        {}
+
+#ifdef _DEBUG
+        if (terminal_node_edge)
+        {
+            clock_gettime(time_option, &time2);
+            DEBUG_OUT(Parent::verbosity > 0, std::cout << "Decoding time: " << std::setw(12) << std::setprecision(9) << debug_get_time_difference(time2,time1) << " s" << std::endl);
+        }
+#endif
+
+        return terminal_node_edge;
+    }
+
     /**
      * Visit a new node
      * \parm node Node to visit
@@ -292,7 +405,8 @@ protected:
         unsigned int n = Parent::encoding.get_n();
         int forward_depth = node_edge->get_depth() + 1;
         T_IOSymbol out_symbol;
-        T_IOSymbol end_symbol;
+        unsigned int input_mask = Parent::get_input_mask(forward_depth, relmat.get_message_length());
+        bool step = true;
 
         // return encoder to appropriate state
         if (node_edge->get_depth() >= 0) // does not concern the root node_edge
@@ -300,27 +414,29 @@ protected:
             Parent::encoding.set_registers(node_edge->get_registers());
         }
 
-        if ((Parent::tail_zeros) && (forward_depth > relmat.get_message_length()-Parent::encoding.get_m()))
-        {
-            end_symbol = 1; // if zero tail option assume tail symbols are all zeros
-        }
-        else
-        {
-            end_symbol = (1<<Parent::encoding.get_k()); // full scan all possible input symbols
-        }
+        unsigned int first_child_id = Parent::node_count;
 
         if (node_edge->get_outgoing_node_edges().size() == 0) // edges are not cached
         {
             if ((tree_cache_size > 0) && (effective_node_count >= tree_cache_size)) // if tree cache is used and cache limit reached
             {
                 purge_tree_cache(node_edge); // purge before allocating new nodes
+                trace_event(CC_Trace_CachePurge, node_edge, node_edge->get_path_metric(), effective_node_count);
             }
 
             // loop through assumption for this symbol place and create child nodes
-            for (T_IOSymbol in_symbol = 0; in_symbol < end_symbol; in_symbol++)
+            for (T_IOSymbol in_symbol = 0; in_symbol < (1U<<Parent::encoding.get_k()); in_symbol++)
             {
-                Parent::encoding.encode(in_symbol, out_symbol, in_symbol > 0); // step only for a new symbol place
-                float edge_metric = ParentInternal::log2(relmat(out_symbol, forward_depth)) - Parent::edge_bias;
+                if (!Parent::is_admissible(input_mask, in_symbol))
+                {
+                    continue; // not admissible
+                }
+
+                Parent::encoding.encode(in_symbol, out_symbol, !step); // step only for a new symbol place
+                step = false;
+                float edge_metric = (relmat.is_hard_decision() ? relmat.get_hard_metric(out_symbol, forward_depth)
+                    : relmat.is_bit_metric() ? relmat.get_bit_metric(out_symbol, forward_depth)
+                    : ParentInternal::log2(relmat(out_symbol, forward_depth))) - Parent::edge_bias;
                 float forward_path_metric = edge_metric + node_edge->get_path_metric();
                 FanoNodeEdge *next_node_edge = new FanoNodeEdge(Parent::node_count++, node_edge, in_symbol, edge_metric, forward_path_metric, forward_depth);
                 next_node_edge->get_tag() = false; // Init traversed back indicator
@@ -329,6 +445,11 @@ protected:
                 effective_node_count++;
             }
         }
+
+        if (Parent::trace)
+        {
+            Parent::trace->record(CC_Trace_Expand, node_edge->get_id(), node_edge->get_depth(), node_edge->get_path_metric(), first_child_id, Parent::node_count - first_child_id);
+        }
     }
 
     /**
@@ -342,6 +463,7 @@ protected:
         if (node_edge_current == ParentInternal::root_node) // at root node there are no other options than loosening threshold
         {
             cur_threshold -= delta_threshold;
+            trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
             DEBUG_OUT(Parent::verbosity > 2, "loosening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
         }
         else
@@ -373,12 +495,15 @@ protected:
                     node_edge_current->get_tag() = true;
                 }
 
+                trace_event(CC_Trace_Backtrack, node_edge_current, node_edge_current->get_path_metric(), node_edge_predecessor->get_id());
+
                 // move back: change node address to previous node address
                 node_edge_current = node_edge_predecessor;
             }
             else // loosen threshold
             {
                 cur_threshold -= delta_threshold;
+                trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
                 DEBUG_OUT(Parent::verbosity > 2, "loosening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
             }
         }
@@ -481,6 +606,29 @@ protected:
         DEBUG_OUT(Parent::verbosity > 1, "purged tree cache, nb of remaining nodes = " << remaining_nodes << std::endl);
     }
 
+    /**
+     * Record an event in the trace if any
+     * \param type Event type
+     * \param node_edge Node+edge combo concerned
+     * \param metric Metric of the record: path metric of the node or new threshold
+     * \param related_id Related node id or count
+     */
+    void trace_event(CC_TraceEventType type, FanoNodeEdge *node_edge, float metric, unsigned int related_id = 0)
+    {
+        if (Parent::trace)
+        {
+            Parent::trace->record(type, node_edge->get_id(), node_edge->get_depth(), metric, related_id);
+        }
+    }
+
+    /**
+     * Record an event of a node in the trace if any
+     */
+    void trace_event(CC_TraceEventType type, FanoNodeEdge *node_edge)
+    {
+        trace_event(type, node_edge, node_edge->get_path_metric());
+    }
+
     float init_threshold;              //!< Initial path metric threshold
     float cur_threshold;               //!< Current path metric threshold
     float delta_threshold;             //!< Delta of path metric that is applied when lowering threshold
@@ -491,6 +639,10 @@ protected:
     unsigned int tree_cache_size;      //!< Tree cache size in maximum number of nodes in cache (0 = tree is not cached)
     bool unloop;                       //!< If true when a loop condition is detected attempt to restart with a lower threshold
     float delta_init_threshold;        //!< Delta of path metric that is applied when restarting with a lower initial threshold 
+    const CC_ReliabilityMatrix *step_relmat; //!< Reliability matrix of the decoding run step by step
+    CC_DecodeStatus step_status;       //!< Status of the decoding run step by step
+    FanoNodeEdge *step_node_edge;      //!< Current node where the next step resumes
+    FanoNodeEdge *terminal_node_edge;  //!< Terminal node of the path found when the decoding is done
 };
 
 
@@ -124,6 +124,96 @@ public:
      * \parm decoded_message Vector of symbols of retrieved message
      */
     virtual bool decode(const CC_ReliabilityMatrix& relmat, std::vector<T_IOSymbol>& decoded_message)
+    {
+        FanoNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Decodes given the reliability matrix writing the decoded message directly in a caller owned buffer
+     * of packed symbols e.g. uint8_t or uint16_t. With a stride greater than one the message symbols can
+     * be interleaved with other frames in the same buffer.
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Buffer receiving the relmat message length symbols of the retrieved message
+     * \param stride Distance in symbols between two successive message symbols in the buffer
+     */
+    template<typename T_OutSymbol>
+    bool decode(const CC_ReliabilityMatrix& relmat, T_OutSymbol *decoded_message, unsigned int stride = 1)
+    {
+        FanoNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, stride, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Print stats to an output stream
+     * \param os Output stream
+     * \param success True if decoding was successful
+     */
+    virtual void print_stats(std::ostream& os, bool success)
+    {
+        std::cout << "score = " << Parent::get_score()
+                << " cur.threshold = " << cur_threshold
+                << " nodes = " << Parent::get_nb_nodes()
+                << " eff.nodes = " << effective_node_count
+                << " moves = " << nb_moves
+                << " max depth = " << Parent::get_max_depth();
+    }
+
+    /**
+     * Print stats summary to an output stream
+     * \param os Output stream
+     * \param success True if decoding was successful
+     */
+    virtual void print_stats_summary(std::ostream& os, bool success)
+    {
+        std::cout << "_RES " << (success ? 1 : 0) << ","
+                << Parent::get_score() << ","
+                << cur_threshold << ","
+                << Parent::get_nb_nodes() << ","
+                << effective_node_count << ","
+                << nb_moves << ","
+                << Parent::get_max_depth();
+    }
+
+    /**
+     * Print the dot (Graphviz) file of the current decode tree to an output stream
+     * \param os Output stream
+     */
+    virtual void print_dot(std::ostream& os)
+    {
+        ParentInternal::print_dot_internal(os);
+    }
+
+protected:
+    typedef CC_SequentialDecoding_FA<T_Register, T_IOSymbol, N_k> Parent; //!< Parent class this class inherits from
+    typedef CC_SequentialDecodingInternal_FA<T_Register, T_IOSymbol, bool, N_k> ParentInternal; //!< Parent class this class inherits from
+    typedef CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, bool, N_k> FanoNodeEdge;   //!< Class of code tree nodes in the Fano algorithm
+
+    /**
+     * Searches the code tree given the reliability matrix. Algorithm reproduced from Sequential Decoding of Convolutional Codes
+     * by Yunghsiang S. Han and Po-Ning Chen p.26
+     * \parm relmat Reference to the reliability matrix
+     * \return Terminal node of the path found or 0 if none
+     */
+    FanoNodeEdge *search(const CC_ReliabilityMatrix& relmat)
     {
         FanoNodeEdge *node_edge_current, *node_edge_successor;
 
@@ -202,14 +292,14 @@ public:
                 if (node_edge_current->get_depth() == relmat.get_message_length() - 1)
                 {
                 	Parent::codeword_score = node_edge_current->get_path_metric();
-                    ParentInternal::back_track(node_edge_current, decoded_message, true); // back track from terminal node to retrieve decoded message
+                    trace_event(CC_Trace_Solution, node_edge_current);
                     solution_found = true;
                     Parent::max_depth++;
 #ifdef _DEBUG
                     clock_gettime(time_option, &time2);
                     DEBUG_OUT(Parent::verbosity > 0, std::cout << "Decoding time: " << std::setw(12) << std::setprecision(9) << debug_get_time_difference(time2,time1) << " s" << std::endl);
 #endif
-                    return true;
+                    return node_edge_current;
                 }
 
                 // threshold tightening for the new current node
@@ -226,6 +316,7 @@ public:
                     	cur_threshold = (nb_delta * delta_threshold) + init_threshold;
                     }
 
+                    trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
                     DEBUG_OUT(Parent::verbosity > 2, "tightening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
                 }
 
@@ -238,54 +329,9 @@ public:
             }
         }
 
-        return false;
-    }
-
-    /**
-     * Print stats to an output stream
-     * \param os Output stream
-     * \param success True if decoding was successful
-     */
-    virtual void print_stats(std::ostream& os, bool success)
-    {
-        std::cout << "score = " << Parent::get_score()
-                << " cur.threshold = " << cur_threshold
-                << " nodes = " << Parent::get_nb_nodes()
-                << " eff.nodes = " << effective_node_count
-                << " moves = " << nb_moves
-                << " max depth = " << Parent::get_max_depth();
-    }
-
-    /**
-     * Print stats summary to an output stream
-     * \param os Output stream
-     * \param success True if decoding was successful
-     */
-    virtual void print_stats_summary(std::ostream& os, bool success)
-    {
-        std::cout << "_RES " << (success ? 1 : 0) << ","
-                << Parent::get_score() << ","
-                << cur_threshold << ","
-                << Parent::get_nb_nodes() << ","
-                << effective_node_count << ","
-                << nb_moves << ","
-                << Parent::get_max_depth();
-    }
-
-    /**
-     * Print the dot (Graphviz) file of the current decode tree to an output stream
-     * \param os Output stream
-     */
-    virtual void print_dot(std::ostream& os)
-    {
-        ParentInternal::print_dot_internal(os);
+        return 0;
     }
 
-protected:
-    typedef CC_SequentialDecoding_FA<T_Register, T_IOSymbol, N_k> Parent; //!< Parent class this class inherits from
-    typedef CC_SequentialDecodingInternal_FA<T_Register, T_IOSymbol, bool, N_k> ParentInternal; //!< Parent class this class inherits from
-    typedef CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, bool, N_k> FanoNodeEdge;   //!< Class of code tree nodes in the Fano algorithm
-
     /**
      * Visit a new node
      * \parm node Node to visit
@@ -296,7 +342,8 @@ protected:
         unsigned int n = Parent::encoding.get_n();
         int forward_depth = node_edge->get_depth() + 1;
         T_IOSymbol out_symbol;
-        T_IOSymbol end_symbol;
+        unsigned int input_mask = Parent::get_input_mask(forward_depth, relmat.get_message_length());
+        bool step = true;
 
         // return encoder to appropriate state
         if (node_edge->get_depth() >= 0) // does not concern the root node_edge
@@ -304,27 +351,35 @@ protected:
             Parent::encoding.set_registers(node_edge->get_registers());
         }
 
-        if ((Parent::tail_zeros) && (forward_depth > relmat.get_message_length()-Parent::encoding.get_m()))
-        {
-            end_symbol = 1; // if zero tail option assume tail symbols are all zeros
-        }
-        else
+        unsigned int first_child_id = Parent::node_count;
+        bool cached = true;
+
+        for (unsigned int in_symbol = 0; (in_symbol < (1U<<N_k)) && cached; in_symbol++)
         {
-            end_symbol = (1<<Parent::encoding.get_k()); // full scan all possible input symbols
+            cached = !Parent::is_admissible(input_mask, in_symbol) || node_edge->get_outgoing_node_edges()[in_symbol];
         }
 
-        if (!node_edge->valid_outgoing_node_edges(end_symbol)) // edges are not cached
+        if (!cached) // edges are not cached
         {
             if ((tree_cache_size > 0) && (effective_node_count >= tree_cache_size)) // if tree cache is used and cache limit reached
             {
                 purge_tree_cache(node_edge); // purge before allocating new nodes
+                trace_event(CC_Trace_CachePurge, node_edge, node_edge->get_path_metric(), effective_node_count);
             }
 
             // loop through assumption for this symbol place and create child nodes
-            for (T_IOSymbol in_symbol = 0; in_symbol < end_symbol; in_symbol++)
+            for (T_IOSymbol in_symbol = 0; in_symbol < (1U<<Parent::encoding.get_k()); in_symbol++)
             {
-                Parent::encoding.encode(in_symbol, out_symbol, in_symbol > 0); // step only for a new symbol place
-                float edge_metric = ParentInternal::log2(relmat(out_symbol, forward_depth)) - Parent::edge_bias;
+                if (!Parent::is_admissible(input_mask, in_symbol))
+                {
+                    continue; // not admissible
+                }
+
+                Parent::encoding.encode(in_symbol, out_symbol, !step); // step only for a new symbol place
+                step = false;
+                float edge_metric = (relmat.is_hard_decision() ? relmat.get_hard_metric(out_symbol, forward_depth)
+                    : relmat.is_bit_metric() ? relmat.get_bit_metric(out_symbol, forward_depth)
+                    : ParentInternal::log2(relmat(out_symbol, forward_depth))) - Parent::edge_bias;
                 float forward_path_metric = edge_metric + node_edge->get_path_metric();
                 FanoNodeEdge *next_node_edge = new FanoNodeEdge(Parent::node_count++, node_edge, in_symbol, edge_metric, forward_path_metric, forward_depth);
                 next_node_edge->get_tag() = false; // Init traversed back indicator
@@ -333,6 +388,11 @@ protected:
                 effective_node_count++;
             }
         }
+
+        if (Parent::trace)
+        {
+            Parent::trace->record(CC_Trace_Expand, node_edge->get_id(), node_edge->get_depth(), node_edge->get_path_metric(), first_child_id, Parent::node_count - first_child_id);
+        }
     }
 
     /**
@@ -346,6 +406,7 @@ protected:
         if (node_edge_current == ParentInternal::root_node) // at root node there are no other options than loosening threshold
         {
             cur_threshold -= delta_threshold;
+            trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
             DEBUG_OUT(Parent::verbosity > 2, "loosening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
         }
         else
@@ -378,12 +439,15 @@ protected:
                     node_edge_current->get_tag() = true;
                 }
 
+                trace_event(CC_Trace_Backtrack, node_edge_current, node_edge_current->get_path_metric(), node_edge_predecessor->get_id());
+
                 // move back: change node address to previous node address
                 node_edge_current = node_edge_predecessor;
             }
             else // loosen threshold
             {
                 cur_threshold -= delta_threshold;
+                trace_event(CC_Trace_Threshold, node_edge_current, cur_threshold);
                 DEBUG_OUT(Parent::verbosity > 2, "loosening " << node_edge_current->get_path_metric() << " -> " << cur_threshold << std::endl);
             }
         }
@@ -404,7 +468,7 @@ protected:
 
             for (; ne_it != outgoing_node_edges.end(); ++ne_it)
             {
-                if ((*ne_it)->get_tag()) // traversed back
+                if ((*ne_it) && (*ne_it)->get_tag()) // traversed back
                 {
                     children_open = false;
                     break;
@@ -489,6 +553,29 @@ protected:
         DEBUG_OUT(Parent::verbosity > 1, "purged tree cache, nb of remaining nodes = " << remaining_nodes << std::endl);
     }
 
+    /**
+     * Record an event in the trace if any
+     * \param type Event type
+     * \param node_edge Node+edge combo concerned
+     * \param metric Metric of the record: path metric of the node or new threshold
+     * \param related_id Related node id or count
+     */
+    void trace_event(CC_TraceEventType type, FanoNodeEdge *node_edge, float metric, unsigned int related_id = 0)
+    {
+        if (Parent::trace)
+        {
+            Parent::trace->record(type, node_edge->get_id(), node_edge->get_depth(), metric, related_id);
+        }
+    }
+
+    /**
+     * Record an event of a node in the trace if any
+     */
+    void trace_event(CC_TraceEventType type, FanoNodeEdge *node_edge)
+    {
+        trace_event(type, node_edge, node_edge->get_path_metric());
+    }
+
     float init_threshold;              //!< Initial path metric threshold
     float cur_threshold;               //!< Current path metric threshold
     float delta_threshold;             //!< Delta of path metric that is applied when lowering threshold
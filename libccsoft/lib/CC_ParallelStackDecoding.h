@@ -0,0 +1,843 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+ Parallel version of the stack algorithm. Several worker threads expand
+ the top entries of a relaxed priority structure at the same time within
+ one frame.
+
+ The stack is split in several ordered queues each protected by its own
+ mutex (multi-queue). A worker pops the best of the tops of two queues
+ picked at random and pushes the successors in random queues. The popped
+ node is therefore only approximately the best of the whole stack and
+ some nodes the sequential algorithm would never reach can be expanded.
+ A node whose path metric is further than the relaxation window from the
+ best open one is put back so that a path far behind cannot run ahead of
+ the best path to the end of the tree while the other workers are idle.
+
+ Each worker owns an encoder and an arena the nodes it creates are carved
+ from. Nodes only link to their incoming node so that the arenas can be
+ rewound at once at the next decoding.
+
+ The best terminal node popped so far is shared. Nodes that are not better
+ than it are dropped and the search stops when no queue has a better entry
+ left, which is the stack algorithm condition of a terminal node at the top
+ of the stack.
+
+ Decoding events are not recorded in a decoding trace set with set_trace as
+ the workers would have to serialize on the ring.
+
+ */
+#ifndef __CC_PARALLEL_STACK_DECODING_H__
+#define __CC_PARALLEL_STACK_DECODING_H__
+
+#include "CC_SequentialDecoding.h"
+#include "CC_SequentialDecodingInternal.h"
+#include "CC_Encoding.h"
+#include "CCSoft_Exception.h"
+#include "CC_TreeNodeEdge.h"
+#include "CC_ReliabilityMatrix.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <new>
+#include <iostream>
+
+
+namespace ccsoft
+{
+
+/**
+ * \brief The parallel Stack Decoding class with node+edge combination
+ * \tparam T_Register Type of the encoder internal registers
+ * \tparam T_IOSymbol Type of the input and output symbols
+ */
+template<typename T_Register, typename T_IOSymbol>
+class CC_ParallelStackDecoding : public CC_SequentialDecoding<T_Register, T_IOSymbol>, public CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty>
+{
+public:
+    /**
+     * Constructor
+     * \param constraints Vector of register lengths (constraint length + 1). The number of elements determines k.
+     * \param genpoly_representations Generator polynomial numeric representations. There are as many elements as there
+     * are input bits (k). Each element is itself a vector with one polynomial value per output bit. The smallest size of
+     * these vectors is retained as the number of output bits n. The input bits of a symbol are clocked simultaneously into
+     * the right hand side, or least significant position of the internal registers. Therefore the given polynomial representation
+     * of generators should follow the same convention.
+     * \param _nb_workers Number of workers including the thread calling decode
+     * \param nb_queues_per_worker Number of queues of the stack per worker
+     */
+	CC_ParallelStackDecoding(const std::vector<unsigned int>& constraints,
+            const std::vector<std::vector<T_Register> >& genpoly_representations,
+            unsigned int _nb_workers = 2,
+            unsigned int nb_queues_per_worker = 2) :
+                CC_SequentialDecoding<T_Register, T_IOSymbol>(constraints, genpoly_representations),
+                CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty>(),
+                nb_workers(_nb_workers),
+                relmat(0),
+                nb_open(0),
+                nb_nodes(0),
+                stop(false),
+                node_limit_exhausted(false),
+                best_terminal(0),
+                best_terminal_metric(-INFINITY),
+                relaxation_window(default_relaxation_window)
+    {
+        if ((nb_workers == 0) || (nb_queues_per_worker == 0))
+        {
+            throw CCSoft_Exception("Parallel stack decoding needs at least one worker and one queue per worker");
+        }
+
+        for (unsigned int i=0; i<nb_workers; i++)
+        {
+            Worker *worker = new Worker(constraints, genpoly_representations);
+            worker->decoding = this;
+            worker->index = i;
+            worker->seed = 2*i + 1;
+            workers.push_back(worker);
+        }
+
+        for (unsigned int i=0; i<nb_workers*nb_queues_per_worker; i++)
+        {
+            StackQueue *queue = new StackQueue;
+            pthread_mutex_init(&queue->mutex, 0);
+            queue->top_metric = -INFINITY;
+            queues.push_back(queue);
+        }
+
+        pthread_mutex_init(&terminal_mutex, 0);
+    }
+
+    /**
+     * Destructor. Releases the nodes arenas.
+     */
+    virtual ~CC_ParallelStackDecoding()
+    {
+        typename std::vector<Worker*>::iterator w_it = workers.begin();
+
+        for (; w_it != workers.end(); ++w_it)
+        {
+            (*w_it)->clear_arena();
+            (*w_it)->release_arena();
+            delete *w_it;
+        }
+
+        typename std::vector<StackQueue*>::iterator q_it = queues.begin();
+
+        for (; q_it != queues.end(); ++q_it)
+        {
+            pthread_mutex_destroy(&(*q_it)->mutex);
+            delete *q_it;
+        }
+
+        pthread_mutex_destroy(&terminal_mutex);
+    }
+
+    /**
+     * Reset the decoding process. Arenas are rewound but keep their memory for the next decoding.
+     */
+    void reset()
+    {
+        ParentInternal::reset();
+        Parent::reset();
+
+        typename std::vector<Worker*>::iterator w_it = workers.begin();
+
+        for (; w_it != workers.end(); ++w_it)
+        {
+            (*w_it)->clear_arena();
+            (*w_it)->nb_nodes = 0;
+            (*w_it)->nb_expansions = 0;
+            (*w_it)->max_depth = 0;
+        }
+
+        typename std::vector<StackQueue*>::iterator q_it = queues.begin();
+
+        for (; q_it != queues.end(); ++q_it)
+        {
+            (*q_it)->entries.clear();
+            (*q_it)->top_metric = -INFINITY;
+        }
+
+        nb_open = 0;
+        nb_nodes = 0;
+        stop = false;
+        node_limit_exhausted = false;
+        best_terminal = 0;
+        best_terminal_metric = -INFINITY;
+    }
+
+    /**
+     * Get the number of workers including the thread calling decode
+     */
+    unsigned int get_nb_workers() const
+    {
+        return nb_workers;
+    }
+
+    /**
+     * Get the number of queues the stack is split into
+     */
+    unsigned int get_nb_queues() const
+    {
+        return queues.size();
+    }
+
+    /**
+     * Set the relaxation window. A worker only expands a node whose path metric is within this distance of the best
+     * path metric open in the queues or at the other workers. Otherwise it puts the node back and waits for better ones
+     * to be expanded. A smaller window keeps the search closer to the sequential stack algorithm order while a larger
+     * one lets more workers expand nodes at the same time.
+     * \param _relaxation_window Relaxation window in path metric units
+     */
+    void set_relaxation_window(float _relaxation_window)
+    {
+        relaxation_window = _relaxation_window;
+    }
+
+    /**
+     * Get the relaxation window
+     */
+    float get_relaxation_window() const
+    {
+        return relaxation_window;
+    }
+
+    /**
+     * Get the number of nodes expanded during the last decoding by all workers
+     */
+    unsigned int get_nb_expansions() const
+    {
+        unsigned int nb_expansions = 0;
+        typename std::vector<Worker*>::const_iterator w_it = workers.begin();
+
+        for (; w_it != workers.end(); ++w_it)
+        {
+            nb_expansions += (*w_it)->nb_expansions;
+        }
+
+        return nb_expansions;
+    }
+
+    /**
+     * Get the stack size i.e. the total number of entries in the queues
+     */
+    unsigned int get_stack_size() const
+    {
+        unsigned int stack_size = 0;
+        typename std::vector<StackQueue*>::const_iterator q_it = queues.begin();
+
+        for (; q_it != queues.end(); ++q_it)
+        {
+            stack_size += (*q_it)->entries.size();
+        }
+
+        return stack_size;
+    }
+
+    /**
+     * Decodes given the reliability matrix
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Vector of symbols of retrieved message
+     */
+    virtual bool decode(const CC_ReliabilityMatrix& relmat, std::vector<T_IOSymbol>& decoded_message)
+    {
+        StackNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Decodes given the reliability matrix writing the decoded message directly in a caller owned buffer
+     * of packed symbols e.g. uint8_t or uint16_t. With a stride greater than one the message symbols can
+     * be interleaved with other frames in the same buffer.
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Buffer receiving the relmat message length symbols of the retrieved message
+     * \param stride Distance in symbols between two successive message symbols in the buffer
+     */
+    template<typename T_OutSymbol>
+    bool decode(const CC_ReliabilityMatrix& relmat, T_OutSymbol *decoded_message, unsigned int stride = 1)
+    {
+        StackNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, stride, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Print stats to an output stream
+     * \param os Output stream
+     * \param success True if decoding was successful
+     */
+    virtual void print_stats(std::ostream&, bool)
+    {
+        std::cout << "score = " << Parent::get_score()
+                << " #nodes = " << Parent::get_nb_nodes()
+                << " #expansions = " << get_nb_expansions()
+                << " stack_size = " << get_stack_size()
+                << " max depth = " << Parent::get_max_depth()
+                << " workers = " << get_nb_workers();
+    }
+
+    /**
+     * Print stats summary to an output stream
+     * \param os Output stream
+     * \param success True if decoding was successful
+     */
+    virtual void print_stats_summary(std::ostream&, bool success)
+    {
+        std::cout << "_RES " << (success ? 1 : 0) << ","
+                << Parent::get_score() << ","
+                << Parent::get_score() << ","
+                << Parent::get_nb_nodes() << ","
+                << get_stack_size() << ","
+                << Parent::get_max_depth();
+    }
+
+    /**
+     * The code tree is not linked forward by the parallel algorithm so it cannot be printed
+     * \param os Output stream
+     */
+    virtual void print_dot(std::ostream&)
+    {
+        throw CCSoft_Exception("Graphviz output is not supported by the parallel stack algorithm");
+    }
+
+protected:
+    typedef CC_SequentialDecoding<T_Register, T_IOSymbol> Parent;                                       //!< Parent class this class inherits from
+    typedef CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty> ParentInternal; //!< Parent class this class inherits from
+    typedef CC_TreeNodeEdge<T_IOSymbol, T_Register, CC_TreeNodeEdgeTag_Empty> StackNodeEdge; //!< Class of code tree nodes in the stack algorithm
+
+    static const unsigned int arena_block_size = 1024; //!< Number of nodes per arena block
+    static const float default_relaxation_window;      //!< Default relaxation window
+
+    /**
+     * One of the queues the stack is split into
+     */
+    struct StackQueue
+    {
+        pthread_mutex_t mutex; //!< Protects entries
+        std::map<NodeEdgeOrdering, StackNodeEdge*, std::greater<NodeEdgeOrdering> > entries; //!< Ordered entries by decreasing path metric
+        volatile float top_metric; //!< Path metric of the first entry or -infinity if empty. Read without the lock to choose the queue.
+    };
+
+    /**
+     * Worker state
+     */
+    struct Worker
+    {
+        Worker(const std::vector<unsigned int>& constraints, const std::vector<std::vector<T_Register> >& genpoly_representations) :
+            encoding(constraints, genpoly_representations),
+            decoding(0),
+            index(0),
+            seed(1),
+            nb_nodes(0),
+            nb_expansions(0),
+            max_depth(0),
+            active_metric(-INFINITY),
+            block_index(0),
+            nb_in_block(0)
+        {}
+
+        /**
+         * Create a node in the arena
+         */
+        StackNodeEdge *new_node_edge(unsigned int id, StackNodeEdge *incoming_node_edge, T_IOSymbol in_symbol, float edge_metric, float path_metric, int depth)
+        {
+            if (nb_in_block == arena_block_size)
+            {
+                block_index++;
+                nb_in_block = 0;
+            }
+
+            if (block_index == blocks.size())
+            {
+                blocks.push_back(static_cast<char*>(::operator new(arena_block_size*sizeof(StackNodeEdge))));
+            }
+
+            void *slot = blocks[block_index] + nb_in_block*sizeof(StackNodeEdge);
+            nb_in_block++;
+            return new (slot) StackNodeEdge(id, incoming_node_edge, in_symbol, edge_metric, path_metric, depth);
+        }
+
+        /**
+         * Destroy the nodes of the arena and rewind it keeping its blocks
+         */
+        void clear_arena()
+        {
+            for (unsigned int ib=0; (ib<=block_index) && (ib<blocks.size()); ib++)
+            {
+                unsigned int nb_nodes_in_block = (ib == block_index ? nb_in_block : arena_block_size);
+
+                for (unsigned int in=0; in<nb_nodes_in_block; in++)
+                {
+                    reinterpret_cast<StackNodeEdge*>(blocks[ib] + in*sizeof(StackNodeEdge))->~StackNodeEdge();
+                }
+            }
+
+            block_index = 0;
+            nb_in_block = 0;
+        }
+
+        /**
+         * Give the arena blocks back to the heap. Arena must be cleared.
+         */
+        void release_arena()
+        {
+            std::vector<char*>::iterator b_it = blocks.begin();
+
+            for (; b_it != blocks.end(); ++b_it)
+            {
+                ::operator delete(*b_it);
+            }
+
+            blocks.clear();
+        }
+
+        /**
+         * Random number for the choice of queues (xorshift)
+         */
+        unsigned int random()
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        }
+
+        CC_Encoding<T_Register, T_IOSymbol> encoding; //!< Encoder of this worker
+        CC_ParallelStackDecoding *decoding;           //!< Decoder the worker belongs to
+        unsigned int index;         //!< Index of the worker, 0 for the thread calling decode
+        unsigned int seed;          //!< State of the random generator
+        unsigned int nb_nodes;      //!< Number of nodes created by this worker
+        unsigned int nb_expansions; //!< Number of nodes expanded by this worker
+        int max_depth;              //!< Maximum depth reached by this worker
+        volatile float active_metric; //!< Path metric of the node being processed or -infinity if none
+        std::vector<char*> blocks;  //!< Arena blocks
+        unsigned int block_index;   //!< Index of the block being filled
+        unsigned int nb_in_block;   //!< Number of nodes in the block being filled
+    };
+
+    static void *worker_thread(void *arg)
+    {
+        Worker *worker = static_cast<Worker*>(arg);
+        worker->decoding->work(*worker);
+        return 0;
+    }
+
+    /**
+     * Searches the code tree given the reliability matrix
+     * \param relmat Reference to the reliability matrix
+     */
+    StackNodeEdge *search(const CC_ReliabilityMatrix& _relmat)
+    {
+        if (_relmat.get_message_length() < Parent::encoding.get_m())
+        {
+            throw CCSoft_Exception("Reliability Matrix should have a number of columns at least equal to the code constraint");
+        }
+
+        if (_relmat.get_nb_symbols_log2() != Parent::encoding.get_n())
+        {
+            throw CCSoft_Exception("Reliability Matrix is not compatible with code output symbol size");
+        }
+
+        reset();
+        ParentInternal::init_root(); // initialize the root node
+        workers[0]->encoding.clear();
+        visit_node_forward(ParentInternal::root_node, _relmat); // visit the root node
+        std::vector<pthread_t> threads(nb_workers);
+
+        for (unsigned int i=1; i<nb_workers; i++)
+        {
+            if (pthread_create(&threads[i], 0, worker_thread, workers[i]) != 0)
+            {
+                stop = true;
+
+                for (unsigned int j=1; j<i; j++)
+                {
+                    pthread_join(threads[j], 0);
+                }
+
+                throw CCSoft_Exception("Cannot start parallel stack decoding thread");
+            }
+        }
+
+        work(*workers[0]);
+
+        for (unsigned int i=1; i<nb_workers; i++)
+        {
+            pthread_join(threads[i], 0);
+        }
+
+        Parent::node_count = nb_nodes + 1; // count the root node
+
+        for (unsigned int i=0; i<nb_workers; i++)
+        {
+            if (workers[i]->max_depth > Parent::max_depth)
+            {
+                Parent::max_depth = workers[i]->max_depth;
+            }
+        }
+
+        if (node_limit_exhausted)
+        {
+            std::cerr << "Node limit exhausted" << std::endl;
+            return 0;
+        }
+        else if (best_terminal)
+        {
+            Parent::codeword_score = best_terminal->get_path_metric(); // the codeword score is the path metric
+            Parent::cur_depth = best_terminal->get_depth();
+            return best_terminal;
+        }
+        else
+        {
+            std::cerr << "Metric limit encountered" << std::endl;
+            return 0; // no solution
+        }
+    }
+
+    /**
+     * Worker loop: pop and expand nodes until the search is over
+     */
+    void work(Worker& worker)
+    {
+        int terminal_depth = relmat->get_message_length() - 1;
+
+        while (!stop)
+        {
+            StackNodeEdge *node_edge = pop(worker);
+
+            if (!node_edge)
+            {
+                if (nb_open == 0) // all paths are under the metric limit and no other worker can add any
+                {
+                    stop = true;
+                }
+                else
+                {
+                    sched_yield();
+                }
+
+                continue;
+            }
+
+            float terminal_metric;
+
+            if (get_best_terminal_metric(terminal_metric) && !(node_edge->get_path_metric() > terminal_metric)) // node is dropped as it cannot beat the best terminal node
+            {
+                if (!better_entry_open(worker, terminal_metric)) // the best terminal node would be on top of the stack
+                {
+                    stop = true;
+                }
+            }
+            else if (node_edge->get_depth() == terminal_depth)
+            {
+                pthread_mutex_lock(&terminal_mutex);
+
+                if (!best_terminal || (node_edge->get_path_metric() > best_terminal_metric))
+                {
+                    best_terminal_metric = node_edge->get_path_metric();
+                    best_terminal = node_edge;
+                }
+
+                pthread_mutex_unlock(&terminal_mutex);
+            }
+            else if (node_edge->get_path_metric() < best_open_metric(worker) - relaxation_window) // too far behind: let better nodes go first
+            {
+                push(worker, node_edge);
+                worker.active_metric = -INFINITY;
+                __sync_fetch_and_sub(&nb_open, 1); // the node was counted again when pushed back
+                sched_yield();
+                continue;
+            }
+            else
+            {
+                expand(worker, node_edge);
+
+                if ((Parent::use_node_limit) && (nb_nodes > Parent::node_limit))
+                {
+                    node_limit_exhausted = true;
+                    stop = true;
+                }
+            }
+
+            worker.active_metric = -INFINITY;
+            __sync_fetch_and_sub(&nb_open, 1);
+        }
+    }
+
+    /**
+     * Get the path metric of the best terminal node and whether there is one as a consistent pair read under the terminal mutex
+     * \param metric Receives the path metric of the best terminal node if any
+     * \return true if a terminal node was popped
+     */
+    bool get_best_terminal_metric(float& metric)
+    {
+        pthread_mutex_lock(&terminal_mutex);
+        bool found = (best_terminal != 0);
+        metric = best_terminal_metric;
+        pthread_mutex_unlock(&terminal_mutex);
+        return found;
+    }
+
+    /**
+     * Tells if another worker processes or any queue holds a node better than the best terminal node. Workers are looked
+     * at before and after the queues so that a node moving from a queue to a worker or from a worker to the queues as
+     * successors is not missed.
+     * \param worker Worker asking
+     * \param terminal_metric Path metric of the best terminal node
+     */
+    bool better_entry_open(const Worker& worker, float terminal_metric) const
+    {
+        if (better_node_active(worker, terminal_metric))
+        {
+            return true;
+        }
+
+        __sync_synchronize();
+        typename std::vector<StackQueue*>::const_iterator q_it = queues.begin();
+
+        for (; q_it != queues.end(); ++q_it)
+        {
+            if ((*q_it)->top_metric > terminal_metric)
+            {
+                return true;
+            }
+        }
+
+        __sync_synchronize();
+        return better_node_active(worker, terminal_metric);
+    }
+
+    /**
+     * Best path metric in the queues or processed by the other workers
+     * \param worker Worker asking
+     */
+    float best_open_metric(const Worker& worker) const
+    {
+        float best_metric = -INFINITY;
+        typename std::vector<StackQueue*>::const_iterator q_it = queues.begin();
+
+        for (; q_it != queues.end(); ++q_it)
+        {
+            if ((*q_it)->top_metric > best_metric)
+            {
+                best_metric = (*q_it)->top_metric;
+            }
+        }
+
+        typename std::vector<Worker*>::const_iterator w_it = workers.begin();
+
+        for (; w_it != workers.end(); ++w_it)
+        {
+            if ((*w_it != &worker) && ((*w_it)->active_metric > best_metric))
+            {
+                best_metric = (*w_it)->active_metric;
+            }
+        }
+
+        return best_metric;
+    }
+
+    /**
+     * Tells if another worker processes a node better than the best terminal node
+     * \param worker Worker asking
+     * \param terminal_metric Path metric of the best terminal node
+     */
+    bool better_node_active(const Worker& worker, float terminal_metric) const
+    {
+        typename std::vector<Worker*>::const_iterator w_it = workers.begin();
+
+        for (; w_it != workers.end(); ++w_it)
+        {
+            if ((*w_it != &worker) && ((*w_it)->active_metric > terminal_metric))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Pop the best entry of two queues chosen at random
+     * \return 0 if both queues were found empty
+     */
+    StackNodeEdge *pop(Worker& worker)
+    {
+        StackQueue *queue_a = queues[worker.random() % queues.size()];
+        StackQueue *queue_b = queues[worker.random() % queues.size()];
+        StackQueue *queue = (queue_b->top_metric > queue_a->top_metric ? queue_b : queue_a);
+        StackNodeEdge *node_edge = 0;
+
+        pthread_mutex_lock(&queue->mutex);
+
+        if (queue->entries.size() > 0)
+        {
+            node_edge = queue->entries.begin()->second;
+            worker.active_metric = node_edge->get_path_metric(); // before it leaves the queue for the other workers
+            queue->entries.erase(queue->entries.begin());
+            queue->top_metric = (queue->entries.size() > 0 ? queue->entries.begin()->first.path_metric : -INFINITY);
+        }
+
+        pthread_mutex_unlock(&queue->mutex);
+
+        if (!node_edge) // unlucky draw: look at all queues before giving up
+        {
+            for (unsigned int i=0; (i<queues.size()) && !node_edge; i++)
+            {
+                queue = queues[(worker.index + i) % queues.size()];
+
+                if (queue->top_metric == -INFINITY)
+                {
+                    continue;
+                }
+
+                pthread_mutex_lock(&queue->mutex);
+
+                if (queue->entries.size() > 0)
+                {
+                    node_edge = queue->entries.begin()->second;
+                    worker.active_metric = node_edge->get_path_metric(); // before it leaves the queue for the other workers
+                    queue->entries.erase(queue->entries.begin());
+                    queue->top_metric = (queue->entries.size() > 0 ? queue->entries.begin()->first.path_metric : -INFINITY);
+                }
+
+                pthread_mutex_unlock(&queue->mutex);
+            }
+        }
+
+        return node_edge;
+    }
+
+    /**
+     * Push an entry in a queue chosen at random
+     */
+    void push(Worker& worker, StackNodeEdge *node_edge)
+    {
+        StackQueue *queue = queues[worker.random() % queues.size()];
+        __sync_fetch_and_add(&nb_open, 1);
+
+        pthread_mutex_lock(&queue->mutex);
+        queue->entries[NodeEdgeOrdering(node_edge->get_path_metric(), node_edge->get_id())] = node_edge;
+        queue->top_metric = queue->entries.begin()->first.path_metric;
+        pthread_mutex_unlock(&queue->mutex);
+    }
+
+    /**
+     * Visit a new node from the thread calling decode
+     * \node Node+edge combo to visit
+     * \relmat Reliability matrix being used
+     */
+    virtual void visit_node_forward(StackNodeEdge* node_edge, const CC_ReliabilityMatrix& _relmat)
+    {
+        relmat = &_relmat;
+        expand(*workers[0], node_edge);
+    }
+
+    /**
+     * Create the successors of a node and push them in the stack
+     * \param worker Worker expanding the node
+     * \param node_edge Node+edge combo to expand
+     */
+    void expand(Worker& worker, StackNodeEdge *node_edge)
+    {
+        int forward_depth = node_edge->get_depth() + 1;
+        T_IOSymbol out_symbol;
+        unsigned int input_mask = Parent::get_input_mask(forward_depth, relmat->get_message_length());
+        bool step = true;
+
+        // return encoder to appropriate state
+        if (node_edge->get_depth() >= 0) // does not concern the root node
+        {
+            worker.encoding.set_registers(node_edge->get_registers());
+        }
+
+        // loop through the admissible assumptions for this symbol place
+        for (T_IOSymbol in_symbol = 0; in_symbol < (1U<<worker.encoding.get_k()); in_symbol++)
+        {
+            if (!Parent::is_admissible(input_mask, in_symbol))
+            {
+                continue;
+            }
+
+            worker.encoding.encode(in_symbol, out_symbol, !step); // step only for a new symbol place
+            step = false;
+            float edge_metric = (relmat->is_hard_decision() ? relmat->get_hard_metric(out_symbol, forward_depth)
+            : relmat->is_bit_metric() ? relmat->get_bit_metric(out_symbol, forward_depth)
+            : ParentInternal::log2((*relmat)(out_symbol, forward_depth))) - Parent::edge_bias;
+
+            float forward_path_metric = edge_metric + node_edge->get_path_metric();
+            if ((!Parent::use_metric_limit) || (forward_path_metric > Parent::metric_limit))
+            {
+                unsigned int id = (worker.nb_nodes * nb_workers) + worker.index + 1; // unique across workers, root node is 0
+                StackNodeEdge *next_node_edge = worker.new_node_edge(id, node_edge, in_symbol, edge_metric, forward_path_metric, forward_depth);
+                next_node_edge->set_registers(worker.encoding.get_registers());
+                worker.nb_nodes++;
+                __sync_fetch_and_add(&nb_nodes, 1);
+                push(worker, next_node_edge);
+            }
+        }
+
+        worker.nb_expansions++;
+
+        if (forward_depth > worker.max_depth)
+        {
+            worker.max_depth = forward_depth;
+        }
+    }
+
+    unsigned int nb_workers;              //!< Number of workers including the thread calling decode
+    std::vector<Worker*> workers;         //!< Workers state
+    std::vector<StackQueue*> queues;      //!< Queues the stack is split into
+    const CC_ReliabilityMatrix *relmat;   //!< Reliability matrix being decoded
+    volatile unsigned int nb_open;        //!< Number of entries in the queues plus nodes being expanded
+    volatile unsigned int nb_nodes;       //!< Number of nodes created by all workers
+    volatile bool stop;                   //!< The search is over
+    volatile bool node_limit_exhausted;   //!< The search stopped on the node limit
+    pthread_mutex_t terminal_mutex;       //!< Protects the best terminal node and its metric while the workers run
+    StackNodeEdge *best_terminal;         //!< Best terminal node popped so far
+    float best_terminal_metric;           //!< Path metric of the best terminal node
+    float relaxation_window;              //!< Path metric distance to the best open node within which nodes are expanded
+};
+
+template<typename T_Register, typename T_IOSymbol>
+const float CC_ParallelStackDecoding<T_Register, T_IOSymbol>::default_relaxation_window = 4.0;
+
+} // namespace ccsoft
+
+#endif // __CC_PARALLEL_STACK_DECODING_H__
@@ -0,0 +1,441 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Reliability matrix kernels with run time instruction set dispatch
+
+ */
+
+#include "CC_ReliabilityKernels.h"
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CC_KERNELS_X86
+#endif
+
+#define CC_KERNELS_INLINE static inline __attribute__((always_inline))
+
+#pragma GCC diagnostic ignored "-Wpsabi" // blocks are only returned by always inlined helpers
+
+namespace ccsoft
+{
+
+namespace
+{
+
+typedef float BlockF __attribute__((vector_size(64))); //!< Block of 16 floats
+typedef int BlockI __attribute__((vector_size(64)));   //!< Block of 16 ints or comparison mask
+static const unsigned int block_size = 16;
+
+CC_KERNELS_INLINE BlockF load_block(const float *values)
+{
+    BlockF block;
+    memcpy(&block, values, sizeof(BlockF));
+    return block;
+}
+
+CC_KERNELS_INLINE void store_block(float *values, const BlockF& block)
+{
+    memcpy(values, &block, sizeof(BlockF));
+}
+
+CC_KERNELS_INLINE BlockF splat(float value)
+{
+    BlockF zero = {};
+    return zero + value;
+}
+
+CC_KERNELS_INLINE bool any_lane(const BlockI& mask)
+{
+    int any = 0;
+
+    for (unsigned int j = 0; j < block_size; j++)
+    {
+        any |= mask[j];
+    }
+
+    return any != 0;
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE float column_sum_body(const float *column, unsigned int nb_rows)
+{
+    BlockF acc = {};
+    unsigned int ir = 0;
+
+    for (; ir + block_size <= nb_rows; ir += block_size)
+    {
+        acc += load_block(&column[ir]);
+    }
+
+    float sum = 0.0;
+
+    for (unsigned int j = 0; j < block_size; j++)
+    {
+        sum += acc[j];
+    }
+
+    for (; ir < nb_rows; ir++)
+    {
+        sum += column[ir];
+    }
+
+    return sum;
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE void column_sums_body(const float *matrix, unsigned int nb_rows, unsigned int nb_cols, float *sums)
+{
+    for (unsigned int ic = 0; ic < nb_cols; ic++)
+    {
+        sums[ic] = column_sum_body(&matrix[ic*nb_rows], nb_rows);
+    }
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE void normalize_body(float *matrix, unsigned int nb_rows, unsigned int nb_cols)
+{
+    for (unsigned int ic = 0; ic < nb_cols; ic++)
+    {
+        float *column = &matrix[ic*nb_rows];
+        float col_sum = column_sum_body(column, nb_rows);
+
+        if (col_sum == 0.0) // erasure
+        {
+            continue;
+        }
+
+        BlockF sum_block = splat(col_sum);
+        unsigned int ir = 0;
+
+        for (; ir + block_size <= nb_rows; ir += block_size)
+        {
+            store_block(&column[ir], load_block(&column[ir]) / sum_block);
+        }
+
+        for (; ir < nb_rows; ir++)
+        {
+            column[ir] /= col_sum;
+        }
+    }
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE float max_value_below_body(const float *values, unsigned int nb_values, float floor, float bound)
+{
+    BlockF acc = splat(floor);
+    BlockF floor_block = acc;
+    BlockF bound_block = splat(bound);
+    unsigned int i = 0;
+
+    for (; i + block_size <= nb_values; i += block_size)
+    {
+        BlockF block = load_block(&values[i]);
+        block = (block < bound_block ? block : floor_block);
+        acc = (block > acc ? block : acc);
+    }
+
+    float max = floor;
+
+    for (unsigned int j = 0; j < block_size; j++)
+    {
+        max = (acc[j] > max ? acc[j] : max);
+    }
+
+    for (; i < nb_values; i++)
+    {
+        if ((values[i] < bound) && (values[i] > max))
+        {
+            max = values[i];
+        }
+    }
+
+    return max;
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE float max_value_body(const float *values, unsigned int nb_values, float floor)
+{
+    return max_value_below_body(values, nb_values, floor, INFINITY);
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE unsigned int find_first_body(const float *values, unsigned int nb_values, float value)
+{
+    BlockF value_block = splat(value);
+    unsigned int i = 0;
+
+    for (; i + block_size <= nb_values; i += block_size)
+    {
+        if (any_lane(load_block(&values[i]) == value_block))
+        {
+            break;
+        }
+    }
+
+    for (; i < nb_values; i++)
+    {
+        if (values[i] == value)
+        {
+            return i;
+        }
+    }
+
+    return nb_values;
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE unsigned int find_last_body(const float *values, unsigned int nb_values, float value)
+{
+    BlockF value_block = splat(value);
+    unsigned int i = nb_values;
+
+    for (; i >= block_size; i -= block_size)
+    {
+        if (any_lane(load_block(&values[i - block_size]) == value_block))
+        {
+            break;
+        }
+    }
+
+    for (; i > 0; i--)
+    {
+        if (values[i-1] == value)
+        {
+            return i-1;
+        }
+    }
+
+    return nb_values;
+}
+
+// ================================================================================================
+// log2(x) = e + log2(m) with x = 2^e*m and m in [sqrt(2)/2, sqrt(2)). log2(m) is 2/ln(2)*atanh(s)
+// with s = (m-1)/(m+1) in [-0.172, 0.172] expanded up to s^9.
+CC_KERNELS_INLINE BlockF log2_block(const BlockF& x)
+{
+    BlockI bits = (BlockI) x;
+    BlockI exponent = ((bits >> 23) & 0xff) - 127;
+    BlockF mantissa = (BlockF) ((bits & 0x7fffff) | 0x3f800000);
+    BlockI above = (mantissa > splat(M_SQRT2)); // -1 where true
+    mantissa = (above ? mantissa * 0.5f : mantissa);
+    exponent -= above;
+    BlockF s = (mantissa - 1.0f) / (mantissa + 1.0f);
+    BlockF s2 = s * s;
+    BlockF poly = splat(2.0*M_LOG2E/9.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/7.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/5.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E/3.0);
+    poly = poly * s2 + (float) (2.0*M_LOG2E);
+    return __builtin_convertvector(exponent, BlockF) + poly * s;
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE void log2_body(const float *values, unsigned int nb_values, float *log2_values)
+{
+    BlockF min_block = splat(FLT_MIN);
+    BlockF inf_block = splat(INFINITY);
+    unsigned int i = 0;
+
+    for (; i + block_size <= nb_values; i += block_size)
+    {
+        BlockF x = load_block(&values[i]);
+        BlockI normal = (x >= min_block) & (x < inf_block);
+        store_block(&log2_values[i], log2_block(x));
+
+        if (!any_lane(~normal)) // all normal numbers
+        {
+            continue;
+        }
+
+        for (unsigned int j = 0; j < block_size; j++) // zeros, denormals, negative numbers, infinities and NaNs
+        {
+            if (!normal[j])
+            {
+                log2_values[i+j] = ::log2f(x[j]);
+            }
+        }
+    }
+
+    for (; i < nb_values; i++)
+    {
+        float x = values[i];
+
+        if ((x >= FLT_MIN) && (x < INFINITY))
+        {
+            log2_values[i] = log2_block(splat(x))[0];
+        }
+        else
+        {
+            log2_values[i] = ::log2f(x);
+        }
+    }
+}
+
+// ================================================================================================
+CC_KERNELS_INLINE void fill_body(float *values, unsigned int nb_values, float value)
+{
+    BlockF value_block = splat(value);
+    unsigned int i = 0;
+
+    for (; i + block_size <= nb_values; i += block_size)
+    {
+        store_block(&values[i], value_block);
+    }
+
+    for (; i < nb_values; i++)
+    {
+        values[i] = value;
+    }
+}
+
+// ================================================================================================
+// Instantiates the kernels for one instruction set
+#define CC_KERNELS_SET(suffix, target_attribute) \
+    static target_attribute void column_sums_##suffix(const float *matrix, unsigned int nb_rows, unsigned int nb_cols, float *sums) \
+    { column_sums_body(matrix, nb_rows, nb_cols, sums); } \
+    static target_attribute void normalize_##suffix(float *matrix, unsigned int nb_rows, unsigned int nb_cols) \
+    { normalize_body(matrix, nb_rows, nb_cols); } \
+    static target_attribute float max_value_##suffix(const float *values, unsigned int nb_values, float floor) \
+    { return max_value_body(values, nb_values, floor); } \
+    static target_attribute float max_value_below_##suffix(const float *values, unsigned int nb_values, float floor, float bound) \
+    { return max_value_below_body(values, nb_values, floor, bound); } \
+    static target_attribute unsigned int find_first_##suffix(const float *values, unsigned int nb_values, float value) \
+    { return find_first_body(values, nb_values, value); } \
+    static target_attribute unsigned int find_last_##suffix(const float *values, unsigned int nb_values, float value) \
+    { return find_last_body(values, nb_values, value); } \
+    static target_attribute void log2_##suffix(const float *values, unsigned int nb_values, float *log2_values) \
+    { log2_body(values, nb_values, log2_values); } \
+    static target_attribute void fill_##suffix(float *values, unsigned int nb_values, float value) \
+    { fill_body(values, nb_values, value); }
+
+#define CC_KERNELS_ENTRY(instruction_set, name, suffix) \
+    { instruction_set, name, column_sums_##suffix, normalize_##suffix, max_value_##suffix, max_value_below_##suffix, \
+        find_first_##suffix, find_last_##suffix, log2_##suffix, fill_##suffix }
+
+CC_KERNELS_SET(generic, )
+
+#ifdef CC_KERNELS_X86
+CC_KERNELS_SET(sse2, __attribute__((target("sse2"))))
+CC_KERNELS_SET(avx2, __attribute__((target("avx2"))))
+CC_KERNELS_SET(avx512, __attribute__((target("avx512f"))))
+#endif
+
+const CC_ReliabilityKernels kernel_sets[] = {
+    CC_KERNELS_ENTRY(CC_ReliabilityKernels::CC_Kernels_Generic, "generic", generic),
+#ifdef CC_KERNELS_X86
+    CC_KERNELS_ENTRY(CC_ReliabilityKernels::CC_Kernels_SSE2, "sse2", sse2),
+    CC_KERNELS_ENTRY(CC_ReliabilityKernels::CC_Kernels_AVX2, "avx2", avx2),
+    CC_KERNELS_ENTRY(CC_ReliabilityKernels::CC_Kernels_AVX512, "avx512", avx512),
+#endif
+};
+
+// ================================================================================================
+bool cpu_supports(CC_ReliabilityKernels::InstructionSet instruction_set)
+{
+#ifdef CC_KERNELS_X86
+    __builtin_cpu_init();
+
+    switch (instruction_set)
+    {
+        case CC_ReliabilityKernels::CC_Kernels_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case CC_ReliabilityKernels::CC_Kernels_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case CC_ReliabilityKernels::CC_Kernels_AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return true;
+    }
+#else
+    return instruction_set == CC_ReliabilityKernels::CC_Kernels_Generic;
+#endif
+}
+
+// ================================================================================================
+const CC_ReliabilityKernels *select_kernels()
+{
+    const CC_ReliabilityKernels *best = &kernel_sets[0];
+
+    for (unsigned int i = 1; i < sizeof(kernel_sets)/sizeof(CC_ReliabilityKernels); i++)
+    {
+        if (cpu_supports(kernel_sets[i].instruction_set))
+        {
+            best = &kernel_sets[i]; // sets are in increasing order of capability
+        }
+    }
+
+    return best;
+}
+
+} // namespace
+
+// ================================================================================================
+const CC_ReliabilityKernels& CC_ReliabilityKernels::get()
+{
+    static const CC_ReliabilityKernels *kernels = select_kernels();
+    return *kernels;
+}
+
+// ================================================================================================
+const CC_ReliabilityKernels *CC_ReliabilityKernels::get(InstructionSet instruction_set)
+{
+    for (unsigned int i = 0; i < sizeof(kernel_sets)/sizeof(CC_ReliabilityKernels); i++)
+    {
+        if ((kernel_sets[i].instruction_set == instruction_set) && cpu_supports(instruction_set))
+        {
+            return &kernel_sets[i];
+        }
+    }
+
+    return 0;
+}
+
+// ================================================================================================
+unsigned int CC_ReliabilityKernels::top_k(const float *column, unsigned int nb_rows, unsigned int k, unsigned int *rows) const
+{
+    unsigned int nb_found = 0;
+    float bound = INFINITY;
+
+    while (nb_found < k)
+    {
+        float max = max_value_below(column, nb_rows, 0.0, bound);
+
+        if (max == 0.0) // no more positive values
+        {
+            break;
+        }
+
+        for (unsigned int ir = find_first(column, nb_rows, max); (ir < nb_rows) && (nb_found < k); ir++) // ties in index order
+        {
+            if (column[ir] == max)
+            {
+                rows[nb_found++] = ir;
+            }
+        }
+
+        bound = max;
+    }
+
+    return nb_found;
+}
+
+} // namespace ccsoft
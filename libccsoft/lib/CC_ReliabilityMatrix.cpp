@@ -22,6 +22,8 @@
  */
 
 #include "CC_ReliabilityMatrix.h"
+#include "CC_ReliabilityKernels.h"
+#include "CCSoft_Exception.h"
 #include <iomanip>
 #include <cstring>
 #include <cmath>
@@ -30,66 +32,179 @@ namespace ccsoft
 {
 
 // ================================================================================================
-CC_ReliabilityMatrix::CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length) :
+CC_HardDecisionMetric::CC_HardDecisionMetric(float crossover_probability, unsigned int _precision_bits) :
+        precision_bits(_precision_bits)
+{
+    if ((crossover_probability <= 0.0) || (crossover_probability >= 1.0))
+    {
+        throw CCSoft_Exception("Crossover probability must be strictly between 0 and 1");
+    }
+
+    float scale = (float) (1<<precision_bits);
+    match = (int) lrint(log2(1.0 - crossover_probability) * scale);
+    mismatch = (int) lrint(log2(crossover_probability) * scale);
+}
+
+// ================================================================================================
+CC_ReliabilityMatrix::CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, bool bit_metric) :
         _nb_symbols_log2(nb_symbols_log2),
         _nb_symbols(1<<nb_symbols_log2),
+        _bit_metric(bit_metric),
+        _nb_rows(bit_metric ? nb_symbols_log2+1 : 1<<nb_symbols_log2),
         _message_length(message_length),
-        _message_symbol_count(0)
+        _message_symbol_count(0),
+        _hard_metric(0.5),
+        _hard_symbols_per_word(0),
+        _hard_symbols(0),
+        _hard_erasures(0),
+        _hard_distance_metrics(0)
 {
-    _matrix = new float[_nb_symbols*_message_length];
+    _matrix = new float[_nb_rows*_message_length];
 
-    for (unsigned int i=0; i<_nb_symbols*_message_length; i++)
+    for (unsigned int i=0; i<_nb_rows*_message_length; i++)
     {
         _matrix[i] = 0.0;
     }
 }
 
+// ================================================================================================
+CC_ReliabilityMatrix::CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, const CC_HardDecisionMetric& hard_metric) :
+        _nb_symbols_log2(nb_symbols_log2),
+        _nb_symbols(1<<nb_symbols_log2),
+        _bit_metric(false),
+        _nb_rows(0),
+        _message_length(message_length),
+        _message_symbol_count(0),
+        _matrix(0),
+        _hard_metric(hard_metric)
+{
+    init_hard_decision();
+}
+
 // ================================================================================================
 CC_ReliabilityMatrix::CC_ReliabilityMatrix(const CC_ReliabilityMatrix& relmat) : 
         _nb_symbols_log2(relmat.get_nb_symbols_log2()),
         _nb_symbols(relmat.get_nb_symbols()),
+        _bit_metric(relmat.is_bit_metric()),
+        _nb_rows(relmat.get_nb_rows()),
         _message_length(relmat.get_message_length()),
-        _message_symbol_count(0)
+        _message_symbol_count(0),
+        _matrix(0),
+        _hard_metric(relmat.get_hard_decision_metric()),
+        _hard_symbols_per_word(0),
+        _hard_symbols(0),
+        _hard_erasures(0),
+        _hard_distance_metrics(0)
 {
-    _matrix = new float[_nb_symbols*_message_length];
-    memcpy((void *) _matrix, (void *) relmat.get_raw_matrix(), _nb_symbols*_message_length*sizeof(float));
+    if (relmat.is_hard_decision())
+    {
+        init_hard_decision();
+        memcpy((void *) _hard_symbols, (void *) relmat._hard_symbols, ((_message_length + _hard_symbols_per_word - 1) / _hard_symbols_per_word)*sizeof(uint32_t));
+        memcpy((void *) _hard_erasures, (void *) relmat._hard_erasures, ((_message_length + 31) / 32)*sizeof(uint32_t));
+    }
+    else
+    {
+        _matrix = new float[_nb_rows*_message_length];
+        memcpy((void *) _matrix, (void *) relmat.get_raw_matrix(), _nb_rows*_message_length*sizeof(float));
+    }
 }
 
 // ================================================================================================
 CC_ReliabilityMatrix::~CC_ReliabilityMatrix()
 {
     delete[] _matrix;
+    delete[] _hard_symbols;
+    delete[] _hard_erasures;
+    delete[] _hard_distance_metrics;
 }
 
 // ================================================================================================
-void CC_ReliabilityMatrix::enter_symbol_data(float *symbol_data)
+void CC_ReliabilityMatrix::init_hard_decision()
+{
+    if ((_nb_symbols_log2 == 0) || (_nb_symbols_log2 > 16))
+    {
+        throw CCSoft_Exception("Hard decided symbols must have 1 to 16 bits");
+    }
+
+    _hard_symbols_per_word = 32 / _nb_symbols_log2;
+    unsigned int nb_words = (_message_length + _hard_symbols_per_word - 1) / _hard_symbols_per_word;
+    unsigned int nb_erasure_words = (_message_length + 31) / 32;
+    _hard_symbols = new uint32_t[nb_words];
+    _hard_erasures = new uint32_t[nb_erasure_words];
+    memset((void *) _hard_symbols, 0, nb_words*sizeof(uint32_t));
+    memset((void *) _hard_erasures, 0, nb_erasure_words*sizeof(uint32_t));
+    _hard_distance_metrics = new float[_nb_symbols_log2+1];
+    float unit = ldexp(1.0, -(int) _hard_metric.precision_bits);
+
+    for (unsigned int d = 0; d <= _nb_symbols_log2; d++)
+    {
+        _hard_distance_metrics[d] = ((int) d*_hard_metric.mismatch + (int) (_nb_symbols_log2-d)*_hard_metric.match) * unit;
+    }
+}
+
+// ================================================================================================
+void CC_ReliabilityMatrix::enter_hard_symbol(unsigned int symbol)
 {
     if (_message_symbol_count < _message_length)
     {
-        memcpy((void *) &_matrix[_message_symbol_count*_nb_symbols], (void *) symbol_data, _nb_symbols*sizeof(float));
+        enter_hard_symbol(_message_symbol_count, symbol);
         _message_symbol_count++;
     }
 }
 
 // ================================================================================================
-void CC_ReliabilityMatrix::enter_symbol_data(unsigned int message_symbol_index, float *symbol_data)
+void CC_ReliabilityMatrix::enter_hard_symbol(unsigned int message_symbol_index, unsigned int symbol)
 {
     if (message_symbol_index < _message_length)
     {
-        memcpy((void *) &_matrix[message_symbol_index*_nb_symbols], (void *) symbol_data, _nb_symbols*sizeof(float));
+        uint32_t& word = _hard_symbols[message_symbol_index / _hard_symbols_per_word];
+        unsigned int shift = (message_symbol_index % _hard_symbols_per_word)*_nb_symbols_log2;
+        word = (word & ~((uint32_t) (_nb_symbols-1) << shift)) | ((uint32_t) (symbol & (_nb_symbols-1)) << shift);
+        _hard_erasures[message_symbol_index >> 5] &= ~(1u << (message_symbol_index & 31));
     }
 }
 
 // ================================================================================================
-void CC_ReliabilityMatrix::enter_erasure()
+void CC_ReliabilityMatrix::enter_symbol_data(float *symbol_data)
 {
     if (_message_symbol_count < _message_length)
     {
-        for (unsigned int i=0; i<_nb_symbols; i++)
+        enter_symbol_data(_message_symbol_count, symbol_data);
+        _message_symbol_count++;
+    }
+}
+
+// ================================================================================================
+void CC_ReliabilityMatrix::enter_symbol_data(unsigned int message_symbol_index, float *symbol_data)
+{
+    if (message_symbol_index >= _message_length)
+    {
+        return;
+    }
+
+    if (_hard_symbols) // keep the most reliable symbol
+    {
+        unsigned int symbol = 0;
+
+        for (unsigned int i = 1; i < _nb_symbols; i++)
         {
-            _matrix[_message_symbol_count*_nb_symbols + i] = 0.0;
+            symbol = (symbol_data[i] > symbol_data[symbol] ? i : symbol);
         }
-        
+
+        enter_hard_symbol(message_symbol_index, symbol);
+    }
+    else
+    {
+        memcpy((void *) &_matrix[message_symbol_index*_nb_rows], (void *) symbol_data, (_bit_metric ? _nb_symbols_log2 : _nb_symbols)*sizeof(float));
+    }
+}
+
+// ================================================================================================
+void CC_ReliabilityMatrix::enter_erasure()
+{
+    if (_message_symbol_count < _message_length)
+    {
+        enter_erasure(_message_symbol_count);
         _message_symbol_count++;
     }    
 }
@@ -97,80 +212,85 @@ void CC_ReliabilityMatrix::enter_erasure()
 // ================================================================================================
 void CC_ReliabilityMatrix::enter_erasure(unsigned int message_symbol_index)
 {
-    if (message_symbol_index < _message_length)
+    if (message_symbol_index >= _message_length)
     {
-        for (unsigned int i=0; i<_nb_symbols; i++)
-        {
-            _matrix[message_symbol_index*_nb_symbols + i] = 0.0;
-        }
+        return;
+    }
+
+    if (_hard_symbols)
+    {
+        _hard_erasures[message_symbol_index >> 5] |= 1u << (message_symbol_index & 31);
+    }
+    else
+    {
+        CC_ReliabilityKernels::get().fill(&_matrix[message_symbol_index*_nb_rows], _nb_rows, 0.0);
     }
 }
 
 // ================================================================================================
 void CC_ReliabilityMatrix::normalize()
 {
-    float col_sum = 0;
-    float last_col_sum;
+    if (_hard_symbols)
+    {
+        return;
+    }
 
-    for (unsigned int ic = 0; ic < _message_length+1; ic++)
+    if (_bit_metric)
     {
-        last_col_sum = col_sum;
-        col_sum = 0;
+        normalize_bit_metric();
+        return;
+    }
 
-        for (unsigned int ir = 0; ir < _nb_symbols; ir++)
-        {
-            if (ic < _message_length)
-            {
-                col_sum += _matrix[ic*_nb_symbols + ir];
-            }
+    CC_ReliabilityKernels::get().normalize(_matrix, _nb_rows, _message_length);
+}
 
-            if (ic > 0)
-            {
-                if (last_col_sum != 0.0)
-                {
-                    _matrix[(ic-1)*_nb_symbols + ir] /= last_col_sum;
-                }
-            }
+// ================================================================================================
+void CC_ReliabilityMatrix::normalize_bit_metric()
+{
+    for (unsigned int ic = 0; ic < _message_length; ic++)
+    {
+        float *llrs = &_matrix[ic*_nb_rows];
+        double col_term = 0.0;
+
+        for (unsigned int i = 0; i < _nb_symbols_log2; i++)
+        {
+            col_term -= log1p(exp(-fabs(llrs[i]))) * M_LOG2E; // log2 of the probability of the hard decision
         }
+
+        llrs[_nb_symbols_log2] = col_term;
     }
 }
 
 // ================================================================================================
 float CC_ReliabilityMatrix::find_max(unsigned int& i_row, unsigned int& i_col) const
 {
-    float max = 0.0;
+    const CC_ReliabilityKernels& kernels = CC_ReliabilityKernels::get();
+    float max = kernels.max_value(_matrix, _nb_rows*_message_length, 0.0);
+    unsigned int index = kernels.find_last(_matrix, _nb_rows*_message_length, max);
     i_row = 0; // prevent core dump if all items are 0
     i_col = 0;
 
-    for (unsigned int ic = 0; ic < _message_length; ic++)
+    if (index < _nb_rows*_message_length)
     {
-        for (unsigned int ir = 0; ir < _nb_symbols; ir++)
-        {
-            if (_matrix[ic*_nb_symbols + ir] >= max)
-            {
-                max = _matrix[ic*_nb_symbols + ir];
-                i_row = ir;
-                i_col = ic;
-            }
-        }
+        i_row = index % _nb_rows;
+        i_col = index / _nb_rows;
     }
-    
+
     return max;
 }
 
 // ================================================================================================
 float CC_ReliabilityMatrix::find_max_in_col(unsigned int& i_row, unsigned int i_col, float prev_max) const
 {
-    float max = 0.0;
+    const CC_ReliabilityKernels& kernels = CC_ReliabilityKernels::get();
+    const float *column = &_matrix[i_col*_nb_rows];
+    float max = kernels.max_value_below(column, _nb_rows, 0.0, prev_max);
     i_row = 0; // prevent core dump if all items are 0
 
-    for (unsigned int ir = 0; ir < _nb_symbols; ir++)
+    if (max < prev_max)
     {
-        if ((_matrix[i_col*_nb_symbols + ir] >= max) && (_matrix[i_col*_nb_symbols + ir] < prev_max))
-        {
-            max = _matrix[i_col*_nb_symbols + ir];
-            i_row = ir;
-        }
+        unsigned int index = kernels.find_last(column, _nb_rows, max);
+        i_row = (index < _nb_rows ? index : 0);
     }
 
     return max;
@@ -179,9 +299,32 @@ float CC_ReliabilityMatrix::find_max_in_col(unsigned int& i_row, unsigned int i_
 // ================================================================================================
 std::ostream& operator <<(std::ostream& os, const CC_ReliabilityMatrix& matrix)
 {
-    unsigned int nb_rows = matrix.get_nb_symbols();
+    unsigned int nb_rows = matrix.get_nb_rows();
     unsigned int nb_cols = matrix.get_message_length();
 
+    if (matrix.is_hard_decision()) // one row of symbols, erasures as dashes
+    {
+        for (unsigned int ic=0; ic<nb_cols; ic++)
+        {
+            if (ic > 0)
+            {
+                os << " ";
+            }
+
+            if (matrix.is_hard_erasure(ic))
+            {
+                os << "-";
+            }
+            else
+            {
+                os << matrix.get_hard_symbol(ic);
+            }
+        }
+
+        os << std::endl;
+        return os;
+    }
+
     for (unsigned int ir=0; ir<nb_rows; ir++)
     {
         for (unsigned int ic=0; ic<nb_cols; ic++)
@@ -202,8 +345,9 @@ std::ostream& operator <<(std::ostream& os, const CC_ReliabilityMatrix& matrix)
 // ================================================================================================
 void CC_ReliabilityMatrix::deinterleave()
 {
-	 float *tmp_matrix = new float[_nb_symbols*_message_length];
-     memcpy((void *) tmp_matrix, (void *) _matrix, _nb_symbols*_message_length*sizeof(float));
+	 float *tmp_matrix = new float[_nb_rows*_message_length];
+     memcpy((void *) tmp_matrix, (void *) _matrix, _nb_rows*_message_length*sizeof(float));
+     CC_ReliabilityMatrix *tmp_hard = (_hard_symbols ? new CC_ReliabilityMatrix(*this) : 0);
 
      unsigned int index_size = (unsigned int) (log(_message_length)/log(2)) + 1;
      unsigned int index_max = 1<<index_size;
@@ -228,10 +372,25 @@ void CC_ReliabilityMatrix::deinterleave()
 
          if (new_index < _message_length)
          {
-        	 memcpy((void *) &(_matrix[old_index*_nb_symbols]), (void *) &(tmp_matrix[new_index*_nb_symbols]), _nb_symbols*sizeof(float));
+             if (tmp_hard)
+             {
+                 enter_hard_symbol(old_index, tmp_hard->get_hard_symbol(new_index));
+
+                 if (tmp_hard->is_hard_erasure(new_index))
+                 {
+                     enter_erasure(old_index);
+                 }
+             }
+             else
+             {
+                 memcpy((void *) &(_matrix[old_index*_nb_rows]), (void *) &(tmp_matrix[new_index*_nb_rows]), _nb_rows*sizeof(float));
+             }
+
              old_index++;
          }
      }
+
+     delete tmp_hard;
 }
 
 } // namespace ccsoft
@@ -20,16 +20,44 @@
  Reliability Matrix class. 
  Analog data is entered first then the normalization method is called to get the actual reliability data (probabilities).
 
+ In bit metric mode each column holds the n log-likelihood ratios ln(P(b=0)/P(b=1)) of the bits of the
+ output symbol (bit i of the symbol for row i) followed by a column term computed at normalization. The log2
+ reliability of a symbol is then the sum of the log2 probabilities of its bits.
+
+ In hard decision mode only the hard decided n bit symbol of each position is stored, packed in 32 bit words.
+ The log2 reliability of a symbol is taken from a Fano style metric pair on the bits of a binary symmetric channel
+ indexed by the Hamming distance between the symbol and the received one. The pair is rounded to integer multiples
+ of a power of two fraction of a bit so that path metrics are exact integer counts whatever the path length.
+
  */
 
 #ifndef __CC_RELIABILITY_MATRIX_H__
 #define __CC_RELIABILITY_MATRIX_H__
 
 #include <iostream>
+#include <cmath>
+#include <stdint.h>
 
 namespace ccsoft
 {
 
+/**
+ * \brief Fano style bit metric pair of a binary symmetric channel used in hard decision mode
+ */
+struct CC_HardDecisionMetric
+{
+    /**
+     * Constructor
+     * \param crossover_probability Probability that a received bit is wrong
+     * \param precision_bits The metrics are integer multiples of 2^-precision_bits
+     */
+    explicit CC_HardDecisionMetric(float crossover_probability, unsigned int precision_bits = 4);
+
+    int match;                  //!< Metric of a bit equal to the received bit in 2^-precision_bits units i.e. round(log2(1-p)*2^precision_bits)
+    int mismatch;               //!< Metric of a bit different from the received bit in 2^-precision_bits units i.e. round(log2(p)*2^precision_bits)
+    unsigned int precision_bits;
+};
+
 /**
  * \brief Reliability Matrix class. Analog data is entered first then the normalization method is called to get the actual reliability data (probabilities).
  */
@@ -40,8 +68,17 @@ public:
      * Constructor
      * \param nb_symbols_log2 Log2 of the number of symbols used (number of symbols is a power of two)
      * \param message_length Length of one message block to be decoded
+     * \param bit_metric Store the nb_symbols_log2 bit LLRs of each symbol position instead of the nb_symbols symbol reliabilities
      */
-    CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length);
+    CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, bool bit_metric = false);
+
+    /**
+     * Constructor of a hard decision matrix
+     * \param nb_symbols_log2 Log2 of the number of symbols used (number of symbols is a power of two)
+     * \param message_length Length of one message block to be decoded
+     * \param hard_metric Bit metric pair applied to the Hamming distance to the received symbols
+     */
+    CC_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, const CC_HardDecisionMetric& hard_metric);
     
     /**
      * Copy Constructor
@@ -56,6 +93,7 @@ public:
     /**
      * Enter one more symbol position data
      * \param symbol_data Pointer to symbol data array. There must be nb_symbol values corresponding to the relative reliability of each symbol for the current symbol position in the message
+     * or nb_symbols_log2 bit LLRs in bit metric mode
      */
     void enter_symbol_data(float *symbol_data);
 
@@ -63,11 +101,23 @@ public:
      * Enter symbol position data at given message symbol position
      * \param message_symbol_index Position of the symbol in the message
      * \param symbol_data Pointer to symbol data array. There must be nb_symbol values corresponding to the relative reliability of each symbol for the current symbol position in the message
+     * or nb_symbols_log2 bit LLRs in bit metric mode
      */
     void enter_symbol_data(unsigned int message_symbol_index, float *symbol_data);
+
+    /**
+     * Enter one more hard decided symbol in hard decision mode
+     */
+    void enter_hard_symbol(unsigned int symbol);
+
+    /**
+     * Enter a hard decided symbol at given message symbol position in hard decision mode
+     */
+    void enter_hard_symbol(unsigned int message_symbol_index, unsigned int symbol);
     
     /**
      * Enter an erasure at current symbol position. This is done by zeroing out the corresponding column in the matrix thus neutralizing it for further multiplicity calculation.
+     * In hard decision mode all symbols get a zero metric at this position.
      */
     void enter_erasure();
 
@@ -78,6 +128,7 @@ public:
 
     /**
      * Normalize each column so that values represent an a posteriori probability i.e. sum of each column is 1.0
+     * In bit metric mode computes the column term of the bit metrics. Does nothing in hard decision mode.
      */
     void normalize();
 
@@ -105,6 +156,92 @@ public:
         return _nb_symbols;
     }
 
+    /**
+     * Get the number of rows i.e. number of values stored per column
+     */
+    unsigned int get_nb_rows() const
+    {
+        return _nb_rows;
+    }
+
+    /**
+     * Tells if the matrix stores bit LLRs
+     */
+    bool is_bit_metric() const
+    {
+        return _bit_metric;
+    }
+
+    /**
+     * Get the log2 of the reliability of a symbol at a message position in bit metric mode. This is the sum over the symbol
+     * bits of log2(P(bit)) obtained as the column term less the LLRs in bits of the bits that disagree with their hard decision.
+     * \param symbol Output symbol
+     * \param i_col Message position
+     */
+    float get_bit_metric(unsigned int symbol, unsigned int i_col) const
+    {
+        const float *llrs = &_matrix[_nb_rows*i_col];
+        float penalty = 0.0;
+
+        for (unsigned int i=0; i<_nb_symbols_log2; i++, symbol >>= 1)
+        {
+            if ((symbol & 1) ? (llrs[i] > 0.0) : (llrs[i] < 0.0))
+            {
+                penalty += fabs(llrs[i]);
+            }
+        }
+
+        return llrs[_nb_symbols_log2] - penalty*M_LOG2E;
+    }
+
+    /**
+     * Tells if the matrix stores hard decided symbols
+     */
+    bool is_hard_decision() const
+    {
+        return _hard_symbols != 0;
+    }
+
+    /**
+     * Get the hard decided symbol at a message position in hard decision mode
+     */
+    unsigned int get_hard_symbol(unsigned int i_col) const
+    {
+        return (_hard_symbols[i_col / _hard_symbols_per_word] >> ((i_col % _hard_symbols_per_word)*_nb_symbols_log2)) & (_nb_symbols-1);
+    }
+
+    /**
+     * Tells if the symbol at a message position is erased in hard decision mode
+     */
+    bool is_hard_erasure(unsigned int i_col) const
+    {
+        return (_hard_erasures[i_col >> 5] >> (i_col & 31)) & 1;
+    }
+
+    /**
+     * Get the log2 of the reliability of a symbol at a message position in hard decision mode. This is the metric of
+     * the Hamming distance between the symbol and the received symbol, zero at an erased position.
+     * \param symbol Output symbol
+     * \param i_col Message position
+     */
+    float get_hard_metric(unsigned int symbol, unsigned int i_col) const
+    {
+        if (is_hard_erasure(i_col))
+        {
+            return 0.0;
+        }
+
+        return _hard_distance_metrics[__builtin_popcount((get_hard_symbol(i_col) ^ symbol) & (_nb_symbols-1))];
+    }
+
+    /**
+     * Get the bit metric pair of the hard decision mode
+     */
+    const CC_HardDecisionMetric& get_hard_decision_metric() const
+    {
+        return _hard_metric;
+    }
+
     /**
      * Get the number of message symbols (i.e. columns)
      */
@@ -114,11 +251,12 @@ public:
     }
 
     /**
-     * Operator to get the value at row i column j. Read-write version.
+     * Operator to get the value at row i column j. Read-write version. In bit metric mode rows are the bit LLRs.
+     * There is no such storage in hard decision mode.
      */
     float& operator()(unsigned int i_row, unsigned int i_col)
     {
-        return _matrix[_nb_symbols*i_col + i_row];
+        return _matrix[_nb_rows*i_col + i_row];
     }
     
     /**
@@ -126,7 +264,7 @@ public:
      */
     const float& operator()(unsigned int i_row, unsigned int i_col) const
     {
-        return _matrix[_nb_symbols*i_col + i_row];
+        return _matrix[_nb_rows*i_col + i_row];
     }
     
     /**
@@ -170,11 +308,28 @@ public:
     
 
 protected:
+    /**
+     * Computes the column term of the bit metrics i.e. the sum of log2 of the probabilities of the hard decisions on the bits
+     */
+    void normalize_bit_metric();
+
+    /**
+     * Allocates the packed storage and the metrics by Hamming distance of the hard decision mode
+     */
+    void init_hard_decision();
+
     unsigned int _nb_symbols_log2;
     unsigned int _nb_symbols;
+    bool _bit_metric;      //!< Columns hold bit LLRs and the column term of the bit metrics
+    unsigned int _nb_rows; //!< Number of values stored per column
     unsigned int _message_length;
     unsigned int _message_symbol_count; //!< incremented each time a new message symbol data is entered
-    float *_matrix; //!< The reliability matrix stored column first
+    float *_matrix; //!< The reliability matrix stored column first. Null in hard decision mode.
+    CC_HardDecisionMetric _hard_metric;    //!< Bit metric pair of the hard decision mode
+    unsigned int _hard_symbols_per_word;   //!< Number of hard decided symbols packed in a 32 bit word
+    uint32_t *_hard_symbols;               //!< Packed hard decided symbols. Null unless in hard decision mode.
+    uint32_t *_hard_erasures;              //!< One bit per position set for erased hard decided symbols
+    float *_hard_distance_metrics;         //!< Log2 reliability by Hamming distance to the received symbol (nb_symbols_log2+1 values)
 };
 
 
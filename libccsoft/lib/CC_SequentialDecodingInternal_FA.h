@@ -121,11 +121,36 @@ protected:
      */
     void back_track(CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, T_Tag, N_k>* node_edge, std::vector<T_IOSymbol>& decoded_message, bool mark_nodes = false)
     {
-        std::vector<T_IOSymbol> reversed_message;
+        if (node_edge->get_depth() < 0)
+        {
+            decoded_message.clear();
+            return;
+        }
+
+        decoded_message.resize(node_edge->get_depth() + 1);
+        back_track(node_edge, &decoded_message[0], 1, mark_nodes);
+    }
+
+    /**
+     * Back track from a node writing the symbols directly in place in a caller owned buffer
+     * \param node Node to track back from
+     * \param decoded_message Buffer receiving the symbols from root node to the given node. It must hold depth+1 symbols at the given stride.
+     * \param stride Distance between two successive symbols in the buffer
+     * \param mark_nodes Mark the nodes along the path
+     */
+    template<typename T_OutSymbol>
+    void back_track(CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, T_Tag, N_k>* node_edge, T_OutSymbol *decoded_message, unsigned int stride, bool mark_nodes = false)
+    {
         CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, T_Tag, N_k> *cur_node_edge = node_edge;
         CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, T_Tag, N_k> *incoming_node_edge;
 
-        reversed_message.push_back(cur_node_edge->get_in_symbol());
+        if (node_edge->get_depth() < 0)
+        {
+            return;
+        }
+
+        T_OutSymbol *out_symbol = decoded_message + node_edge->get_depth()*stride; // fill from the end
+        *out_symbol = cur_node_edge->get_in_symbol();
 
         while (incoming_node_edge = (cur_node_edge->get_incoming_node_edge()))
         {
@@ -133,14 +158,12 @@ protected:
 
             if (incoming_node_edge->get_depth() >= 0) // don't take root node
             {
-                reversed_message.push_back(incoming_node_edge->get_in_symbol());
+                out_symbol -= stride;
+                *out_symbol = incoming_node_edge->get_in_symbol();
             }
 
             cur_node_edge = incoming_node_edge;
         }
-
-        decoded_message.resize(reversed_message.size());
-        std::reverse_copy(reversed_message.begin(), reversed_message.end(), decoded_message.begin());
     }
 
     /**
@@ -27,10 +27,13 @@
 #include "CC_Encoding_FA.h"
 #include "CC_ReliabilityMatrix.h"
 #include "CC_Interleaver.h"
+#include "CC_DecodingTrace.h"
+#include "CCSoft_Exception.h"
 
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 
 
@@ -114,7 +117,8 @@ public:
                 node_count(0),
                 tail_zeros(true),
                 edge_bias(0.0),
-                verbosity(0)
+                verbosity(0),
+                trace(0)
 	{}
 
 	/**
@@ -166,6 +170,39 @@ public:
         tail_zeros = _tail_zeros;
     }
 
+    /**
+     * Set the input symbols known a priori at each depth of the code tree, for example from sync words, header fields
+     * or pilot symbols. Only the admissible branches are created at a constrained depth. The constraints apply to the
+     * next decodes until they are reset.
+     * \param _input_constraints Allowed input symbols bitmask per depth: bit s is set when input symbol s is allowed.
+     * Depths beyond the size of the vector are not constrained. The tail zeros option still applies on top of it.
+     */
+    void set_input_constraints(const std::vector<unsigned int>& _input_constraints)
+    {
+        if (encoding.get_k() > 5)
+        {
+            throw CCSoft_Exception("Input constraints bitmasks are limited to input symbols of at most 5 bits");
+        }
+
+        for (unsigned int i = 0; i < _input_constraints.size(); i++)
+        {
+            if ((_input_constraints[i] & get_all_inputs_mask()) == 0)
+            {
+                throw CCSoft_Exception("Input constraints must allow at least one input symbol at each depth");
+            }
+        }
+
+        input_constraints = _input_constraints;
+    }
+
+    /**
+     * Remove the input symbols constraints
+     */
+    void reset_input_constraints()
+    {
+        input_constraints.clear();
+    }
+
     /**
      * Reset the decoding process
      */
@@ -249,6 +286,23 @@ public:
         verbosity = _verbosity;
     }
 
+    /**
+     * Set the trace the decoding events are recorded into. The trace is not owned by the decoder and is not
+     * cleared at each decoding.
+     */
+    void set_trace(CC_DecodingTrace *_trace)
+    {
+        trace = _trace;
+    }
+
+    /**
+     * Stop recording decoding events
+     */
+    void reset_trace()
+    {
+        trace = 0;
+    }
+
     /**
      * Print the dot (Graphviz) file of the current decode tree to an output stream
      * \param os Output stream
@@ -277,6 +331,53 @@ public:
     virtual bool decode(const CC_ReliabilityMatrix& relmat, std::vector<T_IOSymbol>& decoded_message) = 0;
 
 protected:
+    /**
+     * Bitmask of all input symbols
+     */
+    unsigned int get_all_inputs_mask() const
+    {
+        return (encoding.get_k() < 5 ? (1U<<(1<<encoding.get_k())) - 1 : 0xFFFFFFFF);
+    }
+
+    /**
+     * Bitmask of the input symbols allowed at a depth of the code tree by the input constraints and tail zeros option
+     * \param depth Depth of the successors
+     * \param message_length Number of symbols in the message
+     */
+    unsigned int get_input_mask(int depth, unsigned int message_length) const
+    {
+        unsigned int input_mask = get_all_inputs_mask();
+
+        if ((unsigned int) depth < input_constraints.size())
+        {
+            input_mask &= input_constraints[depth];
+        }
+
+        if ((tail_zeros) && (depth > (int) (message_length - encoding.get_m())))
+        {
+            input_mask &= 1; // if zero tail option assume tail symbols are all zeros
+        }
+
+        return input_mask;
+    }
+
+    /**
+     * Tells if an input symbol is allowed by a bitmask of get_input_mask. Input symbols beyond the bitmask
+     * size are allowed only by the unconstrained bitmask.
+     */
+    bool is_admissible(unsigned int input_mask, T_IOSymbol in_symbol) const
+    {
+        return (in_symbol < 32 ? ((input_mask >> in_symbol) & 1) != 0 : input_mask == 0xFFFFFFFF);
+    }
+
+    /**
+     * Number of input symbols allowed by a bitmask of get_input_mask
+     */
+    unsigned int get_nb_inputs(unsigned int input_mask) const
+    {
+        return (input_mask == get_all_inputs_mask() ? 1<<encoding.get_k() : __builtin_popcount(input_mask));
+    }
+
     CC_Encoding_FA<T_Register, T_IOSymbol, N_k> encoding;   //!< Convolutional encoding object
     bool use_metric_limit;    //!< True if a give up path metric threshold is used
     float metric_limit;       //!< The give up path metric threshold
@@ -287,8 +388,10 @@ protected:
     int max_depth;            //!< Maximum depth reached in the graph
     unsigned int node_count;  //!< Count of nodes in the code tree
     bool tail_zeros;          //!< True if tail of m-1 zeros in the message are assumed. This is the default option.
+    std::vector<unsigned int> input_constraints; //!< Allowed input symbols bitmask per depth
     float edge_bias;          //!< Edge metric bias subtracted from log2 of reliability of the edge
     unsigned int verbosity;   //!< Verbosity level
+    CC_DecodingTrace *trace;  //!< Trace decoding events are recorded into if not null
 };
 
 } // namespace ccsoft
@@ -20,6 +20,15 @@
  Convolutional soft-decision decoder based on the stack or Zigangirov-Jelinek
  (ZJ) algorithm. Uses the node+edge combination in the code tree.
 
+ With the binary expansion option the 2^k successors of a node of a k > 1
+ input bits code are not created at once. The input bits are decided one at
+ a time through light partial branches kept in their own stack. The metric
+ of a partial branch is the log2 of the sum of the probabilities of the
+ output symbols of all its completions minus the full edge bias. It is an
+ upper bound of the metric of every successor it leads to so that the nodes
+ are expanded in the same order as with the full expansion while the weak
+ sub-branches are never materialized.
+
  */
 #ifndef __CC_STACK_DECODING_H__
 #define __CC_STACK_DECODING_H__
@@ -35,6 +44,7 @@
 #include <map>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 
 namespace ccsoft
@@ -61,7 +71,17 @@ public:
 	CC_StackDecoding(const std::vector<unsigned int>& constraints,
             const std::vector<std::vector<T_Register> >& genpoly_representations) :
                 CC_SequentialDecoding<T_Register, T_IOSymbol>(constraints, genpoly_representations),
-                CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty>()
+                CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty>(),
+                use_max_stack_size(false),
+                max_stack_size(0),
+                nb_evictions(0),
+                binary_expansion(false),
+                partial_count(0),
+                nb_partial_expansions(0),
+                lazy_successors(false),
+                step_relmat(0),
+                step_status(CC_Decode_Failed),
+                terminal_node_edge(0)
     {}
 
     /**
@@ -78,6 +98,67 @@ public:
         ParentInternal::reset();
         Parent::reset();
         node_edge_stack.clear();
+        nb_evictions = 0;
+        partial_stack.clear();
+        nb_pending_partials.clear();
+        partial_count = 0;
+        nb_partial_expansions = 0;
+        next_sibling_ranks.clear();
+    }
+
+    /**
+     * Set the maximum stack size. When it is exceeded the entries with the lowest path metric are evicted
+     * with the branches of the code tree that lead only to them.
+     * \param _max_stack_size Maximum number of entries in the stack. At least one entry is kept.
+     */
+    void set_max_stack_size(unsigned int _max_stack_size)
+    {
+        max_stack_size = (_max_stack_size > 0 ? _max_stack_size : 1);
+        use_max_stack_size = true;
+    }
+
+    /**
+     * Remove the stack size limit
+     */
+    void reset_max_stack_size()
+    {
+        use_max_stack_size = false;
+    }
+
+    /**
+     * Get the number of stack entries evicted during the last decoding
+     */
+    unsigned int get_nb_evictions() const
+    {
+        return nb_evictions;
+    }
+
+    /**
+     * Set the binary expansion option. When set and the code has more than one input bit the
+     * successors of a node are reached through partial branches deciding one input bit at a time.
+     */
+    void set_binary_expansion(bool _binary_expansion)
+    {
+        binary_expansion = _binary_expansion;
+    }
+
+    /**
+     * Get the number of partial branches expanded during the last decoding
+     */
+    unsigned int get_nb_partial_expansions() const
+    {
+        return nb_partial_expansions;
+    }
+
+    /**
+     * Set the lazy successors option. When set only the best successor of a node is created when the node is visited.
+     * Its next best sibling enters the stack as a partial branch when the successor is visited in its turn and is
+     * created from the encoder state of their predecessor when the partial branch reaches the top of the stack.
+     * This does not apply to codes using the binary expansion.
+     */
+    void set_lazy_successors(bool _lazy_successors)
+    {
+        lazy_successors = _lazy_successors;
     }
 
     /**
@@ -89,11 +170,11 @@ public:
     }
 
     /**
-     * Get the stack size
+     * Get the stack size. Partial branches, lazy siblings included, count as entries.
      */
     unsigned int get_stack_size() const
     {
-        return node_edge_stack.size();
+        return node_edge_stack.size() + partial_stack.size();
     }
 
     /**
@@ -102,6 +183,49 @@ public:
      * \param decoded_message Vector of symbols of retrieved message
      */
     virtual bool decode(const CC_ReliabilityMatrix& relmat, std::vector<T_IOSymbol>& decoded_message)
+    {
+        StackNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Decodes given the reliability matrix writing the decoded message directly in a caller owned buffer
+     * of packed symbols e.g. uint8_t or uint16_t. With a stride greater than one the message symbols can
+     * be interleaved with other frames in the same buffer.
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Buffer receiving the relmat message length symbols of the retrieved message
+     * \param stride Distance in symbols between two successive message symbols in the buffer
+     */
+    template<typename T_OutSymbol>
+    bool decode(const CC_ReliabilityMatrix& relmat, T_OutSymbol *decoded_message, unsigned int stride = 1)
+    {
+        StackNodeEdge *terminal_node_edge = search(relmat);
+
+        if (terminal_node_edge)
+        {
+            ParentInternal::back_track(terminal_node_edge, decoded_message, stride, true); // back track from terminal node to retrieve decoded message
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Starts a decoding to be run step by step so that several decoders can share a thread.
+     * \param relmat Reference to the reliability matrix. It must be kept unchanged until the decoding has ended.
+     */
+    void start(const CC_ReliabilityMatrix& relmat)
     {
         if (relmat.get_message_length() < Parent::encoding.get_m())
         {
@@ -117,34 +241,88 @@ public:
         ParentInternal::init_root(); // initialize the root node
         Parent::node_count++;
         visit_node_forward(ParentInternal::root_node, relmat); // visit the root node
+        step_relmat = &relmat;
+        step_status = CC_Decode_Pending;
+        terminal_node_edge = 0;
+    }
+
+    /**
+     * Continues the decoding started with start() for at most a number of iterations of the search.
+     * An iteration visits the node at the top of the stack or expands a partial branch.
+     * \param budget Maximum number of iterations
+     * \return Status of the decoding. Once it is no longer pending further steps return the same status.
+     */
+    CC_DecodeStatus step(unsigned int budget)
+    {
+        if (step_status != CC_Decode_Pending)
+        {
+            return step_status;
+        }
+
+        const CC_ReliabilityMatrix& relmat = *step_relmat;
 
         // loop until we get to a terminal node or the metric limit is encountered hence the stack is empty
-        while ((node_edge_stack.size() > 0)
-            && (node_edge_stack.begin()->second->get_depth() < relmat.get_message_length() - 1))
+        for (unsigned int i = 0; i < budget; i++)
         {
-            StackNodeEdge* node = node_edge_stack.begin()->second;
-            //std::cout << std::dec << node->get_id() << ":" << node->get_depth() << ":" << node_stack.begin()->first.path_metric << std::endl;
-            visit_node_forward(node, relmat);
+            if ((partial_stack.size() > 0)
+                && ((node_edge_stack.size() == 0) || (partial_stack.begin()->first.path_metric > node_edge_stack.begin()->first.path_metric)))
+            {
+                PartialBranch partial_branch = partial_stack.begin()->second;
+                partial_stack.erase(partial_stack.begin());
+
+                if (partial_branch.nb_bits == Parent::encoding.get_k()) // lazy sibling
+                {
+                    add_lazy_successor(partial_branch.node_edge, partial_branch.prefix, partial_branch.sibling_rank, relmat);
+                }
+                else
+                {
+                    expand_partial_branch(partial_branch, relmat);
+                }
+
+                release_partial_branch(partial_branch.node_edge);
+            }
+            else if ((node_edge_stack.size() > 0)
+                && (node_edge_stack.begin()->second->get_depth() < relmat.get_message_length() - 1))
+            {
+                StackNodeEdge* node = node_edge_stack.begin()->second;
+                visit_node_forward(node, relmat);
+            }
+            else
+            {
+                return finish_search();
+            }
+
+            if ((use_max_stack_size) && (node_edge_stack.size() + partial_stack.size() > max_stack_size))
+            {
+                evict();
+            }
 
             if ((Parent::use_node_limit) && (Parent::node_count > Parent::node_limit))
             {
                 std::cerr << "Node limit exhausted" << std::endl;
-                return false;
+                step_status = CC_Decode_Failed;
+                return step_status;
             }
         }
 
-        // Top node has the solution if we have not given up
-        if (!Parent::use_metric_limit || node_edge_stack.size() != 0)
+        return step_status;
+    }
+
+    /**
+     * Retrieves the decoded message of a decoding run step by step once it is done
+     * \param decoded_message Vector of symbols of retrieved message
+     * \return true if the decoding is done
+     */
+    bool get_decoded_message(std::vector<T_IOSymbol>& decoded_message)
+    {
+        if (step_status == CC_Decode_Done)
         {
-            //std::cout << "final: " << std::dec << node_stack.begin()->second->get_id() << ":" << node_stack.begin()->second->get_depth() << ":" << node_stack.begin()->first.path_metric << std::endl;
-            ParentInternal::back_track(node_edge_stack.begin()->second, decoded_message, true); // back track from terminal node to retrieve decoded message
-            Parent::codeword_score = node_edge_stack.begin()->first.path_metric; // the codeword score is the path metric
+            ParentInternal::back_track(terminal_node_edge, decoded_message, true); // back track from terminal node to retrieve decoded message
             return true;
         }
         else
         {
-            std::cerr << "Metric limit encountered" << std::endl;
-            return false; // no solution
+            return false;
         }
     }
 
@@ -159,7 +337,13 @@ public:
                 << " stack_score = " << get_stack_score()
                 << " #nodes = " << Parent::get_nb_nodes()
                 << " stack_size = " << get_stack_size()
-                << " max depth = " << Parent::get_max_depth();
+                << " max depth = " << Parent::get_max_depth()
+                << " evictions = " << get_nb_evictions();
+
+        if (binary_expansion)
+        {
+            std::cout << " partial expansions = " << get_nb_partial_expansions();
+        }
     }
 
     /**
@@ -191,6 +375,49 @@ protected:
     typedef CC_SequentialDecodingInternal<T_Register, T_IOSymbol, CC_TreeNodeEdgeTag_Empty> ParentInternal; //!< Parent class this class inherits from
     typedef CC_TreeNodeEdge<T_IOSymbol, T_Register, CC_TreeNodeEdgeTag_Empty> StackNodeEdge; //!< Class of code tree nodes in the stack algorithm
 
+    /**
+     * Searches the code tree given the reliability matrix
+     * \param relmat Reference to the reliability matrix
+     * \param decoded_message Vector of symbols of retrieved message
+     */
+    StackNodeEdge *search(const CC_ReliabilityMatrix& relmat)
+    {
+        start(relmat);
+
+        while (step(std::numeric_limits<unsigned int>::max()) == CC_Decode_Pending)
+        {}
+
+        return terminal_node_edge;
+    }
+
+    /**
+     * Ends the search when the stack is empty or the top node is terminal
+     * \return Status of the decoding
+     */
+    CC_DecodeStatus finish_search()
+    {
+        // Top node has the solution if we have not given up
+        if (!Parent::use_metric_limit || node_edge_stack.size() != 0)
+        {
+            Parent::codeword_score = node_edge_stack.begin()->first.path_metric; // the codeword score is the path metric
+            terminal_node_edge = node_edge_stack.begin()->second;
+
+            if (Parent::trace)
+            {
+                Parent::trace->record(CC_Trace_Solution, terminal_node_edge->get_id(), terminal_node_edge->get_depth(), terminal_node_edge->get_path_metric());
+            }
+
+            step_status = CC_Decode_Done;
+        }
+        else
+        {
+            std::cerr << "Metric limit encountered" << std::endl;
+            step_status = CC_Decode_Failed;
+        }
+
+        return step_status;
+    }
+
     /**
      * Visit a new node
      * \node Node+edge combo to visit
@@ -200,38 +427,47 @@ protected:
     {
         int forward_depth = node_edge->get_depth() + 1;
         T_IOSymbol out_symbol;
-        T_IOSymbol end_symbol;
+        unsigned int input_mask = get_successor_inputs(node_edge, relmat);
+        unsigned int nb_inputs = Parent::get_nb_inputs(input_mask);
+        bool step = true;
+        typename std::map<StackNodeEdge*, unsigned int>::iterator rank_it = next_sibling_ranks.find(node_edge);
 
-        // return encoder to appropriate state
-        if (node_edge->get_depth() >= 0) // does not concern the root node
+        if (rank_it != next_sibling_ranks.end()) // the next best sibling enters the stack when the lazy successor leaves it
         {
-            Parent::encoding.set_registers(node_edge->get_registers());
+            push_lazy_sibling(node_edge->get_incoming_node_edge(), rank_it->second, relmat);
+            next_sibling_ranks.erase(rank_it);
         }
 
-        if ((Parent::tail_zeros) && (forward_depth > relmat.get_message_length()-Parent::encoding.get_m()))
+        restore_encoder(node_edge);
+        unsigned int first_child_id = Parent::node_count;
+
+        if ((binary_expansion) && (nb_inputs > 2))
         {
-            end_symbol = 1; // if zero tail option assume tail symbols are all zeros
+            PartialBranch partial_branch(node_edge, 0, 0);
+            expand_partial_branch(partial_branch, relmat); // decide the first input bit only
         }
-        else
+        else if ((lazy_successors) && (nb_inputs > 1))
         {
-            end_symbol = (1<<Parent::encoding.get_k()); // full scan all possible input symbols
+            std::vector<std::pair<float, T_IOSymbol> > ranked_inputs;
+            rank_successors(node_edge, relmat, ranked_inputs);
+            add_lazy_successor(node_edge, ranked_inputs[0].second, 0, relmat);
         }
-
-        // loop through assumption for this symbol place
-        for (T_IOSymbol in_symbol = 0; in_symbol < end_symbol; in_symbol++)
+        else
         {
-            Parent::encoding.encode(in_symbol, out_symbol, in_symbol > 0); // step only for a new symbol place
-            float edge_metric = ParentInternal::log2(relmat(out_symbol, forward_depth)) - Parent::edge_bias;
+            // loop through the admissible assumptions for this symbol place
+            for (T_IOSymbol in_symbol = 0; in_symbol < (1U<<Parent::encoding.get_k()); in_symbol++)
+            {
+                if (Parent::is_admissible(input_mask, in_symbol))
+                {
+                    Parent::encoding.encode(in_symbol, out_symbol, !step); // step only for a new symbol place
+                    step = false;
+                    add_successor(node_edge, in_symbol, out_symbol, relmat);
+                }
+            }
 
-            float forward_path_metric = edge_metric + node_edge->get_path_metric();
-            if ((!Parent::use_metric_limit) || (forward_path_metric > Parent::metric_limit))
+            if (Parent::trace)
             {
-                StackNodeEdge *next_node_edge = new StackNodeEdge(Parent::node_count, node_edge, in_symbol, edge_metric, forward_path_metric, forward_depth);
-                next_node_edge->set_registers(Parent::encoding.get_registers());
-                node_edge->add_outgoing_node_edge(next_node_edge); // add forward edge+node combo
-                node_edge_stack[NodeEdgeOrdering(forward_path_metric, Parent::node_count)] = next_node_edge;
-                //std::cout << "->" << std::dec << node_count << ":" << forward_depth << " (" << (unsigned int) in_symbol << "," << (unsigned int) out_symbol << "): " << forward_path_metric << std::endl;
-                Parent::node_count++;
+                Parent::trace->record(CC_Trace_Expand, node_edge->get_id(), node_edge->get_depth(), node_edge->get_path_metric(), first_child_id, Parent::node_count - first_child_id);
             }
         }
 
@@ -248,6 +484,240 @@ protected:
         }
     }
 
+    /**
+     * Branch of the code tree where only the first input bits of the successor of a node are decided.
+     * When all k input bits are decided it is a successor not yet created of the lazy successors option.
+     */
+    struct PartialBranch
+    {
+        PartialBranch(StackNodeEdge *_node_edge, T_IOSymbol _prefix, unsigned int _nb_bits, unsigned int _sibling_rank = 0) :
+            node_edge(_node_edge),
+            prefix(_prefix),
+            nb_bits(_nb_bits),
+            sibling_rank(_sibling_rank)
+        {}
+
+        StackNodeEdge *node_edge;  //!< Node whose successors are being decided
+        T_IOSymbol prefix;         //!< Input bits decided so far starting from the most significant
+        unsigned int nb_bits;      //!< Number of input bits decided so far
+        unsigned int sibling_rank; //!< Rank of the successor by decreasing edge metric when all input bits are decided
+    };
+
+    /**
+     * Returns the encoder to the state after the input symbol of a node
+     */
+    void restore_encoder(StackNodeEdge *node_edge)
+    {
+        if (node_edge->get_depth() >= 0) // does not concern the root node
+        {
+            Parent::encoding.set_registers(node_edge->get_registers());
+        }
+        else
+        {
+            Parent::encoding.clear(); // partial branches may have moved the encoder since the reset
+        }
+    }
+
+    /**
+     * Bitmask of the input symbols that can follow a node
+     */
+    unsigned int get_successor_inputs(StackNodeEdge *node_edge, const CC_ReliabilityMatrix& relmat)
+    {
+        return Parent::get_input_mask(node_edge->get_depth() + 1, relmat.get_message_length());
+    }
+
+    /**
+     * Ranks the input symbols following a node by decreasing edge metric. Ties go to the highest input symbol
+     * first as they do when all successors are in the stack.
+     * \param ranked_inputs Receives the edge metric (without bias) and input symbol pairs in rank order
+     */
+    void rank_successors(StackNodeEdge *node_edge, const CC_ReliabilityMatrix& relmat, std::vector<std::pair<float, T_IOSymbol> >& ranked_inputs)
+    {
+        int forward_depth = node_edge->get_depth() + 1;
+        unsigned int input_mask = get_successor_inputs(node_edge, relmat);
+        T_IOSymbol out_symbol;
+        bool step = true;
+        restore_encoder(node_edge);
+
+        for (T_IOSymbol in_symbol = 0; in_symbol < (1U<<Parent::encoding.get_k()); in_symbol++)
+        {
+            if (!Parent::is_admissible(input_mask, in_symbol))
+            {
+                continue;
+            }
+
+            Parent::encoding.encode(in_symbol, out_symbol, !step); // step only for a new symbol place
+            step = false;
+            ranked_inputs.push_back(std::make_pair(relmat.is_hard_decision() ? relmat.get_hard_metric(out_symbol, forward_depth)
+                : relmat.is_bit_metric() ? relmat.get_bit_metric(out_symbol, forward_depth)
+                : ParentInternal::log2(relmat(out_symbol, forward_depth)), in_symbol));
+        }
+
+        std::sort(ranked_inputs.begin(), ranked_inputs.end(), std::greater<std::pair<float, T_IOSymbol> >());
+    }
+
+    /**
+     * Creates the successor of a node of the given rank and pushes it in the stack. The successor keeps the rank of its next sibling if any.
+     */
+    void add_lazy_successor(StackNodeEdge *node_edge, T_IOSymbol in_symbol, unsigned int rank, const CC_ReliabilityMatrix& relmat)
+    {
+        T_IOSymbol out_symbol;
+        unsigned int first_child_id = Parent::node_count;
+        restore_encoder(node_edge);
+        Parent::encoding.encode(in_symbol, out_symbol);
+        StackNodeEdge *successor = add_successor(node_edge, in_symbol, out_symbol, relmat);
+
+        if ((successor) && (rank + 1 < Parent::get_nb_inputs(get_successor_inputs(node_edge, relmat))))
+        {
+            next_sibling_ranks[successor] = rank + 1;
+        }
+
+        if (Parent::trace)
+        {
+            Parent::trace->record(CC_Trace_Expand, node_edge->get_id(), node_edge->get_depth(), node_edge->get_path_metric(), first_child_id, Parent::node_count - first_child_id);
+        }
+    }
+
+    /**
+     * Pushes the successor of a node of the given rank in the stack as a partial branch with all its input bits decided
+     */
+    void push_lazy_sibling(StackNodeEdge *node_edge, unsigned int rank, const CC_ReliabilityMatrix& relmat)
+    {
+        std::vector<std::pair<float, T_IOSymbol> > ranked_inputs;
+        rank_successors(node_edge, relmat, ranked_inputs);
+        float path_metric = node_edge->get_path_metric() + ranked_inputs[rank].first - Parent::edge_bias;
+
+        if ((!Parent::use_metric_limit) || (path_metric > Parent::metric_limit)) // and so are the next ones
+        {
+            partial_stack.insert(std::make_pair(NodeEdgeOrdering(path_metric, partial_count++),
+                PartialBranch(node_edge, ranked_inputs[rank].second, Parent::encoding.get_k(), rank)));
+            nb_pending_partials[node_edge]++;
+        }
+    }
+
+    /**
+     * Creates a successor of a node for the input symbol just encoded and pushes it in the stack
+     * \return The successor or 0 if its path metric is below the metric limit
+     */
+    StackNodeEdge *add_successor(StackNodeEdge *node_edge, T_IOSymbol in_symbol, T_IOSymbol out_symbol, const CC_ReliabilityMatrix& relmat)
+    {
+        int forward_depth = node_edge->get_depth() + 1;
+        float edge_metric = (relmat.is_hard_decision() ? relmat.get_hard_metric(out_symbol, forward_depth)
+            : relmat.is_bit_metric() ? relmat.get_bit_metric(out_symbol, forward_depth)
+            : ParentInternal::log2(relmat(out_symbol, forward_depth))) - Parent::edge_bias;
+
+        float forward_path_metric = edge_metric + node_edge->get_path_metric();
+        if ((!Parent::use_metric_limit) || (forward_path_metric > Parent::metric_limit))
+        {
+            StackNodeEdge *next_node_edge = new StackNodeEdge(Parent::node_count, node_edge, in_symbol, edge_metric, forward_path_metric, forward_depth);
+            next_node_edge->set_registers(Parent::encoding.get_registers());
+            node_edge->add_outgoing_node_edge(next_node_edge); // add forward edge+node combo
+            node_edge_stack[NodeEdgeOrdering(forward_path_metric, Parent::node_count)] = next_node_edge;
+            //std::cout << "->" << std::dec << node_count << ":" << forward_depth << " (" << (unsigned int) in_symbol << "," << (unsigned int) out_symbol << "): " << forward_path_metric << std::endl;
+            Parent::node_count++;
+            return next_node_edge;
+        }
+
+        return 0;
+    }
+
+    /**
+     * Decides the next input bit of a partial branch. Creates the successors when it is the last bit
+     * or else pushes the two longer partial branches with the probability of their completions.
+     */
+    void expand_partial_branch(const PartialBranch& partial_branch, const CC_ReliabilityMatrix& relmat)
+    {
+        StackNodeEdge *node_edge = partial_branch.node_edge;
+        int forward_depth = node_edge->get_depth() + 1;
+        unsigned int nb_free_bits = Parent::encoding.get_k() - partial_branch.nb_bits - 1; // input bits left undecided after this one
+        unsigned int first_child_id = Parent::node_count;
+        unsigned int input_mask = get_successor_inputs(node_edge, relmat);
+        bool step = true;
+        T_IOSymbol out_symbol;
+
+        if (node_edge->get_depth() >= 0)
+        {
+            Parent::encoding.set_registers(node_edge->get_registers());
+        }
+        else
+        {
+            Parent::encoding.clear();
+        }
+
+        for (T_IOSymbol bit = 0; bit < 2; bit++)
+        {
+            T_IOSymbol prefix = (partial_branch.prefix << 1) + bit;
+            T_IOSymbol first_symbol = prefix << nb_free_bits;
+
+            if (nb_free_bits == 0)
+            {
+                if (Parent::is_admissible(input_mask, first_symbol))
+                {
+                    Parent::encoding.encode(first_symbol, out_symbol, !step);
+                    step = false;
+                    add_successor(node_edge, first_symbol, out_symbol, relmat);
+                }
+            }
+            else
+            {
+                float probability = 0.0;
+                bool admissible = false;
+
+                for (T_IOSymbol in_symbol = first_symbol; in_symbol < first_symbol + (1<<nb_free_bits); in_symbol++)
+                {
+                    if (!Parent::is_admissible(input_mask, in_symbol))
+                    {
+                        continue;
+                    }
+
+                    admissible = true;
+                    Parent::encoding.encode(in_symbol, out_symbol, !step);
+                    step = false;
+                    probability += (relmat.is_hard_decision() ? exp2(relmat.get_hard_metric(out_symbol, forward_depth))
+                        : relmat.is_bit_metric() ? exp2(relmat.get_bit_metric(out_symbol, forward_depth))
+                        : relmat(out_symbol, forward_depth));
+                }
+
+                float path_metric = node_edge->get_path_metric() + ParentInternal::log2(probability) - Parent::edge_bias;
+
+                if ((admissible) && ((!Parent::use_metric_limit) || (path_metric > Parent::metric_limit))) // no admissible completion prunes the prefix
+                {
+                    partial_stack.insert(std::make_pair(NodeEdgeOrdering(path_metric, partial_count++), PartialBranch(node_edge, prefix, partial_branch.nb_bits + 1)));
+                    nb_pending_partials[node_edge]++;
+                }
+            }
+        }
+
+        if (partial_branch.nb_bits > 0)
+        {
+            nb_partial_expansions++;
+        }
+
+        if ((Parent::trace) && (nb_free_bits == 0))
+        {
+            Parent::trace->record(CC_Trace_Expand, node_edge->get_id(), node_edge->get_depth(), node_edge->get_path_metric(), first_child_id, Parent::node_count - first_child_id);
+        }
+    }
+
+    /**
+     * Accounts for a partial branch of a node leaving the partial stack
+     * \return true if the node has no partial branch left
+     */
+    bool release_partial_branch(StackNodeEdge *node_edge)
+    {
+        typename std::map<StackNodeEdge*, unsigned int>::iterator pending_it = nb_pending_partials.find(node_edge);
+
+        if (--(pending_it->second) == 0)
+        {
+            nb_pending_partials.erase(pending_it);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
     /**
      * Removes a node from the stack map. Does a full scan but usually the nodes to be removed are on the top of the stack (i.e. beginning of the map).
      */
@@ -265,7 +735,91 @@ protected:
         }
     }
 
+    /**
+     * Evict the entries at the tail of the stack (lowest path metric) until the stack fits in its maximum size.
+     * Partial branches count as entries. The branch leading to an evicted node is deleted up to the first ancestor
+     * that still has other outgoing node+edges or partial branches.
+     */
+    void evict()
+    {
+        while (node_edge_stack.size() + partial_stack.size() > max_stack_size)
+        {
+            if ((partial_stack.size() > 0)
+                && ((node_edge_stack.size() == 0) || (partial_stack.rbegin()->first.path_metric < node_edge_stack.rbegin()->first.path_metric)))
+            {
+                typename std::map<NodeEdgeOrdering, PartialBranch, std::greater<NodeEdgeOrdering> >::iterator last_it = partial_stack.end();
+                --last_it;
+                StackNodeEdge *node_edge = last_it->second.node_edge;
+                float path_metric = last_it->first.path_metric;
+                partial_stack.erase(last_it);
+                nb_evictions++;
+
+                if (Parent::trace)
+                {
+                    Parent::trace->record(CC_Trace_Eviction, node_edge->get_id(), node_edge->get_depth(), path_metric);
+                }
+
+                // an expanded node left without successors nor partial branches is a dead branch
+                if (release_partial_branch(node_edge) && (node_edge->get_outgoing_node_edges().size() == 0) && (node_edge->get_depth() >= 0))
+                {
+                    delete_branch(node_edge);
+                }
+            }
+            else
+            {
+                typename std::map<NodeEdgeOrdering, StackNodeEdge*, std::greater<NodeEdgeOrdering> >::iterator last_it = node_edge_stack.end();
+                --last_it;
+                StackNodeEdge *dead_node_edge = last_it->second;
+                node_edge_stack.erase(last_it);
+                next_sibling_ranks.erase(dead_node_edge); // its lazy siblings have lower path metrics
+                nb_evictions++;
+
+                if (Parent::trace)
+                {
+                    Parent::trace->record(CC_Trace_Eviction, dead_node_edge->get_id(), dead_node_edge->get_depth(), dead_node_edge->get_path_metric());
+                }
+
+                delete_branch(dead_node_edge);
+            }
+        }
+    }
+
+    /**
+     * Deletes a node that has no successors and is not in the stack with its ancestors up to the first one
+     * that still has other outgoing node+edges or partial branches.
+     */
+    void delete_branch(StackNodeEdge *dead_node_edge)
+    {
+        while (true) // stack entries are leaves and all their ancestors down to the root have been visited
+        {
+            StackNodeEdge *incoming_node_edge = dead_node_edge->get_incoming_node_edge();
+            bool incoming_dead = incoming_node_edge->remove_outgoing_node_edge(dead_node_edge) && (incoming_node_edge->get_depth() >= 0)
+                && (nb_pending_partials.find(incoming_node_edge) == nb_pending_partials.end());
+            delete dead_node_edge;
+
+            if (!incoming_dead)
+            {
+                break;
+            }
+
+            dead_node_edge = incoming_node_edge;
+        }
+    }
+
     std::map<NodeEdgeOrdering, StackNodeEdge*, std::greater<NodeEdgeOrdering> > node_edge_stack; //!< Ordered stack of node+edge combos by decreasing path metric
+    bool use_max_stack_size;     //!< Evict the lowest entries when the stack grows above max_stack_size
+    unsigned int max_stack_size; //!< Maximum number of entries in the stack
+    unsigned int nb_evictions;   //!< Number of entries evicted during the last decoding
+    bool binary_expansion;       //!< Decide the input bits of the successors one at a time for k > 1 codes
+    std::map<NodeEdgeOrdering, PartialBranch, std::greater<NodeEdgeOrdering> > partial_stack; //!< Ordered stack of partial branches by decreasing path metric
+    std::map<StackNodeEdge*, unsigned int> nb_pending_partials; //!< Number of partial branches in the stack per expanded node
+    unsigned int partial_count;          //!< Counter used to order partial branches of equal path metric
+    unsigned int nb_partial_expansions;  //!< Number of partial branches expanded during the last decoding
+    bool lazy_successors;                //!< Create the successors of a node one at a time by decreasing edge metric
+    std::map<StackNodeEdge*, unsigned int> next_sibling_ranks; //!< Rank of the next sibling of a lazily created successor still in the stack
+    const CC_ReliabilityMatrix *step_relmat; //!< Reliability matrix of the decoding run step by step
+    CC_DecodeStatus step_status;         //!< Status of the decoding run step by step
+    StackNodeEdge *terminal_node_edge;   //!< Terminal node of the path found when the decoding is done
 };
 
 } // namespace ccsoft
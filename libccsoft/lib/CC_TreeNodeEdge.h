@@ -28,6 +28,7 @@
 
 #include "CC_TreeNodeEdge_base.h"
 #include <vector>
+#include <algorithm>
 
 namespace ccsoft
 {
@@ -99,6 +100,23 @@ public:
         p_outgoing_node_edges.clear();
     }
 
+    /**
+     * Detach an outgoing node+edge without deleting it
+     * \param p_outgoing_node_edge Outgoing edge+node to detach
+     * \return true if there are no more outgoing node+edges
+     */
+    bool remove_outgoing_node_edge(CC_TreeNodeEdge<T_IOSymbol, T_Register, T_Tag> *p_outgoing_node_edge)
+    {
+        typename std::vector<CC_TreeNodeEdge<T_IOSymbol, T_Register, T_Tag>*>::iterator ne_it = std::find(p_outgoing_node_edges.begin(), p_outgoing_node_edges.end(), p_outgoing_node_edge);
+
+        if (ne_it != p_outgoing_node_edges.end())
+        {
+            p_outgoing_node_edges.erase(ne_it);
+        }
+
+        return p_outgoing_node_edges.size() == 0;
+    }
+
     /**
      * Return a R/O reference to the outgoing node+edges
      */
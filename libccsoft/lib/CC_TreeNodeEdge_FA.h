@@ -111,6 +111,30 @@ public:
         clear_outgoing_edges();
     }
 
+    /**
+     * Detach an outgoing node+edge without deleting it
+     * \param p_outgoing_node_edge Outgoing edge+node to detach
+     * \return true if there are no more outgoing node+edges
+     */
+    bool remove_outgoing_node_edge(CC_TreeNodeEdge_FA<T_IOSymbol, T_Register, T_Tag, N_k> *p_outgoing_node_edge)
+    {
+        bool empty = true;
+
+        for (unsigned int i=0; i<(1<<N_k); i++)
+        {
+            if (p_outgoing_node_edges[i] == p_outgoing_node_edge)
+            {
+                p_outgoing_node_edges[i] = 0;
+            }
+            else if (p_outgoing_node_edges[i])
+            {
+                empty = false;
+            }
+        }
+
+        return empty;
+    }
+
     /**
      * Verifies validity of outgoing node+edges i.e. pointers are all non null
      */
@@ -0,0 +1,163 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+     Tests of the channel models filling CC reliability matrices and of
+     decoding their output
+
+*/
+
+#include "CC_Encoding.h"
+#include "CC_StackDecoding.h"
+#include "CC_ChannelModel.h"
+#include "CC_ReliabilityMatrix.h"
+#include "CCSoft_Exception.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdlib.h>
+
+static const unsigned int message_length = 60; //!< including the tail of zeros
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void check(const char *title, bool ok)
+{
+    std::cout << title << (ok ? " OK" : " KO") << std::endl;
+    nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    try
+    {
+        std::cout << "kernels: " << ccsoft::CC_ChannelModel::get_kernels_name() << std::endl;
+
+        // (2,1,3) code of Han & Chen example 1
+        std::vector<unsigned int> ks(1,3);
+        std::vector<unsigned int> g;
+        g.push_back(7);
+        g.push_back(5);
+        std::vector<std::vector<unsigned int> > gs(1, g);
+
+        ccsoft::CC_Encoding<unsigned int, unsigned int> encoding(ks, gs);
+        std::vector<unsigned int> message, out_symbols;
+        unsigned int out_symbol;
+
+        srand(1);
+
+        for (unsigned int i=0; i<message_length; i++)
+        {
+            message.push_back(i < message_length-2 ? rand() % 2 : 0);
+            encoding.encode(message.back(), out_symbol);
+            out_symbols.push_back(out_symbol);
+        }
+
+        // bit metric matrix gets the LLRs: right signs at high SNR
+        ccsoft::CC_ChannelModel bpsk(ccsoft::CC_ChannelModel::CC_Modulation_BPSK, 10.0);
+        ccsoft::CC_RandomStream stream(5);
+        ccsoft::CC_ReliabilityMatrix bit_relmat(2, message_length, true);
+        bpsk.transmit(out_symbols, bit_relmat, stream);
+        bool signs_ok = true;
+
+        for (unsigned int ic=0; ic<message_length; ic++)
+        {
+            for (unsigned int b=0; b<2; b++)
+            {
+                signs_ok = signs_ok && ((bit_relmat(b, ic) < 0.0) == (((out_symbols[ic] >> b) & 1) == 1));
+            }
+        }
+
+        check("bpsk llrs", signs_ok);
+
+        // hard decision matrix gets the signs of the same LLRs
+        ccsoft::CC_RandomStream llr_stream(6), hard_stream(6);
+        ccsoft::CC_ReliabilityMatrix llr_relmat(2, message_length, true);
+        ccsoft::CC_ReliabilityMatrix hard_relmat(2, message_length, ccsoft::CC_HardDecisionMetric(0.01));
+        bpsk.transmit(out_symbols, llr_relmat, llr_stream);
+        bpsk.transmit(out_symbols, hard_relmat, hard_stream);
+        bool hard_ok = true;
+
+        for (unsigned int ic=0; ic<message_length; ic++)
+        {
+            hard_ok = hard_ok && (hard_relmat.get_hard_symbol(ic) == (unsigned int) ((llr_relmat(0, ic) < 0.0) | ((llr_relmat(1, ic) < 0.0) << 1)));
+        }
+
+        check("bpsk hard decisions", hard_ok);
+
+        // noisy MFSK frame through the stack decoder
+        ccsoft::CC_ChannelModel mfsk(ccsoft::CC_ChannelModel::CC_Modulation_MFSK, 6.0, ccsoft::CC_ChannelModel::CC_Fading_Rician);
+        ccsoft::CC_ReliabilityMatrix relmat(2, message_length);
+        mfsk.transmit(out_symbols, relmat, stream);
+        relmat.normalize();
+        ccsoft::CC_StackDecoding<unsigned int, unsigned int> stack_decoder(ks, gs);
+        stack_decoder.set_edge_bias(-0.5);
+        std::vector<unsigned int> decoded;
+        check("mfsk decode", stack_decoder.decode(relmat, decoded) && (decoded == message));
+
+        // series of frames: same values as one run over all symbols, erasure bursts included
+        ccsoft::CC_ChannelModel bursty(ccsoft::CC_ChannelModel::CC_Modulation_MFSK, 10.0, ccsoft::CC_ChannelModel::CC_Fading_Rayleigh);
+        bursty.set_fading_block(8);
+        bursty.set_burst(ccsoft::CC_ChannelModel::CC_Burst_Erasure, 0.05, 0.3);
+        std::vector<unsigned int> series_symbols(out_symbols);
+        series_symbols.insert(series_symbols.end(), out_symbols.begin(), out_symbols.end());
+        ccsoft::CC_ReliabilityMatrix frame_a(2, message_length), frame_b(2, message_length);
+        std::vector<ccsoft::CC_ReliabilityMatrix*> frames;
+        frames.push_back(&frame_a);
+        frames.push_back(&frame_b);
+        std::vector<float> powers(2*message_length*4);
+        std::vector<unsigned char> bad(2*message_length);
+        ccsoft::CC_RandomStream series_stream(9), run_stream(9);
+        unsigned int nb_bad = bursty.transmit(series_symbols, frames, series_stream);
+        bool series_ok = (nb_bad == bursty.run(&series_symbols[0], 2*message_length, 2, &powers[0], run_stream, &bad[0])) && (nb_bad > 0);
+
+        for (unsigned int i=0; i<2*message_length; i++)
+        {
+            for (unsigned int r=0; r<4; r++)
+            {
+                float value = (i < message_length ? frame_a(r, i) : frame_b(r, i - message_length));
+                series_ok = series_ok && (value == powers[i*4 + r]) && (!bad[i] || (value == 0.0));
+            }
+        }
+
+        check("series of frames", series_ok);
+
+        bool thrown = false;
+
+        try
+        {
+            mfsk.transmit(out_symbols, bit_relmat, stream);
+        }
+        catch (ccsoft::CCSoft_Exception& e)
+        {
+            thrown = true;
+        }
+
+        check("bit metric check", thrown);
+    }
+    catch (ccsoft::CCSoft_Exception& e)
+    {
+        std::cout << "CCSoft exception caught: " << e.what() << std::endl;
+        nb_errors++;
+    }
+
+    std::cout << nb_errors << " error(s)" << std::endl;
+    return (nb_errors == 0 ? 0 : 1);
+}
@@ -0,0 +1,366 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+     Offline reader of the binary decoding traces written by FullTest -T.
+     Prints a summary of the events per depth, a Graphviz file of the
+     explored part of the code tree or folded stacks of the expansions per
+     depth range that flame graph tools take as input.
+
+*/
+
+#include "CC_DecodingTrace.h"
+
+#include <getopt.h>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+
+// ================================================================================================
+struct Options
+{
+public:
+    typedef enum
+    {
+        Output_summary,
+        Output_graphviz,
+        Output_folded
+    } OutputFormat;
+
+    Options() :
+        output_format(Output_summary),
+        depth_bucket(8)
+    {}
+
+    bool get_options(int argc, char *argv[]);
+
+    OutputFormat output_format;
+    unsigned int depth_bucket; //!< Depth range of a summary line or of a folded stack frame
+    std::string trace_filename;
+};
+
+// ================================================================================================
+bool Options::get_options(int argc, char *argv[])
+{
+    int c;
+    bool status = true;
+
+    while (true)
+    {
+        static struct option long_options[] =
+        {
+            {"summary", no_argument, 0, 's'},
+            {"graphviz", no_argument, 0, 'g'},
+            {"folded", no_argument, 0, 'f'},
+            {"depth-bucket", required_argument, 0, 'b'},
+            {0, 0, 0, 0}
+        };
+
+        int option_index = 0;
+        c = getopt_long (argc, argv, "sgfb:", long_options, &option_index);
+
+        if (c == -1) // end of options
+        {
+            break;
+        }
+
+        switch(c)
+        {
+            case 's':
+                output_format = Output_summary;
+                break;
+            case 'g':
+                output_format = Output_graphviz;
+                break;
+            case 'f':
+                output_format = Output_folded;
+                break;
+            case 'b':
+                try
+                {
+                    depth_bucket = boost::lexical_cast<unsigned int>(optarg);
+                }
+                catch (boost::bad_lexical_cast &)
+                {
+                    std::cout << "wrong argument for -b: " << optarg << std::endl;
+                    status = false;
+                }
+                break;
+            case '?':
+                status = false;
+                break;
+        }
+    }
+
+    if (optind == argc - 1)
+    {
+        trace_filename = argv[optind];
+    }
+    else
+    {
+        std::cout << "Usage: CC_TraceTool [-s|-g|-f] [-b depth_bucket] trace_file" << std::endl;
+        status = false;
+    }
+
+    if (depth_bucket == 0)
+    {
+        std::cout << "Depth bucket must be at least 1" << std::endl;
+        status = false;
+    }
+
+    return status;
+}
+
+// ================================================================================================
+// depth range of a depth, the root node having depth -1
+unsigned int get_bucket(int depth, unsigned int depth_bucket)
+{
+    return (depth < 0 ? 0 : depth / depth_bucket);
+}
+
+// ================================================================================================
+void print_summary(const std::vector<ccsoft::CC_TraceRecord>& records, uint64_t nb_dropped, const Options& options)
+{
+    std::map<unsigned int, std::vector<unsigned int> > counts; // event counts per depth bucket
+    std::vector<unsigned int> totals(ccsoft::CC_Trace_Solution + 1, 0);
+    std::vector<ccsoft::CC_TraceRecord>::const_iterator r_it = records.begin();
+
+    for (; r_it != records.end(); ++r_it)
+    {
+        if (r_it->type > ccsoft::CC_Trace_Solution)
+        {
+            continue;
+        }
+
+        std::vector<unsigned int>& bucket_counts = counts[get_bucket(r_it->depth, options.depth_bucket)];
+        bucket_counts.resize(ccsoft::CC_Trace_Solution + 1, 0);
+        bucket_counts[r_it->type]++;
+        totals[r_it->type]++;
+    }
+
+    std::cout << "# " << records.size() << " records, " << nb_dropped << " dropped" << std::endl;
+    std::cout << std::setw(12) << "depth";
+
+    for (unsigned int type = ccsoft::CC_Trace_Expand; type <= ccsoft::CC_Trace_Solution; type++)
+    {
+        std::cout << std::setw(10) << ccsoft::CC_DecodingTrace::get_type_name(type);
+    }
+
+    std::cout << std::endl;
+
+    std::map<unsigned int, std::vector<unsigned int> >::const_iterator c_it = counts.begin();
+
+    for (; c_it != counts.end(); ++c_it)
+    {
+        std::ostringstream range;
+        range << c_it->first * options.depth_bucket << "-" << (c_it->first + 1) * options.depth_bucket - 1;
+        std::cout << std::setw(12) << range.str();
+
+        for (unsigned int type = ccsoft::CC_Trace_Expand; type <= ccsoft::CC_Trace_Solution; type++)
+        {
+            std::cout << std::setw(10) << c_it->second[type];
+        }
+
+        std::cout << std::endl;
+    }
+
+    std::cout << std::setw(12) << "total";
+
+    for (unsigned int type = ccsoft::CC_Trace_Expand; type <= ccsoft::CC_Trace_Solution; type++)
+    {
+        std::cout << std::setw(10) << totals[type];
+    }
+
+    std::cout << std::endl;
+}
+
+// ================================================================================================
+void print_graphviz(const std::vector<ccsoft::CC_TraceRecord>& records)
+{
+    std::map<uint32_t, uint32_t> predecessors;      // node id to predecessor id
+    std::map<uint32_t, const ccsoft::CC_TraceRecord *> expansions; // last expansion of a node
+    std::map<uint32_t, unsigned int> nb_expansions; // Fano visits the same nodes several times
+    std::set<uint32_t> evicted;
+    std::set<uint32_t> solution_path;
+    std::vector<ccsoft::CC_TraceRecord>::const_iterator r_it = records.begin();
+
+    for (; r_it != records.end(); ++r_it)
+    {
+        if (r_it->type == ccsoft::CC_Trace_Expand)
+        {
+            expansions[r_it->node_id] = &(*r_it);
+            nb_expansions[r_it->node_id]++;
+
+            for (unsigned int i = 0; i < r_it->nb_children; i++)
+            {
+                predecessors[r_it->related_id + i] = r_it->node_id;
+            }
+        }
+        else if (r_it->type == ccsoft::CC_Trace_Eviction)
+        {
+            evicted.insert(r_it->node_id);
+        }
+        else if (r_it->type == ccsoft::CC_Trace_Solution)
+        {
+            uint32_t node_id = r_it->node_id;
+            solution_path.insert(node_id);
+            std::map<uint32_t, uint32_t>::const_iterator p_it = predecessors.find(node_id);
+
+            while (p_it != predecessors.end())
+            {
+                node_id = p_it->second;
+                solution_path.insert(node_id);
+                p_it = predecessors.find(node_id);
+            }
+        }
+    }
+
+    std::cout << "digraph trace {" << std::endl;
+    std::cout << "    node [shape=box, style=filled, fillcolor=white];" << std::endl;
+
+    std::map<uint32_t, const ccsoft::CC_TraceRecord *>::const_iterator e_it = expansions.begin();
+
+    for (; e_it != expansions.end(); ++e_it)
+    {
+        std::cout << "    n" << e_it->first << " [label=\"" << e_it->first << "\\n" << e_it->second->depth << ":" << e_it->second->metric;
+
+        if (nb_expansions[e_it->first] > 1)
+        {
+            std::cout << "\\nx" << nb_expansions[e_it->first];
+        }
+
+        std::cout << "\"";
+
+        if (solution_path.count(e_it->first))
+        {
+            std::cout << ", fillcolor=lightblue";
+        }
+        else if (evicted.count(e_it->first))
+        {
+            std::cout << ", fillcolor=grey";
+        }
+
+        std::cout << "];" << std::endl;
+    }
+
+    std::map<uint32_t, uint32_t>::const_iterator p_it = predecessors.begin();
+
+    for (; p_it != predecessors.end(); ++p_it)
+    {
+        if (expansions.find(p_it->first) == expansions.end()) // leaf of the explored tree
+        {
+            std::cout << "    n" << p_it->first << " [label=\"" << p_it->first << "\"";
+
+            if (solution_path.count(p_it->first))
+            {
+                std::cout << ", fillcolor=lightblue";
+            }
+            else if (evicted.count(p_it->first))
+            {
+                std::cout << ", fillcolor=grey";
+            }
+
+            std::cout << "];" << std::endl;
+        }
+
+        std::cout << "    n" << p_it->second << " -> n" << p_it->first << ";" << std::endl;
+    }
+
+    std::cout << "}" << std::endl;
+}
+
+// ================================================================================================
+// one line per depth range with the stack of all depth ranges down to it and the number of expansions in it
+void print_folded(const std::vector<ccsoft::CC_TraceRecord>& records, const Options& options)
+{
+    std::map<unsigned int, unsigned int> nb_expansions;
+    std::vector<ccsoft::CC_TraceRecord>::const_iterator r_it = records.begin();
+
+    for (; r_it != records.end(); ++r_it)
+    {
+        if (r_it->type == ccsoft::CC_Trace_Expand)
+        {
+            nb_expansions[get_bucket(r_it->depth, options.depth_bucket)]++;
+        }
+    }
+
+    if (nb_expansions.size() == 0)
+    {
+        return;
+    }
+
+    unsigned int last_bucket = nb_expansions.rbegin()->first;
+    std::string stack;
+
+    for (unsigned int bucket = 0; bucket <= last_bucket; bucket++)
+    {
+        std::ostringstream frame;
+        frame << (bucket > 0 ? ";" : "") << "depth_" << bucket * options.depth_bucket << "-" << (bucket + 1) * options.depth_bucket - 1;
+        stack += frame.str();
+        std::map<unsigned int, unsigned int>::const_iterator n_it = nb_expansions.find(bucket);
+
+        if (n_it != nb_expansions.end())
+        {
+            std::cout << stack << " " << n_it->second << std::endl;
+        }
+    }
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    if (!options.get_options(argc, argv))
+    {
+        std::cout << "Wrong options" << std::endl;
+        return -1;
+    }
+
+    std::ifstream trace_file(options.trace_filename.c_str(), std::ios::in | std::ios::binary);
+    std::vector<ccsoft::CC_TraceRecord> records;
+    uint64_t nb_dropped;
+
+    if (!trace_file.is_open() || !ccsoft::CC_DecodingTrace::read(trace_file, records, nb_dropped))
+    {
+        std::cout << "Cannot read decoding trace " << options.trace_filename << std::endl;
+        return -1;
+    }
+
+    switch (options.output_format)
+    {
+        case Options::Output_graphviz:
+            print_graphviz(records);
+            break;
+        case Options::Output_folded:
+            print_folded(records, options);
+            break;
+        default:
+            print_summary(records, nb_dropped, options);
+            break;
+    }
+
+    return 0;
+}
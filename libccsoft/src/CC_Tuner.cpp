@@ -0,0 +1,517 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+     Offline tuner of the sequential decoding parameters. Sweeps the
+     algorithm, edge bias and Fano thresholds on synthetic AWGN frames for
+     each SNR, measures the frame error rate and the CPU time and writes a
+     decoding policy with the cheapest parameters meeting the target frame
+     error rate at each SNR.
+
+*/
+
+#include "CC_ReliabilityMatrix.h"
+#include "CC_Encoding.h"
+#include "CC_StackDecoding.h"
+#include "CC_FanoDecoding.h"
+#include "CC_DecodingPolicy.h"
+#include "CCSoft_Exception.h"
+#include "URandom.h"
+
+#include <getopt.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+
+static URandom ur; // Global random generator object
+
+// ================================================================================================
+// template to extract information from getopt more easily
+template<typename TOpt, typename TField> bool extract_option(TField& field, char short_option)
+{
+    TOpt option_value;
+
+    try
+    {
+        option_value = boost::lexical_cast<TOpt>(optarg);
+        field = option_value;
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong argument for -" << short_option << ": " << optarg << " leave default (" << field << ")";
+        std::cout << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+// template to extract a vector of elements from a delimiter separated string
+template<typename TElement> bool extract_vector(std::vector<TElement>& velements, const char *separator, std::string cs_string)
+{
+    std::string element_str;
+    TElement element;
+
+    boost::char_separator<char> sep(separator);
+    boost::tokenizer<boost::char_separator<char> > tokens(cs_string, sep);
+
+    boost::tokenizer<boost::char_separator<char> >::iterator tok_iter = tokens.begin();
+    boost::tokenizer<boost::char_separator<char> >::iterator toks_end = tokens.end();
+
+    velements.clear();
+
+    try
+    {
+        for (; tok_iter != toks_end; ++tok_iter)
+        {
+            element = boost::lexical_cast<TElement>(*tok_iter);
+            velements.push_back(element);
+        }
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong element in delimiter separated string argument: " << *tok_iter << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+struct Options
+{
+public:
+    Options() :
+        message_length(50),
+        nb_frames(100),
+        target_fer(0.01),
+        node_limit(10000),
+        seed(0),
+        has_seed(false)
+    {
+        snr_values.push_back(3.0);
+        snr_values.push_back(5.0);
+        snr_values.push_back(7.0);
+        algorithms.push_back("stack");
+        algorithms.push_back("fano");
+        edge_biases.push_back(0.0);
+        edge_biases.push_back(-0.5);
+        fano_init_metrics.push_back(-1.0);
+        fano_delta_metrics.push_back(1.0);
+    }
+
+    bool get_options(int argc, char *argv[]);
+
+    std::vector<unsigned int> k_constraints;
+    std::vector<std::vector<unsigned int> > generator_polys;
+    unsigned int message_length; //!< Number of random input symbols per frame (tail not included)
+    unsigned int nb_frames; //!< Number of frames per SNR point
+    float target_fer; //!< Target frame error rate
+    unsigned int node_limit; //!< Node limit applied to all parameter sets so that hopeless frames are cut short
+    unsigned int seed;
+    bool has_seed;
+    std::vector<float> snr_values; //!< SNR points of the sweep
+    std::vector<std::string> algorithms; //!< Algorithms to try: stack and/or fano
+    std::vector<float> edge_biases; //!< Edge biases to try
+    std::vector<float> fano_init_metrics; //!< Fano initial thresholds to try
+    std::vector<float> fano_delta_metrics; //!< Fano threshold steps to try
+    std::string policy_filename; //!< Output policy file or empty for standard output
+
+private:
+    bool parse_generator_polys_data(std::string generator_polys_data_str);
+};
+
+// ================================================================================================
+bool Options::get_options(int argc, char *argv[])
+{
+    int c;
+    bool status = true;
+
+    while (true)
+    {
+        static struct option long_options[] =
+        {
+            {"k-constraints", required_argument, 0, 'k'},
+            {"gen-polys", required_argument, 0, 'g'},
+            {"snr", required_argument, 0, 'n'},
+            {"algorithms", required_argument, 0, 'A'},
+            {"edge-biases", required_argument, 0, 'b'},
+            {"fano-init-metrics", required_argument, 0, 'I'},
+            {"fano-delta-metrics", required_argument, 0, 'D'},
+            {"node-limit", required_argument, 0, 'N'},
+            {"message-length", required_argument, 0, 'l'},
+            {"nb-frames", required_argument, 0, 'f'},
+            {"target-fer", required_argument, 0, 'F'},
+            {"seed", required_argument, 0, 's'},
+            {"output", required_argument, 0, 'o'},
+            {0, 0, 0, 0}
+        };
+
+        int option_index = 0;
+        c = getopt_long (argc, argv, "k:g:n:A:b:I:D:N:l:f:F:s:o:", long_options, &option_index);
+
+        if (c == -1) // end of options
+        {
+            break;
+        }
+
+        switch(c)
+        {
+            case 'k':
+                status = extract_vector<unsigned int>(k_constraints, ",", std::string(optarg));
+                break;
+            case 'g':
+                status = parse_generator_polys_data(std::string(optarg));
+                break;
+            case 'n':
+                status = extract_vector<float>(snr_values, ",", std::string(optarg));
+                break;
+            case 'A':
+                status = extract_vector<std::string>(algorithms, ",", std::string(optarg));
+                break;
+            case 'b':
+                status = extract_vector<float>(edge_biases, ",", std::string(optarg));
+                break;
+            case 'I':
+                status = extract_vector<float>(fano_init_metrics, ",", std::string(optarg));
+                break;
+            case 'D':
+                status = extract_vector<float>(fano_delta_metrics, ",", std::string(optarg));
+                break;
+            case 'N':
+                status = extract_option<int, unsigned int>(node_limit, 'N');
+                break;
+            case 'l':
+                status = extract_option<int, unsigned int>(message_length, 'l');
+                break;
+            case 'f':
+                status = extract_option<int, unsigned int>(nb_frames, 'f');
+                break;
+            case 'F':
+                status = extract_option<double, float>(target_fer, 'F');
+                break;
+            case 's':
+                status = extract_option<int, unsigned int>(seed, 's');
+                has_seed = true;
+                break;
+            case 'o':
+                policy_filename = std::string(optarg);
+                break;
+            case '?':
+                status = false;
+                break;
+        }
+    }
+
+    if (status)
+    {
+        std::vector<std::string>::const_iterator a_it = algorithms.begin();
+
+        for (; a_it != algorithms.end(); ++a_it)
+        {
+            if ((*a_it != "stack") && (*a_it != "fano"))
+            {
+                std::cout << "Unknown algorithm " << *a_it << std::endl;
+                status = false;
+            }
+        }
+
+        if ((k_constraints.size() == 0) || (generator_polys.size() == 0))
+        {
+            std::cout << "Code must be given with -k and -g" << std::endl;
+            status = false;
+        }
+        else if ((snr_values.size() == 0) || (algorithms.size() == 0) || (edge_biases.size() == 0) || (nb_frames == 0) || (message_length == 0))
+        {
+            std::cout << "Nothing to sweep" << std::endl;
+            status = false;
+        }
+    }
+
+    return status;
+}
+
+// ================================================================================================
+bool Options::parse_generator_polys_data(std::string generator_polys_data_str)
+{
+    std::vector<std::string> g_strings;
+
+    if (!extract_vector(g_strings, ":", generator_polys_data_str))
+    {
+        std::cerr << "Invalid generator polynomials specification" << std::endl;
+        return false;
+    }
+
+    std::vector<std::string>::const_iterator gs_it = g_strings.begin();
+
+    for (; gs_it != g_strings.end(); ++gs_it)
+    {
+        std::vector<unsigned int> g;
+
+        if (extract_vector<unsigned int>(g, ",", *gs_it))
+        {
+            generator_polys.push_back(g);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ================================================================================================
+// synthetic frame behind the AWGN power channel of FullTest
+struct Frame
+{
+    std::vector<unsigned int> input_symbols; //!< Input symbols including the zero tail
+    std::vector<float> powers; //!< Reliability matrix before normalization
+};
+
+// ================================================================================================
+void make_frame(Frame& frame, ccsoft::CC_Encoding<unsigned int, unsigned int>& encoding, unsigned int message_length, float snr_dB)
+{
+    double std_dev  = 1.0 / pow(10.0, (snr_dB/10.0)); // Standard deviation for power AWGN
+    unsigned int nb_symbols = 1<<encoding.get_n();
+    unsigned int in_symbols_nb = 1<<encoding.get_k();
+
+    encoding.clear();
+    frame.input_symbols.clear();
+
+    for (unsigned int i=0; i<message_length; i++)
+    {
+        frame.input_symbols.push_back(ur.rand_int(in_symbols_nb));
+    }
+
+    for (unsigned int i=0; i<encoding.get_m()-1; i++)
+    {
+        frame.input_symbols.push_back(0);
+    }
+
+    frame.powers.resize(nb_symbols*frame.input_symbols.size());
+
+    for (unsigned int i=0; i<frame.input_symbols.size(); i++)
+    {
+        unsigned int out_symbol;
+        encoding.encode(frame.input_symbols[i], out_symbol);
+
+        for (unsigned int si=0; si<nb_symbols; si++)
+        {
+            float amplitude = (si == out_symbol ? 1.0 : 0.0) + std_dev * ur.rand_gaussian();
+            frame.powers[i*nb_symbols + si] = amplitude * amplitude;
+        }
+    }
+}
+
+// ================================================================================================
+ccsoft::CC_SequentialDecoding<unsigned int, unsigned int> *create_decoder(const Options& options, const ccsoft::CC_PolicyEntry& entry)
+{
+    ccsoft::CC_SequentialDecoding<unsigned int, unsigned int> *cc_decoding;
+
+    if (entry.algorithm_type == ccsoft::CC_PolicyEntry::Algorithm_Fano)
+    {
+        cc_decoding = new ccsoft::CC_FanoDecoding<unsigned int, unsigned int>(options.k_constraints,
+                options.generator_polys,
+                entry.fano_init_metric,
+                entry.fano_delta_metric,
+                0,
+                entry.fano_delta_init_threshold);
+    }
+    else
+    {
+        cc_decoding = new ccsoft::CC_StackDecoding<unsigned int, unsigned int>(options.k_constraints, options.generator_polys);
+    }
+
+    cc_decoding->set_edge_bias(entry.edge_bias);
+
+    if (entry.node_limit > 0)
+    {
+        cc_decoding->set_node_limit(entry.node_limit);
+    }
+
+    return cc_decoding;
+}
+
+// ================================================================================================
+// all parameter sets of the sweep
+void make_candidates(const Options& options, std::vector<ccsoft::CC_PolicyEntry>& candidates)
+{
+    std::vector<std::string>::const_iterator a_it = options.algorithms.begin();
+
+    for (; a_it != options.algorithms.end(); ++a_it)
+    {
+        bool fano = (*a_it == "fano");
+        unsigned int nb_init = (fano ? options.fano_init_metrics.size() : 1);
+        unsigned int nb_delta = (fano ? options.fano_delta_metrics.size() : 1);
+
+        for (unsigned int ib = 0; ib < options.edge_biases.size(); ib++)
+        {
+            for (unsigned int ii = 0; ii < nb_init; ii++)
+            {
+                for (unsigned int id = 0; id < nb_delta; id++)
+                {
+                    ccsoft::CC_PolicyEntry entry;
+                    entry.algorithm_type = (fano ? ccsoft::CC_PolicyEntry::Algorithm_Fano : ccsoft::CC_PolicyEntry::Algorithm_Stack);
+                    entry.edge_bias = options.edge_biases[ib];
+                    entry.node_limit = options.node_limit;
+
+                    if (fano)
+                    {
+                        entry.fano_init_metric = options.fano_init_metrics[ii];
+                        entry.fano_delta_metric = options.fano_delta_metrics[id];
+                    }
+
+                    candidates.push_back(entry);
+                }
+            }
+        }
+    }
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    if (!options.get_options(argc, argv))
+    {
+        std::cout << "Wrong options" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        ccsoft::CC_Encoding<unsigned int, unsigned int> encoding(options.k_constraints, options.generator_polys);
+        ccsoft::CC_DecodingPolicy policy;
+        std::vector<ccsoft::CC_PolicyEntry> candidates;
+        make_candidates(options, candidates);
+
+        if (options.has_seed)
+        {
+            ur.set_seed(options.seed);
+        }
+
+        std::cerr << "# snr_dB snr_estimate_dB algorithm edge_bias fano_init_metric fano_delta_metric fer cpu_ms_per_frame" << std::endl;
+
+        std::vector<float>::const_iterator snr_it = options.snr_values.begin();
+
+        for (; snr_it != options.snr_values.end(); ++snr_it)
+        {
+            // same frames for all parameters so that they are compared on the same noise
+            std::vector<Frame> frames(options.nb_frames);
+            double snr_estimate_sum = 0.0;
+
+            for (unsigned int i_f = 0; i_f < options.nb_frames; i_f++)
+            {
+                make_frame(frames[i_f], encoding, options.message_length, *snr_it);
+                ccsoft::CC_ReliabilityMatrix raw_relmat(encoding.get_n(), frames[i_f].input_symbols.size());
+
+                for (unsigned int i = 0; i < frames[i_f].input_symbols.size(); i++)
+                {
+                    raw_relmat.enter_symbol_data(&frames[i_f].powers[i*(1<<encoding.get_n())]);
+                }
+
+                snr_estimate_sum += ccsoft::CC_DecodingPolicy::estimate_snr_dB(raw_relmat);
+            }
+
+            float snr_estimate = snr_estimate_sum / options.nb_frames;
+            bool best_meets_target = false;
+            float best_fer = 2.0;
+            double best_cpu = 0.0;
+            ccsoft::CC_PolicyEntry best_entry;
+
+            std::vector<ccsoft::CC_PolicyEntry>::const_iterator c_it = candidates.begin();
+
+            for (; c_it != candidates.end(); ++c_it)
+            {
+                ccsoft::CC_SequentialDecoding<unsigned int, unsigned int> *cc_decoding = create_decoder(options, *c_it);
+                unsigned int nb_failed = 0;
+                std::clock_t start = std::clock();
+
+                for (unsigned int i_f = 0; i_f < options.nb_frames; i_f++)
+                {
+                    ccsoft::CC_ReliabilityMatrix relmat(encoding.get_n(), frames[i_f].input_symbols.size());
+                    std::vector<unsigned int> result;
+
+                    for (unsigned int i = 0; i < frames[i_f].input_symbols.size(); i++)
+                    {
+                        relmat.enter_symbol_data(&frames[i_f].powers[i*(1<<encoding.get_n())]);
+                    }
+
+                    relmat.normalize();
+
+                    try
+                    {
+                        if (!cc_decoding->decode(relmat, result) || (result != frames[i_f].input_symbols))
+                        {
+                            nb_failed++;
+                        }
+                    }
+                    catch (ccsoft::CCSoft_Exception& e) // e.g. Fano loop condition
+                    {
+                        nb_failed++;
+                    }
+                }
+
+                double cpu = ((double) (std::clock() - start)) / CLOCKS_PER_SEC / options.nb_frames;
+                float fer = ((float) nb_failed) / options.nb_frames;
+                bool meets_target = (nb_failed <= options.target_fer * options.nb_frames + 1e-6); // on counts to avoid rounding
+                delete cc_decoding;
+
+                std::cerr << *snr_it << " " << snr_estimate << " "
+                          << (c_it->algorithm_type == ccsoft::CC_PolicyEntry::Algorithm_Fano ? "fano" : "stack") << " "
+                          << c_it->edge_bias << " " << c_it->fano_init_metric << " " << c_it->fano_delta_metric << " "
+                          << fer << " " << cpu*1000.0 << std::endl;
+
+                // cheapest among those meeting the target else the lowest error rate
+                if ((meets_target && (!best_meets_target || (cpu < best_cpu)))
+                    || (!meets_target && !best_meets_target && ((fer < best_fer) || ((fer == best_fer) && (cpu < best_cpu)))))
+                {
+                    best_meets_target = meets_target;
+                    best_fer = fer;
+                    best_cpu = cpu;
+                    best_entry = *c_it;
+                }
+            }
+
+            best_entry.snr_dB = snr_estimate;
+            policy.add_entry(best_entry);
+        }
+
+        if (options.policy_filename.size() > 0)
+        {
+            policy.save(options.policy_filename);
+        }
+        else
+        {
+            policy.save(std::cout);
+        }
+    }
+    catch (ccsoft::CCSoft_Exception& e)
+    {
+        std::cout << "CCSoft exception caught: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+     Tests of the parallel stack decoding against the stack decoding on
+     noisy frames
+
+*/
+
+#include "CC_Encoding.h"
+#include "CC_StackDecoding.h"
+#include "CC_ParallelStackDecoding.h"
+#include "CCSoft_Exception.h"
+#include "CC_ReliabilityMatrix.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdlib.h>
+
+static const unsigned int message_length = 120; //!< including the tail of zeros
+static const unsigned int nb_frames = 20;
+static const float noise_std_dev = 0.65;        //!< of the BPSK samples
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// gaussian random number (Box-Muller)
+double gaussian()
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0*log(u1)) * cos(2.0*M_PI*u2);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    try
+    {
+        // NASA standard (2,1,7) code
+        std::vector<unsigned int> ks(1,7);
+        std::vector<unsigned int> g;
+        g.push_back(109);
+        g.push_back(79);
+        std::vector<std::vector<unsigned int> > gs(1, g);
+
+        ccsoft::CC_Encoding<unsigned int, unsigned int> encoding(ks, gs);
+        ccsoft::CC_StackDecoding<unsigned int, unsigned int> stack_decoder(ks, gs);
+        ccsoft::CC_ParallelStackDecoding<unsigned int, unsigned int> single_decoder(ks, gs, 1, 1);
+        ccsoft::CC_ParallelStackDecoding<unsigned int, unsigned int> parallel_decoder(ks, gs, 4, 2);
+        stack_decoder.set_edge_bias(-1.0);
+        single_decoder.set_edge_bias(-1.0);
+        parallel_decoder.set_edge_bias(-1.0);
+
+        srand(1);
+        unsigned int nb_single_same = 0;
+        unsigned int nb_parallel_ok = 0;
+        unsigned int nb_stack_ok = 0;
+
+        for (unsigned int fi=0; fi<nb_frames; fi++)
+        {
+            ccsoft::CC_ReliabilityMatrix relmat(2, message_length, true);
+            std::vector<unsigned int> message;
+            unsigned int out_symbol;
+            float llrs[2];
+
+            encoding.clear();
+
+            for (unsigned int i=0; i<message_length; i++)
+            {
+                message.push_back(i < message_length-6 ? rand() % 2 : 0);
+                encoding.encode(message.back(), out_symbol);
+
+                for (unsigned int b=0; b<2; b++)
+                {
+                    double sample = ((out_symbol >> b) & 1 ? -1.0 : 1.0) + noise_std_dev*gaussian();
+                    llrs[b] = 2.0*sample / (noise_std_dev*noise_std_dev);
+                }
+
+                relmat.enter_symbol_data(llrs);
+            }
+
+            relmat.normalize();
+
+            std::vector<unsigned int> stack_decoded;
+            std::vector<unsigned int> single_decoded;
+            std::vector<unsigned int> parallel_decoded;
+            bool stack_ok = stack_decoder.decode(relmat, stack_decoded) && (stack_decoded == message);
+            bool single_ok = single_decoder.decode(relmat, single_decoded);
+            bool parallel_ok = parallel_decoder.decode(relmat, parallel_decoded) && (parallel_decoded == message);
+
+            // one worker with one queue is the sequential stack algorithm
+            if (single_ok && (single_decoded == stack_decoded)
+                && (single_decoder.get_score() == stack_decoder.get_score())
+                && (single_decoder.get_nb_nodes() == stack_decoder.get_nb_nodes()))
+            {
+                nb_single_same++;
+            }
+
+            nb_stack_ok += (stack_ok ? 1 : 0);
+            nb_parallel_ok += (parallel_ok ? 1 : 0);
+        }
+
+        bool single_same = (nb_single_same == nb_frames);
+        std::cout << "single worker same as stack: " << nb_single_same << "/" << nb_frames << (single_same ? " OK" : " KO") << std::endl;
+        nb_errors += (single_same ? 0 : 1);
+
+        bool parallel_same = (nb_parallel_ok >= nb_stack_ok);
+        std::cout << "4 workers frames decoded: " << nb_parallel_ok << " stack: " << nb_stack_ok << (parallel_same ? " OK" : " KO") << std::endl;
+        nb_errors += (parallel_same ? 0 : 1);
+    }
+    catch (ccsoft::CCSoft_Exception& e)
+    {
+        std::cout << "CCSoft exception caught: " << e.what() << std::endl;
+        nb_errors++;
+    }
+
+    std::cout << nb_errors << " error(s)" << std::endl;
+    return (nb_errors == 0 ? 0 : 1);
+}
@@ -0,0 +1,401 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of CCSoft. A Convolutional Codes Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+     Tests of the decoding into caller owned packed buffers against the
+     decoding into vectors, of the bounded stack, of the bit metric mode, of
+     the hard decision mode, of the lazy successors and of the decoding trace
+
+*/
+
+#include "CC_Encoding.h"
+#include "CC_StackDecoding.h"
+#include "CC_FanoDecoding.h"
+#include "CCSoft_Exception.h"
+#include "CC_ReliabilityMatrix.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmath>
+
+static const unsigned int message_length = 40; //!< including the tail of zeros
+static const unsigned int stride = 3;          //!< interleaving of the output buffers
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// decode into a vector, a packed 8 bit buffer and an interleaved 16 bit buffer and compare
+template<typename T_Decoder>
+void check_decoder(const char *title, T_Decoder& decoder, const ccsoft::CC_ReliabilityMatrix& relmat, const std::vector<unsigned char>& message)
+{
+    std::vector<unsigned char> decoded_vector;
+    uint8_t decoded_packed[message_length];
+    uint16_t decoded_interleaved[message_length*stride];
+    bool ok = true;
+
+    for (unsigned int i=0; i<message_length*stride; i++)
+    {
+        decoded_interleaved[i] = 0xFFFF;
+    }
+
+    ok = ok && decoder.decode(relmat, decoded_vector);
+    ok = ok && decoder.decode(relmat, decoded_packed);
+    ok = ok && decoder.decode(relmat, decoded_interleaved+1, stride);
+    ok = ok && (decoded_vector == message);
+
+    for (unsigned int i=0; ok && (i<message_length); i++)
+    {
+        ok = (decoded_packed[i] == message[i])
+            && (decoded_interleaved[i*stride] == 0xFFFF)
+            && (decoded_interleaved[i*stride+1] == message[i])
+            && (decoded_interleaved[i*stride+2] == 0xFFFF);
+    }
+
+    std::cout << title << (ok ? " OK" : " KO") << std::endl;
+    nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    try
+    {
+        // (2,1,3) code of Han & Chen example 1
+        std::vector<unsigned int> ks(1,3);
+        std::vector<unsigned char> g;
+        g.push_back(7);
+        g.push_back(5);
+        std::vector<std::vector<unsigned char> > gs(1, g);
+
+        ccsoft::CC_Encoding<unsigned char, unsigned char> encoding(ks, gs);
+        ccsoft::CC_ReliabilityMatrix relmat(2, message_length);
+        std::vector<unsigned char> decoded_lazy_ref;
+        ccsoft::CC_ReliabilityMatrix bit_relmat(2, message_length, true);
+        ccsoft::CC_ReliabilityMatrix hard_relmat(2, message_length, ccsoft::CC_HardDecisionMetric(0.05));
+        std::vector<unsigned char> received;
+        std::vector<unsigned char> message;
+        float soft_array[4] = {0.01, 0.01, 0.01, 0.01};
+        float llrs[2];
+        unsigned char out_symbol;
+
+        srand(1);
+
+        for (unsigned int i=0; i<message_length; i++)
+        {
+            message.push_back(i < message_length-2 ? rand() % 2 : 0);
+            encoding.encode(message.back(), out_symbol);
+            soft_array[out_symbol] = 0.97;
+            relmat.enter_symbol_data(soft_array);
+            soft_array[out_symbol] = 0.01;
+            llrs[0] = (out_symbol & 1 ? -3.0 : 3.0) + (i % 8 == 4 ? (out_symbol & 1 ? 4.0 : -4.0) : 0.0); // some wrong hard decisions
+            llrs[1] = (out_symbol & 2 ? -3.0 : 3.0);
+            bit_relmat.enter_symbol_data(llrs);
+            received.push_back(out_symbol ^ (i % 8 == 4 ? 1 : 0));
+            hard_relmat.enter_hard_symbol(received.back());
+        }
+
+        relmat.normalize();
+        bit_relmat.normalize();
+
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> stack_decoder(ks, gs);
+        ccsoft::CC_FanoDecoding<unsigned char, unsigned char> fano_decoder(ks, gs, -1.0, 1.0);
+        fano_decoder.set_edge_bias(-0.5);
+
+        check_decoder("stack", stack_decoder, relmat, message);
+        check_decoder("fano", fano_decoder, relmat, message);
+
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> bounded_stack_decoder(ks, gs);
+        bounded_stack_decoder.set_max_stack_size(4);
+        check_decoder("bounded stack", bounded_stack_decoder, relmat, message);
+        bool evicted = (bounded_stack_decoder.get_nb_evictions() > 0) && (bounded_stack_decoder.get_stack_size() <= 4);
+        std::cout << "evictions = " << bounded_stack_decoder.get_nb_evictions() << (evicted ? " OK" : " KO") << std::endl;
+        nb_errors += (evicted ? 0 : 1);
+
+        // lazy successors: same path and score with fewer nodes
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> lazy_stack_decoder(ks, gs);
+        lazy_stack_decoder.set_lazy_successors(true);
+        check_decoder("lazy stack", lazy_stack_decoder, relmat, message);
+        stack_decoder.decode(relmat, decoded_lazy_ref);
+        bool lazy_ok = (lazy_stack_decoder.get_score() == stack_decoder.get_score())
+            && (lazy_stack_decoder.get_nb_nodes() < stack_decoder.get_nb_nodes());
+        std::cout << "lazy nodes = " << lazy_stack_decoder.get_nb_nodes() << " / " << stack_decoder.get_nb_nodes() << (lazy_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (lazy_ok ? 0 : 1);
+
+        bool metric_ok = true;
+
+        for (unsigned int ic=0; ic<message_length; ic++) // bit metric against the log2 of the product of bit probabilities
+        {
+            for (unsigned int s=0; s<4; s++)
+            {
+                double log2_p = 0.0;
+
+                for (unsigned int b=0; b<2; b++)
+                {
+                    double p0 = 1.0 / (1.0 + exp(-bit_relmat(b, ic)));
+                    log2_p += log2((s >> b) & 1 ? 1.0 - p0 : p0);
+                }
+
+                metric_ok = metric_ok && (fabs(bit_relmat.get_bit_metric(s, ic) - log2_p) < 1e-4);
+            }
+        }
+
+        std::cout << "bit metric" << (metric_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (metric_ok ? 0 : 1);
+        check_decoder("stack bit metric", stack_decoder, bit_relmat, message);
+        check_decoder("lazy stack bit metric", lazy_stack_decoder, bit_relmat, message); // wrong hard decisions make the search back up
+        stack_decoder.decode(bit_relmat, decoded_lazy_ref);
+        lazy_ok = (lazy_stack_decoder.get_score() == stack_decoder.get_score()) && (lazy_stack_decoder.get_nb_nodes() < stack_decoder.get_nb_nodes());
+        std::cout << "lazy bit metric nodes = " << lazy_stack_decoder.get_nb_nodes() << " / " << stack_decoder.get_nb_nodes() << (lazy_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (lazy_ok ? 0 : 1);
+
+        // hard decisions: packed symbols, metrics in 1/16 of a bit and integer path metrics
+        bool hard_ok = true;
+        ccsoft::CC_ReliabilityMatrix hard_copy(hard_relmat);
+
+        for (unsigned int ic=0; ic<message_length; ic++)
+        {
+            hard_ok = hard_ok && (hard_copy.get_hard_symbol(ic) == received[ic]);
+
+            for (unsigned int s=0; s<4; s++)
+            {
+                int d = ((s ^ received[ic]) & 1) + (((s ^ received[ic]) >> 1) & 1);
+                float metric = (d*hard_relmat.get_hard_decision_metric().mismatch + (2-d)*hard_relmat.get_hard_decision_metric().match) / 16.0;
+                hard_ok = hard_ok && (hard_relmat.get_hard_metric(s, ic) == metric);
+            }
+        }
+
+        hard_copy.enter_erasure(3);
+        hard_ok = hard_ok && hard_copy.is_hard_erasure(3) && (hard_copy.get_hard_metric(received[3] ^ 3, 3) == 0.0) && !hard_relmat.is_hard_erasure(3);
+        std::cout << "hard metric" << (hard_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (hard_ok ? 0 : 1);
+        check_decoder("stack hard decision", stack_decoder, hard_relmat, message);
+        ccsoft::CC_FanoDecoding<unsigned char, unsigned char> hard_fano_decoder(ks, gs, -10.0, 1.0); // initial threshold below the dip of a wrong bit
+        hard_fano_decoder.set_edge_bias(-0.5);
+        check_decoder("fano hard decision", hard_fano_decoder, hard_relmat, message);
+        float scaled_score = stack_decoder.get_score() * 16.0;
+        hard_ok = (scaled_score == floor(scaled_score));
+        std::cout << "hard path metric = " << stack_decoder.get_score() << (hard_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (hard_ok ? 0 : 1);
+
+        // small ring that wraps: the last record is the solution and survives a dump roundtrip
+        ccsoft::CC_DecodingTrace trace(16);
+        std::vector<unsigned char> decoded;
+        stack_decoder.set_trace(&trace);
+        stack_decoder.decode(relmat, decoded);
+        stack_decoder.reset_trace();
+        std::stringstream dump;
+        std::vector<ccsoft::CC_TraceRecord> records;
+        uint64_t nb_dropped = 0;
+        bool trace_ok = (trace.size() == 16) && (trace.get_nb_dropped() > 0) && (trace[15].type == ccsoft::CC_Trace_Solution)
+            && (trace[15].depth == (int) message_length-1);
+        trace_ok = trace_ok && trace.write(dump) && ccsoft::CC_DecodingTrace::read(dump, records, nb_dropped);
+        trace_ok = trace_ok && (records.size() == 16) && (nb_dropped == trace.get_nb_dropped()) && (records[15].node_id == trace[15].node_id);
+        dump.str("CCTR");
+        trace_ok = trace_ok && !ccsoft::CC_DecodingTrace::read(dump, records, nb_dropped);
+        std::cout << "stack trace" << (trace_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (trace_ok ? 0 : 1);
+
+        ccsoft::CC_FanoDecoding<unsigned char, unsigned char> tight_fano_decoder(ks, gs, 0.0, 0.25); // threshold tightened along the path
+        tight_fano_decoder.set_edge_bias(-0.5);
+        ccsoft::CC_DecodingTrace fano_trace;
+        unsigned int nb_thresholds = 0;
+        tight_fano_decoder.set_trace(&fano_trace);
+        bool fano_decoded = tight_fano_decoder.decode(relmat, decoded) && (decoded == message);
+        tight_fano_decoder.reset_trace();
+
+        for (unsigned int i=0; i<fano_trace.size(); i++)
+        {
+            nb_thresholds += (fano_trace[i].type == ccsoft::CC_Trace_Threshold ? 1 : 0);
+        }
+
+        trace_ok = fano_decoded && (fano_trace.get_nb_dropped() == 0) && (nb_thresholds > 0) && (fano_trace[fano_trace.size()-1].type == ccsoft::CC_Trace_Solution);
+        std::cout << "fano trace" << (trace_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (trace_ok ? 0 : 1);
+
+        // k=2 code: input bit by input bit expansion finds the same path with fewer nodes
+        std::vector<unsigned int> ks2(2,2);
+        std::vector<unsigned char> g2;
+        g2.push_back(3);
+        g2.push_back(1);
+        g2.push_back(2);
+        std::vector<std::vector<unsigned char> > gs2(1, g2);
+        g2[0] = 1;
+        g2[1] = 3;
+        g2[2] = 3;
+        gs2.push_back(g2);
+
+        ccsoft::CC_Encoding<unsigned char, unsigned char> encoding2(ks2, gs2);
+        ccsoft::CC_ReliabilityMatrix relmat2(3, message_length);
+        std::vector<unsigned char> message2;
+        float soft_array2[8];
+
+        for (unsigned int i=0; i<message_length; i++)
+        {
+            message2.push_back(i < message_length-2 ? rand() % 4 : 0);
+            encoding2.encode(message2.back(), out_symbol);
+
+            for (unsigned int s=0; s<8; s++)
+            {
+                soft_array2[s] = (s == out_symbol ? 0.6 : 0.4/7);
+            }
+
+            relmat2.enter_symbol_data(soft_array2);
+        }
+
+        relmat2.normalize();
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> full_stack_decoder(ks2, gs2);
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> binary_stack_decoder(ks2, gs2);
+        full_stack_decoder.set_edge_bias(-1.0);
+        binary_stack_decoder.set_edge_bias(-1.0);
+        binary_stack_decoder.set_binary_expansion(true);
+        std::vector<unsigned char> decoded_full, decoded_binary;
+        bool binary_ok = full_stack_decoder.decode(relmat2, decoded_full) && binary_stack_decoder.decode(relmat2, decoded_binary);
+        binary_ok = binary_ok && (decoded_full == message2) && (decoded_binary == message2)
+            && (binary_stack_decoder.get_score() == full_stack_decoder.get_score())
+            && (binary_stack_decoder.get_nb_nodes() < full_stack_decoder.get_nb_nodes())
+            && (binary_stack_decoder.get_nb_partial_expansions() > 0);
+        std::cout << "binary expansion nodes = " << binary_stack_decoder.get_nb_nodes() << " / " << full_stack_decoder.get_nb_nodes()
+            << (binary_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (binary_ok ? 0 : 1);
+
+        ccsoft::CC_StackDecoding<unsigned char, unsigned char> lazy_stack_decoder2(ks2, gs2);
+        lazy_stack_decoder2.set_edge_bias(-1.0);
+        lazy_stack_decoder2.set_lazy_successors(true);
+        bool lazy2_ok = lazy_stack_decoder2.decode(relmat2, decoded_binary) && (decoded_binary == message2)
+            && (lazy_stack_decoder2.get_score() == full_stack_decoder.get_score())
+            && (lazy_stack_decoder2.get_nb_nodes()*2 < full_stack_decoder.get_nb_nodes())
+            && (lazy_stack_decoder2.get_stack_size()*2 < full_stack_decoder.get_stack_size());
+        std::cout << "lazy k=2 nodes = " << lazy_stack_decoder2.get_nb_nodes() << " / " << full_stack_decoder.get_nb_nodes()
+            << " stack = " << lazy_stack_decoder2.get_stack_size() << " / " << full_stack_decoder.get_stack_size() << (lazy2_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (lazy2_ok ? 0 : 1);
+
+        binary_stack_decoder.set_max_stack_size(8); // evictions of nodes and partial branches
+        binary_ok = binary_stack_decoder.decode(relmat2, decoded_binary) && (decoded_binary == message2) && (binary_stack_decoder.get_stack_size() <= 8);
+        std::cout << "bounded binary expansion" << (binary_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (binary_ok ? 0 : 1);
+
+        // known sync and pilot symbols: only admissible branches are created at their depths
+        std::vector<unsigned int> known_inputs(message_length, 0xF);
+        binary_stack_decoder.reset_max_stack_size();
+
+        for (unsigned int i=0; i<message_length; i++)
+        {
+            if ((i < 4) || (i % 4 == 0))
+            {
+                known_inputs[i] = 1 << message2[i];
+            }
+        }
+
+        binary_stack_decoder.decode(relmat2, decoded_binary);
+        unsigned int nodes_full = full_stack_decoder.get_nb_nodes();
+        unsigned int nodes_binary = binary_stack_decoder.get_nb_nodes();
+        unsigned int nodes_lazy = lazy_stack_decoder2.get_nb_nodes();
+        full_stack_decoder.set_input_constraints(known_inputs);
+        binary_stack_decoder.set_input_constraints(known_inputs);
+        lazy_stack_decoder2.set_input_constraints(known_inputs);
+        bool constraints_ok = full_stack_decoder.decode(relmat2, decoded_full) && (decoded_full == message2)
+            && (full_stack_decoder.get_nb_nodes() < nodes_full);
+        constraints_ok = constraints_ok && binary_stack_decoder.decode(relmat2, decoded_binary) && (decoded_binary == message2)
+            && (binary_stack_decoder.get_nb_nodes() < nodes_binary);
+        constraints_ok = constraints_ok && lazy_stack_decoder2.decode(relmat2, decoded_binary) && (decoded_binary == message2)
+            && (lazy_stack_decoder2.get_nb_nodes() <= nodes_lazy);
+        std::cout << "known symbols nodes = " << full_stack_decoder.get_nb_nodes() << " / " << nodes_full
+            << " binary = " << binary_stack_decoder.get_nb_nodes() << " / " << nodes_binary
+            << " lazy = " << lazy_stack_decoder2.get_nb_nodes() << " / " << nodes_lazy << (constraints_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (constraints_ok ? 0 : 1);
+
+        std::vector<unsigned int> known_head(8);
+        unsigned int nodes_fano;
+        fano_decoder.decode(relmat, decoded);
+        nodes_fano = fano_decoder.get_nb_nodes();
+
+        for (unsigned int i=0; i<known_head.size(); i++)
+        {
+            known_head[i] = 1 << message[i];
+        }
+
+        fano_decoder.set_input_constraints(known_head);
+        constraints_ok = fano_decoder.decode(relmat, decoded) && (decoded == message) && (fano_decoder.get_nb_nodes() < nodes_fano);
+        std::cout << "fano known symbols nodes = " << fano_decoder.get_nb_nodes() << " / " << nodes_fano << (constraints_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (constraints_ok ? 0 : 1);
+
+        bool thrown = false;
+        known_head[3] = 0;
+
+        try
+        {
+            fano_decoder.set_input_constraints(known_head);
+        }
+        catch (ccsoft::CCSoft_Exception& e)
+        {
+            thrown = true;
+        }
+
+        std::cout << "empty constraint" << (thrown ? " OK" : " KO") << std::endl;
+        nb_errors += (thrown ? 0 : 1);
+
+        // step by step: two decoders interleaved on one thread find the same paths as a run to completion
+        fano_decoder.reset_input_constraints();
+        full_stack_decoder.reset_input_constraints();
+        fano_decoder.decode(relmat, decoded);
+        float fano_score = fano_decoder.get_score();
+        full_stack_decoder.decode(relmat2, decoded);
+        float stack_score = full_stack_decoder.get_score();
+        unsigned int stack_nodes = full_stack_decoder.get_nb_nodes();
+        fano_decoder.start(relmat);
+        full_stack_decoder.start(relmat2);
+        ccsoft::CC_DecodeStatus fano_status = ccsoft::CC_Decode_Pending, stack_status = ccsoft::CC_Decode_Pending;
+        unsigned int nb_rounds = 0;
+
+        while ((fano_status == ccsoft::CC_Decode_Pending) || (stack_status == ccsoft::CC_Decode_Pending))
+        {
+            fano_status = fano_decoder.step(4);
+            stack_status = full_stack_decoder.step(4);
+            nb_rounds++;
+        }
+
+        std::vector<unsigned char> decoded_fano, decoded_stack;
+        bool step_ok = (nb_rounds > 1) && (fano_status == ccsoft::CC_Decode_Done) && (stack_status == ccsoft::CC_Decode_Done)
+            && fano_decoder.get_decoded_message(decoded_fano) && (decoded_fano == message) && (fano_decoder.get_score() == fano_score)
+            && full_stack_decoder.get_decoded_message(decoded_stack) && (decoded_stack == message2)
+            && (full_stack_decoder.get_score() == stack_score) && (full_stack_decoder.get_nb_nodes() == stack_nodes)
+            && (full_stack_decoder.step(4) == ccsoft::CC_Decode_Done);
+        std::cout << "step by step rounds = " << nb_rounds << (step_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (step_ok ? 0 : 1);
+
+        full_stack_decoder.set_node_limit(20);
+        full_stack_decoder.start(relmat2);
+
+        while ((stack_status = full_stack_decoder.step(4)) == ccsoft::CC_Decode_Pending)
+        {}
+
+        step_ok = (stack_status == ccsoft::CC_Decode_Failed) && !full_stack_decoder.get_decoded_message(decoded_stack);
+        std::cout << "step by step node limit" << (step_ok ? " OK" : " KO") << std::endl;
+        nb_errors += (step_ok ? 0 : 1);
+    }
+    catch (ccsoft::CCSoft_Exception& e)
+    {
+        std::cout << "CCSoft exception caught: " << e.what() << std::endl;
+        nb_errors++;
+    }
+
+    std::cout << nb_errors << " error(s)" << std::endl;
+    return (nb_errors == 0 ? 0 : 1);
+}
@@ -24,8 +24,11 @@
 #include "CC_ReliabilityMatrix.h"
 #include "CC_Encoding.h"
 #include "CC_StackDecoding.h"
+#include "CC_ParallelStackDecoding.h"
 #include "CC_FanoDecoding.h"
 #include "CCSoft_Exception.h"
+#include "CC_DecodingPolicy.h"
+#include "CC_ChannelModel.h"
 #include "URandom.h"
 
 #include <getopt.h>
@@ -35,6 +38,7 @@
 #include <sstream>
 #include <fstream>
 #include <cstring>
+#include <cmath>
 #include <cctype> // for toupper
 
 static URandom ur; // Global random generator object
@@ -129,6 +133,7 @@ public:
         dot_output(false),
         snr_dB(0),
         verbosity(0),
+        trace_output(false),
         indicator_int(0),
         print_seed(false),
         seed(0),
@@ -137,6 +142,9 @@ public:
         generate_random_symbols(false),
         node_limit(0),
         use_node_limit(false),
+        max_stack_size(0),
+        use_max_stack_size(false),
+        nb_workers(1),
         metric_limit(0.0),
         use_metric_limit(false),
         algorithm_type(Algorithm_Stack),
@@ -145,19 +153,33 @@ public:
         fano_tree_cache_size(0),
         edge_bias(0.0),
         fano_delta_init_threshold(0.0),
-        interleave(false)
+        interleave(false),
+        bit_metric(false),
+        hard_crossover_probability(0.0),
+        binary_expansion(false),
+        lazy_successors(false),
+        known_head(0),
+        fading(ccsoft::CC_ChannelModel::CC_Fading_None),
+        rician_factor(4.0),
+        fading_block(1),
+        burst(ccsoft::CC_ChannelModel::CC_Burst_None),
+        p_good_to_bad(0.0),
+        p_bad_to_good(1.0)
     {}
 
     ~Options()
     {}
 
     bool get_options(int argc, char *argv[]);
+    void apply_policy(const ccsoft::CC_PolicyEntry& policy_entry);
 
     bool make_noise;
     bool dot_output;
     float snr_dB;
     unsigned int verbosity;
     std::string dot_filename;
+    bool trace_output;
+    std::string trace_filename; //!< Binary decoding trace file
     std::vector<unsigned int> k_constraints;
     std::vector<std::vector<unsigned int> > generator_polys;
     std::vector<unsigned int> input_symbols;
@@ -169,6 +191,9 @@ public:
     bool generate_random_symbols;
     unsigned int node_limit;
     bool use_node_limit;
+    unsigned int max_stack_size;
+    bool use_max_stack_size;
+    unsigned int nb_workers; //!< Number of threads expanding the stack. Above one the parallel stack algorithm is used
     float metric_limit;
     bool use_metric_limit;
     Algorithm_type_t algorithm_type;
@@ -178,10 +203,24 @@ public:
     float edge_bias;
     float fano_delta_init_threshold;
     bool interleave;
+    bool bit_metric; //!< Decode from bit LLRs of a BPSK channel instead of symbol reliabilities
+    float hard_crossover_probability; //!< Decode from hard decisions on the bits of a BPSK channel with this metric crossover probability if not zero
+    bool binary_expansion; //!< Stack algorithm decides the input bits of k > 1 codes one at a time
+    bool lazy_successors; //!< Stack algorithm creates the successors of a node one at a time
+    unsigned int known_head; //!< Number of leading input symbols known to the decoder as for a sync word
+    std::string policy_filename; //!< Decoding policy file giving the decoding parameters from the estimated SNR
+    ccsoft::CC_ChannelModel::Fading fading;
+    float rician_factor;
+    unsigned int fading_block; //!< Number of symbols seeing the same fading gain
+    ccsoft::CC_ChannelModel::Burst burst;
+    float p_good_to_bad; //!< Probability to enter a burst
+    float p_bad_to_good; //!< Probability to leave a burst
 
 private:
     bool parse_generator_polys_data(std::string generator_polys_data_str);
     bool parse_algorithm_type(std::string algorithm_type_str);
+    bool parse_channel(std::string channel_str);
+    bool parse_burst(std::string burst_str);
 };
 
 // ================================================================================================
@@ -197,22 +236,34 @@ bool Options::get_options(int argc, char *argv[])
             // these options set a flag
             {"print-seed", no_argument, &indicator_int, 1},
             {"interleave", no_argument, &indicator_int, 1},
+            {"bit-metric", no_argument, &indicator_int, 1},
+            {"binary-expansion", no_argument, &indicator_int, 1},
+            {"lazy", no_argument, &indicator_int, 1},
             // these options do not set a flag
             {"snr", required_argument, 0, 'n'},
             {"verbosity", required_argument, 0, 'v'},
             {"dot-output", required_argument, 0, 'd'},
+            {"trace-output", required_argument, 0, 'T'},
             {"k-constraints", required_argument, 0, 'k'},
             {"gen-polys", required_argument, 0, 'g'},
             {"in-symbols", required_argument, 0, 'i'},
             {"nb-random-symbols", required_argument, 0, 'r'},
             {"seed", required_argument, 0, 's'},
             {"node-limit", required_argument, 0, 'N'},
+            {"max-stack-size", required_argument, 0, 'S'},
+            {"workers", required_argument, 0, 'w'},
             {"metric-limit", required_argument, 0, 'M'},
             {"algorithm-type", required_argument,0, 'a'},
+            {"policy", required_argument, 0, 'P'},
+            {"channel", required_argument, 0, 'C'},
+            {"fading-block", required_argument, 0, 'F'},
+            {"burst", required_argument, 0, 'b'},
+            {"hard", required_argument, 0, 'H'},
+            {"known-head", required_argument, 0, 'K'},
         };
 
         int option_index = 0;
-        c = getopt_long (argc, argv, "n:v:d:k:g:i:r:s:N:M:a:", long_options, &option_index);
+        c = getopt_long (argc, argv, "n:v:d:k:g:i:r:s:N:S:w:M:a:P:T:C:F:b:H:K:", long_options, &option_index);
 
         if (c == -1) // end of options
         {
@@ -230,6 +281,18 @@ bool Options::get_options(int argc, char *argv[])
                 {
                     interleave = true;
                 }
+                else if (strcmp("bit-metric", long_options[option_index].name) == 0)
+                {
+                    bit_metric = true;
+                }
+                else if (strcmp("binary-expansion", long_options[option_index].name) == 0)
+                {
+                    binary_expansion = true;
+                }
+                else if (strcmp("lazy", long_options[option_index].name) == 0)
+                {
+                    lazy_successors = true;
+                }
                 break;
             case 'n':
                 make_noise = true;
@@ -242,6 +305,10 @@ bool Options::get_options(int argc, char *argv[])
                 dot_output = true;
                 dot_filename = std::string(optarg);
                 break;
+            case 'T':
+                trace_output = true;
+                trace_filename = std::string(optarg);
+                break;
             case 'k':
                 status = extract_vector<unsigned int>(k_constraints, ",", std::string(optarg));
                 break;
@@ -263,6 +330,13 @@ bool Options::get_options(int argc, char *argv[])
                 status = extract_option<int, unsigned int>(node_limit, 'N');
                 use_node_limit = true;
                 break;
+            case 'S':
+                status = extract_option<int, unsigned int>(max_stack_size, 'S');
+                use_max_stack_size = true;
+                break;
+            case 'w':
+                status = extract_option<int, unsigned int>(nb_workers, 'w');
+                break;
             case 'M':
                 status = extract_option<float, float>(metric_limit, 'M');
                 use_metric_limit = true;
@@ -270,11 +344,120 @@ bool Options::get_options(int argc, char *argv[])
             case 'a':
                 status = parse_algorithm_type(std::string(optarg));
                 break;
+            case 'P':
+                policy_filename = std::string(optarg);
+                break;
+            case 'C':
+                status = parse_channel(std::string(optarg));
+                break;
+            case 'F':
+                status = extract_option<int, unsigned int>(fading_block, 'F');
+                break;
+            case 'b':
+                status = parse_burst(std::string(optarg));
+                break;
+            case 'H':
+                status = extract_option<double, float>(hard_crossover_probability, 'H');
+                break;
+            case 'K':
+                status = extract_option<int, unsigned int>(known_head, 'K');
+                break;
             case '?':
                 status = false;
                 break;
         }
     }
+
+    if (fading_block == 0)
+    {
+        std::cerr << "The fading block must be at least one symbol" << std::endl;
+        status = false;
+    }
+
+    return status;
+}
+
+// ================================================================================================
+// awgn, rayleigh or rician with an optional K factor (ex: rician:10)
+bool Options::parse_channel(std::string channel_str)
+{
+    std::vector<std::string> channel_strings;
+
+    if (!extract_vector(channel_strings, ":", channel_str) || (channel_strings.size() == 0))
+    {
+        std::cerr << "Invalid channel specification" << std::endl;
+        return false;
+    }
+
+    std::transform(channel_strings[0].begin(), channel_strings[0].end(), channel_strings[0].begin(), toupper);
+
+    if (channel_strings[0] == "AWGN")
+    {
+        fading = ccsoft::CC_ChannelModel::CC_Fading_None;
+    }
+    else if (channel_strings[0] == "RAYLEIGH")
+    {
+        fading = ccsoft::CC_ChannelModel::CC_Fading_Rayleigh;
+    }
+    else if (channel_strings[0] == "RICIAN")
+    {
+        fading = ccsoft::CC_ChannelModel::CC_Fading_Rician;
+
+        if (channel_strings.size() > 1)
+        {
+            std::vector<float> rician_parms;
+
+            if (!extract_vector(rician_parms, ",", channel_strings[1]) || (rician_parms.size() != 1))
+            {
+                std::cerr << "Invalid Rician factor specification" << std::endl;
+                return false;
+            }
+
+            rician_factor = rician_parms[0];
+        }
+    }
+    else
+    {
+        std::cerr << "Unrecognized channel type" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ================================================================================================
+// erasure or error followed by the probabilities to enter and leave a burst (ex: erasure:0.01,0.2)
+bool Options::parse_burst(std::string burst_str)
+{
+    std::vector<std::string> burst_strings;
+    std::vector<float> burst_parms;
+
+    if (!extract_vector(burst_strings, ":", burst_str) || (burst_strings.size() != 2)
+        || !extract_vector(burst_parms, ",", burst_strings[1]) || (burst_parms.size() != 2))
+    {
+        std::cerr << "Invalid burst specification" << std::endl;
+        return false;
+    }
+
+    std::transform(burst_strings[0].begin(), burst_strings[0].end(), burst_strings[0].begin(), toupper);
+
+    if (burst_strings[0] == "ERASURE")
+    {
+        burst = ccsoft::CC_ChannelModel::CC_Burst_Erasure;
+    }
+    else if (burst_strings[0] == "ERROR")
+    {
+        burst = ccsoft::CC_ChannelModel::CC_Burst_Error;
+    }
+    else
+    {
+        std::cerr << "Unrecognized burst type" << std::endl;
+        return false;
+    }
+
+    p_good_to_bad = burst_parms[0];
+    p_bad_to_good = burst_parms[1];
+    return true;
 }
 
 // ================================================================================================
@@ -389,27 +572,63 @@ bool Options::parse_algorithm_type(std::string algorithm_type_str)
 }
 
 // ================================================================================================
-void create_symbol_data(float *symbol_data,
-        unsigned int nb_symbols,
-        unsigned int out_symbol,
-        float snr_dB,
-        bool make_noise)
+void Options::apply_policy(const ccsoft::CC_PolicyEntry& policy_entry)
 {
-    double std_dev  = 1.0 / pow(10.0, (snr_dB/10.0)); // Standard deviation for power AWGN
+    algorithm_type = (policy_entry.algorithm_type == ccsoft::CC_PolicyEntry::Algorithm_Fano ? Algorithm_FanoLike : Algorithm_Stack);
+    edge_bias = policy_entry.edge_bias;
+    fano_init_metric = policy_entry.fano_init_metric;
+    fano_delta_metric = policy_entry.fano_delta_metric;
+    fano_delta_init_threshold = policy_entry.fano_delta_init_threshold;
+    use_node_limit = (policy_entry.node_limit > 0);
+    node_limit = policy_entry.node_limit;
+}
 
-    for (unsigned int si=0; si<nb_symbols; si++)
+// ================================================================================================
+ccsoft::CC_SequentialDecoding<unsigned int, unsigned int> *create_decoder(const Options& options)
+{
+    ccsoft::CC_SequentialDecoding<unsigned int, unsigned int> *cc_decoding;
+
+    if (options.algorithm_type == Options::Algorithm_FanoLike)
     {
-        if (si == out_symbol)
-        {
-            symbol_data[si] = 1.0 + (make_noise ? std_dev * ur.rand_gaussian() : 0.0);
-        }
-        else
+        cc_decoding = new ccsoft::CC_FanoDecoding<unsigned int, unsigned int>(options.k_constraints,
+                options.generator_polys,
+                options.fano_init_metric,
+                options.fano_delta_metric,
+                options.fano_tree_cache_size,
+                options.fano_delta_init_threshold);
+    }
+    else if (options.nb_workers > 1)
+    {
+        cc_decoding = new ccsoft::CC_ParallelStackDecoding<unsigned int, unsigned int>(options.k_constraints, options.generator_polys, options.nb_workers);
+    }
+    else
+    {
+        ccsoft::CC_StackDecoding<unsigned int, unsigned int> *stack_decoding = new ccsoft::CC_StackDecoding<unsigned int, unsigned int>(options.k_constraints, options.generator_polys);
+
+        if (options.use_max_stack_size)
         {
-            symbol_data[si] = 0.0 + (make_noise ? std_dev * ur.rand_gaussian() : 0.0);
+            stack_decoding->set_max_stack_size(options.max_stack_size);
         }
 
-        symbol_data[si] *= symbol_data[si];
+        stack_decoding->set_binary_expansion(options.binary_expansion);
+        stack_decoding->set_lazy_successors(options.lazy_successors);
+        cc_decoding = stack_decoding;
     }
+
+    cc_decoding->set_verbosity(options.verbosity);
+    cc_decoding->set_edge_bias(options.edge_bias);
+
+    if (options.use_node_limit)
+    {
+        cc_decoding->set_node_limit(options.node_limit);
+    }
+
+    if (options.use_metric_limit)
+    {
+        cc_decoding->set_metric_limit(options.metric_limit);
+    }
+
+    return cc_decoding;
 }
 
 // ================================================================================================
@@ -424,41 +643,17 @@ int main(int argc, char *argv[])
     
         try
         {
-            if (options.algorithm_type == Options::Algorithm_Stack)
-            {
-                cc_decoding = new ccsoft::CC_StackDecoding<unsigned int, unsigned int>(options.k_constraints, options.generator_polys);
-            }
-            else if (options.algorithm_type == Options::Algorithm_FanoLike)
-            {
-                cc_decoding = new ccsoft::CC_FanoDecoding<unsigned int, unsigned int>(options.k_constraints,
-                        options.generator_polys,
-                        options.fano_init_metric,
-                        options.fano_delta_metric,
-                        options.fano_tree_cache_size,
-                        options.fano_delta_init_threshold);
-            }
-            else
+            if ((options.algorithm_type != Options::Algorithm_Stack) && (options.algorithm_type != Options::Algorithm_FanoLike))
             {
                 std::cerr << "Unrecognized algorithm type" << std::endl;
                 return 1;
             }
-             
-            cc_decoding->set_verbosity(options.verbosity);
-            cc_decoding->set_edge_bias(options.edge_bias); 
+
+            cc_decoding = create_decoder(options);
             cc_decoding->get_encoding().print(std::cout);
             unsigned int out_symbols_nb = 1<<cc_decoding->get_encoding().get_n();
             unsigned int in_symbols_nb = 1<<cc_decoding->get_encoding().get_k();
 
-            if (options.use_node_limit)
-            {
-                cc_decoding->set_node_limit(options.node_limit);
-            }
-
-            if (options.use_metric_limit)
-            {
-                cc_decoding->set_metric_limit(options.metric_limit);
-            }
-
             if (options.has_seed)
             {
                 ur.set_seed(options.seed);
@@ -488,56 +683,89 @@ int main(int argc, char *argv[])
                     options.input_symbols.push_back(0);
                 }
 
-                ccsoft::CC_ReliabilityMatrix relmat(cc_decoding->get_encoding().get_n(), options.input_symbols.size());
-                unsigned int nb_symbols = 1<<cc_decoding->get_encoding().get_n();
-                float *symbol_data = new float[nb_symbols];
+                bool hard = (options.hard_crossover_probability > 0.0);
+                ccsoft::CC_ReliabilityMatrix relmat = (hard
+                        ? ccsoft::CC_ReliabilityMatrix(cc_decoding->get_encoding().get_n(), options.input_symbols.size(), ccsoft::CC_HardDecisionMetric(options.hard_crossover_probability))
+                        : ccsoft::CC_ReliabilityMatrix(cc_decoding->get_encoding().get_n(), options.input_symbols.size(), options.bit_metric));
+                ccsoft::CC_ChannelModel channel(options.bit_metric || hard ? ccsoft::CC_ChannelModel::CC_Modulation_BPSK : ccsoft::CC_ChannelModel::CC_Modulation_MFSK,
+                        options.make_noise ? options.snr_dB : INFINITY, options.fading);
+                channel.set_rician_factor(options.rician_factor);
+                channel.set_fading_block(options.fading_block);
+                channel.set_burst(options.burst, options.p_good_to_bad, options.p_bad_to_good);
+                ccsoft::CC_RandomStream channel_stream(ur.rand_uword());
+                std::vector<unsigned int> out_symbols;
 
                 std::ostringstream oos;
 
                 if (options.interleave)
                 {
-                	std::cout << "interleave" << std::endl;
-                	std::vector<unsigned int> out_symbols;
-
-					for (unsigned int i=0; i<options.input_symbols.size(); i++)
-					{
-						unsigned int out_symbol;
-						cc_decoding->get_encoding().encode(options.input_symbols[i], out_symbol);
-						out_symbols.push_back(out_symbol);
-						std::cout << options.input_symbols[i] << " ";
-						oos << out_symbol << " ";
-					}
-
-					cc_decoding->interleave(out_symbols);
-
-					for (unsigned int i=0; i<out_symbols.size(); i++)
-					{
-						create_symbol_data(symbol_data, nb_symbols, out_symbols[i], options.snr_dB, options.make_noise);
-						relmat.enter_symbol_data(symbol_data);
-					}
-
-					relmat.deinterleave();
+                    std::cout << "interleave" << std::endl;
                 }
-                else
+
+                for (unsigned int i=0; i<options.input_symbols.size(); i++)
+                {
+                    unsigned int out_symbol;
+                    cc_decoding->get_encoding().encode(options.input_symbols[i], out_symbol);
+                    out_symbols.push_back(out_symbol);
+                    std::cout << options.input_symbols[i] << " ";
+                    oos << out_symbol << " ";
+                }
+
+                if (options.interleave)
+                {
+                    cc_decoding->interleave(out_symbols);
+                }
+
+                unsigned int nb_burst_symbols = channel.transmit(out_symbols, relmat, channel_stream);
+
+                if (options.interleave)
                 {
-					for (unsigned int i=0; i<options.input_symbols.size(); i++)
-					{
-						unsigned int out_symbol;
-						cc_decoding->get_encoding().encode(options.input_symbols[i], out_symbol);
-						create_symbol_data(symbol_data, nb_symbols, out_symbol, options.snr_dB, options.make_noise);
-						relmat.enter_symbol_data(symbol_data);
-						std::cout << options.input_symbols[i] << " ";
-						oos << out_symbol << " ";
-					}
+                    relmat.deinterleave();
                 }
 
-                delete[] symbol_data;
                 std::cout << std::endl;
                 std::cout << oos.str() << std::endl;
 
+                if (nb_burst_symbols > 0)
+                {
+                    std::cout << nb_burst_symbols << " symbol(s) sent in bursts" << std::endl;
+                }
+
+                if (options.policy_filename.size() > 0) // decoder parameters from the estimated SNR
+                {
+                    ccsoft::CC_DecodingPolicy policy;
+                    policy.load(options.policy_filename);
+                    float snr_estimate = ccsoft::CC_DecodingPolicy::estimate_snr_dB(relmat);
+                    options.apply_policy(policy.lookup(snr_estimate));
+                    std::cout << "Policy: SNR estimate " << snr_estimate << " dB: "
+                              << (options.algorithm_type == Options::Algorithm_FanoLike ? "Fano" : "Stack")
+                              << " edge bias " << options.edge_bias << std::endl;
+                    delete cc_decoding;
+                    cc_decoding = create_decoder(options);
+                }
+
                 relmat.normalize();
                 std::vector<unsigned int> result;
 
+                if (options.known_head > 0) // only the sent symbol is admissible in the head
+                {
+                    std::vector<unsigned int> known_inputs;
+
+                    for (unsigned int i=0; (i<options.known_head) && (i<options.input_symbols.size()); i++)
+                    {
+                        known_inputs.push_back(1 << options.input_symbols[i]);
+                    }
+
+                    cc_decoding->set_input_constraints(known_inputs);
+                }
+
+                ccsoft::CC_DecodingTrace trace;
+
+                if (options.trace_output)
+                {
+                    cc_decoding->set_trace(&trace);
+                }
+
                 if (cc_decoding->decode(relmat, result))
                 {
                     print_vector<unsigned int>(result, std::cout);
@@ -566,6 +794,13 @@ int main(int argc, char *argv[])
                 {
                     std::cout << "Message cannot be decoded" << std::endl;
                 }
+
+                if (options.trace_output)
+                {
+                    std::ofstream trace_file(options.trace_filename.c_str(), std::ios::out | std::ios::binary);
+                    trace.write(trace_file);
+                    cc_decoding->reset_trace();
+                }
                 
                 cc_decoding->print_stats(std::cout, success);
                 std::cout << std::endl;
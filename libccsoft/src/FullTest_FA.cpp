@@ -129,6 +129,7 @@ public:
         dot_output(false),
         snr_dB(0),
         verbosity(0),
+        trace_output(false),
         indicator_int(0),
         print_seed(false),
         seed(0),
@@ -137,6 +138,8 @@ public:
         generate_random_symbols(false),
         node_limit(0),
         use_node_limit(false),
+        max_stack_size(0),
+        use_max_stack_size(false),
         metric_limit(0.0),
         use_metric_limit(false),
         algorithm_type(Algorithm_Stack),
@@ -145,7 +148,8 @@ public:
         fano_tree_cache_size(0),
         edge_bias(0.0),
         fano_delta_init_threshold(0.0),
-        interleave(false)
+        interleave(false),
+        bit_metric(false)
     {}
 
     ~Options()
@@ -158,6 +162,8 @@ public:
     float snr_dB;
     unsigned int verbosity;
     std::string dot_filename;
+    bool trace_output;
+    std::string trace_filename; //!< Binary decoding trace file
     std::vector<unsigned int> k_constraints;
     std::vector<std::vector<unsigned int> > generator_polys;
     std::vector<unsigned int> input_symbols;
@@ -169,6 +175,8 @@ public:
     bool generate_random_symbols;
     unsigned int node_limit;
     bool use_node_limit;
+    unsigned int max_stack_size;
+    bool use_max_stack_size;
     float metric_limit;
     bool use_metric_limit;
     Algorithm_type_t algorithm_type;
@@ -178,6 +186,7 @@ public:
     float edge_bias;
     float fano_delta_init_threshold;
     bool interleave;
+    bool bit_metric; //!< Decode from bit LLRs of a BPSK channel instead of symbol reliabilities
 
 private:
     bool parse_generator_polys_data(std::string generator_polys_data_str);
@@ -197,22 +206,25 @@ bool Options::get_options(int argc, char *argv[])
             // these options set a flag
             {"print-seed", no_argument, &indicator_int, 1},
             {"interleave", no_argument, &indicator_int, 1},
+            {"bit-metric", no_argument, &indicator_int, 1},
             // these options do not set a flag
             {"snr", required_argument, 0, 'n'},
             {"verbosity", required_argument, 0, 'v'},
             {"dot-output", required_argument, 0, 'd'},
+            {"trace-output", required_argument, 0, 'T'},
             {"k-constraints", required_argument, 0, 'k'},
             {"gen-polys", required_argument, 0, 'g'},
             {"in-symbols", required_argument, 0, 'i'},
             {"nb-random-symbols", required_argument, 0, 'r'},
             {"seed", required_argument, 0, 's'},
             {"node-limit", required_argument, 0, 'N'},
+            {"max-stack-size", required_argument, 0, 'S'},
             {"metric-limit", required_argument, 0, 'M'},
             {"algorithm-type", required_argument,0, 'a'},
         };
 
         int option_index = 0;
-        c = getopt_long (argc, argv, "n:v:d:k:g:i:r:s:N:M:a:", long_options, &option_index);
+        c = getopt_long (argc, argv, "n:v:d:k:g:i:r:s:N:S:M:a:T:", long_options, &option_index);
 
         if (c == -1) // end of options
         {
@@ -230,6 +242,10 @@ bool Options::get_options(int argc, char *argv[])
                 {
                     interleave = true;
                 }
+                else if (strcmp("bit-metric", long_options[option_index].name) == 0)
+                {
+                    bit_metric = true;
+                }
                 break;
             case 'n':
                 make_noise = true;
@@ -242,6 +258,10 @@ bool Options::get_options(int argc, char *argv[])
                 dot_output = true;
                 dot_filename = std::string(optarg);
                 break;
+            case 'T':
+                trace_output = true;
+                trace_filename = std::string(optarg);
+                break;
             case 'k':
                 status = extract_vector<unsigned int>(k_constraints, ",", std::string(optarg));
                 break;
@@ -263,6 +283,10 @@ bool Options::get_options(int argc, char *argv[])
                 status = extract_option<int, unsigned int>(node_limit, 'N');
                 use_node_limit = true;
                 break;
+            case 'S':
+                status = extract_option<int, unsigned int>(max_stack_size, 'S');
+                use_max_stack_size = true;
+                break;
             case 'M':
                 status = extract_option<float, float>(metric_limit, 'M');
                 use_metric_limit = true;
@@ -275,6 +299,8 @@ bool Options::get_options(int argc, char *argv[])
                 break;
         }
     }
+
+    return status;
 }
 
 // ================================================================================================
@@ -412,6 +438,22 @@ void create_symbol_data(float *symbol_data,
     }
 }
 
+// ================================================================================================
+void create_bit_data(float *bit_llrs,
+        unsigned int nb_bits,
+        unsigned int out_symbol,
+        float snr_dB,
+        bool make_noise)
+{
+    double std_dev  = 1.0 / pow(10.0, (snr_dB/10.0)); // Standard deviation for power AWGN
+
+    for (unsigned int bi=0; bi<nb_bits; bi++)
+    {
+        double sample = ((out_symbol >> bi) & 1 ? -1.0 : 1.0) + (make_noise ? std_dev * ur.rand_gaussian() : 0.0); // BPSK bit 0 -> +1
+        bit_llrs[bi] = 2.0 * sample / (std_dev * std_dev);
+    }
+}
+
 // ================================================================================================
 int main(int argc, char *argv[])
 {
@@ -426,7 +468,14 @@ int main(int argc, char *argv[])
         {
             if (options.algorithm_type == Options::Algorithm_Stack)
             {
-                cc_decoding = new ccsoft::CC_StackDecoding_FA<unsigned int, unsigned int, 1>(options.k_constraints, options.generator_polys);
+                ccsoft::CC_StackDecoding_FA<unsigned int, unsigned int, 1> *stack_decoding = new ccsoft::CC_StackDecoding_FA<unsigned int, unsigned int, 1>(options.k_constraints, options.generator_polys);
+
+                if (options.use_max_stack_size)
+                {
+                    stack_decoding->set_max_stack_size(options.max_stack_size);
+                }
+
+                cc_decoding = stack_decoding;
             }
             else if (options.algorithm_type == Options::Algorithm_FanoLike)
             {
@@ -488,7 +537,7 @@ int main(int argc, char *argv[])
                     options.input_symbols.push_back(0);
                 }
 
-                ccsoft::CC_ReliabilityMatrix relmat(cc_decoding->get_encoding().get_n(), options.input_symbols.size());
+                ccsoft::CC_ReliabilityMatrix relmat(cc_decoding->get_encoding().get_n(), options.input_symbols.size(), options.bit_metric);
                 unsigned int nb_symbols = 1<<cc_decoding->get_encoding().get_n();
                 float *symbol_data = new float[nb_symbols];
 
@@ -512,7 +561,15 @@ int main(int argc, char *argv[])
 
 					for (unsigned int i=0; i<out_symbols.size(); i++)
 					{
-						create_symbol_data(symbol_data, nb_symbols, out_symbols[i], options.snr_dB, options.make_noise);
+						if (options.bit_metric)
+						{
+							create_bit_data(symbol_data, cc_decoding->get_encoding().get_n(), out_symbols[i], options.snr_dB, options.make_noise);
+						}
+						else
+						{
+							create_symbol_data(symbol_data, nb_symbols, out_symbols[i], options.snr_dB, options.make_noise);
+						}
+
 						relmat.enter_symbol_data(symbol_data);
 					}
 
@@ -525,7 +582,16 @@ int main(int argc, char *argv[])
 					{
 						unsigned int out_symbol;
 						cc_decoding->get_encoding().encode(options.input_symbols[i], out_symbol);
-						create_symbol_data(symbol_data, nb_symbols, out_symbol, options.snr_dB, options.make_noise);
+
+						if (options.bit_metric)
+						{
+							create_bit_data(symbol_data, cc_decoding->get_encoding().get_n(), out_symbol, options.snr_dB, options.make_noise);
+						}
+						else
+						{
+							create_symbol_data(symbol_data, nb_symbols, out_symbol, options.snr_dB, options.make_noise);
+						}
+
 						relmat.enter_symbol_data(symbol_data);
 						std::cout << options.input_symbols[i] << " ";
 						oos << out_symbol << " ";
@@ -538,6 +604,12 @@ int main(int argc, char *argv[])
 
                 relmat.normalize();
                 std::vector<unsigned int> result;
+                ccsoft::CC_DecodingTrace trace;
+
+                if (options.trace_output)
+                {
+                    cc_decoding->set_trace(&trace);
+                }
 
                 if (cc_decoding->decode(relmat, result))
                 {
@@ -567,6 +639,13 @@ int main(int argc, char *argv[])
                 {
                     std::cout << "Message cannot be decoded" << std::endl;
                 }
+
+                if (options.trace_output)
+                {
+                    std::ofstream trace_file(options.trace_filename.c_str(), std::ios::out | std::ios::binary);
+                    trace.write(trace_file);
+                    cc_decoding->reset_trace();
+                }
                 
                 cc_decoding->print_stats(std::cout, success);
                 std::cout << std::endl;
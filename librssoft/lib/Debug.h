@@ -17,7 +17,7 @@
  along with this program; if not, write to the Free Software
  Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
 
- Debug log output macro
+ Debug log output and debug only check macros
 
 */
 #ifndef __DEBUG_H__
@@ -25,8 +25,10 @@
 
 #ifdef _DEBUG
 #define DEBUG_OUT(condition, str) if (condition) { std::cout << str; };
+#define DEBUG_CHECK(condition, exception) if (!(condition)) { throw exception; };
 #else
 #define DEBUG_OUT(condition, str) 
+#define DEBUG_CHECK(condition, exception)
 #endif
 
 #endif // __DEBUG_H__
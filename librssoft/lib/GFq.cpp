@@ -52,7 +52,7 @@ namespace gf
 
 // ================================================================================================
 GFq::GFq(const int pwr, const GF2_Polynomial& _primitive_poly) :
-		power(pwr), field_size((1 << power) - 1), primitive_poly(_primitive_poly)
+		power(pwr), field_size((1 << power) - 1), primitive_poly(_primitive_poly), owns_tables(true)
 {
 	if (primitive(primitive_poly, pwr))
 	{
@@ -82,20 +82,7 @@ GFq::GFq(const int pwr, const GF2_Polynomial& _primitive_poly) :
 
 		#endif
 
-			prim_poly_hash = 0xAAAAAAAA;
-			unsigned int prim_poly_mono_power = 1;
-
-			for (unsigned int i = 0; i <= power; i++)
-			{
-				if (i < power)
-				{
-					prim_poly_hash += ((i & 1) == 0) ? (  (prim_poly_hash <<  7) ^ primitive_poly[i].uint_value() ^ (prim_poly_hash >> 3)) :
-									  (~((prim_poly_hash << 11) ^ primitive_poly[i].uint_value() ^ (prim_poly_hash >> 5)));
-				}
-
-				prim_poly_mono_power <<= 1;
-			}
-
+			hash_primitive_poly();
 			generate_field();
 	}
 	else
@@ -105,9 +92,43 @@ GFq::GFq(const int pwr, const GF2_Polynomial& _primitive_poly) :
 }
 
 
+// ================================================================================================
+GFq::GFq(const int pwr, const GF2_Polynomial& _primitive_poly, const GFq_Tables& tables) :
+		power(pwr), field_size((1 << power) - 1), primitive_poly(_primitive_poly), owns_tables(false)
+{
+	alpha_to = const_cast<GFq_Symbol*>(tables.alpha_to);
+	index_of = const_cast<GFq_Symbol*>(tables.index_of);
+
+#if !defined(NO_GFLUT)
+
+	mul_table = new GFq_Symbol*[(field_size + 1)];
+	div_table = new GFq_Symbol*[(field_size + 1)];
+	exp_table = new GFq_Symbol*[(field_size + 1)];
+	mul_inverse = const_cast<GFq_Symbol*>(tables.mul_inverse);
+
+	for (unsigned int i = 0; i < (field_size + 1); i++) // rows point into the flat tables
+	{
+		mul_table[i] = const_cast<GFq_Symbol*>(tables.mul_table + i*(field_size + 1));
+		div_table[i] = const_cast<GFq_Symbol*>(tables.div_table + i*(field_size + 1));
+		exp_table[i] = const_cast<GFq_Symbol*>(tables.exp_table + i*(field_size + 1));
+	}
+
+#else
+
+	mul_table = new GFq_Symbol *[1];
+	div_table = new GFq_Symbol *[1];
+	exp_table = new GFq_Symbol *[1];
+	mul_inverse = const_cast<GFq_Symbol*>(tables.mul_inverse);
+
+#endif
+
+	hash_primitive_poly();
+}
+
+
 // ================================================================================================
 GFq::GFq(const GFq& gf) :
-		primitive_poly(gf.primitive_poly)
+		primitive_poly(gf.primitive_poly), owns_tables(true)
 {
 	power = gf.power;
 	field_size = gf.field_size;
@@ -134,10 +155,6 @@ GFq::GFq(const GFq& gf) :
 
 	memcpy(mul_inverse, gf.mul_inverse, (field_size + 1) * sizeof(GFq_Symbol) * 2);
 
-	memcpy(mul_table, gf.mul_table, (field_size + 1) * sizeof(GFq_Symbol*));
-	memcpy(div_table, gf.div_table, (field_size + 1) * sizeof(GFq_Symbol*));
-	memcpy(exp_table, gf.exp_table, (field_size + 1) * sizeof(GFq_Symbol*));
-
 	for (unsigned int i = 0; i < (field_size + 1); i++)
 	{
 		memcpy(mul_table[i], gf.mul_table[i], (field_size + 1) * sizeof(GFq_Symbol));
@@ -152,68 +169,31 @@ GFq::GFq(const GFq& gf) :
 // ================================================================================================
 GFq::~GFq()
 {
-	if (alpha_to != NULL)
+	if (owns_tables)
 	{
 		delete[] alpha_to;
-	}
-	if (index_of != NULL)
-	{
 		delete[] index_of;
 	}
 
 #if !defined(NO_GFLUT)
 
-	for (unsigned int i = 0; i < (field_size + 1); i++)
+	if (owns_tables)
 	{
-		if (mul_table[i] != NULL)
+		for (unsigned int i = 0; i < (field_size + 1); i++)
 		{
 			delete[] mul_table[i];
-		}
-		if (div_table[i] != NULL)
-		{
 			delete[] div_table[i];
-		}
-		if (exp_table[i] != NULL)
-		{
 			delete[] exp_table[i];
 		}
-	}
-
-	if (mul_table != NULL)
-	{
-		delete[] mul_table;
-	}
-
-	if (div_table != NULL)
-	{
-		delete[] div_table;
-	}
 
-	if (exp_table != NULL)
-	{
-		delete[] exp_table;
-	}
-
-	if (mul_inverse != NULL)
-	{
 		delete[] mul_inverse;
 	}
 
-#endif
-}
+	delete[] mul_table;
+	delete[] div_table;
+	delete[] exp_table;
 
-
-// ================================================================================================
-bool GFq::operator==(const GFq& gf) const
-{
-	return ((this->power == gf.power) && (this->prim_poly_hash == gf.prim_poly_hash));
-}
-
-
-// ================================================================================================
-bool GFq::operator!=(const GFq& gf) const
-{
-	return ((this->power != gf.power) || (this->prim_poly_hash != gf.prim_poly_hash));
+#endif
 }
 
 
@@ -225,45 +205,44 @@ GFq& GFq::operator=(const GFq& gf)
 		return *this;
 	}
 
-	if (alpha_to != NULL)
+	if (owns_tables)
 	{
 		delete[] alpha_to;
+		delete[] index_of;
 	}
 
-	if (index_of != NULL)
+#if !defined(NO_GFLUT)
+
+	if (owns_tables)
 	{
-		delete[] index_of;
+		for (unsigned int i = 0; i < (field_size + 1); i++)
+		{
+			delete[] mul_table[i];
+			delete[] div_table[i];
+			delete[] exp_table[i];
+		}
+
+		delete[] mul_inverse;
 	}
 
+	delete[] mul_table;
+	delete[] div_table;
+	delete[] exp_table;
+
+#endif
+
 	power = gf.power;
 	field_size = gf.field_size;
 	prim_poly_hash = gf.prim_poly_hash;
+	owns_tables = true;
 
+	alpha_to = new GFq_Symbol[field_size + 1];
+	index_of = new GFq_Symbol[field_size + 1];
 	memcpy(alpha_to, gf.alpha_to, (field_size + 1) * sizeof(GFq_Symbol));
 	memcpy(index_of, gf.index_of, (field_size + 1) * sizeof(GFq_Symbol));
 
 #if !defined(NO_GFLUT)
 
-	if (mul_table != NULL)
-	{
-		delete[] mul_table;
-	}
-
-	if (div_table != NULL)
-	{
-		delete[] div_table;
-	}
-
-	if (exp_table != NULL)
-	{
-		delete[] exp_table;
-	}
-
-	if (mul_inverse != NULL)
-	{
-		delete[] mul_inverse;
-	}
-
 	mul_table = new GFq_Symbol*[(field_size + 1)];
 	div_table = new GFq_Symbol*[(field_size + 1)];
 	exp_table = new GFq_Symbol*[(field_size + 1)];
@@ -274,24 +253,83 @@ GFq& GFq::operator=(const GFq& gf)
 		mul_table[i] = new GFq_Symbol[(field_size + 1)];
 		div_table[i] = new GFq_Symbol[(field_size + 1)];
 		exp_table[i] = new GFq_Symbol[(field_size + 1)];
+		memcpy(mul_table[i], gf.mul_table[i], (field_size + 1) * sizeof(GFq_Symbol));
+		memcpy(div_table[i], gf.div_table[i], (field_size + 1) * sizeof(GFq_Symbol));
+		memcpy(exp_table[i], gf.exp_table[i], (field_size + 1) * sizeof(GFq_Symbol));
 	}
 
 	memcpy(mul_inverse, gf.mul_inverse, (field_size + 1) * sizeof(GFq_Symbol) * 2);
 
-	memcpy(mul_table, gf.mul_table, (field_size + 1) * sizeof(GFq_Symbol*));
-	memcpy(div_table, gf.div_table, (field_size + 1) * sizeof(GFq_Symbol*));
-	memcpy(exp_table, gf.exp_table, (field_size + 1) * sizeof(GFq_Symbol*));
+#endif
 
-	for (unsigned int i = 0; i < (field_size + 1); i++)
+	return *this;
+}
+
+
+// ================================================================================================
+void GFq::hash_primitive_poly()
+{
+	prim_poly_hash = 0xAAAAAAAA;
+
+	for (unsigned int i = 0; i < power; i++)
 	{
-		memcpy(mul_table[i], gf.mul_table[i], (field_size + 1) * sizeof(GFq_Symbol));
-		memcpy(div_table[i], gf.div_table[i], (field_size + 1) * sizeof(GFq_Symbol));
-		memcpy(exp_table[i], gf.exp_table[i], (field_size + 1) * sizeof(GFq_Symbol));
+		prim_poly_hash += ((i & 1) == 0) ? (  (prim_poly_hash <<  7) ^ primitive_poly[i].uint_value() ^ (prim_poly_hash >> 3)) :
+						  (~((prim_poly_hash << 11) ^ primitive_poly[i].uint_value() ^ (prim_poly_hash >> 5)));
 	}
+}
 
-#endif
 
-	return *this;
+// ================================================================================================
+size_t GFq::tables_size(unsigned int pwr)
+{
+	size_t q = 1 << pwr;
+	return 4*q + 3*q*q;
+}
+
+
+// ================================================================================================
+GFq_Tables GFq::map_tables(unsigned int pwr, const GFq_Symbol *flat_tables)
+{
+	size_t q = 1 << pwr;
+	GFq_Tables tables;
+	tables.alpha_to = flat_tables;
+	tables.index_of = tables.alpha_to + q;
+	tables.mul_inverse = tables.index_of + q;
+	tables.mul_table = tables.mul_inverse + 2*q;
+	tables.div_table = tables.mul_table + q*q;
+	tables.exp_table = tables.div_table + q*q;
+	return tables;
+}
+
+
+// ================================================================================================
+void GFq::get_tables(std::vector<GFq_Symbol>& flat_tables) const
+{
+	size_t q = field_size + 1;
+	flat_tables.resize(tables_size(power));
+	GFq_Symbol *p = &flat_tables[0];
+
+	memcpy(p, alpha_to, q * sizeof(GFq_Symbol));
+	memcpy(p + q, index_of, q * sizeof(GFq_Symbol));
+	p += 2*q;
+
+	for (unsigned int i = 0; i < q; i++)
+	{
+		p[i] = gen_inverse(i);
+		p[i + q] = p[i];
+	}
+
+	p += 2*q;
+
+	for (unsigned int i = 0; i < q; i++)
+	{
+		for (unsigned int j = 0; j < q; j++)
+		{
+			p[i*q + j] = gen_mul(i, j);
+			p[q*q + i*q + j] = gen_div(i, j);
+			p[2*q*q + i*q + j] = gen_exp(i, j);
+		}
+	}
 }
 
 
@@ -56,6 +56,20 @@ namespace gf
 typedef unsigned int GFq_Symbol; //!< Symbol or binary-polynomial representation (ex: 5 is X^2+1)
 const GFq_Symbol GFERROR = -1; //!< Undefined symbol
 
+/**
+ * \brief LUTs of a field stored outside of the field object, for example in a mapped table bundle.
+ * Binary operation LUTs are stored row first.
+ */
+struct GFq_Tables
+{
+	const GFq_Symbol *alpha_to;    //!< q symbols
+	const GFq_Symbol *index_of;    //!< q symbols
+	const GFq_Symbol *mul_inverse; //!< 2*q symbols
+	const GFq_Symbol *mul_table;   //!< q*q symbols
+	const GFq_Symbol *div_table;   //!< q*q symbols
+	const GFq_Symbol *exp_table;   //!< q*q symbols
+};
+
 /**
  * \brief Galois Field GF(q=2^m) class.
  * Generates and holds lookup tables (LUT) for basic operations.
@@ -66,12 +80,34 @@ class GFq
 
 public:
 	GFq(const int pwr, const GF2_Polynomial& primitive_poly);
+
+	/**
+	 * Constructs a field using LUTs computed beforehand. The primitive polynomial is not checked and the LUTs are
+	 * neither generated nor copied. It is the caller's responsibility to keep them alive during the lifetime of this object.
+	 * \param pwr m as in GF(2^m)
+	 * \param primitive_poly Primitive polynomial the LUTs were computed with
+	 * \param tables LUTs of the field
+	 */
+	GFq(const int pwr, const GF2_Polynomial& primitive_poly, const GFq_Tables& tables);
+
 	GFq(const GFq& gf);
 	~GFq();
 
 	GFq& operator=(const GFq& gf);
-	bool operator==(const GFq& gf) const;
-	bool operator!=(const GFq& gf) const;
+
+	/**
+	 * Fields are equal when they have the same power and primitive polynomial. Elements and
+	 * polynomials of one decoder normally refer to the same field object which is tested first.
+	 */
+	bool operator==(const GFq& gf) const
+	{
+		return (this == &gf) || ((power == gf.power) && (prim_poly_hash == gf.prim_poly_hash));
+	}
+
+	bool operator!=(const GFq& gf) const
+	{
+		return !(*this == gf);
+	}
 
 	/**
 	 * Alpha based log
@@ -239,10 +275,40 @@ public:
 #endif
 	}
 
+	/**
+	 * Get the primitive polynomial
+	 */
+	inline const GF2_Polynomial& get_primitive_poly() const
+	{
+		return primitive_poly;
+	}
+
+	/**
+	 * Number of symbols of the flat copy of the LUTs of a field
+	 * \param pwr m as in GF(2^m)
+	 */
+	static size_t tables_size(unsigned int pwr);
+
+	/**
+	 * Pointers to the LUTs in a flat copy
+	 * \param pwr m as in GF(2^m)
+	 * \param flat_tables Flat copy of tables_size(pwr) symbols
+	 */
+	static GFq_Tables map_tables(unsigned int pwr, const GFq_Symbol *flat_tables);
+
+	/**
+	 * Flat copy of the LUTs in the order alpha_to, index_of, mul_inverse, mul_table, div_table, exp_table.
+	 * Binary operation LUTs are computed if they are not held by the field (NO_GFLUT).
+	 * \param flat_tables Receives tables_size() symbols
+	 */
+	void get_tables(std::vector<GFq_Symbol>& flat_tables) const;
+
 	friend std::ostream& operator <<(std::ostream& os, const GFq& gf);
 
 private:
 
+	void hash_primitive_poly();
+
 	void generate_field();
 	GFq_Symbol fast_modulus(GFq_Symbol x) const;
 	GFq_Symbol gen_mul(const GFq_Symbol& a, const GFq_Symbol& b) const;
@@ -260,6 +326,7 @@ private:
 	GFq_Symbol** mul_table;               //!< Multiplication binary operation LUT
 	GFq_Symbol** div_table;               //!< Division binary operation LUT
 	GFq_Symbol** exp_table;               //!< Exponent binary operation LUT
+	bool owns_tables;                     //!< LUTs were allocated by this object
 
 };
 
@@ -0,0 +1,549 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Bivariate polynomials with coefficients in GF(2^m) stored as a flat
+	 vector of terms sorted in weighted reverse lexical order.
+
+ */
+
+#include "GFq_BivariateFlatPolynomial.h"
+#include "GF_Exception.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+namespace rssoft
+{
+namespace gf
+{
+
+/**
+ * \brief Orders terms on their key only
+ */
+struct GFq_BivariateFlatTermOrdering
+{
+	bool operator()(const GFq_BivariateFlatPolynomial::Term& t1, const GFq_BivariateFlatPolynomial::Term& t2) const
+	{
+		return t1.first < t2.first;
+	}
+};
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial::GFq_BivariateFlatPolynomial(const GFq& _gf, unsigned int w_x, unsigned int w_y) :
+	gf(_gf),
+	weights(w_x, w_y)
+{}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial::GFq_BivariateFlatPolynomial(const GFq& _gf, const GFq_BivariatePolynomial& polynomial) :
+	gf(_gf),
+	weights(polynomial.get_weights())
+{
+	const GFq_BivariateMonomials& monomials = polynomial.get_monomials();
+	GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
+	terms.reserve(monomials.size());
+
+	for (; mono_it != monomials.end(); ++mono_it)
+	{
+		if ((mono_it->first.x() > max_exponent) || (mono_it->first.y() > max_exponent))
+		{
+			throw GF_Exception("Bivariate polynomial exponent too large for flat representation");
+		}
+
+		if (mono_it->second.poly() != 0)
+		{
+			terms.push_back(Term(make_key(mono_it->first.x(), mono_it->first.y()), mono_it->second.poly())); // map order is key order
+		}
+	}
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial::GFq_BivariateFlatPolynomial(const GFq_BivariateFlatPolynomial& polynomial) :
+	gf(polynomial.gf),
+	weights(polynomial.weights),
+	terms(polynomial.terms)
+{}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial::~GFq_BivariateFlatPolynomial()
+{}
+
+// ================================================================================================
+void GFq_BivariateFlatPolynomial::get_bivariate(GFq_BivariatePolynomial& polynomial) const
+{
+	if (polynomial.get_weights() != weights)
+	{
+		throw GF_Exception("Bivariate polynomials weights do not match");
+	}
+
+	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
+	GFq_BivariateMonomials monomials(mono_exp_compare);
+	std::vector<Term>::const_iterator t_it = terms.begin();
+
+	for (; t_it != terms.end(); ++t_it)
+	{
+		monomials.insert(monomials.end(), std::make_pair(GFq_BivariateMonomialExponents(key_x(t_it->first), key_y(t_it->first)), GFq_Element(gf, t_it->second)));
+	}
+
+	polynomial.init(monomials);
+}
+
+// ================================================================================================
+GFq_Symbol GFq_BivariateFlatPolynomial::coeff(unsigned int x, unsigned int y) const
+{
+	Term probe(make_key(x, y), 0);
+	std::vector<Term>::const_iterator t_it = std::lower_bound(terms.begin(), terms.end(), probe, GFq_BivariateFlatTermOrdering());
+
+	if ((t_it != terms.end()) && (t_it->first == probe.first))
+	{
+		return t_it->second;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+// ================================================================================================
+void GFq_BivariateFlatPolynomial::add_monomial(GFq_Symbol coeff, unsigned int x, unsigned int y)
+{
+	if ((x > max_exponent) || (y > max_exponent))
+	{
+		throw GF_Exception("Bivariate polynomial exponent too large for flat representation");
+	}
+
+	if (coeff == 0)
+	{
+		return;
+	}
+
+	Term term(make_key(x, y), coeff);
+	std::vector<Term>::iterator t_it = std::lower_bound(terms.begin(), terms.end(), term, GFq_BivariateFlatTermOrdering());
+
+	if ((t_it != terms.end()) && (t_it->first == term.first))
+	{
+		t_it->second = gf.add(t_it->second, coeff);
+
+		if (t_it->second == 0)
+		{
+			terms.erase(t_it);
+		}
+	}
+	else
+	{
+		terms.insert(t_it, term);
+	}
+}
+
+// ================================================================================================
+void GFq_BivariateFlatPolynomial::sum(std::vector<Term>& sum_terms, const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b)
+{
+	if (a.weights != b.weights)
+	{
+		throw GF_Exception("Bivariate polynomials weights do not match");
+	}
+
+	std::vector<Term>::const_iterator a_it = a.terms.begin();
+	std::vector<Term>::const_iterator b_it = b.terms.begin();
+	sum_terms.clear();
+	sum_terms.reserve(a.terms.size() + b.terms.size());
+
+	while ((a_it != a.terms.end()) && (b_it != b.terms.end()))
+	{
+		if (a_it->first < b_it->first)
+		{
+			sum_terms.push_back(*a_it);
+			++a_it;
+		}
+		else if (b_it->first < a_it->first)
+		{
+			sum_terms.push_back(*b_it);
+			++b_it;
+		}
+		else
+		{
+			GFq_Symbol s = a.gf.add(a_it->second, b_it->second);
+
+			if (s != 0)
+			{
+				sum_terms.push_back(Term(a_it->first, s));
+			}
+
+			++a_it;
+			++b_it;
+		}
+	}
+
+	sum_terms.insert(sum_terms.end(), a_it, a.terms.end());
+	sum_terms.insert(sum_terms.end(), b_it, b.terms.end());
+}
+
+// ================================================================================================
+void GFq_BivariateFlatPolynomial::product(std::vector<Term>& prod_terms, const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b)
+{
+	if (a.weights != b.weights)
+	{
+		throw GF_Exception("Bivariate polynomials weights do not match");
+	}
+
+	prod_terms.clear();
+
+	if ((a.terms.size() == 0) || (b.terms.size() == 0))
+	{
+		return;
+	}
+
+	unsigned int a_max_x = 0, a_max_y = 0, b_max_x = 0, b_max_y = 0;
+	std::vector<Term>::const_iterator t_it;
+
+	for (t_it = a.terms.begin(); t_it != a.terms.end(); ++t_it)
+	{
+		a_max_x = std::max(a_max_x, key_x(t_it->first));
+		a_max_y = std::max(a_max_y, key_y(t_it->first));
+	}
+
+	for (t_it = b.terms.begin(); t_it != b.terms.end(); ++t_it)
+	{
+		b_max_x = std::max(b_max_x, key_x(t_it->first));
+		b_max_y = std::max(b_max_y, key_y(t_it->first));
+	}
+
+	if ((a_max_x + b_max_x > max_exponent) || (a_max_y + b_max_y > max_exponent))
+	{
+		throw GF_Exception("Bivariate polynomial exponent too large for flat representation");
+	}
+
+	// Multiplying by a monomial preserves the order so each row a_i*b is sorted. Rows are merged with a heap.
+	typedef std::pair<Key, unsigned int> HeapEntry; // (key of next product in row, row index)
+	std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > heap;
+	std::vector<unsigned int> row_col(a.terms.size(), 0);
+	unsigned int b0_x = key_x(b.terms[0].first);
+	unsigned int b0_y = key_y(b.terms[0].first);
+
+	for (unsigned int i = 0; i < a.terms.size(); i++)
+	{
+		heap.push(HeapEntry(a.make_key(key_x(a.terms[i].first) + b0_x, key_y(a.terms[i].first) + b0_y), i));
+	}
+
+	while (!heap.empty())
+	{
+		HeapEntry entry = heap.top();
+		heap.pop();
+		unsigned int i = entry.second;
+		unsigned int j = row_col[i];
+		GFq_Symbol s = a.gf.mul(a.terms[i].second, b.terms[j].second);
+
+		if ((prod_terms.size() > 0) && (prod_terms.back().first == entry.first))
+		{
+			prod_terms.back().second = a.gf.add(prod_terms.back().second, s);
+		}
+		else
+		{
+			if ((prod_terms.size() > 0) && (prod_terms.back().second == 0)) // previous key cancelled out
+			{
+				prod_terms.pop_back();
+			}
+
+			prod_terms.push_back(Term(entry.first, s));
+		}
+
+		if (++row_col[i] < b.terms.size())
+		{
+			j = row_col[i];
+			heap.push(HeapEntry(a.make_key(key_x(a.terms[i].first) + key_x(b.terms[j].first), key_y(a.terms[i].first) + key_y(b.terms[j].first)), i));
+		}
+	}
+
+	if ((prod_terms.size() > 0) && (prod_terms.back().second == 0))
+	{
+		prod_terms.pop_back();
+	}
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::operator=(const GFq_BivariateFlatPolynomial& polynomial)
+{
+	if (&gf != &polynomial.gf && gf != polynomial.gf)
+	{
+		throw GF_Exception("Bivariate polynomials fields do not match");
+	}
+
+	weights = polynomial.weights;
+	terms = polynomial.terms;
+	return *this;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::operator+=(const GFq_BivariateFlatPolynomial& polynomial)
+{
+	std::vector<Term> sum_terms;
+	sum(sum_terms, *this, polynomial);
+	terms.swap(sum_terms);
+	return *this;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::operator*=(const GFq_BivariateFlatPolynomial& polynomial)
+{
+	std::vector<Term> prod_terms;
+	product(prod_terms, *this, polynomial);
+	terms.swap(prod_terms);
+	return *this;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::operator*=(GFq_Symbol value)
+{
+	if (value == 0)
+	{
+		terms.clear();
+	}
+	else
+	{
+		std::vector<Term>::iterator t_it = terms.begin();
+
+		for (; t_it != terms.end(); ++t_it)
+		{
+			t_it->second = gf.mul(t_it->second, value);
+		}
+	}
+
+	return *this;
+}
+
+// ================================================================================================
+bool GFq_BivariateFlatPolynomial::operator==(const GFq_BivariateFlatPolynomial& polynomial) const
+{
+	return (weights == polynomial.weights) && (terms == polynomial.terms);
+}
+
+// ================================================================================================
+bool GFq_BivariateFlatPolynomial::operator!=(const GFq_BivariateFlatPolynomial& polynomial) const
+{
+	return !(*this == polynomial);
+}
+
+// ================================================================================================
+GFq_Symbol GFq_BivariateFlatPolynomial::operator()(GFq_Symbol x_value, GFq_Symbol y_value) const
+{
+	GFq_Symbol result = 0;
+	std::vector<Term>::const_iterator t_it = terms.begin();
+
+	for (; t_it != terms.end(); ++t_it)
+	{
+		GFq_Symbol v = gf.mul(gf.exp(x_value, key_x(t_it->first)), gf.exp(y_value, key_y(t_it->first)));
+		result = gf.add(result, gf.mul(t_it->second, v));
+	}
+
+	return result;
+}
+
+// ================================================================================================
+GFq_Polynomial GFq_BivariateFlatPolynomial::get_X_0() const
+{
+	return get_v_0(true);
+}
+
+// ================================================================================================
+GFq_Polynomial GFq_BivariateFlatPolynomial::get_0_Y() const
+{
+	return get_v_0(false);
+}
+
+// ================================================================================================
+GFq_Polynomial GFq_BivariateFlatPolynomial::get_v_0(bool x_terms) const
+{
+	GFq_Element zero(gf, 0);
+	std::vector<GFq_Element> poly;
+	std::vector<Term>::const_iterator t_it = terms.begin();
+
+	for (; t_it != terms.end(); ++t_it)
+	{
+		unsigned int x = key_x(t_it->first);
+		unsigned int y = key_y(t_it->first);
+		unsigned int pwr;
+
+		if (x_terms)
+		{
+			if (y != 0) // Y term
+			{
+				continue;
+			}
+
+			pwr = x;
+		}
+		else
+		{
+			if (x != 0) // X term
+			{
+				continue;
+			}
+
+			pwr = y;
+		}
+
+		if (pwr >= poly.size())
+		{
+			poly.resize(pwr+1, zero);
+		}
+
+		poly[pwr] = GFq_Element(gf, t_it->second);
+	}
+
+	if (poly.size() == 0)
+	{
+		return GFq_Polynomial(zero);
+	}
+	else
+	{
+		return GFq_Polynomial(gf, poly);
+	}
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::make_star()
+{
+	unsigned int h = max_exponent;
+	std::vector<Term>::iterator t_it = terms.begin();
+
+	for (; t_it != terms.end(); ++t_it)
+	{
+		h = std::min(h, key_x(t_it->first));
+	}
+
+	if ((terms.size() > 0) && (h > 0))
+	{
+		for (t_it = terms.begin(); t_it != terms.end(); ++t_it)
+		{
+			t_it->first = make_key(key_x(t_it->first) - h, key_y(t_it->first));
+		}
+	}
+
+	return *this;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial& GFq_BivariateFlatPolynomial::make_Y_substitution(GFq_Symbol c)
+{
+	std::vector<Term> sub_terms;
+	std::vector<Term>::const_iterator t_it = terms.begin();
+
+	for (; t_it != terms.end(); ++t_it)
+	{
+		unsigned int x = key_x(t_it->first);
+		unsigned int y = key_y(t_it->first);
+
+		if (x + y > max_exponent)
+		{
+			throw GF_Exception("Bivariate polynomial exponent too large for flat representation");
+		}
+
+		for (unsigned int l = y; ; l = (l-1) & y) // l runs through the subsets of the bits of y
+		{
+			GFq_Symbol s = gf.mul(t_it->second, gf.exp(c, y-l));
+
+			if (s != 0)
+			{
+				sub_terms.push_back(Term(make_key(x+l, l), s));
+			}
+
+			if (l == 0)
+			{
+				break;
+			}
+		}
+	}
+
+	std::sort(sub_terms.begin(), sub_terms.end(), GFq_BivariateFlatTermOrdering());
+	terms.clear();
+	std::vector<Term>::const_iterator s_it = sub_terms.begin();
+
+	for (; s_it != sub_terms.end(); ++s_it)
+	{
+		if ((terms.size() > 0) && (terms.back().first == s_it->first))
+		{
+			terms.back().second = gf.add(terms.back().second, s_it->second);
+
+			if (terms.back().second == 0) // cancelled out
+			{
+				terms.pop_back();
+			}
+		}
+		else
+		{
+			terms.push_back(*s_it);
+		}
+	}
+
+	return *this;
+}
+
+// ================================================================================================
+std::ostream& operator <<(std::ostream& os, const GFq_BivariateFlatPolynomial& polynomial)
+{
+	if (polynomial.terms.size() == 0)
+	{
+		os << "0";
+	}
+	else
+	{
+		std::vector<GFq_BivariateFlatPolynomial::Term>::const_iterator t_it = polynomial.terms.begin();
+
+		for (; t_it != polynomial.terms.end(); ++t_it)
+		{
+			if (t_it != polynomial.terms.begin())
+			{
+				os << " + ";
+			}
+
+			os << GFq_BivariateMonomialKeyValueRepresentation(
+					GFq_BivariateMonomialExponents(GFq_BivariateFlatPolynomial::key_x(t_it->first), GFq_BivariateFlatPolynomial::key_y(t_it->first)),
+					GFq_Element(polynomial.gf, t_it->second));
+		}
+	}
+
+	return os;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial operator +(const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b)
+{
+	GFq_BivariateFlatPolynomial result(a);
+	result += b;
+	return result;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial operator *(const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b)
+{
+	GFq_BivariateFlatPolynomial result(a);
+	result *= b;
+	return result;
+}
+
+// ================================================================================================
+GFq_BivariateFlatPolynomial star(const GFq_BivariateFlatPolynomial& a)
+{
+	GFq_BivariateFlatPolynomial result(a);
+	result.make_star();
+	return result;
+}
+
+} // namespace gf
+} // namespace rssoft
@@ -0,0 +1,235 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Bivariate polynomials with coefficients in GF(2^m) stored as a flat
+	 vector of terms sorted in weighted reverse lexical order.
+
+	 Each term is a (key, symbol) pair where the key packs the weighted
+	 degree and the exponents in a 64 bit integer so that comparing two keys
+	 as integers gives the same result as GFq_WeightedRevLex_BivariateMonomial:
+	 - bits 63..32: weighted degree wX*x + wY*y
+	 - bits 31..16: 0xFFFF - x (higher X power first for equal weighted degree)
+	 - bits 15..0 : y
+
+ */
+#ifndef __GFQ_BIVARIATE_FLAT_POLYNOMIAL_H__
+#define __GFQ_BIVARIATE_FLAT_POLYNOMIAL_H__
+
+#include "GFq.h"
+#include "GFq_BivariatePolynomial.h"
+#include "GFq_Polynomial.h"
+#include <stdint.h>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+namespace rssoft
+{
+namespace gf
+{
+
+/**
+ * \brief Bivariate polynomial in GF(2^m)[X,Y] as a sorted vector of (packed order key, symbol) terms.
+ * Sum is a linear merge, product is a heap merge of the sorted rows a_i*b and coefficient lookup is a
+ * binary search. Terms are kept in increasing order so that the leading monomial is the last term.
+ */
+class GFq_BivariateFlatPolynomial
+{
+public:
+	typedef uint64_t Key;                   //!< Packed order key
+	typedef std::pair<Key, GFq_Symbol> Term; //!< Term of the polynomial
+
+	static const unsigned int max_exponent = 0xFFFF; //!< Largest exponent that can be packed in a key
+
+	/**
+	 * Constructs a zero polynomial
+	 * \param _gf Galois Field of the coefficients
+	 * \param w_x Weight in X for monomials weighted ordering
+	 * \param w_y Weight in Y for monomials weighted ordering
+	 */
+	GFq_BivariateFlatPolynomial(const GFq& _gf, unsigned int w_x, unsigned int w_y);
+
+	/**
+	 * Constructs from the map representation
+	 * \param _gf Galois Field of the coefficients
+	 * \param polynomial Polynomial in map representation. Its weights are used.
+	 */
+	GFq_BivariateFlatPolynomial(const GFq& _gf, const GFq_BivariatePolynomial& polynomial);
+
+	/**
+	 * Copy constructor
+	 */
+	GFq_BivariateFlatPolynomial(const GFq_BivariateFlatPolynomial& polynomial);
+
+	/**
+	 * Destructor
+	 */
+	~GFq_BivariateFlatPolynomial();
+
+	/**
+	 * Converts to the map representation
+	 * \param polynomial Polynomial with the same weights receiving the monomials
+	 */
+	void get_bivariate(GFq_BivariatePolynomial& polynomial) const;
+
+	/**
+	 * Field of the coefficients
+	 */
+	const GFq& field() const
+	{
+		return gf;
+	}
+
+	/**
+	 * Gets the weights pair in (X,Y) used for weighted monomial ordering
+	 */
+	const std::pair<unsigned int, unsigned int>& get_weights() const
+	{
+		return weights;
+	}
+
+	/**
+	 * Sorted terms
+	 */
+	const std::vector<Term>& get_terms() const
+	{
+		return terms;
+	}
+
+	/**
+	 * Packs exponents in an order key
+	 */
+	Key make_key(unsigned int x, unsigned int y) const
+	{
+		return (((Key) (weights.first*x + weights.second*y)) << 32) | (((Key) (max_exponent - x)) << 16) | ((Key) y);
+	}
+
+	/**
+	 * X exponent of an order key
+	 */
+	static unsigned int key_x(Key key)
+	{
+		return max_exponent - ((key >> 16) & max_exponent);
+	}
+
+	/**
+	 * Y exponent of an order key
+	 */
+	static unsigned int key_y(Key key)
+	{
+		return key & max_exponent;
+	}
+
+	/**
+	 * Tells if the polynomial has no non zero coefficients
+	 */
+	bool is_zero() const
+	{
+		return terms.size() == 0;
+	}
+
+	/**
+	 * Leading term with respect to weighted reverse lexical order. Polynomial must not be zero.
+	 */
+	const Term& get_leading_term() const
+	{
+		return terms.back();
+	}
+
+	/**
+	 * Coefficient of X^x*Y^y found by binary search
+	 */
+	GFq_Symbol coeff(unsigned int x, unsigned int y) const;
+
+	/**
+	 * Adds a monomial coeff*X^x*Y^y
+	 */
+	void add_monomial(GFq_Symbol coeff, unsigned int x, unsigned int y);
+
+	/**
+	 * Helper method to create the terms of the sum of polynomials a and b. Terms must not alias a or b.
+	 */
+	static void sum(std::vector<Term>& sum_terms, const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b);
+
+	/**
+	 * Helper method to create the terms of the product of polynomials a and b. Terms must not alias a or b.
+	 */
+	static void product(std::vector<Term>& prod_terms, const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b);
+
+	GFq_BivariateFlatPolynomial& operator=(const GFq_BivariateFlatPolynomial& polynomial);
+	GFq_BivariateFlatPolynomial& operator+=(const GFq_BivariateFlatPolynomial& polynomial);
+	GFq_BivariateFlatPolynomial& operator*=(const GFq_BivariateFlatPolynomial& polynomial);
+	GFq_BivariateFlatPolynomial& operator*=(GFq_Symbol value);
+
+	bool operator==(const GFq_BivariateFlatPolynomial& polynomial) const;
+	bool operator!=(const GFq_BivariateFlatPolynomial& polynomial) const;
+
+	/**
+	 * Evaluation of bivariate polynomial at a (x,y) point in GFq^2
+	 */
+	GFq_Symbol operator()(GFq_Symbol x_value, GFq_Symbol y_value) const;
+
+	/**
+	 * Evaluation of polynomial for Y=0 as a univariate polynomial in X
+	 * \return Univariate polynomial in X as P(X,0)
+	 */
+	GFq_Polynomial get_X_0() const;
+
+	/**
+	 * Evaluation of polynomial for X=0 as a univariate polynomial in Y
+	 * \return Univariate polynomial in Y as P(0,Y)
+	 */
+	GFq_Polynomial get_0_Y() const;
+
+	/**
+	 * Applies to self the star function as P*(X,Y) = P(X,Y)/X^h where h is the greatest power of X so that X^h divides P.
+	 * Dividing all terms by the same power of X keeps their order so keys are rewritten in place.
+	 * \return reference to the new polynomial
+	 */
+	GFq_BivariateFlatPolynomial& make_star();
+
+	/**
+	 * Applies to self the substitution of Y by X*Y+c as P(X,X*Y+c). In characteristic 2 (X*Y+c)^j is the sum
+	 * of the X^l*Y^l*c^(j-l) terms for the l whose bits are a subset of the bits of j (Lucas' theorem).
+	 * \param c Constant term of the substituted Y
+	 * \return reference to the new polynomial
+	 */
+	GFq_BivariateFlatPolynomial& make_Y_substitution(GFq_Symbol c);
+
+	/**
+	 * Prints a polynomial to an output stream using the same format as the map representation
+	 */
+	friend std::ostream& operator <<(std::ostream& os, const GFq_BivariateFlatPolynomial& polynomial);
+
+protected:
+	GFq_Polynomial get_v_0(bool x_terms) const;
+
+	const GFq& gf; //!< Galois Field of the coefficients
+	std::pair<unsigned int, unsigned int> weights; //!< weights for weighted degree ordering
+	std::vector<Term> terms; //!< Terms sorted by increasing key with non zero coefficients
+};
+
+GFq_BivariateFlatPolynomial operator +(const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b);
+GFq_BivariateFlatPolynomial operator *(const GFq_BivariateFlatPolynomial& a, const GFq_BivariateFlatPolynomial& b);
+GFq_BivariateFlatPolynomial star(const GFq_BivariateFlatPolynomial& a);
+
+} // namespace gf
+} // namespace rssoft
+
+#endif // __GFQ_BIVARIATE_FLAT_POLYNOMIAL_H__
@@ -24,7 +24,9 @@
 #define __GFQ_BIVARIATE_MONOMIAL_H__
 
 #include <GFq_Element.h>
+#include "GFq_MonomialArena.h"
 #include <utility>
+#include <map>
 
 namespace rssoft
 {
@@ -198,6 +200,13 @@ protected:
 	std::pair<unsigned int, unsigned int> weights;
 };
 
+/**
+ * Map of monomials of a bivariate polynomial in weighted reverse lexical order. Nodes are allocated from the
+ * arena open for the current thread if any (see GFq_MonomialArenaScope) else from the global heap.
+ */
+typedef std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial,
+		GFq_MonomialAllocator<std::pair<const GFq_BivariateMonomialExponents, GFq_Element> > > GFq_BivariateMonomials;
+
 } // namespace gf
 } // namespace rssoft
 
@@ -23,6 +23,8 @@
 
 #include "GFq_BivariatePolynomial.h"
 #include "GF_Utils.h"
+#include "GF_Exception.h"
+#include "Debug.h"
 #include <set>
 
 namespace rssoft
@@ -68,7 +70,7 @@ void GFq_BivariatePolynomial::init(const GFq_BivariatePolynomial& polynomial)
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::init(const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& _monomials)
+void GFq_BivariatePolynomial::init(const GFq_BivariateMonomials& _monomials)
 {
 	monomials = _monomials;
 }
@@ -200,7 +202,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator =(const GFq_Bivariate
 // ================================================================================================
 unsigned int GFq_BivariatePolynomial::wdeg() const
 {
-    std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+    GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
     unsigned int max_wd = 0;
     
     for (; mono_it != monomials.end(); ++mono_it)
@@ -225,65 +227,71 @@ void GFq_BivariatePolynomial::sum(std::vector<GFq_BivariateMonomial>& _sum_monom
 	}
 	else
 	{
-		std::vector<GFq_BivariateMonomial> sum_monomials;
-		GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(a.get_weights()); // Use reverse lexical order
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials = a.get_monomials();
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& b_monomials = b.get_monomials();
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator a_it = a_monomials.begin();
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator b_it = b_monomials.begin();
-
-		while ((a_it != a_monomials.end()) || (b_it != b_monomials.end()))
+		sum_unchecked(_sum_monomials, a, b);
+	}
+}
+
+// ================================================================================================
+void GFq_BivariatePolynomial::sum_unchecked(std::vector<GFq_BivariateMonomial>& _sum_monomials, const GFq_BivariatePolynomial& a, const GFq_BivariatePolynomial& b)
+{
+	DEBUG_CHECK(a.get_weights() == b.get_weights(), GF_Exception("Cannot add bivariate polynomials with different degree weights"));
+	std::vector<GFq_BivariateMonomial> sum_monomials;
+	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(a.get_weights()); // Use reverse lexical order
+	const GFq_BivariateMonomials& a_monomials = a.get_monomials();
+	const GFq_BivariateMonomials& b_monomials = b.get_monomials();
+	GFq_BivariateMonomials::const_iterator a_it = a_monomials.begin();
+	GFq_BivariateMonomials::const_iterator b_it = b_monomials.begin();
+
+	while ((a_it != a_monomials.end()) || (b_it != b_monomials.end()))
+	{
+		if (a_it == a_monomials.end())
+		{
+			sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*b_it));
+			++b_it;
+		}
+		else if (b_it ==  b_monomials.end())
 		{
-			if (a_it == a_monomials.end())
+			sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*a_it));
+			++a_it;
+		}
+		else
+		{
+			if (mono_exp_compare(a_it->first, b_it->first)) // a monomial is less than b
+			{
+				sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*a_it));
+				++a_it;
+			}
+			else if (mono_exp_compare(b_it->first, a_it->first)) // b monomial is less than a
 			{
 				sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*b_it));
 				++b_it;
 			}
-			else if (b_it ==  b_monomials.end())
+			else // monomial orders are equal (thus their exponents are equal) so coefficient can be summed up
 			{
 				sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*a_it));
+				sum_monomials.back().second += b_it->second;
 				++a_it;
-			}
-			else
-			{
-				if (mono_exp_compare(a_it->first, b_it->first)) // a monomial is less than b
-				{
-					sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*a_it));
-					++a_it;
-				}
-				else if (mono_exp_compare(b_it->first, a_it->first)) // b monomial is less than a
-				{
-					sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*b_it));
-					++b_it;
-				}
-				else // monomial orders are equal (thus their exponents are equal) so coefficient can be summed up
-				{
-					sum_monomials.push_back(static_cast<GFq_BivariateMonomial>(*a_it));
-					sum_monomials.back().second += b_it->second;
-					++a_it;
-					++b_it;
-				}
+				++b_it;
 			}
 		}
+	}
 
-        // simplify (removes monomials with zero coefficients)
+    // simplify (removes monomials with zero coefficients)
 
-		std::vector<GFq_BivariateMonomial>::iterator mono_it = sum_monomials.begin();
+	std::vector<GFq_BivariateMonomial>::iterator mono_it = sum_monomials.begin();
 
-        for (; mono_it != sum_monomials.end(); ++mono_it)
+    for (; mono_it != sum_monomials.end(); ++mono_it)
+    {
+        if (!(mono_it->second.is_zero()))
         {
-            if (!(mono_it->second.is_zero()))
-            {
-            	_sum_monomials.push_back(*mono_it);
-            }
+        	_sum_monomials.push_back(*mono_it);
         }
-
-	}
+    }
 }
 
 
 // ================================================================================================
-void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
+void GFq_BivariatePolynomial::product(GFq_BivariateMonomials& prod_monomials,
 			const GFq_BivariatePolynomial& a,
 			const GFq_BivariatePolynomial& b)
 {
@@ -293,21 +301,30 @@ void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, G
 	}
 	else
 	{
-		product(prod_monomials, a.get_monomials(), b.get_monomials());
-		simplify(prod_monomials); // simplify (removes monomials with zero coefficients)
+		product_unchecked(prod_monomials, a, b);
 	}
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials,
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& b_monomials)
+void GFq_BivariatePolynomial::product_unchecked(GFq_BivariateMonomials& prod_monomials,
+			const GFq_BivariatePolynomial& a,
+			const GFq_BivariatePolynomial& b)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator a_it = a_monomials.begin();
+	DEBUG_CHECK(a.get_weights() == b.get_weights(), GF_Exception("Cannot multiply bivariate polynomials with different degree weights"));
+	product(prod_monomials, a.get_monomials(), b.get_monomials());
+	simplify(prod_monomials); // simplify (removes monomials with zero coefficients)
+}
+
+// ================================================================================================
+void GFq_BivariatePolynomial::product(GFq_BivariateMonomials& prod_monomials,
+		const GFq_BivariateMonomials& a_monomials,
+		const GFq_BivariateMonomials& b_monomials)
+{
+	GFq_BivariateMonomials::const_iterator a_it = a_monomials.begin();
 
 	for (; a_it != a_monomials.end(); ++a_it)
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator b_it = b_monomials.begin();
+		GFq_BivariateMonomials::const_iterator b_it = b_monomials.begin();
 
 		for (; b_it != b_monomials.end(); ++b_it)
 		{
@@ -318,16 +335,16 @@ void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, G
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
+void GFq_BivariatePolynomial::product(GFq_BivariateMonomials& prod_monomials,
 		const GFq_Element& v,
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials,
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& b_monomials)
+		const GFq_BivariateMonomials& a_monomials,
+		const GFq_BivariateMonomials& b_monomials)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator a_it = a_monomials.begin();
+	GFq_BivariateMonomials::const_iterator a_it = a_monomials.begin();
 
 	for (; a_it != a_monomials.end(); ++a_it)
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator b_it = b_monomials.begin();
+		GFq_BivariateMonomials::const_iterator b_it = b_monomials.begin();
 
 		for (; b_it != b_monomials.end(); ++b_it)
 		{
@@ -338,12 +355,12 @@ void GFq_BivariatePolynomial::product(std::map<GFq_BivariateMonomialExponents, G
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::division(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& div_monomials,
+void GFq_BivariatePolynomial::division(GFq_BivariateMonomials& div_monomials,
 		const GFq_BivariatePolynomial& a,
 		const GFq_BivariateMonomial& b)
 {
-	const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials = a.get_monomials();
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator a_it = a_monomials.begin();
+	const GFq_BivariateMonomials& a_monomials = a.get_monomials();
+	GFq_BivariateMonomials::const_iterator a_it = a_monomials.begin();
 
 	for (; a_it != a_monomials.end(); ++a_it)
 	{
@@ -353,7 +370,7 @@ void GFq_BivariatePolynomial::division(std::map<GFq_BivariateMonomialExponents,
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::pow(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& pow_monomials,
+void GFq_BivariatePolynomial::pow(GFq_BivariateMonomials& pow_monomials,
 		const GFq_BivariatePolynomial& a,
 		unsigned int n)
 {
@@ -363,7 +380,7 @@ void GFq_BivariatePolynomial::pow(std::map<GFq_BivariateMonomialExponents, GFq_E
 	}
 	else
 	{
-		const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials = a.get_monomials();
+		const GFq_BivariateMonomials& a_monomials = a.get_monomials();
 		const GFq& gf = a_monomials.begin()->second.field();
 
 		if (n == 0)
@@ -380,21 +397,21 @@ void GFq_BivariatePolynomial::pow(std::map<GFq_BivariateMonomialExponents, GFq_E
         }
         else
 		{
-			std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> at_monomials(a_monomials); //!< temporary a^i monomials
-			std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> pt_monomials(pow_monomials); //!< temporary power monomials
+			GFq_BivariateMonomials at_monomials(a_monomials); //!< temporary a^i monomials
+			GFq_BivariateMonomials pt_monomials(pow_monomials); //!< temporary power monomials
 
 			for (unsigned int i=0; i<n-1; i++)
 			{
 				pt_monomials.clear();
 
-				std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator at_it = at_monomials.begin();
+				GFq_BivariateMonomials::const_iterator at_it = at_monomials.begin();
 				for (; at_it != at_monomials.end(); ++at_it)
 				{
-					std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator a_it = a_monomials.begin();
+					GFq_BivariateMonomials::const_iterator a_it = a_monomials.begin();
 					for (; a_it != a_monomials.end(); ++a_it)
 					{
 						GFq_BivariateMonomial mono_product = static_cast<GFq_BivariateMonomial>(*at_it) * static_cast<GFq_BivariateMonomial>(*a_it);
-						std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = pt_monomials.find(mono_product.get_exponents());
+						GFq_BivariateMonomials::iterator mono_it = pt_monomials.find(mono_product.get_exponents());
 
 						if (mono_it == pt_monomials.end()) // exponents pair does not exist yet
 						{
@@ -412,7 +429,7 @@ void GFq_BivariatePolynomial::pow(std::map<GFq_BivariateMonomialExponents, GFq_E
 
 			// copy last temporary a^i monomials to result and simplify
 
-	        std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = at_monomials.begin();
+	        GFq_BivariateMonomials::iterator mono_it = at_monomials.begin();
 
 	        for (; mono_it != at_monomials.end(); ++mono_it)
 	        {
@@ -426,10 +443,10 @@ void GFq_BivariatePolynomial::pow(std::map<GFq_BivariateMonomialExponents, GFq_E
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::add_monomial(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials,
+void GFq_BivariatePolynomial::add_monomial(GFq_BivariateMonomials& monomials,
 		const GFq_BivariateMonomialKeyValueRepresentation& a)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = monomials.find(a.first);
+	GFq_BivariateMonomials::iterator mono_it = monomials.find(a.first);
 
 	if (mono_it == monomials.end()) // exponents pair does not exist yet
 	{
@@ -442,13 +459,13 @@ void GFq_BivariatePolynomial::add_monomial(std::map<GFq_BivariateMonomialExponen
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::add_monomial(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials,
+void GFq_BivariatePolynomial::add_monomial(GFq_BivariateMonomials& monomials,
 		const GFq_Element& coeff,
 		unsigned int x_pow,
 		unsigned int y_pow)
 {
 	GFq_BivariateMonomialExponents exponents(x_pow, y_pow);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = monomials.find(exponents);
+	GFq_BivariateMonomials::iterator mono_it = monomials.find(exponents);
 
 	if (mono_it == monomials.end()) // exponents pair does not exist yet
 	{
@@ -462,9 +479,9 @@ void GFq_BivariatePolynomial::add_monomial(std::map<GFq_BivariateMonomialExponen
 }
 
 // ================================================================================================
-void GFq_BivariatePolynomial::simplify(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials)
+void GFq_BivariatePolynomial::simplify(GFq_BivariateMonomials& monomials)
 {
-    std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = monomials.begin();
+    GFq_BivariateMonomials::iterator mono_it = monomials.begin();
 
     while (mono_it != monomials.end())
     {
@@ -530,7 +547,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator-=(const GFq_Element&
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_BivariatePolynomial& polynomial)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> product_monomials(mono_exp_compare);
+	GFq_BivariateMonomials product_monomials(mono_exp_compare);
 
 	product(product_monomials, *this, polynomial);
 	monomials = product_monomials;
@@ -542,8 +559,8 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_Bivariate
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_BivariateMonomial& monomial)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> product_monomials(mono_exp_compare);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+	GFq_BivariateMonomials product_monomials(mono_exp_compare);
+	GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
 	
 	for (; mono_it != monomials.end(); ++mono_it)
 	{
@@ -560,7 +577,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_Bivariate
 // ================================================================================================
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_Element& gfe)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = monomials.begin();
+	GFq_BivariateMonomials::iterator mono_it = monomials.begin();
 
 	for (; mono_it != monomials.end(); ++mono_it)
 	{
@@ -574,7 +591,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator*=(const GFq_Element&
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator/=(const GFq_BivariateMonomial& monomial)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> div_monomials(mono_exp_compare);
+	GFq_BivariateMonomials div_monomials(mono_exp_compare);
 
 	division(div_monomials, *this, monomial);
 	monomials = div_monomials;
@@ -585,7 +602,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator/=(const GFq_Bivariate
 // ================================================================================================
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator/=(const GFq_Element& gfe)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::iterator mono_it = monomials.begin();
+	GFq_BivariateMonomials::iterator mono_it = monomials.begin();
 
 	for (; mono_it != monomials.end(); ++mono_it)
 	{
@@ -599,7 +616,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator/=(const GFq_Element&
 GFq_BivariatePolynomial& GFq_BivariatePolynomial::operator^=(unsigned int n)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> pow_monomials(mono_exp_compare);
+	GFq_BivariateMonomials pow_monomials(mono_exp_compare);
 
 	pow(pow_monomials, *this, n);
 	monomials = pow_monomials;
@@ -629,16 +646,48 @@ GFq_Element GFq_BivariatePolynomial::operator()(const GFq_Element& x_value, cons
 	}
 	else
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
-		GFq_Element result(mono_it->second.field(), 0);
+		return evaluate_unchecked(x_value, y_value);
+	}
+}
 
-		for (; mono_it != monomials.end(); ++mono_it)
-		{
-			result += (x_value^mono_it->first.first) * (y_value^mono_it->first.second) * (mono_it->second);
-		}
+// ================================================================================================
+GFq_Element GFq_BivariatePolynomial::evaluate_unchecked(const GFq_Element& x_value, const GFq_Element& y_value) const
+{
+	DEBUG_CHECK(x_value.field() == y_value.field(), GF_Exception("point coordinates must be of the same Galois Field to evaluate bivariate polynomial at this point"));
+	GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
+	GFq_Element result(mono_it->second.field(), 0);
 
-		return result;
+	for (; mono_it != monomials.end(); ++mono_it)
+	{
+		result += (x_value^mono_it->first.first) * (y_value^mono_it->first.second) * (mono_it->second);
 	}
+
+	return result;
+}
+
+// ================================================================================================
+GFq_BivariatePolynomial& GFq_BivariatePolynomial::add_unchecked(const GFq_BivariatePolynomial& polynomial)
+{
+	std::vector<GFq_BivariateMonomial> sum_monomials;
+
+	sum_unchecked(sum_monomials, *this, polynomial);
+
+	monomials.clear();
+	monomials.insert(sum_monomials.begin(), sum_monomials.end());
+
+	return *this;
+}
+
+// ================================================================================================
+GFq_BivariatePolynomial& GFq_BivariatePolynomial::multiply_unchecked(const GFq_BivariatePolynomial& polynomial)
+{
+	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
+	GFq_BivariateMonomials product_monomials(mono_exp_compare);
+
+	product_unchecked(product_monomials, *this, polynomial);
+	monomials.swap(product_monomials);
+
+	return *this;
 }
 
 // ================================================================================================
@@ -663,7 +712,7 @@ GFq_Polynomial GFq_BivariatePolynomial::get_v_0(bool x_terms) const
 	else
 	{
 		std::map<unsigned int, GFq_Element> poly_map;
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+		GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
 		const GFq& gf = mono_it->second.field();
 		GFq_Element zero(gf,0);
 
@@ -726,7 +775,7 @@ bool GFq_BivariatePolynomial::is_in_v(bool x_terms) const
 	}
 	else
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+		GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
         
         for (; mono_it != monomials.end(); ++mono_it)
         {
@@ -771,16 +820,16 @@ GFq_BivariatePolynomial GFq_BivariatePolynomial::operator()(const GFq_BivariateP
 	}
 	else
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+		GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
 		const GFq& gf = mono_it->second.field();
 		GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights); // Use reverse lexical order
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> result_monomials(mono_exp_compare);
+		GFq_BivariateMonomials result_monomials(mono_exp_compare);
 
 		for (; mono_it != monomials.end(); ++mono_it)
 		{
-			std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> partX_monomials(mono_exp_compare);
+			GFq_BivariateMonomials partX_monomials(mono_exp_compare);
 			pow(partX_monomials, P, mono_it->first.first); // X^i -> (P(X,Y))^i
-			std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> partY_monomials(mono_exp_compare);
+			GFq_BivariateMonomials partY_monomials(mono_exp_compare);
 			pow(partY_monomials, Q, mono_it->first.second); // Y^j -> (Q(X,Y))^j
 			product(result_monomials, mono_it->second, partX_monomials, partY_monomials); // a_i,j*(P(X,Y))^i*(Q(X,Y))^j
 		}
@@ -802,7 +851,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::make_star()
 	else
 	{
 		std::set<unsigned int> x_exp_set;
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+		GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
 		const GFq& gf = mono_it->second.field();
 		
 		for (; mono_it != monomials.end(); ++mono_it)
@@ -815,7 +864,7 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::make_star()
 		if (h > 0)
 		{
 			GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-			std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> div_monomials(mono_exp_compare);
+			GFq_BivariateMonomials div_monomials(mono_exp_compare);
 			mono_it = monomials.begin();
 			
 			for (; mono_it != monomials.end(); ++mono_it)
@@ -840,8 +889,8 @@ GFq_BivariatePolynomial& GFq_BivariatePolynomial::make_dHasse(unsigned int mu, u
 	else if ((mu != 0) or (nu != 0)) // ^[0,0] is the trivial case where the polynomial is unmodified
 	{
 		GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(weights);
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> hasse_monomials(mono_exp_compare);
-		std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>::const_iterator mono_it = monomials.begin();
+		GFq_BivariateMonomials hasse_monomials(mono_exp_compare);
+		GFq_BivariateMonomials::const_iterator mono_it = monomials.begin();
 		const GFq& gf = mono_it->second.field();
 
 		for (; mono_it != monomials.end(); ++mono_it)
@@ -882,7 +931,7 @@ std::ostream& operator <<(std::ostream& os, const GFq_BivariatePolynomial& polyn
 	}
 	else
 	{
-		std::map<GFq_BivariateMonomialExponents, GFq_Element>::const_iterator it = polynomial.monomials.begin();
+		GFq_BivariateMonomials::const_iterator it = polynomial.monomials.begin();
 
 		for (; it != polynomial.monomials.end(); ++it)
 		{
@@ -901,7 +950,7 @@ std::ostream& operator <<(std::ostream& os, const GFq_BivariatePolynomial& polyn
 // ================================================================================================
 void simplify(GFq_BivariatePolynomial& polynomial)
 {
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials = polynomial.get_monomials_for_update();
+	GFq_BivariateMonomials& monomials = polynomial.get_monomials_for_update();
 	GFq_BivariatePolynomial::simplify(monomials);
 }
 
@@ -956,7 +1005,7 @@ GFq_BivariatePolynomial operator -(const GFq_Element& a, const GFq_BivariatePoly
 GFq_BivariatePolynomial operator*(const GFq_BivariatePolynomial& a, const GFq_BivariatePolynomial& b)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(a.get_weights());
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> product_monomials(mono_exp_compare);
+	GFq_BivariateMonomials product_monomials(mono_exp_compare);
 	GFq_BivariatePolynomial result(a.get_weights()); // copy without creating monomials
 	GFq_BivariatePolynomial::product(product_monomials, a, b);
 	result.init(product_monomials);
@@ -992,7 +1041,7 @@ GFq_BivariatePolynomial operator*(const GFq_Element& a, const GFq_BivariatePolyn
 GFq_BivariatePolynomial operator /(const GFq_BivariatePolynomial& a, const GFq_BivariateMonomial& b)
 {
 	GFq_WeightedRevLex_BivariateMonomial mono_exp_compare(a.get_weights());
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> div_monomials(mono_exp_compare);
+	GFq_BivariateMonomials div_monomials(mono_exp_compare);
 	GFq_BivariatePolynomial result(a.get_weights()); // copy without creating monomials
 	GFq_BivariatePolynomial::division(div_monomials, a, b);
 	result.init(div_monomials);
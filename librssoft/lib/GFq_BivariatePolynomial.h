@@ -78,7 +78,7 @@ public:
 	/**
 	 * Initializes the polynomial with a map of monomials
 	 */
-	void init(const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials);
+	void init(const GFq_BivariateMonomials& monomials);
     
     /**
      * Initializes the polynomial as X^n
@@ -141,7 +141,7 @@ public:
 	 * Get the monomials
 	 * \return Reference to the set of monomials
 	 */
-	const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& get_monomials() const
+	const GFq_BivariateMonomials& get_monomials() const
 	{
 		return monomials;
 	}
@@ -150,7 +150,7 @@ public:
 	 * Get the monomials to be updated
 	 * \return Reference to the set of monomials
 	 */
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& get_monomials_for_update() 
+	GFq_BivariateMonomials& get_monomials_for_update() 
 	{
 		return monomials;
 	}
@@ -190,31 +190,45 @@ public:
 	 */
 	static void sum(std::vector<GFq_BivariateMonomial>& sum_monomials, const GFq_BivariatePolynomial& a, const GFq_BivariatePolynomial& b);
 
+	/**
+	 * Same as sum without checking that the degree weights of a and b match.
+	 * The check is kept in debug builds (_DEBUG).
+	 */
+	static void sum_unchecked(std::vector<GFq_BivariateMonomial>& sum_monomials, const GFq_BivariatePolynomial& a, const GFq_BivariatePolynomial& b);
+
 	/**
 	 * Helper method to create the map of monomials of the product of polynomials a and b
 	 */
-	static void product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
+	static void product(GFq_BivariateMonomials& prod_monomials,
+			const GFq_BivariatePolynomial& a,
+			const GFq_BivariatePolynomial& b);
+
+	/**
+	 * Same as product without checking that the degree weights of a and b match.
+	 * The check is kept in debug builds (_DEBUG).
+	 */
+	static void product_unchecked(GFq_BivariateMonomials& prod_monomials,
 			const GFq_BivariatePolynomial& a,
 			const GFq_BivariatePolynomial& b);
 
 	/**
 	 * Helper method to create the map of monomials of the division of polynomial a by monomial b
 	 */
-	static void division(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& div_monomials,
+	static void division(GFq_BivariateMonomials& div_monomials,
 			const GFq_BivariatePolynomial& a,
 			const GFq_BivariateMonomial& b);
 
 	/**
 	 * Helper method to create the map of monomials of the polynomial to the nth power
 	 */
-	static void pow(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& pow_monomials,
+	static void pow(GFq_BivariateMonomials& pow_monomials,
 			const GFq_BivariatePolynomial& a,
 			unsigned int n);
 
 	/**
 	 * Helper method to simplify a map of monomials i.e. remove those with coefficient 0
 	 */
-	static void simplify(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials);
+	static void simplify(GFq_BivariateMonomials& monomials);
 
 	GFq_BivariatePolynomial& operator =(const GFq_BivariatePolynomial& polynomial);
 	GFq_BivariatePolynomial& operator+=(const GFq_BivariatePolynomial& polynomial);
@@ -247,6 +261,25 @@ public:
 	 */
 	GFq_BivariatePolynomial operator()(const GFq_BivariatePolynomial& P, const GFq_BivariatePolynomial& Q) const;
 
+	/**
+	 * Adds a polynomial without checking that degree weights match.
+	 * For inner loops where the caller has checked operands once beforehand.
+	 */
+	GFq_BivariatePolynomial& add_unchecked(const GFq_BivariatePolynomial& polynomial);
+
+	/**
+	 * Multiplies by a polynomial without checking that degree weights match.
+	 * For inner loops where the caller has checked operands once beforehand.
+	 */
+	GFq_BivariatePolynomial& multiply_unchecked(const GFq_BivariatePolynomial& polynomial);
+
+	/**
+	 * Evaluation at a (x,y) point without checking that x and y are in the same field.
+	 * For inner loops where the caller has checked the points once beforehand.
+	 * The check is kept in debug builds (_DEBUG).
+	 */
+	GFq_Element evaluate_unchecked(const GFq_Element& x_value, const GFq_Element& y_value) const;
+
 	/**
 	 * Evaluation of polynomial for Y=0 as a univariate polynomial in X
 	 * \return Univariate polynomial in X as P(X,0)
@@ -296,34 +329,34 @@ protected:
 	/**
 	 * Helper method to create the map of monomials of the product of maps a and b
 	 */
-	static void product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
-			const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials,
-			const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& b_monomials);
+	static void product(GFq_BivariateMonomials& prod_monomials,
+			const GFq_BivariateMonomials& a_monomials,
+			const GFq_BivariateMonomials& b_monomials);
 
 	/**
 	 * Helper method to create the map of monomials of the product of constant, maps a and b
 	 */
-	static void product(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& prod_monomials,
+	static void product(GFq_BivariateMonomials& prod_monomials,
 			const GFq_Element& v,
-			const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& a_monomials,
-			const std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& b_monomials);
+			const GFq_BivariateMonomials& a_monomials,
+			const GFq_BivariateMonomials& b_monomials);
 
 	/**
 	 * Helper method to add a monomial to a map of monomials
 	 */
-	static void add_monomial(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials,
+	static void add_monomial(GFq_BivariateMonomials& monomials,
 			const GFq_BivariateMonomialKeyValueRepresentation& a);
 
 	/**
 	 * Helper method to add a monomial to a map of monomials
 	 */
-	static void add_monomial(std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial>& monomials,
+	static void add_monomial(GFq_BivariateMonomials& monomials,
 			const GFq_Element& coeff,
 			unsigned int x_pow,
 			unsigned int y_pow);
 
 	std::pair<unsigned int, unsigned int> weights; //<! weights for weighted degree ordering
-	std::map<GFq_BivariateMonomialExponents, GFq_Element, GFq_WeightedRevLex_BivariateMonomial> monomials; //<! set of monomials
+	GFq_BivariateMonomials monomials; //<! set of monomials
 };
 
 /**
@@ -0,0 +1,177 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Arena memory resource for the monomial maps of bivariate polynomials.
+
+ */
+
+#include "GFq_MonomialArena.h"
+#include <cstdlib>
+
+namespace rssoft
+{
+namespace gf
+{
+
+static __thread GFq_MonomialArena *current_arena = 0; //!< Arena open for the current thread
+
+// ================================================================================================
+GFq_MonomialArena::GFq_MonomialArena(size_t _block_size) :
+	block_size(_block_size),
+	bump(0),
+	bump_end(0),
+	nb_live(0),
+	nb_allocations(0),
+	closed(false),
+	previous(0)
+{
+	for (unsigned int i=0; i<nb_size_classes; i++)
+	{
+		free_lists[i] = 0;
+	}
+}
+
+// ================================================================================================
+GFq_MonomialArena::~GFq_MonomialArena()
+{
+	std::vector<char*>::iterator b_it = blocks.begin();
+
+	for (; b_it != blocks.end(); ++b_it)
+	{
+		::operator delete(*b_it);
+	}
+}
+
+// ================================================================================================
+GFq_MonomialArena *GFq_MonomialArena::current()
+{
+	return current_arena;
+}
+
+// ================================================================================================
+void *GFq_MonomialArena::allocate(size_t size)
+{
+	size_t size_class = (size + granularity - 1) / granularity;
+
+	if ((current_arena) && (size_class < nb_size_classes))
+	{
+		return current_arena->arena_allocate(size_class);
+	}
+	else
+	{
+		ChunkHeader *chunk = static_cast<ChunkHeader*>(::operator new(granularity + size));
+		chunk->arena = 0;
+		chunk->size_class = 0;
+		return ((char *) chunk) + granularity;
+	}
+}
+
+// ================================================================================================
+void GFq_MonomialArena::deallocate(void *p)
+{
+	if (p)
+	{
+		ChunkHeader *chunk = (ChunkHeader *) (((char *) p) - granularity);
+
+		if (chunk->arena)
+		{
+			chunk->arena->arena_deallocate(chunk);
+		}
+		else
+		{
+			::operator delete(chunk);
+		}
+	}
+}
+
+// ================================================================================================
+void *GFq_MonomialArena::arena_allocate(size_t size_class)
+{
+	ChunkHeader *chunk;
+
+	if (free_lists[size_class]) // recycle
+	{
+		chunk = (ChunkHeader *) free_lists[size_class];
+		free_lists[size_class] = *((void **) (((char *) chunk) + granularity));
+	}
+	else // carve out of the current block
+	{
+		size_t chunk_size = granularity*(size_class + 1);
+
+		if (bump + chunk_size > bump_end)
+		{
+			size_t new_block_size = (chunk_size > block_size ? chunk_size : block_size);
+			bump = static_cast<char*>(::operator new(new_block_size));
+			bump_end = bump + new_block_size;
+			blocks.push_back(bump);
+		}
+
+		chunk = (ChunkHeader *) bump;
+		bump += chunk_size;
+	}
+
+	chunk->arena = this;
+	chunk->size_class = size_class;
+	nb_live++;
+	nb_allocations++;
+
+	return ((char *) chunk) + granularity;
+}
+
+// ================================================================================================
+void GFq_MonomialArena::arena_deallocate(ChunkHeader *chunk)
+{
+	*((void **) (((char *) chunk) + granularity)) = free_lists[chunk->size_class];
+	free_lists[chunk->size_class] = chunk;
+	nb_live--;
+
+	if (closed && (nb_live == 0)) // last survivor of a closed arena
+	{
+		delete this;
+	}
+}
+
+// ================================================================================================
+void GFq_MonomialArena::close()
+{
+	closed = true;
+
+	if (nb_live == 0)
+	{
+		delete this;
+	}
+}
+
+// ================================================================================================
+GFq_MonomialArenaScope::GFq_MonomialArenaScope(size_t block_size) :
+	arena(new GFq_MonomialArena(block_size))
+{
+	arena->previous = current_arena;
+	current_arena = arena;
+}
+
+// ================================================================================================
+GFq_MonomialArenaScope::~GFq_MonomialArenaScope()
+{
+	current_arena = arena->previous;
+	arena->close();
+}
+
+} // namespace gf
+} // namespace rssoft
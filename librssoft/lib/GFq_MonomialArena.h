@@ -0,0 +1,233 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Arena memory resource for the monomial maps of bivariate polynomials.
+
+	 An arena is opened for the duration of a decode with a scope object.
+	 While it is open, map nodes allocated by the current thread are carved
+	 out of large blocks and recycled through size class free lists instead
+	 of going to the global heap. All blocks are released at once when the
+	 scope is closed. Nodes that outlive the scope (e.g. polynomials kept in
+	 decoder objects) keep their arena alive until they are all freed.
+
+ */
+#ifndef __GFQ_MONOMIAL_ARENA_H__
+#define __GFQ_MONOMIAL_ARENA_H__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace rssoft
+{
+namespace gf
+{
+
+/**
+ * \brief Arena memory resource. Instances are managed by GFq_MonomialArenaScope.
+ */
+class GFq_MonomialArena
+{
+public:
+	/**
+	 * Allocate memory from the arena open for the current thread or the global heap if none is open
+	 * \param size Size in bytes
+	 */
+	static void *allocate(size_t size);
+
+	/**
+	 * Give memory back to the arena it was allocated from or to the global heap
+	 * \param p Pointer returned by allocate
+	 */
+	static void deallocate(void *p);
+
+	/**
+	 * Arena open for the current thread or 0 if none
+	 */
+	static GFq_MonomialArena *current();
+
+	/**
+	 * Number of blocks obtained from the global heap
+	 */
+	unsigned int get_nb_blocks() const
+	{
+		return blocks.size();
+	}
+
+	/**
+	 * Number of allocations served since the arena was opened
+	 */
+	unsigned long get_nb_allocations() const
+	{
+		return nb_allocations;
+	}
+
+protected:
+	friend class GFq_MonomialArenaScope;
+
+	static const size_t granularity = 16;     //!< Allocation sizes are rounded up to this and headers have this size
+	static const size_t nb_size_classes = 32; //!< Sizes up to nb_size_classes*granularity are served by the arena
+
+	/**
+	 * Header prepended to each allocation
+	 */
+	struct ChunkHeader
+	{
+		GFq_MonomialArena *arena; //!< Owning arena or 0 for the global heap
+		size_t size_class;        //!< Index of the free list
+	};
+
+	GFq_MonomialArena(size_t _block_size);
+	~GFq_MonomialArena();
+
+	void *arena_allocate(size_t size_class);
+	void arena_deallocate(ChunkHeader *chunk);
+
+	/**
+	 * Called when the scope closes. Releases all blocks when no allocation is alive
+	 * else defers it to the last deallocation.
+	 */
+	void close();
+
+	size_t block_size;              //!< Size of blocks obtained from the heap
+	std::vector<char*> blocks;      //!< Blocks obtained from the heap
+	char *bump;                     //!< Next free byte in the current block
+	char *bump_end;                 //!< End of the current block
+	void *free_lists[nb_size_classes]; //!< Recycled chunks by size class
+	unsigned long nb_live;          //!< Number of allocations not given back yet
+	unsigned long nb_allocations;   //!< Number of allocations served
+	bool closed;                    //!< Scope is closed
+	GFq_MonomialArena *previous;    //!< Arena that was open for this thread before this one
+};
+
+/**
+ * \brief Opens an arena for the current thread for the lifetime of the scope object. Scopes can be nested.
+ */
+class GFq_MonomialArenaScope
+{
+public:
+	/**
+	 * Opens a new arena
+	 * \param block_size Size of blocks obtained from the heap
+	 */
+	GFq_MonomialArenaScope(size_t block_size = 65536);
+
+	/**
+	 * Closes the arena and restores the previous one
+	 */
+	~GFq_MonomialArenaScope();
+
+	/**
+	 * The arena opened by this scope
+	 */
+	const GFq_MonomialArena& get_arena() const
+	{
+		return *arena;
+	}
+
+protected:
+	GFq_MonomialArena *arena;
+
+private:
+	GFq_MonomialArenaScope(const GFq_MonomialArenaScope&);
+	GFq_MonomialArenaScope& operator=(const GFq_MonomialArenaScope&);
+};
+
+/**
+ * \brief Standard allocator drawing from the arena open for the current thread. It is stateless so
+ * that containers using it keep the same type and can be swapped and assigned freely.
+ */
+template<typename T>
+class GFq_MonomialAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U> struct rebind
+	{
+		typedef GFq_MonomialAllocator<U> other;
+	};
+
+	GFq_MonomialAllocator()
+	{}
+
+	GFq_MonomialAllocator(const GFq_MonomialAllocator&)
+	{}
+
+	template<typename U> GFq_MonomialAllocator(const GFq_MonomialAllocator<U>&)
+	{}
+
+	pointer address(reference x) const
+	{
+		return &x;
+	}
+
+	const_pointer address(const_reference x) const
+	{
+		return &x;
+	}
+
+	pointer allocate(size_type n, const void * = 0)
+	{
+		return static_cast<pointer>(GFq_MonomialArena::allocate(n*sizeof(T)));
+	}
+
+	void deallocate(pointer p, size_type)
+	{
+		GFq_MonomialArena::deallocate(p);
+	}
+
+	size_type max_size() const
+	{
+		return size_t(-1) / sizeof(T);
+	}
+
+	void construct(pointer p, const T& value)
+	{
+		new ((void *) p) T(value);
+	}
+
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+};
+
+template<typename T, typename U>
+inline bool operator==(const GFq_MonomialAllocator<T>&, const GFq_MonomialAllocator<U>&)
+{
+	return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const GFq_MonomialAllocator<T>&, const GFq_MonomialAllocator<U>&)
+{
+	return false;
+}
+
+} // namespace gf
+} // namespace rssoft
+
+#endif // __GFQ_MONOMIAL_ARENA_H__
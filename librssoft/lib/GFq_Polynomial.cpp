@@ -46,6 +46,7 @@
 
 #include "GFq_Polynomial.h"
 #include "GF_Exception.h"
+#include "Debug.h"
 #include <algorithm>
 #include <numeric>
 
@@ -194,31 +195,40 @@ GFq_Polynomial& GFq_Polynomial::operator+=(const GFq_Polynomial& polynomial)
 {
 	if (gf == polynomial.gf)
 	{
-		if (poly.size() < polynomial.poly.size())
+		add_unchecked(polynomial);
+	}
+
+	return *this;
+}
+
+// ================================================================================================
+GFq_Polynomial& GFq_Polynomial::add_unchecked(const GFq_Polynomial& polynomial)
+{
+	DEBUG_CHECK(gf == polynomial.gf, GF_Exception("Polynomials fields do not match"));
+
+	if (poly.size() < polynomial.poly.size())
+	{
+		unsigned int j = 0;
+		for (unsigned int i = 0; i < poly.size(); i++)
 		{
-			unsigned int j = 0;
-			for (unsigned int i = 0; i < poly.size(); i++)
-			{
-				poly[i] += polynomial.poly[j++];
-			}
+			poly[i] += polynomial.poly[j++];
+		}
 
-			for (; j < polynomial.poly.size(); j++)
-			{
-				poly.push_back(polynomial.poly[j]);
-			}
+		for (; j < polynomial.poly.size(); j++)
+		{
+			poly.push_back(polynomial.poly[j]);
 		}
-		else
+	}
+	else
+	{
+		unsigned int i = 0;
+		for (unsigned int j = 0; j < polynomial.poly.size(); j++)
 		{
-			unsigned int i = 0;
-			for (unsigned int j = 0; j < polynomial.poly.size(); j++)
-			{
-				poly[i++] += polynomial.poly[j];
-			}
+			poly[i++] += polynomial.poly[j];
 		}
-
-		simplify(*this);
 	}
 
+	simplify(*this);
 	return *this;
 }
 
@@ -247,20 +257,28 @@ GFq_Polynomial& GFq_Polynomial::operator*=(const GFq_Polynomial& polynomial)
 {
 	if (gf == polynomial.gf)
 	{
-		GFq_Polynomial product(gf, deg() + polynomial.deg() + 1);
+		multiply_unchecked(polynomial);
+	}
 
-		for (unsigned int i = 0; i < poly.size(); i++)
+	return *this;
+}
+
+// ================================================================================================
+GFq_Polynomial& GFq_Polynomial::multiply_unchecked(const GFq_Polynomial& polynomial)
+{
+	DEBUG_CHECK(gf == polynomial.gf, GF_Exception("Polynomials fields do not match"));
+	GFq_Polynomial product(gf, deg() + polynomial.deg() + 1);
+
+	for (unsigned int i = 0; i < poly.size(); i++)
+	{
+		for (unsigned int j = 0; j < polynomial.poly.size(); j++)
 		{
-			for (unsigned int j = 0; j < polynomial.poly.size(); j++)
-			{
-				product.poly[i + j] += poly[i] * polynomial.poly[j];
-			}
+			product.poly[i + j] += poly[i] * polynomial.poly[j];
 		}
-
-		simplify(product);
-		poly = product.poly;
 	}
 
+	simplify(product);
+	poly = product.poly;
 	return *this;
 }
 
@@ -338,7 +356,7 @@ GFq_Polynomial& GFq_Polynomial::operator^=(const int& n)
         
         for (unsigned int i=0; i<n-1; i++)
         {
-            result *= *this;
+            result.multiply_unchecked(*this); // same field
         }
 
         *this = result;
@@ -533,7 +551,7 @@ void GFq_Polynomial::rootChien(std::vector<GFq_Element>& roots)
 
 		for (unsigned int j=0; j<wpoly.size(); j++)
 		{
-			wpoly[j] *= gf.alpha(j);
+			wpoly[j] *= gf.alpha(j % gf.size()); // degree can exceed the field size
 		}
 	}
 }
@@ -197,6 +197,18 @@ public:
 	bool operator==(const GFq_Polynomial& polynomial) const;
 	bool operator!=(const GFq_Polynomial& polynomial) const;
 
+	/**
+	 * Adds a polynomial without checking that fields match. For inner loops where the caller
+	 * has checked it once beforehand. The check is kept in debug builds (_DEBUG).
+	 */
+	GFq_Polynomial& add_unchecked(const GFq_Polynomial& polynomial);
+
+	/**
+	 * Multiplies by a polynomial without checking that fields match. For inner loops where the
+	 * caller has checked it once beforehand. The check is kept in debug builds (_DEBUG).
+	 */
+	GFq_Polynomial& multiply_unchecked(const GFq_Polynomial& polynomial);
+
 	/**
 	 * Calculates the derivative of a polynomial
 	 */
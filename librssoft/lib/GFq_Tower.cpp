@@ -0,0 +1,254 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+ Composite (tower) field representation of GF(2^m) for even m as
+ GF((2^h)^2) with h = m/2.
+
+ */
+
+#include "GFq_Tower.h"
+#include "GF_Exception.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GFQ_TOWER_X86
+#endif
+
+namespace rssoft
+{
+namespace gf
+{
+
+namespace
+{
+
+typedef unsigned char Block __attribute__((vector_size(16))); //!< Block of 16 tower symbols or a multiplier table
+
+// ================================================================================================
+static inline __attribute__((always_inline)) void mul_add_body(const unsigned char *lo_table, const unsigned char *hi_table,
+		unsigned int half, const unsigned char *in, unsigned char *out, unsigned int size)
+{
+	Block lo, hi, x, y;
+	Block mask = {};
+	mask += (unsigned char) ((1<<half)-1);
+	memcpy(&lo, lo_table, sizeof(Block));
+	memcpy(&hi, hi_table, sizeof(Block));
+	unsigned int i = 0;
+
+	for (; i + sizeof(Block) <= size; i += sizeof(Block))
+	{
+		memcpy(&x, in + i, sizeof(Block));
+		memcpy(&y, out + i, sizeof(Block));
+		y ^= __builtin_shuffle(lo, x & mask) ^ __builtin_shuffle(hi, x >> half);
+		memcpy(out + i, &y, sizeof(Block));
+	}
+
+	for (; i < size; i++)
+	{
+		out[i] ^= lo_table[in[i] & mask[0]] ^ hi_table[in[i] >> half];
+	}
+}
+
+static void mul_add_generic(const unsigned char *lo_table, const unsigned char *hi_table,
+		unsigned int half, const unsigned char *in, unsigned char *out, unsigned int size)
+{
+	mul_add_body(lo_table, hi_table, half, in, out, size);
+}
+
+#ifdef GFQ_TOWER_X86
+static __attribute__((target("ssse3"))) void mul_add_ssse3(const unsigned char *lo_table, const unsigned char *hi_table,
+		unsigned int half, const unsigned char *in, unsigned char *out, unsigned int size)
+{
+	mul_add_body(lo_table, hi_table, half, in, out, size);
+}
+#endif
+
+// ================================================================================================
+bool cpu_has_shuffle()
+{
+#ifdef GFQ_TOWER_X86
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+#else
+	return false;
+#endif
+}
+
+} // namespace
+
+// ================================================================================================
+GFq_Tower::GFq_Tower(const GFq& _gf) :
+		gf(_gf),
+		half(_gf.pwr()/2),
+		sub_mask((1<<(_gf.pwr()/2))-1),
+		norm_w(0),
+		shuffle_kernels(cpu_has_shuffle())
+{
+	if ((gf.pwr() % 2 != 0) || (gf.pwr() < 4) || (gf.pwr() > 8))
+	{
+		throw GF_Exception("Tower field representation needs a field power of 4, 6 or 8");
+	}
+
+	unsigned int q = gf.size() + 1;
+	unsigned int sub_q = sub_mask + 1;
+	std::vector<GFq_Symbol> sub_to_std(sub_q, 0);
+	std::vector<GFq_Symbol> std_to_sub(q, GFERROR);
+
+	// subfield elements on the basis beta^i, i < h, with beta = alpha^(2^h+1) of order 2^h-1
+	for (GFq_Symbol c = 0; c < sub_q; c++)
+	{
+		for (unsigned int i = 0; i < half; i++)
+		{
+			if (c & (1<<i))
+			{
+				sub_to_std[c] ^= gf.alpha((sub_q+1)*i);
+			}
+		}
+
+		std_to_sub[sub_to_std[c]] = c;
+	}
+
+	// w of trace 1 over the subfield: w + w^(2^h) = 1. The trace is onto the subfield so that it exists.
+	GFq_Symbol w = 0;
+
+	for (GFq_Symbol s = 1; (s < q) && (w == 0); s++)
+	{
+		if ((s ^ gf.exp(s, sub_q)) == 1)
+		{
+			w = s;
+		}
+	}
+
+	norm_w = std_to_sub[gf.mul(w, gf.exp(w, sub_q))];
+
+	if ((w == 0) || (norm_w == GFERROR))
+	{
+		throw GF_Exception("Cannot find a tower field basis");
+	}
+
+	to_tower_map.resize(q);
+	from_tower_map.resize(q);
+
+	for (GFq_Symbol t = 0; t < q; t++)
+	{
+		from_tower_map[t] = gf.mul(sub_to_std[t >> half], w) ^ sub_to_std[t & sub_mask];
+		to_tower_map[from_tower_map[t]] = t;
+	}
+
+	sub_mul_table.resize(sub_q*sub_q);
+	sub_inverse.resize(sub_q, 0);
+
+	for (GFq_Symbol a = 0; a < sub_q; a++)
+	{
+		for (GFq_Symbol b = 0; b < sub_q; b++)
+		{
+			sub_mul_table[(a << half) | b] = std_to_sub[gf.mul(sub_to_std[a], sub_to_std[b])];
+		}
+
+		if (a != 0)
+		{
+			sub_inverse[a] = std_to_sub[gf.inverse(sub_to_std[a])];
+		}
+	}
+}
+
+// ================================================================================================
+GFq_Tower::~GFq_Tower()
+{}
+
+// ================================================================================================
+void GFq_Tower::to_tower(const GFq_Symbol *in, GFq_Symbol *out, unsigned int size) const
+{
+	for (unsigned int i = 0; i < size; i++)
+	{
+		out[i] = to_tower_map[in[i]];
+	}
+}
+
+// ================================================================================================
+void GFq_Tower::from_tower(const GFq_Symbol *in, GFq_Symbol *out, unsigned int size) const
+{
+	for (unsigned int i = 0; i < size; i++)
+	{
+		out[i] = from_tower_map[in[i]];
+	}
+}
+
+// ================================================================================================
+void GFq_Tower::to_tower(const GFq_Symbol *in, unsigned char *out, unsigned int size) const
+{
+	for (unsigned int i = 0; i < size; i++)
+	{
+		out[i] = to_tower_map[in[i]];
+	}
+}
+
+// ================================================================================================
+void GFq_Tower::from_tower(const unsigned char *in, GFq_Symbol *out, unsigned int size) const
+{
+	for (unsigned int i = 0; i < size; i++)
+	{
+		out[i] = from_tower_map[in[i]];
+	}
+}
+
+// ================================================================================================
+void GFq_Tower::make_multiplier(GFq_Symbol c, unsigned char *lo_table, unsigned char *hi_table) const
+{
+	memset(lo_table, 0, 16);
+	memset(hi_table, 0, 16);
+
+	// tables are linear: the entries of 2^b to 2^(b+1)-1 are the previous ones plus the product by 2^b
+	for (unsigned int b = 0; b < half; b++)
+	{
+		unsigned char lo_bit = mul(c, 1<<b);
+		unsigned char hi_bit = mul(c, 1<<(b+half));
+
+		for (unsigned int j = 0; j < (1U<<b); j++)
+		{
+			lo_table[(1<<b) + j] = lo_table[j] ^ lo_bit;
+			hi_table[(1<<b) + j] = hi_table[j] ^ hi_bit;
+		}
+	}
+}
+
+// ================================================================================================
+void GFq_Tower::mul_add(GFq_Symbol c, const unsigned char *in, unsigned char *out, unsigned int size) const
+{
+	unsigned char tables[32];
+	make_multiplier(c, tables, tables + 16);
+	mul_add(tables, in, out, size);
+}
+
+// ================================================================================================
+void GFq_Tower::mul_add(const unsigned char *tables, const unsigned char *in, unsigned char *out, unsigned int size) const
+{
+#ifdef GFQ_TOWER_X86
+	if (shuffle_kernels)
+	{
+		mul_add_ssse3(tables, tables + 16, half, in, out, size);
+		return;
+	}
+#endif
+
+	mul_add_generic(tables, tables + 16, half, in, out, size);
+}
+
+} // namespace gf
+} // namespace rssoft
@@ -0,0 +1,204 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+ Composite (tower) field representation of GF(2^m) for even m as
+ GF((2^h)^2) with h = m/2.
+
+ The subfield GF(2^h) of GF(2^m) is generated by beta = alpha^(2^h+1)
+ and its elements are written on the basis 1, beta, ..., beta^(h-1).
+ An element w with w + w^(2^h) = 1 completes the basis over the subfield
+ so that w^2 = w + n where n = w^(2^h+1) is the norm of w. A tower symbol
+ is a1*2^h + a0 for the element a1*w + a0. The maps to and from the
+ polynomial basis of the field given by its primitive polynomial are
+ linear over GF(2) and stored as LUTs of 2^m symbols.
+
+ Multiplication takes three products in GF(2^h) (Karatsuba) and one by
+ the constant n, all from a 2^h x 2^h table. Inversion goes through the
+ norm into GF(2^h). Multiplication by a constant is linear over GF(2)
+ and done with two 2^h entry tables indexed by a0 and a1. With m at most 8
+ tower symbols fit in a byte and both tables fit in a 16 byte vector so
+ that vectors of symbols are multiplied by a constant with byte shuffles
+ (SSSE3 pshufb on x86 picked at run time when the CPU supports it).
+
+ */
+
+#ifndef __GFQ_TOWER_H__
+#define __GFQ_TOWER_H__
+
+#include "GFq.h"
+#include <vector>
+
+namespace rssoft
+{
+namespace gf
+{
+
+/**
+ * \brief Tower field GF((2^h)^2) representation of a GF(2^m) field with m = 2h.
+ */
+class GFq_Tower
+{
+public:
+	/**
+	 * Constructor
+	 * \param _gf Field in polynomial basis. Its power must be 4, 6 or 8.
+	 */
+	GFq_Tower(const GFq& _gf);
+
+	~GFq_Tower();
+
+	/**
+	 * Get the field in polynomial basis
+	 */
+	const GFq& field() const
+	{
+		return gf;
+	}
+
+	/**
+	 * Get h the power of 2 of the subfield GF(2^h)
+	 */
+	unsigned int sub_pwr() const
+	{
+		return half;
+	}
+
+	/**
+	 * Map a symbol from the polynomial basis to the tower representation
+	 */
+	inline GFq_Symbol to_tower(const GFq_Symbol& value) const
+	{
+		return to_tower_map[value];
+	}
+
+	/**
+	 * Map a symbol from the tower representation to the polynomial basis
+	 */
+	inline GFq_Symbol from_tower(const GFq_Symbol& value) const
+	{
+		return from_tower_map[value];
+	}
+
+	/**
+	 * Map a vector of symbols from the polynomial basis to the tower representation. In and out may be the same.
+	 */
+	void to_tower(const GFq_Symbol *in, GFq_Symbol *out, unsigned int size) const;
+
+	/**
+	 * Map a vector of symbols from the tower representation to the polynomial basis. In and out may be the same.
+	 */
+	void from_tower(const GFq_Symbol *in, GFq_Symbol *out, unsigned int size) const;
+
+	inline GFq_Symbol add(const GFq_Symbol& a, const GFq_Symbol& b) const
+	{
+		return (a ^ b);
+	}
+
+	/**
+	 * Product of two symbols in tower representation
+	 */
+	inline GFq_Symbol mul(const GFq_Symbol& a, const GFq_Symbol& b) const
+	{
+		GFq_Symbol a0 = a & sub_mask, a1 = a >> half;
+		GFq_Symbol b0 = b & sub_mask, b1 = b >> half;
+		GFq_Symbol p0 = sub_mul(a0, b0);
+		GFq_Symbol p1 = sub_mul(a1, b1);
+		GFq_Symbol ps = sub_mul(a0 ^ a1, b0 ^ b1);
+		// (a1w + a0)(b1w + b0) = (a1b1 + a1b0 + a0b1)w + a0b0 + n*a1b1 as w^2 = w + n
+		return ((ps ^ p0) << half) | (p0 ^ sub_mul(norm_w, p1));
+	}
+
+	/**
+	 * Inverse of a symbol in tower representation. The conjugate of a1w + a0 is a1w + a1 + a0 and their
+	 * product is the norm a1^2*n + a1a0 + a0^2 in GF(2^h). Zero is returned for zero.
+	 */
+	inline GFq_Symbol inverse(const GFq_Symbol& a) const
+	{
+		GFq_Symbol a0 = a & sub_mask, a1 = a >> half;
+		GFq_Symbol norm = sub_mul(norm_w, sub_mul(a1, a1)) ^ sub_mul(a1, a0) ^ sub_mul(a0, a0);
+		GFq_Symbol norm_inv = sub_inverse[norm];
+		return (sub_mul(a1, norm_inv) << half) | sub_mul(a0 ^ a1, norm_inv);
+	}
+
+	/**
+	 * Map a vector of symbols from the polynomial basis to tower symbols stored in bytes
+	 */
+	void to_tower(const GFq_Symbol *in, unsigned char *out, unsigned int size) const;
+
+	/**
+	 * Map a vector of tower symbols stored in bytes to the polynomial basis
+	 */
+	void from_tower(const unsigned char *in, GFq_Symbol *out, unsigned int size) const;
+
+	/**
+	 * Tables of the product by a constant of tower symbols split as a1*2^h + a0:
+	 * c*(a1w + a0) = hi_table[a1] + lo_table[a0]. Entries from 2^h to 15 are zero.
+	 * \param c Constant in tower representation
+	 * \param lo_table Receives the 16 products by a0
+	 * \param hi_table Receives the 16 products by a1w
+	 */
+	void make_multiplier(GFq_Symbol c, unsigned char *lo_table, unsigned char *hi_table) const;
+
+	/**
+	 * Multiply-accumulate of a vector by a constant: out[i] += c*in[i] all in tower representation
+	 * \param c Constant
+	 * \param in Input vector
+	 * \param out Output vector
+	 * \param size Number of symbols
+	 */
+	void mul_add(GFq_Symbol c, const unsigned char *in, unsigned char *out, unsigned int size) const;
+
+	/**
+	 * Multiply-accumulate of a vector by a constant given by its tables from make_multiplier
+	 * \param tables The 16 entries of lo_table followed by the 16 entries of hi_table
+	 * \param in Input vector
+	 * \param out Output vector
+	 * \param size Number of symbols
+	 */
+	void mul_add(const unsigned char *tables, const unsigned char *in, unsigned char *out, unsigned int size) const;
+
+	/**
+	 * Tells if the vector kernels use byte shuffle instructions
+	 */
+	bool has_shuffle_kernels() const
+	{
+		return shuffle_kernels;
+	}
+
+protected:
+	inline GFq_Symbol sub_mul(const GFq_Symbol& a, const GFq_Symbol& b) const
+	{
+		return sub_mul_table[(a << half) | b];
+	}
+
+	const GFq& gf;      //!< Field in polynomial basis
+	unsigned int half;  //!< h = m/2
+	GFq_Symbol sub_mask; //!< 2^h - 1
+	GFq_Symbol norm_w;  //!< n = w^(2^h+1) in GF(2^h) with w^2 = w + n
+	std::vector<GFq_Symbol> to_tower_map;   //!< Polynomial basis to tower LUT
+	std::vector<GFq_Symbol> from_tower_map; //!< Tower to polynomial basis LUT
+	std::vector<unsigned char> sub_mul_table; //!< GF(2^h) multiplication LUT at [(a << h) | b]
+	std::vector<unsigned char> sub_inverse;   //!< GF(2^h) inverse LUT with 0 for 0
+	bool shuffle_kernels; //!< Vector kernels use byte shuffle instructions
+};
+
+} // namespace gf
+} // namespace rssoft
+
+#endif // __GFQ_TOWER_H__
@@ -42,18 +42,40 @@ GSKV_Interpolation::GSKV_Interpolation(const gf::GFq& _gf, unsigned int _k, cons
 		gf(_gf),
 		k(_k),
 		evaluation_values(_evaluation_values),
-		it_number(0),
-		Cm(0),
-		final_ig(0),
         verbosity(0),
+        shifted_basis(true),
         dX(0),
         dY(0),
-        mcost(0)
+        mcost(0),
+        shift_order(0),
+		it_number(0),
+		Cm(0),
+		final_ig(0)
 {
 	if (k < 2)
 	{
 		throw RSSoft_Exception("k parameter must be at least 2");
 	}
+
+	// fields are checked once here so that the Hasse derivatives loop uses unchecked arithmetic
+	std::vector<gf::GFq_Element>::const_iterator x_it = evaluation_values.get_x_values().begin();
+	std::vector<gf::GFq_Element>::const_iterator y_it = evaluation_values.get_y_values().begin();
+
+	for (; x_it != evaluation_values.get_x_values().end(); ++x_it)
+	{
+		if (x_it->field() != gf)
+		{
+			throw RSSoft_Exception("Evaluation points must be in the interpolation Galois Field");
+		}
+	}
+
+	for (; y_it != evaluation_values.get_y_values().end(); ++y_it)
+	{
+		if (y_it->field() != gf)
+		{
+			throw RSSoft_Exception("Symbol values must be in the interpolation Galois Field");
+		}
+	}
 }
 
 // ================================================================================================
@@ -122,6 +144,7 @@ void GSKV_Interpolation::init_G(unsigned int dY)
 	G.clear();
 	calcG.clear();
 	lodG.clear();
+	shiftedG.assign(dY+1, std::vector<gf::GFq_Symbol>());
 
 	for (unsigned int i=0; i<dY+1; i++)
 	{
@@ -138,6 +161,11 @@ void GSKV_Interpolation::init_G(unsigned int dY)
 // ================================================================================================
 void GSKV_Interpolation::process_point(unsigned int iX, unsigned int iY, unsigned int multiplicity)
 {
+	if (shifted_basis)
+	{
+		shift_G(evaluation_values.get_x_values()[iX], evaluation_values.get_y_values()[iY], multiplicity);
+	}
+
 	for (unsigned int mu = 0; mu < multiplicity; mu++)
 	{
 		for (unsigned int nu = 0; nu < multiplicity-mu; nu++)
@@ -147,6 +175,66 @@ void GSKV_Interpolation::process_point(unsigned int iX, unsigned int iY, unsigne
 	}
 }
 
+// ================================================================================================
+void GSKV_Interpolation::shift_G(const gf::GFq_Element& x, const gf::GFq_Element& y, unsigned int multiplicity)
+{
+	// P(X,Y) = sum c_ab X^a Y^b = sum c_ab (X'+x)^a (Y'+y)^b. In characteristic 2 the coefficient of X'^mu Y'^nu
+	// gets c_ab x^(a-mu) y^(b-nu) when both binomial coefficients C(a,mu) and C(b,nu) are odd that is when the
+	// bits of mu are a subset of the bits of a and likewise for nu and b (Lucas).
+	// Only mu+nu < multiplicity is needed: this is what the point's Hasse derivatives read and the G updates
+	// (linear combinations and product by X'=X-x) never bring higher order coefficients down into this range.
+	std::vector<gf::GFq_Symbol> x_pow(1,1), y_pow(1,1);
+	shift_order = multiplicity;
+
+	for (unsigned int ig = 0; ig < G.size(); ig++)
+	{
+		if (!calcG[ig])
+		{
+			continue;
+		}
+
+		std::vector<gf::GFq_Symbol>& shifted = shiftedG[ig];
+		shifted.assign(multiplicity*multiplicity, 0);
+		gf::GFq_BivariateMonomials::const_iterator mono_it = G[ig].get_monomials().begin();
+
+		for (; mono_it != G[ig].get_monomials().end(); ++mono_it)
+		{
+			unsigned int eX = mono_it->first.first;
+			unsigned int eY = mono_it->first.second;
+
+			while (x_pow.size() <= eX)
+			{
+				x_pow.push_back(gf.mul(x_pow.back(), x.poly()));
+			}
+
+			while (y_pow.size() <= eY)
+			{
+				y_pow.push_back(gf.mul(y_pow.back(), y.poly()));
+			}
+
+			for (unsigned int mu = 0; (mu < multiplicity) && (mu <= eX); mu++)
+			{
+				if (mu & ~eX) // C(eX,mu) is even
+				{
+					continue;
+				}
+
+				gf::GFq_Symbol cx = gf.mul(mono_it->second.poly(), x_pow[eX-mu]);
+
+				for (unsigned int nu = 0; (nu < multiplicity-mu) && (nu <= eY); nu++)
+				{
+					if (nu & ~eY) // C(eY,nu) is even
+					{
+						continue;
+					}
+
+					shifted[mu*multiplicity+nu] = gf.add(shifted[mu*multiplicity+nu], gf.mul(cx, y_pow[eY-nu]));
+				}
+			}
+		}
+	}
+}
+
 // ================================================================================================
 void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_Element& y, unsigned int mu, unsigned int nu)
 {
@@ -156,6 +244,7 @@ void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_E
     std::vector<gf::GFq_Element> hasse_xy_G;             //!< evaluations of Hasse derivative at (x,y) for all polynomials in G
     std::vector<gf::GFq_BivariatePolynomial> G_next; //!< G list for next iteration
     std::vector<unsigned int> lodG_next;             //!< Leading orders of polynomials in G_next
+    std::vector<std::vector<gf::GFq_Symbol> > shiftedG_next; //!< Shifted basis coefficients of polynomials in G_next
     bool zero_Hasse = true;
     std::string ind("");        //!< indicator character for debug display
     
@@ -170,8 +259,16 @@ void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_E
     {
         if (calcG[ig]) // Polynomial is part of calculation as per Li Chen's optimization
         {
-            gf::GFq_BivariatePolynomial h = dHasse(mu, nu, *it_g);
-            hasse_xy_G.push_back(h(x,y));
+            if (shifted_basis)
+            {
+                hasse_xy_G.push_back(gf::GFq_Element(gf, shiftedG[ig][mu*shift_order+nu]));
+            }
+            else
+            {
+                gf::GFq_BivariatePolynomial h = dHasse(mu, nu, *it_g);
+                hasse_xy_G.push_back(h.evaluate_unchecked(x,y));
+            }
+
             unsigned int wd = it_g->wdeg();
             
             if (hasse_xy_G.back().is_zero())
@@ -239,6 +336,11 @@ void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_E
 				{
 					G_next.push_back(*it_g); // carry over the same polynomial
 					lodG_next.push_back(lodG[ig]);
+
+					if (shifted_basis)
+					{
+						shiftedG_next.push_back(shiftedG[ig]);
+					}
 				}
 				else
 				{
@@ -246,15 +348,37 @@ void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_E
 					{
 						gf::GFq_BivariatePolynomial X1(1,k-1);
 						X1.init_x_pow(gf,1); // X1(X,Y) = X
-						G_next.push_back(hasse_xy_G[ig]*(*it_g)*(X1-x));
+						G_next.push_back(hasse_xy_G[ig]*(*it_g));
+						G_next.back().multiply_unchecked(X1-x); // all polynomials have (1,k-1) weights
 						unsigned int mX = it_g->lmX(); // leading monomial's X power
 						unsigned int mY = it_g->lmY(); // leading monomial's Y power
 						lodG_next.push_back(lodG[ig_lodmin]+(mX/(k-1))+1+mY); // new leading order by sliding one position of X powers to the right
+
+						if (shifted_basis) // X-x is X' in the shifted basis
+						{
+							shiftedG_next.push_back(std::vector<gf::GFq_Symbol>(shift_order*shift_order, 0));
+
+							for (unsigned int i = shift_order; i < shift_order*shift_order; i++)
+							{
+								shiftedG_next.back()[i] = gf.mul(hasse_xy_G[ig].poly(), shiftedG[ig][i-shift_order]);
+							}
+						}
 					}
 					else // other polynomials
 					{
-						G_next.push_back(hasse_xy_G[ig]*G[ig_lodmin]-hasse_xy_G[ig_lodmin]*(*it_g));
+						G_next.push_back(hasse_xy_G[ig]*G[ig_lodmin]);
+						G_next.back().add_unchecked(hasse_xy_G[ig_lodmin]*(*it_g)); // minus is plus in GF(2^m)
 						lodG_next.push_back(std::max(lodG[ig],lodG[ig_lodmin]));   // new leading order is the max of the two
+
+						if (shifted_basis)
+						{
+							shiftedG_next.push_back(std::vector<gf::GFq_Symbol>(shift_order*shift_order));
+
+							for (unsigned int i = 0; i < shift_order*shift_order; i++)
+							{
+								shiftedG_next.back()[i] = gf.add(gf.mul(hasse_xy_G[ig].poly(), shiftedG[ig_lodmin][i]), gf.mul(hasse_xy_G[ig_lodmin].poly(), shiftedG[ig][i]));
+							}
+						}
 					}
 				}
 
@@ -267,12 +391,25 @@ void GSKV_Interpolation::process_hasse(const gf::GFq_Element& x, const gf::GFq_E
 			{
 				G_next.push_back(*it_g); // carry over the same polynomial
 				lodG_next.push_back(lodG[ig]);
+
+				if (shifted_basis)
+				{
+					shiftedG_next.push_back(shiftedG[ig]);
+				}
 			}
 		}
 
 		// store next values if matrix cost is not reached
 		if (it_number < mcost)
-		G.assign(G_next.begin(), G_next.end());
+		{
+			G.assign(G_next.begin(), G_next.end());
+
+			if (shifted_basis)
+			{
+				shiftedG.swap(shiftedG_next);
+			}
+		}
+
 		lodG.assign(lodG_next.begin(), lodG_next.end());
     }
     
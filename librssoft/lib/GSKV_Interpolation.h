@@ -47,7 +47,8 @@ public:
 	 * Constructor
 	 * \param _gf Reference to the Galois Field being used
 	 * \param _k as in RS(n,k)
-	 * \param _evaluation_values Evaluation X,Y values used for coding
+	 * \param _evaluation_values Evaluation X,Y values used for coding. Their field is checked once here
+	 * and not in the interpolation loops.
 	 */
 	GSKV_Interpolation(const gf::GFq& _gf, unsigned int _k, const EvaluationValues& _evaluation_values);
 
@@ -78,6 +79,19 @@ public:
         verbosity = _verbosity;
     }
     
+    /**
+     * Set or reset the shifted basis mode. When set (default) the low order coefficients of the G polynomials
+     * in the basis X'=X-x, Y'=Y-y of the current point (x,y) are computed once when entering the point and
+     * updated along with the polynomials. The Hasse derivatives D_{mu,nu} at (x,y) are then read as the
+     * coefficients of X'^mu Y'^nu instead of being evaluated from scratch at each inner iteration.
+     * Both modes give the same result polynomial.
+     * \param _shifted_basis True to use the shifted basis
+     */
+    void set_shifted_basis(bool _shifted_basis)
+    {
+        shifted_basis = _shifted_basis;
+    }
+
     unsigned int get_dX() const
     {
     	return dX;
@@ -114,6 +128,15 @@ protected:
 	 */
 	void process_point(unsigned int iX, unsigned int iY, unsigned int multiplicity);
 
+	/**
+	 * Compute the coefficients of X'^mu Y'^nu for mu+nu < multiplicity of the G polynomials being processed
+	 * in the shifted basis X'=X-x, Y'=Y-y
+	 * \param x Evaluation point in GFq
+	 * \param y Value in GFq at evaluation point
+	 * \param multiplicity Multiplicity
+	 */
+	void shift_G(const gf::GFq_Element& x, const gf::GFq_Element& y, unsigned int multiplicity);
+
 	/**
 	 * Process a Hasse derivative. This is the inner iteration of the algorithm
 	 * \param x Evaluation point in GFq
@@ -134,6 +157,7 @@ protected:
 	unsigned int k; //!< k factor as in RS(n,k)
 	const EvaluationValues& evaluation_values; //!< Interpolation X,Y values
     unsigned int verbosity; //!< Verbose level, 0 to shut down any debug message
+    bool shifted_basis; //!< Hasse derivatives are read in the shifted basis of the current point
 
 	// parameters changing at each process run
     unsigned int dX;
@@ -142,6 +166,8 @@ protected:
 	std::vector<gf::GFq_BivariatePolynomial> G; //!< The G list of polynomials
 	std::vector<bool> calcG; //!< Li Chen's optimization. If true the corresponding polynomial in G is processed.
 	std::vector<unsigned int> lodG; //!< Leading orders of polynomials in G
+	std::vector<std::vector<gf::GFq_Symbol> > shiftedG; //!< Coefficients of X'^mu Y'^nu at index mu*shift_order+nu of polynomials in G in the shifted basis
+	unsigned int shift_order; //!< Multiplicity of the current point in the shifted basis mode
     unsigned int it_number; //!< Hasse derivative iteration number (inner loop)
     unsigned int Cm; //!< Cost of current multiplicity matrix
     unsigned int final_ig; //!< Index of the result polynomial in G list
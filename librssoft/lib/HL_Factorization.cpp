@@ -0,0 +1,435 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Hensel lifting factorization class for soft decision decoding
+
+ */
+#include "HL_Factorization.h"
+#include "GFq.h"
+#include "GFq_Polynomial.h"
+#include "GFq_BivariatePolynomial.h"
+#include "RSSoft_Exception.h"
+#include "Debug.h"
+#include <algorithm>
+
+namespace rssoft
+{
+
+// ================================================================================================
+HL_Factorization::HL_Factorization(const gf::GFq& _gf, unsigned int _k) :
+		gf(_gf),
+		k(_k),
+		verbosity(0),
+		nb_lifts(0),
+		nb_expansions(0)
+{
+
+}
+
+// ================================================================================================
+HL_Factorization::~HL_Factorization()
+{
+
+}
+
+// ================================================================================================
+void HL_Factorization::init()
+{
+	nb_lifts = 0;
+	nb_expansions = 0;
+	F.clear();
+}
+
+// ================================================================================================
+std::vector<gf::GFq_Polynomial>& HL_Factorization::run(const gf::GFq_BivariatePolynomial& polynomial)
+{
+    if (!polynomial.is_valid())
+    {
+        throw RSSoft_Exception("Invalid polynomial");
+    }
+    else if (k == 0)
+    {
+    	throw RSSoft_Exception("k must be positive");
+    }
+    else
+    {
+    	to_dense(polynomial, Q);
+    	star(Q); // same roots in Y
+    	Series prefix;
+
+    	if (Q.size() > 0)
+    	{
+    		node_run(Q, prefix);
+    	}
+
+        return F;
+    }
+}
+
+// ================================================================================================
+void HL_Factorization::node_run(const DenseBivariatePolynomial& Qu, Series& prefix)
+{
+	DenseBivariatePolynomial Qu_Y;
+	derivative_Y(Qu, Qu_Y);
+	Series Q0(Qu.size(), 0);   // Qu(0,Y)
+	Series Q0_Y(Qu_Y.size(), 0); // Qu_Y(0,Y)
+
+	for (unsigned int j=0; j<Qu.size(); j++)
+	{
+		Q0[j] = (Qu[j].size() > 0 ? Qu[j][0] : 0);
+	}
+
+	for (unsigned int j=0; j<Qu_Y.size(); j++)
+	{
+		Q0_Y[j] = (Qu_Y[j].size() > 0 ? Qu_Y[j][0] : 0);
+	}
+
+	DEBUG_OUT(verbosity > 0, "*** Depth " << prefix.size() << ": dY = " << Qu.size()-1 << std::endl);
+
+	for (unsigned int ry=0; ry <= gf.size(); ry++) // search roots of Qu(0,Y) over all the field
+	{
+		if (evaluate(Q0, ry) != 0)
+		{
+			continue;
+		}
+
+		if (evaluate(Q0_Y, ry) != 0) // simple root: lift it up to the required precision
+		{
+			Series s;
+			lift(Qu, Qu_Y, ry, k - prefix.size(), s);
+			nb_lifts++;
+			DEBUG_OUT(verbosity > 1, "    simple root " << ry << " lifted" << std::endl);
+			Series f(prefix);
+			f.insert(f.end(), s.begin(), s.end());
+			collect(f);
+		}
+		else // multiple root: take one Roth-Ruckenstein step
+		{
+			nb_expansions++;
+			DEBUG_OUT(verbosity > 1, "    multiple root " << ry << " expanded" << std::endl);
+			prefix.push_back(ry);
+
+			if (prefix.size() == k)
+			{
+				collect(prefix);
+			}
+			else
+			{
+				DenseBivariatePolynomial Qv;
+				shift(Qu, ry, Qv);
+				star(Qv);
+
+				if (Qv.size() > 0)
+				{
+					node_run(Qv, prefix);
+				}
+			}
+
+			prefix.pop_back();
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::lift(const DenseBivariatePolynomial& Qu, const DenseBivariatePolynomial& Qu_Y, gf::GFq_Symbol ry, unsigned int precision, Series& s) const
+{
+	Series e, d, d_inv, correction;
+	unsigned int p = 1;
+	s.assign(1, ry);
+
+	while (p < precision)
+	{
+		unsigned int p2 = std::min(2*p, precision);
+		// s <- s - Qu(X,s)/Qu_Y(X,s) mod X^p2
+		evaluate(Qu, s, p2, e);
+		evaluate(Qu_Y, s, p2, d);
+		inverse(d, p2, d_inv);
+		multiply(e, d_inv, p2, correction);
+		s.resize(p2, 0);
+
+		for (unsigned int i=0; i<correction.size(); i++)
+		{
+			s[i] = gf.sub(s[i], correction[i]);
+		}
+
+		p = p2;
+	}
+}
+
+// ================================================================================================
+bool HL_Factorization::is_root(const Series& f) const
+{
+	Series result;
+	evaluate(Q, f, 0, result);
+	Series::const_iterator r_it = result.begin();
+
+	for (; r_it != result.end(); ++r_it)
+	{
+		if (*r_it != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ================================================================================================
+void HL_Factorization::collect(const Series& f)
+{
+	unsigned int size = f.size();
+
+	while ((size > 1) && (f[size-1] == 0))
+	{
+		size--;
+	}
+
+	Series f_trimmed(f.begin(), f.begin() + size);
+
+	if (is_root(f_trimmed))
+	{
+		std::vector<gf::GFq_Element> poly;
+
+		for (unsigned int i=0; i<size; i++)
+		{
+			poly.push_back(gf::GFq_Element(gf, f_trimmed[i]));
+		}
+
+		gf::GFq_Polynomial Fi(gf, poly);
+
+		if (std::find(F.begin(), F.end(), Fi) == F.end())
+		{
+			DEBUG_OUT(verbosity > 0, "    Fi = " << Fi << std::endl);
+			F.push_back(Fi);
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::to_dense(const gf::GFq_BivariatePolynomial& polynomial, DenseBivariatePolynomial& Q) const
+{
+	Q.clear();
+	gf::GFq_BivariateMonomials::const_iterator mono_it = polynomial.get_monomials().begin();
+
+	for (; mono_it != polynomial.get_monomials().end(); ++mono_it)
+	{
+		unsigned int x = mono_it->first.x();
+		unsigned int y = mono_it->first.y();
+
+		if (y >= Q.size())
+		{
+			Q.resize(y+1);
+		}
+
+		if (x >= Q[y].size())
+		{
+			Q[y].resize(x+1, 0);
+		}
+
+		Q[y][x] = gf.add(Q[y][x], mono_it->second.poly());
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::star(DenseBivariatePolynomial& Q) const
+{
+	unsigned int h = 0;
+	bool h_found = false;
+
+	for (unsigned int j=0; j<Q.size(); j++) // trim rows and find the lowest power of X
+	{
+		while ((Q[j].size() > 0) && (Q[j].back() == 0))
+		{
+			Q[j].pop_back();
+		}
+
+		for (unsigned int i=0; i<Q[j].size(); i++)
+		{
+			if (Q[j][i] != 0)
+			{
+				if (!h_found || (i < h))
+				{
+					h = i;
+					h_found = true;
+				}
+
+				break;
+			}
+		}
+	}
+
+	while ((Q.size() > 0) && (Q.back().size() == 0))
+	{
+		Q.pop_back();
+	}
+
+	if (h > 0)
+	{
+		for (unsigned int j=0; j<Q.size(); j++)
+		{
+			if (Q[j].size() > 0)
+			{
+				Q[j].erase(Q[j].begin(), Q[j].begin() + h);
+			}
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::shift(const DenseBivariatePolynomial& Qu, gf::GFq_Symbol ry, DenseBivariatePolynomial& Qv) const
+{
+	Series ry_pow(Qu.size(), 1);
+
+	for (unsigned int j=1; j<Qu.size(); j++)
+	{
+		ry_pow[j] = gf.mul(ry_pow[j-1], ry);
+	}
+
+	Qv.assign(Qu.size(), Series());
+
+	// (X*Y+ry)^j = sum of C(j,i)*ry^(j-i)*X^i*Y^i and C(j,i) is odd iff the bits of i are a subset of the bits of j
+	for (unsigned int j=0; j<Qu.size(); j++)
+	{
+		for (unsigned int i=0; i<=j; i++)
+		{
+			if (((i & j) != i) || (Qu[j].size() == 0) || (ry_pow[j-i] == 0))
+			{
+				continue;
+			}
+
+			if (Qv[i].size() < Qu[j].size() + i)
+			{
+				Qv[i].resize(Qu[j].size() + i, 0);
+			}
+
+			for (unsigned int x=0; x<Qu[j].size(); x++)
+			{
+				Qv[i][x+i] = gf.add(Qv[i][x+i], gf.mul(ry_pow[j-i], Qu[j][x]));
+			}
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::derivative_Y(const DenseBivariatePolynomial& Q, DenseBivariatePolynomial& Q_Y) const
+{
+	Q_Y.clear();
+
+	for (unsigned int j=1; j<Q.size(); j++)
+	{
+		if (j % 2 == 1) // j*q_j is zero for even j in characteristic 2
+		{
+			Q_Y.resize(j);
+			Q_Y[j-1] = Q[j];
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::evaluate(const DenseBivariatePolynomial& Q, const Series& s, unsigned int precision, Series& result) const
+{
+	Series product;
+	result.clear();
+
+	for (int j=Q.size()-1; j>=0; j--) // Horner
+	{
+		multiply(result, s, precision, product);
+		result.swap(product);
+		unsigned int size = Q[j].size();
+
+		if ((precision > 0) && (size > precision))
+		{
+			size = precision;
+		}
+
+		if (result.size() < size)
+		{
+			result.resize(size, 0);
+		}
+
+		for (unsigned int i=0; i<size; i++)
+		{
+			result[i] = gf.add(result[i], Q[j][i]);
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::multiply(const Series& a, const Series& b, unsigned int precision, Series& product) const
+{
+	product.clear();
+
+	if ((a.size() == 0) || (b.size() == 0))
+	{
+		return;
+	}
+
+	unsigned int size = a.size() + b.size() - 1;
+
+	if ((precision > 0) && (size > precision))
+	{
+		size = precision;
+	}
+
+	product.assign(size, 0);
+
+	for (unsigned int i=0; i<a.size() && i<size; i++)
+	{
+		if (a[i] == 0)
+		{
+			continue;
+		}
+
+		for (unsigned int j=0; (j<b.size()) && (i+j<size); j++)
+		{
+			product[i+j] = gf.add(product[i+j], gf.mul(a[i], b[j]));
+		}
+	}
+}
+
+// ================================================================================================
+void HL_Factorization::inverse(const Series& h, unsigned int precision, Series& h_inv) const
+{
+	Series g2;
+	unsigned int q = 1;
+	h_inv.assign(1, gf.inverse(h[0]));
+
+	while (q < precision)
+	{
+		q = std::min(2*q, precision);
+		// g <- 2g - h*g^2 = h*g^2 in characteristic 2
+		multiply(h_inv, h_inv, q, g2);
+		multiply(h, g2, q, h_inv);
+	}
+}
+
+// ================================================================================================
+gf::GFq_Symbol HL_Factorization::evaluate(const Series& p, gf::GFq_Symbol value) const
+{
+	gf::GFq_Symbol result = 0;
+
+	for (int i=p.size()-1; i>=0; i--)
+	{
+		result = gf.add(gf.mul(result, value), p[i]);
+	}
+
+	return result;
+}
+
+} // namespace rssoft
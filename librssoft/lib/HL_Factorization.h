@@ -0,0 +1,183 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Hensel lifting factorization class for soft decision decoding
+
+	 Finds the Y-roots f(X) of degree less than k of Q(X,Y) as power series.
+	 Simple roots of Q(0,Y) are lifted by Newton iteration doubling the
+	 precision at each step with dense univariate arithmetic. Multiple roots
+	 cannot be lifted this way and take one Roth-Ruckenstein step
+	 Q(X,Y) <- <<Q(X,X*Y+r)>> before lifting the roots of the new polynomial.
+	 Candidates are kept only if they are exact roots of Q(X,Y).
+
+ */
+#ifndef __HL_FACTORIZATION_H__
+#define __HL_FACTORIZATION_H__
+
+#include "GFq_Polynomial.h"
+#include "GFq_Element.h"
+#include <vector>
+
+namespace rssoft
+{
+
+namespace gf
+{
+class GFq;
+class GFq_BivariatePolynomial;
+}
+
+/**
+ * \brief Hensel lifting factorization. Alternative to RR_Factorization with the same interface.
+ */
+class HL_Factorization
+{
+public:
+	typedef std::vector<gf::GFq_Symbol> Series;         //!< Power series or polynomial in X by increasing powers
+	typedef std::vector<Series> DenseBivariatePolynomial; //!< Polynomials in X of each power of Y by increasing powers
+
+	/**
+	 * Constructor
+	 * \param gf Reference to the Galois Field being used
+	 * \param k as in RS(n,k)
+	 */
+	HL_Factorization(const gf::GFq& _gf, unsigned int _k);
+
+	/**
+	 * Destructor
+	 */
+	~HL_Factorization();
+
+	/**
+	 * Initialization before run
+	 */
+	void init();
+
+    /**
+     * Set verbosity level, 0 for none. This is active only in debug mode (CPPFLAGS=-D_DEBUG)
+     */
+    void set_verbosity(unsigned int _verbosity)
+    {
+        verbosity = _verbosity;
+    }
+
+	/**
+	 * Run factorization of given polynomial
+	 * \param polynomial Input polynomial
+     * \return list of polynomial factors
+	 */
+	std::vector<gf::GFq_Polynomial>& run(const gf::GFq_BivariatePolynomial& polynomial);
+
+	/**
+	 * Get the number of Newton liftings done since initialization
+	 */
+	unsigned int get_nb_lifts() const
+	{
+		return nb_lifts;
+	}
+
+	/**
+	 * Get the number of Roth-Ruckenstein steps done on multiple roots since initialization
+	 */
+	unsigned int get_nb_expansions() const
+	{
+		return nb_expansions;
+	}
+
+protected:
+	/**
+	 * Recursive run on a polynomial at a given depth
+	 * \param Qu Polynomial. X does not divide it.
+	 * \param prefix Coefficients of f(X) found so far, its size is the depth
+	 */
+	void node_run(const DenseBivariatePolynomial& Qu, Series& prefix);
+
+	/**
+	 * Newton lifting of a simple root of Q(0,Y)
+	 * \param Qu Polynomial
+	 * \param Qu_Y Derivative of the polynomial in Y
+	 * \param ry Simple root of Qu(0,Y)
+	 * \param precision Number of coefficients to compute
+	 * \param s Lifted root such that Qu(X,s(X)) = 0 mod X^precision
+	 */
+	void lift(const DenseBivariatePolynomial& Qu, const DenseBivariatePolynomial& Qu_Y, gf::GFq_Symbol ry, unsigned int precision, Series& s) const;
+
+	/**
+	 * Tells if f(X) is a root of the input polynomial
+	 */
+	bool is_root(const Series& f) const;
+
+	/**
+	 * Collects a root candidate if it is an exact root
+	 */
+	void collect(const Series& f);
+
+	/**
+	 * Converts from the map representation
+	 */
+	void to_dense(const gf::GFq_BivariatePolynomial& polynomial, DenseBivariatePolynomial& Q) const;
+
+	/**
+	 * Divides by the greatest power of X dividing the polynomial and removes zero powers of Y on top
+	 */
+	void star(DenseBivariatePolynomial& Q) const;
+
+	/**
+	 * Qv(X,Y) = Qu(X,X*Y+ry) (star is not applied)
+	 */
+	void shift(const DenseBivariatePolynomial& Qu, gf::GFq_Symbol ry, DenseBivariatePolynomial& Qv) const;
+
+	/**
+	 * Derivative in Y
+	 */
+	void derivative_Y(const DenseBivariatePolynomial& Q, DenseBivariatePolynomial& Q_Y) const;
+
+	/**
+	 * Evaluation of Q(X,s(X)) mod X^precision. Precision 0 is exact evaluation.
+	 */
+	void evaluate(const DenseBivariatePolynomial& Q, const Series& s, unsigned int precision, Series& result) const;
+
+	/**
+	 * Product a*b mod X^precision. Precision 0 is exact product.
+	 */
+	void multiply(const Series& a, const Series& b, unsigned int precision, Series& product) const;
+
+	/**
+	 * Inverse of h mod X^precision by Newton iteration. h(0) must not be zero.
+	 */
+	void inverse(const Series& h, unsigned int precision, Series& h_inv) const;
+
+	/**
+	 * Evaluation of a univariate polynomial in GF(2^m)
+	 */
+	gf::GFq_Symbol evaluate(const Series& p, gf::GFq_Symbol value) const;
+
+	const gf::GFq& gf; //!< Reference to the Galois Field being used
+	unsigned int k;    //!< k as in RS(n,k)
+	unsigned int verbosity; //!< verbosity level, 0 for none
+
+	DenseBivariatePolynomial Q; //!< Input polynomial
+	unsigned int nb_lifts;      //!< Number of Newton liftings
+	unsigned int nb_expansions; //!< Number of Roth-Ruckenstein steps
+	std::vector<gf::GFq_Polynomial> F; //!< Result list of f(X) polynomials
+};
+
+} // namespace rssoft
+
+#endif // __HL_FACTORIZATION_H__
@@ -22,6 +22,7 @@
  */
 #include "MultiplicityMatrix.h"
 #include "RS_ReliabilityMatrix.h"
+#include "RS_ReliabilityKernels.h"
 #include <iomanip>
 #include <cmath>
  
@@ -61,19 +62,13 @@ MultiplicityMatrix::MultiplicityMatrix(const RS_ReliabilityMatrix& relmat, unsig
     }
     else // build for hard decision
     {
+        const RS_ReliabilityKernels& kernels = RS_ReliabilityKernels::get();
+
         for (unsigned int ic = 0; ic < _message_length; ic++)
         {
-            float max_p = 0.0;
-            unsigned int max_ir = 0;
-            
-            for (unsigned int ir = 0; ir < _nb_symbols; ir++)
-            {
-                if (relmat(ir, ic) > max_p)
-                {
-                    max_p = relmat(ir, ic);
-                    max_ir = ir;
-                }
-            }
+            const float *column = &relmat.get_raw_matrix()[ic*_nb_symbols];
+            float max_p = kernels.max_value(column, _nb_symbols, 0.0);
+            unsigned int max_ir = (max_p > 0.0 ? kernels.find_first(column, _nb_symbols, max_p) : 0);
             
             insert(std::make_pair(std::make_pair(max_ir, ic), multiplicity));
         }
@@ -110,6 +105,30 @@ MultiplicityMatrix::MultiplicityMatrix(const RS_ReliabilityMatrix& relmat, float
     _cost /= 2;
  }
  
+// ================================================================================================
+MultiplicityMatrix::MultiplicityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, const unsigned int *multiplicities, unsigned int stride) :
+    _nb_symbols_log2(nb_symbols_log2),
+    _nb_symbols(1<<nb_symbols_log2),
+    _message_length(message_length),
+    _cost(0)
+{
+    for (unsigned int ic = 0; ic < _message_length; ic++)
+    {
+        for (unsigned int ir = 0; ir < _nb_symbols; ir++)
+        {
+            unsigned int m = multiplicities[(ic*_nb_symbols + ir)*stride];
+
+            if (m > 0)
+            {
+                insert(end(), std::make_pair(std::make_pair(ir, ic), m)); // column first order is the map order
+                _cost += m * (m + 1);
+            }
+        }
+    }
+
+    _cost /= 2;
+}
+
 // ================================================================================================
 MultiplicityMatrix::~MultiplicityMatrix()
 {}
@@ -118,6 +118,15 @@ public:
      * \param lambda Multiplicative constant
      */
     MultiplicityMatrix(const RS_ReliabilityMatrix& relmat, float lambda);
+
+    /**
+     * Constructs a new multiplicity matrix from dense multiplicities e.g. computed for a batch of codewords by RS_BatchReliabilityMatrix
+     * \param nb_symbols_log2 Log2 of the number of symbols (rows)
+     * \param message_length Number of message symbols (columns)
+     * \param multiplicities Multiplicity at row i column j is at [(j*nb_symbols + i)*stride]
+     * \param stride Distance between successive multiplicities (batch size for interleaved storage)
+     */
+    MultiplicityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, const unsigned int *multiplicities, unsigned int stride = 1);
     
     /**
      * Destructor
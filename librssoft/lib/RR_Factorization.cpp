@@ -25,15 +25,18 @@
 #include "GFq.h"
 #include "GFq_Polynomial.h"
 #include "GFq_BivariatePolynomial.h"
+#include "GFq_BivariateFlatPolynomial.h"
+#include "RR_TaskPool.h"
 #include "RSSoft_Exception.h"
 #include "Debug.h"
+#include <string>
 
 namespace rssoft
 {
 
 // ================================================================================================
 RR_Node::RR_Node(RR_Node *_parent,
-		const gf::GFq_BivariatePolynomial& _Q,
+		const gf::GFq_BivariateFlatPolynomial& _Q,
         const gf::GFq_Element& _coeff,
 		unsigned int _id) :
 	parent(_parent),
@@ -51,12 +54,66 @@ RR_Node::RR_Node(RR_Node *_parent,
 	}
 }
 
+// ================================================================================================
+/**
+ * \brief Exploration of the subtree of a branch of the root node
+ */
+class RR_BranchTask : public RR_Task
+{
+public:
+	RR_BranchTask(RR_Factorization& _factorization, RR_Node& _root_node, const gf::GFq_Element& _ry) :
+		factorization(_factorization),
+		root_node(_root_node),
+		ry(_ry),
+		root_stop(false),
+		part_Fv(_ry.field()),
+		failed(false)
+	{}
+
+	virtual void run(unsigned int worker_index);
+
+	RR_Factorization& factorization; //!< Factorization being run
+	RR_Node& root_node;       //!< Root node
+	gf::GFq_Element ry;       //!< Root in Y of the root node's polynomial followed by this branch
+	bool root_stop;           //!< Qv(Y=0) = 0 at the root node stops the exploration of the following branches
+	gf::GFq_Polynomial part_Fv; //!< Result of the branch, invalid if the route is invalid
+	bool failed;              //!< An exception was caught
+	std::string error;        //!< Message of the exception caught
+};
+
+// ================================================================================================
+void RR_BranchTask::run(unsigned int worker_index)
+{
+	try
+	{
+		RR_Factorization& explorer = *factorization.explorers[worker_index];
+		gf::GFq_BivariateFlatPolynomial Qv = RR_Factorization::child_polynomial(root_node.getQ(), ry);
+
+		if (Qv.get_X_0().is_zero()) // Qv(Y=0) = 0
+		{
+			root_stop = true;
+		}
+		else if (root_node.get_degree() != factorization.k-1) // else the route is invalid
+		{
+			explorer.t++;
+			RR_Node child_node(&root_node, Qv, ry, explorer.t);
+			part_Fv = explorer.node_run(child_node);
+		}
+	}
+	catch (std::exception& e)
+	{
+		failed = true;
+		error = e.what();
+	}
+}
+
 // ================================================================================================
 RR_Factorization::RR_Factorization(const gf::GFq& _gf, unsigned int _k) :
 		gf(_gf),
 		k(_k),
 		t(0),
-        verbosity(0)
+        verbosity(0),
+        task_pool(0)
 {
 
 }
@@ -64,7 +121,62 @@ RR_Factorization::RR_Factorization(const gf::GFq& _gf, unsigned int _k) :
 // ================================================================================================
 RR_Factorization::~RR_Factorization()
 {
+	set_nb_threads(0);
+}
+
+// ================================================================================================
+void RR_Factorization::set_verbosity(unsigned int _verbosity)
+{
+	verbosity = _verbosity;
+	std::vector<RR_Factorization*>::iterator e_it = explorers.begin();
 
+	for (; e_it != explorers.end(); ++e_it)
+	{
+		(*e_it)->set_verbosity(_verbosity);
+	}
+}
+
+// ================================================================================================
+void RR_Factorization::set_nb_threads(unsigned int nb_threads)
+{
+	if (task_pool)
+	{
+		delete task_pool;
+		task_pool = 0;
+	}
+
+	std::vector<RR_Factorization*>::iterator e_it = explorers.begin();
+
+	for (; e_it != explorers.end(); ++e_it)
+	{
+		delete *e_it;
+	}
+
+	explorers.clear();
+
+	if (nb_threads > 1)
+	{
+		for (unsigned int i=0; i<nb_threads; i++)
+		{
+			explorers.push_back(new RR_Factorization(gf, k));
+			explorers.back()->set_verbosity(verbosity);
+		}
+
+		task_pool = new RR_TaskPool(nb_threads);
+	}
+}
+
+// ================================================================================================
+unsigned int RR_Factorization::get_nb_threads() const
+{
+	if (task_pool)
+	{
+		return task_pool->get_nb_workers();
+	}
+	else
+	{
+		return 1;
+	}
 }
 
 // ================================================================================================
@@ -84,8 +196,19 @@ std::vector<gf::GFq_Polynomial>& RR_Factorization::run(const gf::GFq_BivariatePo
     else
     {
         const gf::GFq& gf = polynomial.get_leading_monomial().coeff().field();
-        RR_Node u(0, polynomial, gf::GFq_Element(gf,0), t);
-        node_run(u);
+        gf::GFq_Element root_coeff(gf,0); // the node keeps a reference to it
+        gf::GFq_BivariateFlatPolynomial Q(gf, polynomial); // the node keeps a reference to it
+        RR_Node u(0, Q, root_coeff, t);
+
+        if (task_pool)
+        {
+        	parallel_run(u);
+        }
+        else
+        {
+        	node_run(u);
+        }
+
         return F;
     }
 }
@@ -93,7 +216,7 @@ std::vector<gf::GFq_Polynomial>& RR_Factorization::run(const gf::GFq_BivariatePo
 // ================================================================================================
 gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
 {
-	gf::GFq_BivariatePolynomial Qu = rr_node.getQ();
+	const gf::GFq_BivariateFlatPolynomial& Qu = rr_node.getQ();
     gf::GFq_Polynomial Qy = Qu.get_0_Y();
 	std::vector<rssoft::gf::GFq_Element> roots_y;
 	Qy.rootChien(roots_y);
@@ -104,9 +227,6 @@ gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
     if (ry_it != roots_y.end())
     {
         const gf::GFq& gf = ry_it->field();
-        gf::GFq_BivariatePolynomial X1Y0(Qu.get_weights());
-        X1Y0.init_x_pow(gf, 1); // X1Y0(X,Y) = X 
-        rssoft::gf::GFq_BivariateMonomial m_XY(rssoft::gf::GFq_Element(gf,1),1,1); // X*Y
         std::vector<gf::GFq_Element> poly_X1;
         poly_X1.push_back(gf::GFq_Element(gf,0));
         poly_X1.push_back(gf::GFq_Element(gf,1));
@@ -117,13 +237,7 @@ gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
             if (!rr_node.is_in_ry_set(*ry_it))
             {
                 rr_node.add_ry(*ry_it);
-                gf::GFq_BivariatePolynomial Yv(Qu.get_weights()); // Yv(X,Y) = X*Y + ry
-                std::vector<rssoft::gf::GFq_BivariateMonomial> monos_Yv; 
-                rssoft::gf::GFq_BivariateMonomial m_ry(*ry_it,0,0);
-                monos_Yv.push_back(m_ry);
-                monos_Yv.push_back(m_XY);
-                Yv.init(monos_Yv);
-                gf::GFq_BivariatePolynomial Qv = star(Qu(X1Y0,Yv));
+                gf::GFq_BivariateFlatPolynomial Qv = child_polynomial(Qu, *ry_it);
                 DEBUG_OUT(verbosity > 0, "    ry = " << *ry_it << " : Qv = " << Qv << std::endl);
                 
                 // Optimization: anticipate behaviour at child node
@@ -133,7 +247,8 @@ gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
                     if (rr_node.get_degree() < k-1)
                     { // trace back this route from node v
                     	DEBUG_OUT(verbosity > 1, "    -> trace back this route from node v: " << (rr_node.get_coeff()*(X1^rr_node.get_degree()))+(*ry_it*(X1^(rr_node.get_degree()+1))) << std::endl);
-                        return (rr_node.get_coeff()*(X1^rr_node.get_degree()))+(*ry_it*(X1^(rr_node.get_degree()+1))); 
+                        gf::GFq_Polynomial part_Fu = rr_node.get_coeff()*(X1^rr_node.get_degree());
+                        return part_Fu.add_unchecked(*ry_it*(X1^(rr_node.get_degree()+1))); // all in the field of the roots
                     }
                     else
                     { // trace back this route from node u
@@ -172,7 +287,8 @@ gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
 						else
 						{
 							DEBUG_OUT(verbosity > 1, "    -> return partial polynomial: " << ((rr_node.get_coeff()*(X1^rr_node.get_degree())) + part_Fv) <<  std::endl);
-							return (rr_node.get_coeff()*(X1^rr_node.get_degree())) + part_Fv;
+							gf::GFq_Polynomial part_Fu = rr_node.get_coeff()*(X1^rr_node.get_degree());
+							return part_Fu.add_unchecked(part_Fv); // all in the field of the roots
 						}
 					}
 				}
@@ -183,5 +299,81 @@ gf::GFq_Polynomial RR_Factorization::node_run(RR_Node& rr_node)
     return gf::GFq_Polynomial(gf);
 }
 
+// ================================================================================================
+void RR_Factorization::parallel_run(RR_Node& root_node)
+{
+    gf::GFq_Polynomial Qy = root_node.getQ().get_0_Y();
+	std::vector<rssoft::gf::GFq_Element> roots_y;
+	Qy.rootChien(roots_y);
+	std::vector<rssoft::gf::GFq_Element>::const_iterator ry_it = roots_y.begin();
+	std::vector<RR_BranchTask*> branch_tasks;
+	std::vector<RR_Task*> tasks;
+
+	DEBUG_OUT(verbosity > 0, "*** Root node: " << roots_y.size() << " roots in Y explored with " << task_pool->get_nb_workers() << " threads" << std::endl);
+
+	for (; ry_it != roots_y.end(); ++ry_it)
+	{
+		if (!root_node.is_in_ry_set(*ry_it))
+		{
+			root_node.add_ry(*ry_it);
+			branch_tasks.push_back(new RR_BranchTask(*this, root_node, *ry_it));
+			tasks.push_back(branch_tasks.back());
+		}
+	}
+
+	task_pool->run(tasks);
+
+	// merge in the order of the sequential exploration
+	std::string error;
+	bool failed = false;
+	std::vector<RR_BranchTask*>::iterator task_it = branch_tasks.begin();
+
+	for (; task_it != branch_tasks.end(); ++task_it)
+	{
+		if ((*task_it)->failed)
+		{
+			failed = true;
+			error = (*task_it)->error;
+			break;
+		}
+		else if ((*task_it)->root_stop)
+		{
+			break;
+		}
+		else if ((*task_it)->part_Fv.is_valid())
+		{
+			DEBUG_OUT(verbosity > 0, "    Fi = " << (*task_it)->part_Fv << std::endl);
+			F.push_back((*task_it)->part_Fv); // collect result
+		}
+	}
+
+	for (task_it = branch_tasks.begin(); task_it != branch_tasks.end(); ++task_it)
+	{
+		delete *task_it;
+	}
+
+	std::vector<RR_Factorization*>::iterator e_it = explorers.begin();
+
+	for (; e_it != explorers.end(); ++e_it)
+	{
+		t += (*e_it)->t;
+		(*e_it)->t = 0;
+	}
+
+	if (failed)
+	{
+		throw RSSoft_Exception(error);
+	}
+}
+
+// ================================================================================================
+gf::GFq_BivariateFlatPolynomial RR_Factorization::child_polynomial(const gf::GFq_BivariateFlatPolynomial& Qu, const gf::GFq_Element& ry)
+{
+	gf::GFq_BivariateFlatPolynomial Qv(Qu);
+	Qv.make_Y_substitution(ry.poly()); // Qu(X,X*Y+ry)
+	Qv.make_star();
+	return Qv;
+}
+
 } // namespace rssoft
 
@@ -20,6 +20,11 @@
  Roth-Ruckenstein factorization class for soft decision decoding
  Optimized recursive strategy
 
+ The branches of the root node can optionally be explored in parallel
+ on a work stealing pool of threads. Results are merged in the order
+ of the sequential exploration so that they do not depend on the
+ scheduling of the branches.
+
  */
 #ifndef __RR_FACTORIZATION_H__
 #define __RR_FACTORIZATION_H__
@@ -36,8 +41,12 @@ namespace gf
 {
 class GFq;
 class GFq_BivariatePolynomial;
+class GFq_BivariateFlatPolynomial;
 }
 
+class RR_TaskPool;
+class RR_BranchTask;
+
 /**
  * \brief Node in the Roth-Ruckenstein's algorithm
  */
@@ -52,7 +61,7 @@ public:
 	 * \param _id Node identifier
 	 */
 	RR_Node(RR_Node *_parent,
-			const gf::GFq_BivariatePolynomial& _Q,
+			const gf::GFq_BivariateFlatPolynomial& _Q,
             const gf::GFq_Element& _coeff,
 			unsigned int _id);
 
@@ -75,7 +84,7 @@ public:
 	/**
 	 * Get node's polynomial
 	 */
-	const gf::GFq_BivariatePolynomial& getQ() const
+	const gf::GFq_BivariateFlatPolynomial& getQ() const
 	{
 		return Q;
 	}
@@ -107,7 +116,7 @@ public:
 
 protected:
 	RR_Node *parent; //!< Pointer to the parent node
-	const gf::GFq_BivariatePolynomial& Q; //!< Node's polynomial
+	const gf::GFq_BivariateFlatPolynomial& Q; //!< Node's polynomial
     const gf::GFq_Element& coeff; // !< Coefficient on the arc towards this node
 	unsigned int id; //!< Identifier number of the node
 	int degree; //!< The distance of the node from the root counted in the number of arcs less one
@@ -141,13 +150,33 @@ public:
     /**
      * Set verbosity level, 0 for none. This is active only in debug mode (CPPFLAGS=-D_DEBUG)
      */ 
-    void set_verbosity(unsigned int _verbosity)
+    void set_verbosity(unsigned int _verbosity);
+
+    /**
+     * Set the number of threads used to explore the branches of the root node in parallel.
+     * Each branch is an independent task. Only the root node branches into
+     * independent subtrees as the other nodes follow their first new root in Y so deeper
+     * nodes are explored sequentially by the task of their root branch.
+     * \param nb_threads Number of threads including the calling thread, 0 or 1 for sequential exploration
+     */
+    void set_nb_threads(unsigned int nb_threads);
+
+    /**
+     * Get the number of threads used for exploration, 1 if sequential
+     */
+    unsigned int get_nb_threads() const;
+
+    /**
+     * Get the number of nodes but root node created by the last runs since initialization
+     */
+    unsigned int get_nb_nodes() const
     {
-        verbosity = _verbosity;
+        return t;
     }
 
 	/**
-	 * Run factorization of given polynomial
+	 * Run factorization of given polynomial. The polynomial is converted once to the flat
+	 * representation in which the node polynomials are computed.
 	 * \param polynomial Input polynomial
      * \return list of polynomial factors
 	 */
@@ -161,12 +190,33 @@ protected:
 	 */
 	gf::GFq_Polynomial node_run(RR_Node& rr_node);
 
+	/**
+	 * Run on the root node with its branches explored in parallel
+	 * \param root_node The root node
+	 */
+	void parallel_run(RR_Node& root_node);
+
+	/**
+	 * Polynomial of the child node following root in Y ry: Qv(X,Y) = <<Qu(X,X*Y+ry)>>
+	 * \param Qu Polynomial of the parent node
+	 * \param ry Root in Y of the parent node's polynomial
+	 */
+	static gf::GFq_BivariateFlatPolynomial child_polynomial(const gf::GFq_BivariateFlatPolynomial& Qu, const gf::GFq_Element& ry);
+
+	friend class RR_BranchTask;
+
 	const gf::GFq& gf; //!< Reference to the Galois Field being used
 	unsigned int k;    //!< k as in RS(n,k)
     unsigned int verbosity; //!< verbosity level, 0 for none
     
 	unsigned int t;    //!< nodes but root node count
 	std::vector<gf::GFq_Polynomial> F; //!< Result list of f(X) polynomials
+	RR_TaskPool *task_pool; //!< Pool of threads for parallel exploration, 0 if sequential
+	std::vector<RR_Factorization*> explorers; //!< Sequential factorizations used by the pool workers to explore subtrees
+
+private:
+	RR_Factorization(const RR_Factorization&);
+	RR_Factorization& operator=(const RR_Factorization&);
 };
 
 } // namespace rssoft
@@ -0,0 +1,236 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Work stealing pool of threads used to explore independent branches of
+	 the Roth-Ruckenstein tree in parallel.
+
+ */
+#include "RR_TaskPool.h"
+#include "RSSoft_Exception.h"
+
+namespace rssoft
+{
+
+// ================================================================================================
+RR_TaskPool::RR_TaskPool(unsigned int nb_workers) :
+	generation(0),
+	nb_pending(0),
+	nb_steals(0),
+	stopping(false)
+{
+	if (nb_workers == 0)
+	{
+		throw RSSoft_Exception("A task pool needs at least one worker");
+	}
+
+	pthread_mutex_init(&mutex, 0);
+	pthread_cond_init(&work_cond, 0);
+	pthread_cond_init(&done_cond, 0);
+
+	for (unsigned int i=0; i<nb_workers; i++)
+	{
+		WorkerQueue *queue = new WorkerQueue;
+		pthread_mutex_init(&queue->mutex, 0);
+		queues.push_back(queue);
+	}
+
+	args.resize(nb_workers);
+	threads.resize(nb_workers-1);
+
+	for (unsigned int i=1; i<nb_workers; i++)
+	{
+		args[i].pool = this;
+		args[i].worker_index = i;
+
+		if (pthread_create(&threads[i-1], 0, worker_thread, &args[i]) != 0)
+		{
+			threads.resize(i-1);
+			shutdown();
+			throw RSSoft_Exception("Cannot start task pool thread");
+		}
+	}
+}
+
+// ================================================================================================
+RR_TaskPool::~RR_TaskPool()
+{
+	shutdown();
+}
+
+// ================================================================================================
+void RR_TaskPool::shutdown()
+{
+	pthread_mutex_lock(&mutex);
+	stopping = true;
+	pthread_cond_broadcast(&work_cond);
+	pthread_mutex_unlock(&mutex);
+
+	std::vector<pthread_t>::iterator t_it = threads.begin();
+
+	for (; t_it != threads.end(); ++t_it)
+	{
+		pthread_join(*t_it, 0);
+	}
+
+	threads.clear();
+
+	std::vector<WorkerQueue*>::iterator q_it = queues.begin();
+
+	for (; q_it != queues.end(); ++q_it)
+	{
+		pthread_mutex_destroy(&(*q_it)->mutex);
+		delete *q_it;
+	}
+
+	queues.clear();
+
+	pthread_cond_destroy(&done_cond);
+	pthread_cond_destroy(&work_cond);
+	pthread_mutex_destroy(&mutex);
+}
+
+// ================================================================================================
+void RR_TaskPool::run(const std::vector<RR_Task*>& tasks)
+{
+	if (tasks.size() == 0)
+	{
+		return;
+	}
+
+	// counted before any task is queued: a worker still draining the previous run may take one at once
+	pthread_mutex_lock(&mutex);
+	nb_pending = tasks.size();
+	pthread_mutex_unlock(&mutex);
+
+	for (unsigned int i=0; i<tasks.size(); i++)
+	{
+		WorkerQueue *queue = queues[i % queues.size()];
+		pthread_mutex_lock(&queue->mutex);
+		queue->tasks.push_back(tasks[i]);
+		pthread_mutex_unlock(&queue->mutex);
+	}
+
+	pthread_mutex_lock(&mutex);
+	generation++;
+	pthread_cond_broadcast(&work_cond);
+	pthread_mutex_unlock(&mutex);
+
+	work(0);
+
+	pthread_mutex_lock(&mutex);
+
+	while (nb_pending > 0)
+	{
+		pthread_cond_wait(&done_cond, &mutex);
+	}
+
+	pthread_mutex_unlock(&mutex);
+}
+
+// ================================================================================================
+void *RR_TaskPool::worker_thread(void *arg)
+{
+	WorkerArg *worker_arg = (WorkerArg *) arg;
+	worker_arg->pool->worker_loop(worker_arg->worker_index);
+	return 0;
+}
+
+// ================================================================================================
+void RR_TaskPool::worker_loop(unsigned int worker_index)
+{
+	unsigned long seen_generation = 0;
+
+	while (true)
+	{
+		pthread_mutex_lock(&mutex);
+
+		while ((generation == seen_generation) && !stopping)
+		{
+			pthread_cond_wait(&work_cond, &mutex);
+		}
+
+		seen_generation = generation;
+		bool exit_loop = stopping;
+		pthread_mutex_unlock(&mutex);
+
+		if (exit_loop)
+		{
+			break;
+		}
+
+		work(worker_index);
+	}
+}
+
+// ================================================================================================
+void RR_TaskPool::work(unsigned int worker_index)
+{
+	RR_Task *task;
+
+	while ((task = next_task(worker_index)) != 0)
+	{
+		task->run(worker_index);
+
+		pthread_mutex_lock(&mutex);
+		nb_pending--;
+
+		if (nb_pending == 0)
+		{
+			pthread_cond_broadcast(&done_cond);
+		}
+
+		pthread_mutex_unlock(&mutex);
+	}
+}
+
+// ================================================================================================
+RR_Task *RR_TaskPool::next_task(unsigned int worker_index)
+{
+	RR_Task *task = 0;
+	WorkerQueue *own_queue = queues[worker_index];
+
+	pthread_mutex_lock(&own_queue->mutex);
+
+	if (own_queue->tasks.size() > 0)
+	{
+		task = own_queue->tasks.back();
+		own_queue->tasks.pop_back();
+	}
+
+	pthread_mutex_unlock(&own_queue->mutex);
+
+	for (unsigned int i=1; (task == 0) && (i<queues.size()); i++) // steal starting from the next worker
+	{
+		WorkerQueue *victim_queue = queues[(worker_index + i) % queues.size()];
+		pthread_mutex_lock(&victim_queue->mutex);
+
+		if (victim_queue->tasks.size() > 0)
+		{
+			task = victim_queue->tasks.front();
+			victim_queue->tasks.pop_front();
+			__sync_fetch_and_add(&nb_steals, 1);
+		}
+
+		pthread_mutex_unlock(&victim_queue->mutex);
+	}
+
+	return task;
+}
+
+} // namespace rssoft
@@ -0,0 +1,155 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Work stealing pool of threads used to explore independent branches of
+	 the Roth-Ruckenstein tree in parallel.
+
+	 Each worker owns a double ended queue of tasks. It pops tasks from the
+	 back of its own queue and when it runs dry it steals from the front of
+	 the other workers queues. The thread submitting a batch of tasks acts
+	 as worker 0 and returns when all tasks of the batch are done.
+
+ */
+#ifndef __RR_TASK_POOL_H__
+#define __RR_TASK_POOL_H__
+
+#include <pthread.h>
+#include <vector>
+#include <deque>
+
+namespace rssoft
+{
+
+/**
+ * \brief Unit of work run by the pool
+ */
+class RR_Task
+{
+public:
+	virtual ~RR_Task()
+	{}
+
+	/**
+	 * Run the task
+	 * \param worker_index Index of the worker running the task, 0 for the submitting thread
+	 */
+	virtual void run(unsigned int worker_index) = 0;
+};
+
+/**
+ * \brief Work stealing thread pool
+ */
+class RR_TaskPool
+{
+public:
+	/**
+	 * Constructor. Starts nb_workers-1 threads.
+	 * \param nb_workers Number of workers including the thread submitting tasks
+	 */
+	RR_TaskPool(unsigned int nb_workers);
+
+	/**
+	 * Destructor. Stops and joins the threads.
+	 */
+	~RR_TaskPool();
+
+	/**
+	 * Number of workers including the thread submitting tasks
+	 */
+	unsigned int get_nb_workers() const
+	{
+		return queues.size();
+	}
+
+	/**
+	 * Number of tasks taken from another worker's queue since construction
+	 */
+	unsigned long get_nb_steals() const
+	{
+		return nb_steals;
+	}
+
+	/**
+	 * Run a batch of tasks and wait for their completion. Tasks are dealt to the
+	 * workers queues in a round robin fashion. The pool does not take ownership of tasks.
+	 * \param tasks Tasks to run
+	 */
+	void run(const std::vector<RR_Task*>& tasks);
+
+protected:
+	/**
+	 * Queue of tasks owned by a worker
+	 */
+	struct WorkerQueue
+	{
+		pthread_mutex_t mutex;     //!< Protects tasks
+		std::deque<RR_Task*> tasks; //!< Tasks waiting to be run
+	};
+
+	/**
+	 * Argument passed to a worker thread
+	 */
+	struct WorkerArg
+	{
+		RR_TaskPool *pool;         //!< The pool
+		unsigned int worker_index; //!< Index of the worker
+	};
+
+	static void *worker_thread(void *arg);
+
+	/**
+	 * Stop and join the threads then release the synchronization objects
+	 */
+	void shutdown();
+
+	/**
+	 * Thread loop of a worker waiting for batches
+	 */
+	void worker_loop(unsigned int worker_index);
+
+	/**
+	 * Run tasks until none can be found in any queue
+	 */
+	void work(unsigned int worker_index);
+
+	/**
+	 * Get the next task from the worker's own queue or steal one from another worker
+	 * \return 0 if all queues are empty
+	 */
+	RR_Task *next_task(unsigned int worker_index);
+
+	std::vector<WorkerQueue*> queues; //!< Queues of tasks one per worker
+	std::vector<WorkerArg> args;      //!< Arguments of the threads
+	std::vector<pthread_t> threads;   //!< Threads of workers 1 to nb_workers-1
+	pthread_mutex_t mutex;            //!< Protects the batch state
+	pthread_cond_t work_cond;         //!< Signals a new batch or stop
+	pthread_cond_t done_cond;         //!< Signals the batch completion
+	unsigned long generation;         //!< Batch counter
+	unsigned int nb_pending;          //!< Number of tasks of the batch not yet completed
+	unsigned long nb_steals;          //!< Number of stolen tasks
+	bool stopping;                    //!< Threads are asked to exit
+
+private:
+	RR_TaskPool(const RR_TaskPool&);
+	RR_TaskPool& operator=(const RR_TaskPool&);
+};
+
+} // namespace rssoft
+
+#endif // __RR_TASK_POOL_H__
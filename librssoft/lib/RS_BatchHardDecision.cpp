@@ -0,0 +1,292 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Hard decision kernels over a batch of codewords interleaved by codeword.
+
+ */
+
+#include "RS_BatchHardDecision.h"
+#include "EvaluationValues.h"
+#include "RSSoft_Exception.h"
+#include <cstring>
+
+namespace rssoft
+{
+
+// ================================================================================================
+RS_BatchHardDecision::RS_BatchHardDecision(const gf::GFq& _gf, unsigned int _k, const EvaluationValues& _evaluation_values) :
+	gf(_gf),
+	k(_k),
+	n(_evaluation_values.get_evaluation_points().size()),
+	tower(0)
+{
+	if ((k == 0) || (k > n))
+	{
+		throw RSSoft_Exception("k must be between 1 and the number of evaluation points");
+	}
+
+	const std::vector<gf::GFq_Element>& x_values = _evaluation_values.get_evaluation_points();
+	const std::vector<gf::GFq_Element>& y_values = _evaluation_values.get_symbols();
+	std::vector<gf::GFq_Symbol> x(n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		x[i] = x_values[i].poly();
+	}
+
+	for (unsigned int i = 0; i < y_values.size(); i++)
+	{
+		row_symbols.push_back(y_values[i].poly());
+	}
+
+	// Parity check of the evaluation code: H(j,i) = v_i*x_i^j with v_i = 1/prod(l!=i)(x_i-x_l)
+	parity_check.resize((n-k)*n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		gf::GFq_Symbol denominator = 1;
+
+		for (unsigned int l = 0; l < n; l++)
+		{
+			if (l != i)
+			{
+				denominator = gf.mul(denominator, gf.sub(x[i], x[l]));
+			}
+		}
+
+		gf::GFq_Symbol h = gf.div(1, denominator);
+
+		for (unsigned int j = 0; j < n-k; j++)
+		{
+			parity_check[j*n + i] = h;
+			h = gf.mul(h, x[i]);
+		}
+	}
+
+	// Message recovery: coefficients of the Lagrange basis polynomials on the first k points
+	std::vector<gf::GFq_Symbol> p(k+1, 0); // P(X) = prod(l<k)(X-x_l)
+	std::vector<gf::GFq_Symbol> q(k);
+	p[0] = 1;
+
+	for (unsigned int l = 0; l < k; l++)
+	{
+		for (unsigned int m = l+1; m > 0; m--)
+		{
+			p[m] = gf.add(p[m-1], gf.mul(p[m], x[l]));
+		}
+
+		p[0] = gf.mul(p[0], x[l]);
+	}
+
+	message_recovery.resize(k*k);
+
+	for (unsigned int i = 0; i < k; i++)
+	{
+		q[k-1] = p[k]; // Q(X) = P(X)/(X-x_i) by synthetic division
+
+		for (unsigned int m = k-1; m > 0; m--)
+		{
+			q[m-1] = gf.add(p[m], gf.mul(x[i], q[m]));
+		}
+
+		gf::GFq_Symbol denominator = 0; // Q(x_i)
+
+		for (unsigned int m = k; m > 0; m--)
+		{
+			denominator = gf.add(gf.mul(denominator, x[i]), q[m-1]);
+		}
+
+		for (unsigned int m = 0; m < k; m++)
+		{
+			message_recovery[m*k + i] = gf.div(q[m], denominator);
+		}
+	}
+}
+
+// ================================================================================================
+RS_BatchHardDecision::~RS_BatchHardDecision()
+{
+	if (tower)
+	{
+		delete tower;
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::set_tower_field(bool use_tower)
+{
+	if (use_tower && !tower)
+	{
+		if ((gf.pwr() % 2 != 0) || (gf.pwr() < 4) || (gf.pwr() > 8))
+		{
+			throw RSSoft_Exception("Tower field representation needs a field power of 4, 6 or 8");
+		}
+
+		tower = new gf::GFq_Tower(gf);
+		make_tower_tables(parity_check, tower_parity_check);
+		make_tower_tables(message_recovery, tower_message_recovery);
+	}
+	else if (!use_tower && tower)
+	{
+		delete tower;
+		tower = 0;
+		tower_parity_check.clear();
+		tower_message_recovery.clear();
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::make_tower_tables(const std::vector<gf::GFq_Symbol>& matrix, std::vector<unsigned char>& tables) const
+{
+	tables.resize(32*matrix.size());
+
+	for (unsigned int i = 0; i < matrix.size(); i++)
+	{
+		tower->make_multiplier(tower->to_tower(matrix[i]), &tables[32*i], &tables[32*i + 16]);
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::symbols(const unsigned int *rows, gf::GFq_Symbol *codewords, unsigned int batch_size) const
+{
+	for (unsigned int i = 0; i < n*batch_size; i++)
+	{
+		if (rows[i] >= row_symbols.size())
+		{
+			throw RSSoft_Exception("Row index has no corresponding symbol");
+		}
+
+		codewords[i] = row_symbols[rows[i]];
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::syndromes(const gf::GFq_Symbol *codewords, gf::GFq_Symbol *syndromes, unsigned int batch_size) const
+{
+	if (tower)
+	{
+		tower_product(parity_check, tower_parity_check, n-k, n, codewords, syndromes, batch_size);
+	}
+	else
+	{
+		product(parity_check, n-k, n, codewords, syndromes, batch_size);
+	}
+}
+
+// ================================================================================================
+unsigned int RS_BatchHardDecision::check(const gf::GFq_Symbol *codewords, std::vector<bool>& valid, unsigned int batch_size) const
+{
+	std::vector<gf::GFq_Symbol> syndrome_values((n-k)*batch_size);
+	std::vector<gf::GFq_Symbol> lane_or(batch_size, 0);
+	unsigned int nb_valid = 0;
+
+	if (n > k)
+	{
+		syndromes(codewords, &syndrome_values[0], batch_size);
+	}
+
+	for (unsigned int j = 0; j < n-k; j++)
+	{
+		const gf::GFq_Symbol *s = &syndrome_values[j*batch_size];
+
+		for (unsigned int b = 0; b < batch_size; b++)
+		{
+			lane_or[b] |= s[b];
+		}
+	}
+
+	valid.resize(batch_size);
+
+	for (unsigned int b = 0; b < batch_size; b++)
+	{
+		valid[b] = (lane_or[b] == 0);
+		nb_valid += (valid[b] ? 1 : 0);
+	}
+
+	return nb_valid;
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::messages(const gf::GFq_Symbol *codewords, gf::GFq_Symbol *messages, unsigned int batch_size) const
+{
+	if (tower)
+	{
+		tower_product(message_recovery, tower_message_recovery, k, k, codewords, messages, batch_size);
+	}
+	else
+	{
+		product(message_recovery, k, k, codewords, messages, batch_size);
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::product(const std::vector<gf::GFq_Symbol>& matrix, unsigned int nb_out, unsigned int nb_in,
+		const gf::GFq_Symbol *in, gf::GFq_Symbol *out, unsigned int batch_size) const
+{
+	memset((void *) out, 0, nb_out*batch_size*sizeof(gf::GFq_Symbol));
+
+	for (unsigned int j = 0; j < nb_out; j++)
+	{
+		gf::GFq_Symbol *out_j = out + j*batch_size;
+
+		for (unsigned int i = 0; i < nb_in; i++)
+		{
+			gf::GFq_Symbol h = matrix[j*nb_in + i];
+			const gf::GFq_Symbol *in_i = in + i*batch_size;
+
+			if (h != 0)
+			{
+				for (unsigned int b = 0; b < batch_size; b++)
+				{
+					out_j[b] ^= gf.mul(h, in_i[b]);
+				}
+			}
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchHardDecision::tower_product(const std::vector<gf::GFq_Symbol>& matrix, const std::vector<unsigned char>& tables,
+		unsigned int nb_out, unsigned int nb_in, const gf::GFq_Symbol *in, gf::GFq_Symbol *out, unsigned int batch_size) const
+{
+	if (nb_out*batch_size == 0)
+	{
+		return;
+	}
+
+	std::vector<unsigned char> tower_in(nb_in*batch_size);
+	std::vector<unsigned char> tower_out(nb_out*batch_size, 0);
+	tower->to_tower(in, &tower_in[0], nb_in*batch_size);
+
+	for (unsigned int j = 0; j < nb_out; j++)
+	{
+		for (unsigned int i = 0; i < nb_in; i++)
+		{
+			if (matrix[j*nb_in + i] != 0)
+			{
+				tower->mul_add(&tables[32*(j*nb_in + i)], &tower_in[i*batch_size], &tower_out[j*batch_size], batch_size);
+			}
+		}
+	}
+
+	tower->from_tower(&tower_out[0], out, nb_out*batch_size);
+}
+
+} // namespace rssoft
@@ -0,0 +1,160 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Hard decision kernels over a batch of codewords interleaved by codeword.
+
+ Hard decision symbols of a batch are checked against the parity check
+ matrix of the evaluation code so that only the codewords that are not
+ already valid are passed on to interpolation. The message of a valid
+ codeword is recovered by Lagrange interpolation on the first k points.
+ Both are matrix products in GF(2^m) run for all codewords at once.
+ For m = 4, 6 or 8 the products may run in the tower field representation
+ GF((2^(m/2))^2) on byte symbols where the product by each matrix
+ coefficient is done with byte shuffles of two 16 entry tables instead of
+ lookups in the rows of the field LUTs.
+
+ */
+#ifndef __RS_BATCH_HARD_DECISION_H__
+#define __RS_BATCH_HARD_DECISION_H__
+
+#include "GFq.h"
+#include "GFq_Tower.h"
+#include <vector>
+
+namespace rssoft
+{
+
+class EvaluationValues;
+
+/**
+ * \brief Hard decision syndrome check and message recovery for a batch of codewords interleaved by codeword
+ */
+class RS_BatchHardDecision
+{
+public:
+	/**
+	 * Constructor. Computes the parity check and message recovery matrices.
+	 * \param _gf Galois Field in use
+	 * \param _k k as in RS(n,k)
+	 * \param _evaluation_values Evaluation X,Y values used for coding
+	 */
+	RS_BatchHardDecision(const gf::GFq& _gf, unsigned int _k, const EvaluationValues& _evaluation_values);
+
+	/**
+	 * Destructor
+	 */
+	~RS_BatchHardDecision();
+
+	/**
+	 * Translate reliability matrix row indexes to symbols
+	 * \param rows Row indexes at [column*batch_size + lane] as given by RS_BatchReliabilityMatrix::hard_decisions
+	 * \param codewords Receives the symbols at the same index
+	 * \param batch_size Number of codewords in the batch
+	 */
+	void symbols(const unsigned int *rows, gf::GFq_Symbol *codewords, unsigned int batch_size) const;
+
+	/**
+	 * Syndromes of a batch of codewords
+	 * \param codewords Symbols at [column*batch_size + lane]
+	 * \param syndromes Receives the n-k syndromes at [syndrome_index*batch_size + lane]
+	 * \param batch_size Number of codewords in the batch
+	 */
+	void syndromes(const gf::GFq_Symbol *codewords, gf::GFq_Symbol *syndromes, unsigned int batch_size) const;
+
+	/**
+	 * Tells which codewords of a batch are valid codewords
+	 * \param codewords Symbols at [column*batch_size + lane]
+	 * \param valid Receives true for each valid codeword. Resized to batch_size.
+	 * \param batch_size Number of codewords in the batch
+	 * \return Number of valid codewords
+	 */
+	unsigned int check(const gf::GFq_Symbol *codewords, std::vector<bool>& valid, unsigned int batch_size) const;
+
+	/**
+	 * Messages of a batch of valid codewords
+	 * \param codewords Symbols at [column*batch_size + lane]
+	 * \param messages Receives the k message symbols at [symbol_index*batch_size + lane]
+	 * \param batch_size Number of codewords in the batch
+	 */
+	void messages(const gf::GFq_Symbol *codewords, gf::GFq_Symbol *messages, unsigned int batch_size) const;
+
+	/**
+	 * Run the matrix products in the tower field representation or in the polynomial basis of the field (default)
+	 * \param use_tower True to use the tower field representation. The field power must then be 4, 6 or 8.
+	 */
+	void set_tower_field(bool use_tower);
+
+	/**
+	 * Tells if the matrix products run in the tower field representation
+	 */
+	bool is_tower_field() const
+	{
+		return tower != 0;
+	}
+
+	/**
+	 * Get the number of syndromes i.e. n-k
+	 */
+	unsigned int get_nb_syndromes() const
+	{
+		return n-k;
+	}
+
+protected:
+	/**
+	 * Product of a matrix of symbols by a batch of vectors
+	 * \param matrix Matrix of nb_out rows of n_in symbols stored row first
+	 * \param nb_out Number of rows of the matrix
+	 * \param nb_in Number of columns of the matrix
+	 * \param in Input vectors at [index*batch_size + lane]
+	 * \param out Output vectors at [index*batch_size + lane]
+	 * \param batch_size Number of vectors
+	 */
+	void product(const std::vector<gf::GFq_Symbol>& matrix, unsigned int nb_out, unsigned int nb_in,
+			const gf::GFq_Symbol *in, gf::GFq_Symbol *out, unsigned int batch_size) const;
+
+	/**
+	 * Product of a matrix by a batch of vectors in the tower field representation
+	 * \param matrix Matrix in polynomial basis. Zero coefficients are skipped.
+	 * \param tables Multiplier tables of the matrix coefficients in tower representation (32 bytes each)
+	 * Other parameters as in product.
+	 */
+	void tower_product(const std::vector<gf::GFq_Symbol>& matrix, const std::vector<unsigned char>& tables, unsigned int nb_out, unsigned int nb_in,
+			const gf::GFq_Symbol *in, gf::GFq_Symbol *out, unsigned int batch_size) const;
+
+	/**
+	 * Multiplier tables of the coefficients of a matrix in tower representation
+	 */
+	void make_tower_tables(const std::vector<gf::GFq_Symbol>& matrix, std::vector<unsigned char>& tables) const;
+
+	const gf::GFq& gf; //!< Galois Field in use
+	unsigned int k; //!< k as in RS(n,k)
+	unsigned int n; //!< n as in RS(n,k) i.e. the number of evaluation points
+	std::vector<gf::GFq_Symbol> row_symbols; //!< Symbol of each reliability matrix row
+	std::vector<gf::GFq_Symbol> parity_check; //!< n-k x n parity check matrix
+	std::vector<gf::GFq_Symbol> message_recovery; //!< k x k inverse Vandermonde matrix of the first k points
+	gf::GFq_Tower *tower; //!< Tower field representation if used else 0
+	std::vector<unsigned char> tower_parity_check; //!< Multiplier tables of the parity check matrix coefficients in tower representation
+	std::vector<unsigned char> tower_message_recovery; //!< Multiplier tables of the message recovery matrix coefficients in tower representation
+};
+
+} // namespace rssoft
+
+#endif // __RS_BATCH_HARD_DECISION_H__
@@ -0,0 +1,288 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Batch of reliability matrices interleaved by codeword (structure of arrays).
+
+ */
+
+#include "RS_BatchReliabilityMatrix.h"
+#include "RS_ReliabilityMatrix.h"
+#include "RSSoft_Exception.h"
+#include <cmath>
+#include <cstring>
+
+namespace rssoft
+{
+
+// ================================================================================================
+RS_BatchReliabilityMatrix::RS_BatchReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int batch_size) :
+		_nb_symbols_log2(nb_symbols_log2),
+		_nb_symbols(1<<nb_symbols_log2),
+		_message_length(message_length),
+		_batch_size(batch_size),
+		_tensor(_nb_symbols*message_length*batch_size, 0.0)
+{
+	if (batch_size == 0)
+	{
+		throw RSSoft_Exception("Batch must contain at least one codeword");
+	}
+}
+
+// ================================================================================================
+RS_BatchReliabilityMatrix::~RS_BatchReliabilityMatrix()
+{}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::enter_symbol_data(unsigned int lane, unsigned int message_symbol_index, const float *symbol_data)
+{
+	if ((lane < _batch_size) && (message_symbol_index < _message_length))
+	{
+		float *cell = &_tensor[message_symbol_index*_nb_symbols*_batch_size + lane];
+
+		for (unsigned int ir = 0; ir < _nb_symbols; ir++, cell += _batch_size)
+		{
+			*cell = symbol_data[ir];
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::enter_erasure(unsigned int lane, unsigned int message_symbol_index)
+{
+	if ((lane < _batch_size) && (message_symbol_index < _message_length))
+	{
+		float *cell = &_tensor[message_symbol_index*_nb_symbols*_batch_size + lane];
+
+		for (unsigned int ir = 0; ir < _nb_symbols; ir++, cell += _batch_size)
+		{
+			*cell = 0.0;
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::set_lane(unsigned int lane, const RS_ReliabilityMatrix& relmat)
+{
+	if ((relmat.get_nb_symbols() != _nb_symbols) || (relmat.get_message_length() != _message_length))
+	{
+		throw RSSoft_Exception("Reliability matrix dimensions do not match the batch");
+	}
+	else if (lane >= _batch_size)
+	{
+		throw RSSoft_Exception("Lane is out of the batch");
+	}
+
+	const float *matrix = relmat.get_raw_matrix();
+	float *cell = &_tensor[lane];
+
+	for (unsigned int i = 0; i < _nb_symbols*_message_length; i++, cell += _batch_size)
+	{
+		*cell = matrix[i];
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::get_lane(unsigned int lane, RS_ReliabilityMatrix& relmat) const
+{
+	if ((relmat.get_nb_symbols() != _nb_symbols) || (relmat.get_message_length() != _message_length))
+	{
+		throw RSSoft_Exception("Reliability matrix dimensions do not match the batch");
+	}
+	else if (lane >= _batch_size)
+	{
+		throw RSSoft_Exception("Lane is out of the batch");
+	}
+
+	float *matrix = relmat.get_raw_matrix();
+	const float *cell = &_tensor[lane];
+
+	for (unsigned int i = 0; i < _nb_symbols*_message_length; i++, cell += _batch_size)
+	{
+		matrix[i] = *cell;
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::normalize()
+{
+	std::vector<float> col_sums(_batch_size);
+	float *sums = &col_sums[0];
+
+	for (unsigned int ic = 0; ic < _message_length; ic++)
+	{
+		float *column = &_tensor[ic*_nb_symbols*_batch_size];
+		memset((void *) sums, 0, _batch_size*sizeof(float));
+
+		for (unsigned int ir = 0; ir < _nb_symbols; ir++) // sum rows in the same order as RS_ReliabilityMatrix
+		{
+			const float *row = column + ir*_batch_size;
+
+			for (unsigned int b = 0; b < _batch_size; b++)
+			{
+				sums[b] += row[b];
+			}
+		}
+
+		for (unsigned int b = 0; b < _batch_size; b++) // erased columns are divided by 1
+		{
+			sums[b] = (sums[b] != 0.0 ? sums[b] : 1.0);
+		}
+
+		for (unsigned int ir = 0; ir < _nb_symbols; ir++)
+		{
+			float *row = column + ir*_batch_size;
+
+			for (unsigned int b = 0; b < _batch_size; b++)
+			{
+				row[b] /= sums[b];
+			}
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::hard_decisions(unsigned int *rows) const
+{
+	std::vector<float> max_values(_batch_size);
+	float *max_p = &max_values[0];
+
+	for (unsigned int ic = 0; ic < _message_length; ic++)
+	{
+		const float *column = &_tensor[ic*_nb_symbols*_batch_size];
+		unsigned int *max_ir = rows + ic*_batch_size;
+
+		for (unsigned int b = 0; b < _batch_size; b++)
+		{
+			max_p[b] = 0.0;
+			max_ir[b] = 0;
+		}
+
+		for (unsigned int ir = 0; ir < _nb_symbols; ir++)
+		{
+			const float *row = column + ir*_batch_size;
+
+			for (unsigned int b = 0; b < _batch_size; b++)
+			{
+				bool greater = row[b] > max_p[b];
+				max_p[b] = (greater ? row[b] : max_p[b]);
+				max_ir[b] = (greater ? ir : max_ir[b]);
+			}
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::multiplicities(unsigned int multiplicity, unsigned int *multiplicities, unsigned int *costs) const
+{
+	unsigned int nb_cells = _nb_symbols*_message_length;
+	std::vector<float> w_tensor(_tensor);
+	std::vector<float> max_values(_batch_size);
+	std::vector<unsigned int> max_cells(_batch_size);
+	float *p_star = &max_values[0];
+	unsigned int *star_cell = &max_cells[0];
+
+	memset((void *) multiplicities, 0, get_size()*sizeof(unsigned int));
+	memset((void *) costs, 0, _batch_size*sizeof(unsigned int));
+
+	for (unsigned int s = multiplicity; s > 0; s--)
+	{
+		for (unsigned int b = 0; b < _batch_size; b++)
+		{
+			p_star[b] = 0.0;
+			star_cell[b] = 0; // as RS_ReliabilityMatrix::find_max if all items are 0
+		}
+
+		// find the first maximum in column first order of each codeword like RS_ReliabilityMatrix::find_max
+		for (unsigned int i_cell = 0; i_cell < nb_cells; i_cell++)
+		{
+			const float *cell = &w_tensor[i_cell*_batch_size];
+
+			for (unsigned int b = 0; b < _batch_size; b++)
+			{
+				bool greater = cell[b] > p_star[b];
+				p_star[b] = (greater ? cell[b] : p_star[b]);
+				star_cell[b] = (greater ? i_cell : star_cell[b]);
+			}
+		}
+
+		for (unsigned int b = 0; b < _batch_size; b++)
+		{
+			unsigned int index = star_cell[b]*_batch_size + b;
+			w_tensor[index] = p_star[b] / (multiplicities[index]+2);
+			multiplicities[index] += 1;
+			costs[b] += multiplicities[index];
+		}
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::multiplicities(float lambda, unsigned int *multiplicities, unsigned int *costs) const
+{
+	memset((void *) costs, 0, _batch_size*sizeof(unsigned int));
+
+	for (unsigned int i_cell = 0; i_cell < _nb_symbols*_message_length; i_cell++)
+	{
+		const float *cell = &_tensor[i_cell*_batch_size];
+		unsigned int *m_cell = multiplicities + i_cell*_batch_size;
+
+		for (unsigned int b = 0; b < _batch_size; b++)
+		{
+			float p = floor(cell[b] * lambda);
+			m_cell[b] = (p > 0.0 ? (unsigned int) p : 0);
+			costs[b] += m_cell[b] * (m_cell[b] + 1);
+		}
+	}
+
+	for (unsigned int b = 0; b < _batch_size; b++)
+	{
+		costs[b] /= 2;
+	}
+}
+
+// ================================================================================================
+void RS_BatchReliabilityMatrix::score(const unsigned int *rows, float *scores, unsigned int *counts) const
+{
+	memset((void *) scores, 0, _batch_size*sizeof(float));
+	memset((void *) counts, 0, _batch_size*sizeof(unsigned int));
+
+	for (unsigned int ic = 0; ic < _message_length; ic++)
+	{
+		const float *column = &_tensor[ic*_nb_symbols*_batch_size];
+		const unsigned int *i_s = rows + ic*_batch_size;
+
+		for (unsigned int b = 0; b < _batch_size; b++)
+		{
+			float p_ij = column[i_s[b]*_batch_size + b];
+
+			if (p_ij != 0.0) // symbol was not erased
+			{
+				scores[b] += 10.0 * log10(p_ij);
+				counts[b]++;
+			}
+		}
+	}
+
+	for (unsigned int b = 0; b < _batch_size; b++)
+	{
+		scores[b] = (counts[b] > 0 ? scores[b]/counts[b] : 0.0);
+	}
+}
+
+} // namespace rssoft
@@ -0,0 +1,199 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Batch of reliability matrices interleaved by codeword (structure of arrays).
+
+ Element (row, column) of the matrix of codeword b is stored at
+ (column*nb_symbols + row)*batch_size + b so that the B values of one
+ matrix cell are contiguous. Column wise kernels (normalization, hard
+ decision, multiplicity assignment, scoring) then run the same operation
+ for all codewords of the batch in the innermost loop over b which the
+ compiler turns into SIMD lanes.
+
+ */
+#ifndef __RS_BATCH_RELIABILITY_MATRIX_H__
+#define __RS_BATCH_RELIABILITY_MATRIX_H__
+
+#include <vector>
+
+namespace rssoft
+{
+
+class RS_ReliabilityMatrix;
+
+/**
+ * \brief Reliability matrices of a batch of codewords interleaved by codeword with kernels processing the whole batch at once.
+ */
+class RS_BatchReliabilityMatrix
+{
+public:
+	/**
+	 * Constructor. All values are zeroed.
+	 * \param nb_symbols_log2 Log2 of the number of symbols used (number of symbols is a power of two)
+	 * \param message_length Length of one message block to be decoded
+	 * \param batch_size Number of codewords in the batch
+	 */
+	RS_BatchReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int batch_size);
+
+	/**
+	 * Destructor
+	 */
+	~RS_BatchReliabilityMatrix();
+
+	/**
+	 * Enter symbol position data of one codeword
+	 * \param lane Index of the codeword in the batch
+	 * \param message_symbol_index Position of the symbol in the message
+	 * \param symbol_data Pointer to nb_symbols values of relative reliability of each symbol
+	 */
+	void enter_symbol_data(unsigned int lane, unsigned int message_symbol_index, const float *symbol_data);
+
+	/**
+	 * Enter an erasure at a given symbol position of one codeword
+	 * \param lane Index of the codeword in the batch
+	 * \param message_symbol_index Position of the symbol in the message
+	 */
+	void enter_erasure(unsigned int lane, unsigned int message_symbol_index);
+
+	/**
+	 * Copy a reliability matrix in the batch
+	 * \param lane Index of the codeword in the batch
+	 * \param relmat Reliability matrix with the same dimensions
+	 */
+	void set_lane(unsigned int lane, const RS_ReliabilityMatrix& relmat);
+
+	/**
+	 * Copy the reliability matrix of one codeword out of the batch
+	 * \param lane Index of the codeword in the batch
+	 * \param relmat Reliability matrix with the same dimensions receiving the values
+	 */
+	void get_lane(unsigned int lane, RS_ReliabilityMatrix& relmat) const;
+
+	/**
+	 * Normalize each column of each codeword so that the sum of each column is 1.0. Erased columns are left null.
+	 */
+	void normalize();
+
+	/**
+	 * Hard decision on each column of each codeword. The first row with the highest reliability is taken.
+	 * \param rows Receives the row index at [column*batch_size + lane]. Must hold message_length*batch_size values.
+	 */
+	void hard_decisions(unsigned int *rows) const;
+
+	/**
+	 * Multiplicity assignment for soft decision with the long (greedy) algorithm of MultiplicityMatrix
+	 * \param multiplicity Target global multiplicity of interpolation points
+	 * \param multiplicities Receives the multiplicities at the same index as reliability values. Must hold get_size() values.
+	 * \param costs Receives the cost of each multiplicity matrix. Must hold batch_size values.
+	 */
+	void multiplicities(unsigned int multiplicity, unsigned int *multiplicities, unsigned int *costs) const;
+
+	/**
+	 * Multiplicity assignment for soft decision with the short algorithm of MultiplicityMatrix
+	 * \param lambda Multiplicative constant
+	 * \param multiplicities Receives the multiplicities at the same index as reliability values. Must hold get_size() values.
+	 * \param costs Receives the cost of each multiplicity matrix. Must hold batch_size values.
+	 */
+	void multiplicities(float lambda, unsigned int *multiplicities, unsigned int *costs) const;
+
+	/**
+	 * Probability score of one candidate per codeword as in FinalEvaluation i.e. mean of reliabilities
+	 * in dB over the non erased positions
+	 * \param rows Row index of the candidate symbols at [column*batch_size + lane]
+	 * \param scores Receives the score of each candidate. Must hold batch_size values.
+	 * \param counts Receives the number of non erased positions used for each score. Must hold batch_size values.
+	 */
+	void score(const unsigned int *rows, float *scores, unsigned int *counts) const;
+
+	/**
+	 * Get the log2 of the number of symbols (i.e. rows)
+	 */
+	unsigned int get_nb_symbols_log2() const
+	{
+		return _nb_symbols_log2;
+	}
+
+	/**
+	 * Get the number of symbols (i.e. rows)
+	 */
+	unsigned int get_nb_symbols() const
+	{
+		return _nb_symbols;
+	}
+
+	/**
+	 * Get the number of message symbols (i.e. columns)
+	 */
+	unsigned int get_message_length() const
+	{
+		return _message_length;
+	}
+
+	/**
+	 * Get the number of codewords in the batch
+	 */
+	unsigned int get_batch_size() const
+	{
+		return _batch_size;
+	}
+
+	/**
+	 * Get the number of values in the batch
+	 */
+	unsigned int get_size() const
+	{
+		return _nb_symbols*_message_length*_batch_size;
+	}
+
+	/**
+	 * Operator to get the value at row i column j of codeword b. Read-write version.
+	 */
+	float& operator()(unsigned int i_row, unsigned int i_col, unsigned int lane)
+	{
+		return _tensor[(_nb_symbols*i_col + i_row)*_batch_size + lane];
+	}
+
+	/**
+	 * Operator to get the value at row i column j of codeword b. Read-only version.
+	 */
+	const float& operator()(unsigned int i_row, unsigned int i_col, unsigned int lane) const
+	{
+		return _tensor[(_nb_symbols*i_col + i_row)*_batch_size + lane];
+	}
+
+	/**
+	 * Get a pointer to the interleaved storage
+	 */
+	const float *get_raw_tensor() const
+	{
+		return &_tensor[0];
+	}
+
+protected:
+	unsigned int _nb_symbols_log2;
+	unsigned int _nb_symbols;
+	unsigned int _message_length;
+	unsigned int _batch_size;
+	std::vector<float> _tensor; //!< Reliability values interleaved by codeword, column first
+};
+
+} // namespace rssoft
+
+#endif // __RS_BATCH_RELIABILITY_MATRIX_H__
@@ -0,0 +1,207 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Channel models producing reliability data for whole frames or batches of
+ frames: AWGN, Rayleigh or Rician block fading and Gilbert-Elliott bursts
+ of erasures or errors, seen through a MFSK demodulator (one power per
+ symbol) or a BPSK demodulator (one LLR per bit).
+
+ Noise follows the convention of the test programs: the noise standard
+ deviation relative to a unit amplitude is 10^(-SNR/10). Fading gains are
+ normalized to a unit mean power.
+
+ Random numbers come from a stream of 16 xorshift128 generators drawn in
+ parallel. A stream is seeded by a seed and a stream index so that threads
+ can each use their own stream and still reproduce a run. Gaussian samples
+ use the Box-Muller transform on whole blocks. Kernels are compiled for the
+ same instruction sets as the reliability matrix kernels. Integer draws are
+ identical on all machines and Gaussian samples may only differ in the last
+ bits where the compiler contracts multiply-adds.
+
+ */
+#ifndef __RS_CHANNEL_MODEL_H__
+#define __RS_CHANNEL_MODEL_H__
+
+#include <stdint.h>
+#include <vector>
+
+namespace rssoft
+{
+
+class RS_ReliabilityMatrix;
+class RS_BatchReliabilityMatrix;
+
+/**
+ * \brief Seedable stream of uniform and Gaussian random numbers drawn 16 at a time
+ */
+class RS_RandomStream
+{
+public:
+	static const unsigned int nb_lanes = 16; //!< Number of generators drawn in parallel
+
+	/**
+	 * Constructor
+	 * \param seed Seed common to all streams of a run
+	 * \param stream_index Index of the stream, typically one per thread
+	 */
+	RS_RandomStream(uint64_t seed, unsigned int stream_index = 0);
+
+	/**
+	 * Uniform values in (0,1). Values are drawn by blocks of nb_lanes and the rest of the last block is dropped.
+	 */
+	void uniform(float *values, unsigned int nb_values);
+
+	/**
+	 * Standard normal values. Values are drawn by pairs of blocks of nb_lanes and the rest of the last pair is dropped.
+	 */
+	void gaussian(float *values, unsigned int nb_values);
+
+	/**
+	 * Raw generator state: four words per lane, word major
+	 */
+	uint32_t *get_state()
+	{
+		return state;
+	}
+
+protected:
+	uint32_t state[4*nb_lanes]; //!< xorshift128 state of the lanes
+};
+
+/**
+ * \brief Channel model filling reliability matrices of whole frames
+ */
+class RS_ChannelModel
+{
+public:
+	typedef enum
+	{
+		RS_Modulation_MFSK, //!< One power per symbol value. Matrix rows are the powers.
+		RS_Modulation_BPSK  //!< Bits of the row index are sent as +1 (bit 0) or -1 (bit 1). Matrix rows are the probabilities derived from the bit LLRs.
+	} Modulation;
+
+	typedef enum
+	{
+		RS_Fading_None,     //!< AWGN only
+		RS_Fading_Rayleigh, //!< Rayleigh fading
+		RS_Fading_Rician    //!< Rician fading. See set_rician_factor.
+	} Fading;
+
+	typedef enum
+	{
+		RS_Burst_None,    //!< No bursts
+		RS_Burst_Erasure, //!< Symbols sent in the bad state are erased
+		RS_Burst_Error    //!< Symbols sent in the bad state are replaced by a random symbol
+	} Burst;
+
+	/**
+	 * Constructor
+	 * \param modulation Modulation and demodulator output
+	 * \param snr_dB Signal to noise ratio in dB
+	 * \param fading Fading of the amplitudes
+	 */
+	RS_ChannelModel(Modulation modulation, float snr_dB, Fading fading = RS_Fading_None);
+
+	/**
+	 * Ratio of the line of sight power to the scattered power of Rician fading. Default is 4.
+	 */
+	void set_rician_factor(float _rician_factor)
+	{
+		rician_factor = _rician_factor;
+	}
+
+	/**
+	 * Number of consecutive symbols seeing the same fading gain. Default is 1 (fast fading).
+	 */
+	void set_fading_block(unsigned int _fading_block);
+
+	/**
+	 * Gilbert-Elliott bursts
+	 * \param _burst What happens to symbols sent in the bad state
+	 * \param _p_good_to_bad Probability to enter the bad state after a symbol
+	 * \param _p_bad_to_good Probability to leave the bad state after a symbol
+	 */
+	void set_burst(Burst _burst, float _p_good_to_bad, float _p_bad_to_good);
+
+	/**
+	 * Channel output of consecutive symbols. The channel starts in the good state with a new fading gain.
+	 * \param rows Row index of each symbol sent
+	 * \param nb_symbols Number of symbols sent
+	 * \param nb_symbols_log2 Log2 of the number of rows
+	 * \param values Receives nb_symbols columns of (1<<nb_symbols_log2) powers (MFSK) or nb_symbols_log2 LLRs (BPSK). Erased columns are all zeros.
+	 * \param stream Random stream
+	 * \param bad_symbols Optional. Receives 1 for the symbols sent in the bad state and 0 for the others.
+	 * \return Number of symbols sent in the bad state
+	 */
+	unsigned int run(const unsigned int *rows, unsigned int nb_symbols, unsigned int nb_symbols_log2, float *values,
+			RS_RandomStream& stream, unsigned char *bad_symbols = 0) const;
+
+	/**
+	 * Fill all columns of a reliability matrix
+	 * \param rows Row index of the symbol sent in each column
+	 * \param relmat Reliability matrix. Data is entered but not normalized.
+	 * \param stream Random stream
+	 * \param bad_symbols Optional. Receives 1 for the symbols sent in the bad state and 0 for the others.
+	 * \return Number of symbols sent in the bad state
+	 */
+	unsigned int transmit(const std::vector<unsigned int>& rows, RS_ReliabilityMatrix& relmat, RS_RandomStream& stream,
+			std::vector<unsigned char> *bad_symbols = 0) const;
+
+	/**
+	 * Fill all codewords of a batch. Frames are sent one after the other on the same channel.
+	 * \param rows Row indexes of the symbols sent, codeword after codeword (batch size times message length)
+	 * \param batch Batch of reliability matrices. Data is entered but not normalized.
+	 * \param stream Random stream
+	 * \return Number of symbols sent in the bad state
+	 */
+	unsigned int transmit(const std::vector<unsigned int>& rows, RS_BatchReliabilityMatrix& batch, RS_RandomStream& stream) const;
+
+	/**
+	 * Noise standard deviation relative to a unit amplitude
+	 */
+	float get_noise_std_dev() const
+	{
+		return std_dev;
+	}
+
+	/**
+	 * Name of the instruction set the kernels were compiled for
+	 */
+	static const char *get_kernels_name();
+
+protected:
+	/**
+	 * Column of probabilities of the symbol values from the LLRs of their bits
+	 */
+	void llrs_to_probabilities(const float *llrs, unsigned int nb_symbols_log2, float *probabilities) const;
+
+	Modulation modulation;
+	Fading fading;
+	float std_dev;           //!< Noise standard deviation
+	float rician_factor;     //!< Rician K factor
+	unsigned int fading_block; //!< Symbols per fading gain
+	Burst burst;
+	float p_good_to_bad;
+	float p_bad_to_good;
+};
+
+} // namespace rssoft
+
+#endif // __RS_CHANNEL_MODEL_H__
@@ -0,0 +1,271 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Decodability predictor: classifies a frame from its normalized
+ reliability matrix before any interpolation is run.
+
+ */
+
+#include "RS_DecodabilityPredictor.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "RSSoft_Exception.h"
+#include <vector>
+#include <cmath>
+
+namespace rssoft
+{
+
+// ================================================================================================
+RS_DecodabilityPredictor::RS_DecodabilityPredictor(unsigned int _k, float _margin) :
+		k(_k),
+		margin(_margin),
+		power_matrix(false)
+{
+	if (k < 2)
+	{
+		throw RSSoft_Exception("k parameter must be at least 2");
+	}
+}
+
+// ================================================================================================
+RS_DecodabilityPredictor::~RS_DecodabilityPredictor()
+{}
+
+// ================================================================================================
+RS_DecodabilityPredictor::Prediction RS_DecodabilityPredictor::predict(const RS_ReliabilityMatrix& relmat,
+		unsigned int global_multiplicity, unsigned int nb_iterations_max, unsigned int max_cost) const
+{
+	Prediction prediction;
+	unsigned int n = relmat.get_message_length();
+	unsigned int nb_rows = relmat.get_nb_symbols();
+	RS_ReliabilityMatrix posterior(relmat);
+	const float *matrix = posterior.get_raw_matrix();
+	float error_variance = 0.0;
+
+	prediction.decodability = RS_Decodable_Hopeless;
+	prediction.global_multiplicity = global_multiplicity;
+	prediction.cost = 0;
+	prediction.expected_score = 0.0;
+	prediction.score_deviation = 0.0;
+	prediction.score_threshold = 0;
+	prediction.expected_errors = 0.0;
+	prediction.nb_erasures = 0;
+
+	if (n <= k)
+	{
+		throw RSSoft_Exception("Reliability matrix must have more columns than k");
+	}
+
+	if (power_matrix)
+	{
+		power_posterior(posterior);
+	}
+
+	// hard decision errors
+	for (unsigned int ic = 0; ic < n; ic++)
+	{
+		const float *column = &matrix[ic*nb_rows];
+		float p_max = 0.0;
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			p_max = (column[ir] > p_max ? column[ir] : p_max);
+		}
+
+		if (p_max == 0.0)
+		{
+			prediction.nb_erasures++;
+		}
+		else
+		{
+			prediction.expected_errors += 1.0 - p_max;
+			error_variance += p_max*(1.0 - p_max);
+		}
+	}
+
+	if (2.0*(prediction.expected_errors + margin*sqrt(error_variance)) + prediction.nb_erasures <= n-k)
+	{
+		prediction.decodability = RS_Decodable_Hard;
+		return prediction;
+	}
+
+	// Koetter-Vardy condition along the schedule
+	for (unsigned int ni = 0; ni < nb_iterations_max; ni++)
+	{
+		MultiplicityMatrix mmat(relmat, global_multiplicity + ni);
+
+		if ((max_cost > 0) && (mmat.cost() > max_cost))
+		{
+			break;
+		}
+
+		prediction.global_multiplicity = global_multiplicity + ni;
+		prediction.cost = mmat.cost();
+		prediction.expected_score = expected_score(posterior, mmat, prediction.score_deviation);
+		prediction.score_threshold = score_threshold(k, mmat.cost());
+
+		if (prediction.expected_score - margin*prediction.score_deviation > prediction.score_threshold)
+		{
+			prediction.decodability = RS_Decodable_Soft;
+			break;
+		}
+	}
+
+	return prediction;
+}
+
+// ================================================================================================
+float RS_DecodabilityPredictor::expected_score(const RS_ReliabilityMatrix& relmat, const MultiplicityMatrix& mmat, float& deviation)
+{
+	std::vector<float> column_mean(relmat.get_message_length(), 0.0);
+	std::vector<float> column_square(relmat.get_message_length(), 0.0);
+	float mean = 0.0, variance = 0.0;
+	MultiplicityMatrix::traversing_iterator m_it(mmat.begin());
+
+	for (; m_it != mmat.end(); ++m_it)
+	{
+		float p = relmat(m_it.iY(), m_it.iX());
+		float m = m_it.multiplicity();
+		column_mean[m_it.iX()] += m*p;
+		column_square[m_it.iX()] += m*m*p;
+	}
+
+	for (unsigned int ic = 0; ic < column_mean.size(); ic++)
+	{
+		mean += column_mean[ic];
+		variance += column_square[ic] - column_mean[ic]*column_mean[ic];
+	}
+
+	deviation = (variance > 0.0 ? sqrt(variance) : 0.0);
+	return mean;
+}
+
+// ================================================================================================
+void RS_DecodabilityPredictor::power_posterior(RS_ReliabilityMatrix& relmat)
+{
+	unsigned int n = relmat.get_message_length();
+	unsigned int nb_rows = relmat.get_nb_symbols();
+	float *matrix = relmat.get_raw_matrix();
+	std::vector<float> log_likelihoods(nb_rows);
+	float noise_power = 0.0, signal_power = 0.0;
+	unsigned int nb_columns = 0;
+
+	// frame signal and noise powers from the largest entry of the columns
+	for (unsigned int ic = 0; ic < n; ic++)
+	{
+		const float *column = &matrix[ic*nb_rows];
+		float p_max = 0.0;
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			p_max = (column[ir] > p_max ? column[ir] : p_max);
+		}
+
+		if (p_max > 0.0)
+		{
+			noise_power += (1.0 - p_max) / (nb_rows - 1);
+			signal_power += p_max;
+			nb_columns++;
+		}
+	}
+
+	if (nb_columns == 0)
+	{
+		return; // all erased
+	}
+
+	noise_power /= nb_columns;
+	signal_power = signal_power / nb_columns - noise_power;
+
+	if ((noise_power <= 0.0) || (signal_power <= 0.0))
+	{
+		return; // noiseless, or no signal to tell the sent symbol from the others
+	}
+
+	float amplitude = sqrt(signal_power) / noise_power;
+
+	// P(row sent | powers) is proportional to cosh(A*sqrt(P)/sigma^2)
+	for (unsigned int ic = 0; ic < n; ic++)
+	{
+		float *column = &matrix[ic*nb_rows];
+		float p_max = 0.0, l_max = 0.0, sum = 0.0;
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			p_max = (column[ir] > p_max ? column[ir] : p_max);
+		}
+
+		if (p_max == 0.0)
+		{
+			continue; // erasure
+		}
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			float x = amplitude * sqrt(column[ir]);
+			log_likelihoods[ir] = x + log1p(exp(-2.0*x));
+			l_max = (log_likelihoods[ir] > l_max ? log_likelihoods[ir] : l_max);
+		}
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			column[ir] = exp(log_likelihoods[ir] - l_max);
+			sum += column[ir];
+		}
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			column[ir] /= sum;
+		}
+	}
+}
+
+// ================================================================================================
+unsigned int RS_DecodabilityPredictor::score_threshold(unsigned int k, unsigned int cost)
+{
+	unsigned int delta = 0;
+	unsigned int nb_monomials = 1; // X^0*Y^0
+
+	// going from delta-1 to delta adds X^(delta-(k-1)b)*Y^b for b = 0..delta/(k-1)
+	while (nb_monomials <= cost)
+	{
+		delta++;
+		nb_monomials += delta/(k-1) + 1;
+	}
+
+	return delta;
+}
+
+// ================================================================================================
+const char *RS_DecodabilityPredictor::get_name(Decodability decodability)
+{
+	switch (decodability)
+	{
+		case RS_Decodable_Hard:
+			return "hard decodable";
+		case RS_Decodable_Soft:
+			return "soft decodable";
+		default:
+			return "hopeless";
+	}
+}
+
+} // namespace rssoft
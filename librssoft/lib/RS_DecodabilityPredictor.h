@@ -0,0 +1,167 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Decodability predictor: classifies a frame from its normalized
+ reliability matrix before any interpolation is run.
+
+ The hard decision of a column is wrong with probability 1 - p_max where
+ p_max is the largest probability of the column. A frame is predicted
+ hard decodable when twice the expected number of hard decision errors,
+ raised by margin standard deviations, plus the number of erased columns
+ does not exceed n-k.
+
+ Otherwise the multiplicity matrices of the decoding schedule are built
+ and the Koetter-Vardy condition is checked on the expected score: the
+ sent codeword is on the list when its score sum_j M(c_j,j) is larger than
+ the smallest (1,k-1) weighted degree delta such that the number of
+ monomials of weighted degree at most delta exceeds the matrix cost C.
+ With the probabilities of the matrix as the distribution of the sent
+ symbols the score has mean sum M(i,j)P(i,j) and the variance of a sum of
+ independent columns. The frame needs soft decoding at the first global
+ multiplicity where the mean less margin standard deviations passes the
+ condition. It is hopeless when none of the schedule does.
+
+ The condition is sufficient only so that a hopeless frame may still be
+ decoded at times. A negative margin makes the predictor less strict.
+
+ A matrix of normalized received powers as made from MFSK detectors is not
+ a posterior distribution of the sent symbols: it overestimates the
+ hard decision errors several fold. In power matrix mode the columns are
+ first turned into posteriors. The noise power per row is estimated over
+ the frame from the entries off the column maxima and the signal power
+ from the maxima. With a real gaussian noise of variance s^2 on the
+ amplitudes the likelihood of row i having been sent is then proportional
+ to cosh(A*sqrt(P(i,j))/s^2). The multiplicity matrices are still built
+ from the matrix as given like the decoder does.
+
+ */
+#ifndef __RS_DECODABILITY_PREDICTOR_H__
+#define __RS_DECODABILITY_PREDICTOR_H__
+
+namespace rssoft
+{
+
+class RS_ReliabilityMatrix;
+class MultiplicityMatrix;
+
+/**
+ * \brief Predicts if and at which cost a frame can be decoded
+ */
+class RS_DecodabilityPredictor
+{
+public:
+	typedef enum
+	{
+		RS_Decodable_Hard = 0, //!< Hard decision errors and erasures are within the correction capability
+		RS_Decodable_Soft,     //!< Soft decision decoding is expected to succeed at the predicted cost
+		RS_Decodable_Hopeless  //!< No multiplicity of the schedule is expected to succeed
+	} Decodability;
+
+	/**
+	 * \brief Outcome of a prediction
+	 */
+	struct Prediction
+	{
+		Decodability decodability;        //!< Frame class
+		unsigned int global_multiplicity; //!< Global multiplicity predicted to succeed or last one tried
+		unsigned int cost;                //!< Multiplicity matrix cost at this global multiplicity (0 for hard decodable frames)
+		float expected_score;             //!< Expected score of the sent codeword at this global multiplicity
+		float score_deviation;            //!< Standard deviation of the score
+		unsigned int score_threshold;     //!< Score the codeword must exceed at this cost
+		float expected_errors;            //!< Expected number of hard decision errors
+		unsigned int nb_erasures;         //!< Number of erased columns
+	};
+
+	/**
+	 * Constructor
+	 * \param _k k as in RS(n,k)
+	 * \param _margin Number of standard deviations taken off the expected values
+	 */
+	RS_DecodabilityPredictor(unsigned int _k, float _margin = 1.0);
+
+	/**
+	 * Destructor
+	 */
+	~RS_DecodabilityPredictor();
+
+	/**
+	 * Set the number of standard deviations taken off the expected values
+	 */
+	void set_margin(float _margin)
+	{
+		margin = _margin;
+	}
+
+	/**
+	 * Take the matrix as normalized received powers and turn its columns into posteriors before predicting
+	 */
+	void set_power_matrix(bool _power_matrix)
+	{
+		power_matrix = _power_matrix;
+	}
+
+	/**
+	 * Predict the outcome of decoding a frame with the global multiplicities M, M+1, ..., M+nb_iterations_max-1
+	 * \param relmat Normalized reliability matrix of the frame
+	 * \param global_multiplicity Global multiplicity at first iteration
+	 * \param nb_iterations_max Maximum number of multiplicity iterations
+	 * \param max_cost Largest affordable multiplicity matrix cost. Stops the schedule before it. 0 for no limit.
+	 */
+	Prediction predict(const RS_ReliabilityMatrix& relmat, unsigned int global_multiplicity, unsigned int nb_iterations_max,
+			unsigned int max_cost = 0) const;
+
+	/**
+	 * Mean and standard deviation of the score of the sent codeword for a multiplicity matrix
+	 * \param relmat Normalized reliability matrix the multiplicity matrix was built from
+	 * \param mmat Multiplicity matrix
+	 * \param deviation Receives the standard deviation
+	 * \return Expected score
+	 */
+	static float expected_score(const RS_ReliabilityMatrix& relmat, const MultiplicityMatrix& mmat, float& deviation);
+
+	/**
+	 * Turn the columns of a matrix of normalized received powers into posterior probabilities of the sent symbols
+	 * given the signal and noise powers estimated over the frame. Erased columns are left untouched.
+	 * \param relmat Normalized reliability matrix to convert in place
+	 */
+	static void power_posterior(RS_ReliabilityMatrix& relmat);
+
+	/**
+	 * Koetter-Vardy score threshold: smallest (1,k-1) weighted degree delta such that the number of monomials X^a*Y^b
+	 * with a+(k-1)b <= delta exceeds the cost
+	 * \param k k as in RS(n,k)
+	 * \param cost Multiplicity matrix cost
+	 */
+	static unsigned int score_threshold(unsigned int k, unsigned int cost);
+
+	/**
+	 * Name of a frame class
+	 */
+	static const char *get_name(Decodability decodability);
+
+protected:
+	unsigned int k;  //!< k as in RS(n,k)
+	float margin;    //!< Number of standard deviations taken off the expected values
+	bool power_matrix; //!< Matrices are normalized received powers
+};
+
+} // namespace rssoft
+
+#endif // __RS_DECODABILITY_PREDICTOR_H__
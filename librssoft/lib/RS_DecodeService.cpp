@@ -0,0 +1,812 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Local decoding service
+
+ */
+
+#include "RS_DecodeService.h"
+#include "RSSoft_Exception.h"
+#include "EvaluationValues.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "GSKV_Interpolation.h"
+#include "RR_Factorization.h"
+#include "FinalEvaluation.h"
+#include "RS_BatchReliabilityMatrix.h"
+#include "RS_BatchHardDecision.h"
+#include "RS_DecodingPolicy.h"
+#include "GFq_MonomialArena.h"
+#include "Debug.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+
+namespace rssoft
+{
+
+// ================================================================================================
+uint32_t RS_ServiceRing::slot_size(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int k)
+{
+	uint32_t size = sizeof(RS_ServiceSlotHeader)
+			+ (1<<nb_symbols_log2)*message_length*sizeof(float)
+			+ k*sizeof(uint32_t);
+	return (size + 63) & ~63U;
+}
+
+// ================================================================================================
+size_t RS_ServiceRing::ring_size(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int k, unsigned int nb_slots)
+{
+	return 64 + ((size_t) nb_slots) * slot_size(nb_symbols_log2, message_length, k);
+}
+
+// ================================================================================================
+RS_ServiceSlotHeader *RS_ServiceRing::slot_header(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot)
+{
+	return (RS_ServiceSlotHeader *) (((char *) ring) + 64 + ((size_t) slot)*geometry.slot_size);
+}
+
+// ================================================================================================
+float *RS_ServiceRing::slot_matrix(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot)
+{
+	return (float *) (((char *) slot_header(ring, geometry, slot)) + sizeof(RS_ServiceSlotHeader));
+}
+
+// ================================================================================================
+uint32_t *RS_ServiceRing::slot_message(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot)
+{
+	return (uint32_t *) (slot_matrix(ring, geometry, slot) + (((size_t) 1)<<geometry.nb_symbols_log2)*geometry.message_length);
+}
+
+// ================================================================================================
+RS_DecodeService::RS_DecodeService(const gf::GFq& _gf, unsigned int _k, const EvaluationValues& _evaluation_values,
+		unsigned int _nb_workers, unsigned int _batch_size, unsigned int _batch_timeout_us) :
+	gf(_gf),
+	k(_k),
+	evaluation_values(_evaluation_values),
+	nb_workers(_nb_workers > 0 ? _nb_workers : 1),
+	batch_size(_batch_size > 0 ? _batch_size : 1),
+	batch_timeout_us(_batch_timeout_us),
+	global_multiplicity(3),
+	nb_iterations_max(1),
+	policy(0),
+	listen_fd(-1),
+	stopping(false),
+	nb_frames(0),
+	nb_batches(0)
+{
+	if (pipe(wakeup_pipe) < 0)
+	{
+		throw RSSoft_Exception("Cannot create service wake up pipe");
+	}
+
+	pthread_mutex_init(&queue_mutex, 0);
+	pthread_cond_init(&queue_cond, 0);
+}
+
+// ================================================================================================
+RS_DecodeService::~RS_DecodeService()
+{
+	stop_workers();
+
+	std::list<Client*>::iterator c_it = clients.begin();
+
+	for (; c_it != clients.end(); ++c_it)
+	{
+		delete_client(*c_it);
+	}
+
+	if (listen_fd >= 0)
+	{
+		::close(listen_fd);
+		unlink(socket_path.c_str());
+	}
+
+	::close(wakeup_pipe[0]);
+	::close(wakeup_pipe[1]);
+	pthread_cond_destroy(&queue_cond);
+	pthread_mutex_destroy(&queue_mutex);
+}
+
+// ================================================================================================
+void RS_DecodeService::open(const std::string& _socket_path)
+{
+	struct sockaddr_un addr;
+
+	if (_socket_path.size() >= sizeof(addr.sun_path))
+	{
+		throw RSSoft_Exception("Service socket path is too long");
+	}
+
+	socket_path = _socket_path;
+	unlink(socket_path.c_str());
+	listen_fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+
+	if (listen_fd < 0)
+	{
+		throw RSSoft_Exception("Cannot create service socket");
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path)-1);
+
+	if ((bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) || (listen(listen_fd, 16) < 0))
+	{
+		::close(listen_fd);
+		listen_fd = -1;
+		throw RSSoft_Exception("Cannot bind service socket to " + socket_path);
+	}
+}
+
+// ================================================================================================
+void RS_DecodeService::stop()
+{
+	char c = 0;
+	ssize_t written = write(wakeup_pipe[1], &c, 1);
+	(void) written;
+}
+
+// ================================================================================================
+void RS_DecodeService::run()
+{
+	if (listen_fd < 0)
+	{
+		throw RSSoft_Exception("Service socket is not open");
+	}
+
+	start_workers();
+
+	while (true)
+	{
+		std::vector<struct pollfd> pfds;
+		std::vector<Client*> pclients;
+		struct pollfd pfd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+
+		pfd.fd = wakeup_pipe[0];
+		pfds.push_back(pfd);
+		pfd.fd = listen_fd;
+		pfds.push_back(pfd);
+
+		std::list<Client*>::iterator c_it = clients.begin();
+
+		for (; c_it != clients.end(); ++c_it)
+		{
+			pfd.fd = (*c_it)->fd;
+			pfds.push_back(pfd);
+			pclients.push_back(*c_it);
+		}
+
+		if (poll(&pfds[0], pfds.size(), -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
+		}
+
+		if (pfds[0].revents & POLLIN)
+		{
+			char c;
+			ssize_t nread = read(wakeup_pipe[0], &c, 1);
+			(void) nread;
+			break; // stop requested
+		}
+
+		if (pfds[1].revents & POLLIN)
+		{
+			int fd = accept(listen_fd, 0, 0);
+
+			if (fd >= 0)
+			{
+				Client *client = new Client;
+				client->fd = fd;
+				client->ring = 0;
+				client->ring_size = 0;
+				client->pending = 0;
+				client->closed = false;
+				pthread_mutex_init(&client->write_mutex, 0);
+				clients.push_back(client);
+			}
+		}
+
+		for (unsigned int i = 0; i < pclients.size(); i++)
+		{
+			if (pfds[i+2].revents & (POLLIN | POLLHUP | POLLERR))
+			{
+				if (!receive_message(pclients[i]))
+				{
+					clients.remove(pclients[i]);
+					close_client(pclients[i]);
+				}
+			}
+		}
+	}
+
+	stop_workers();
+}
+
+// ================================================================================================
+bool RS_DecodeService::receive_message(Client *client)
+{
+	RS_ServiceMessage message;
+	ssize_t nread = recv(client->fd, &message, sizeof(message), 0);
+
+	if (nread != sizeof(message))
+	{
+		return false; // closed or garbage
+	}
+
+	if (message.type == RS_ServiceMessage_Hello)
+	{
+		message.shm_name[RS_SERVICE_SHM_NAME_SIZE-1] = '\0';
+		return attach_ring(client, message.shm_name);
+	}
+	else if ((message.type == RS_ServiceMessage_Submit) && (client->ring))
+	{
+		if (message.slot >= client->geometry.nb_slots)
+		{
+			return false;
+		}
+
+		Job job;
+		job.client = client;
+		job.slot = message.slot;
+
+		pthread_mutex_lock(&queue_mutex);
+
+		if (client->slot_pending[message.slot]) // the slot is still being decoded
+		{
+			pthread_mutex_unlock(&queue_mutex);
+			return false;
+		}
+
+		RS_ServiceRing::slot_header(client->ring, client->geometry, message.slot)->status = RS_ServiceSlot_Pending;
+		client->slot_pending[message.slot] = 1;
+		client->pending++;
+		jobs.push_back(job);
+		pthread_cond_broadcast(&queue_cond);
+		pthread_mutex_unlock(&queue_mutex);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// ================================================================================================
+bool RS_DecodeService::attach_ring(Client *client, const char *shm_name)
+{
+	if (client->ring)
+	{
+		return false; // only one ring per connection
+	}
+
+	int shm_fd = shm_open(shm_name, O_RDWR, 0);
+
+	if (shm_fd < 0)
+	{
+		return false;
+	}
+
+	struct stat shm_stat;
+	RS_ServiceRingHeader ring_header;
+
+	if ((fstat(shm_fd, &shm_stat) < 0)
+		|| (((size_t) shm_stat.st_size) < sizeof(RS_ServiceRingHeader))
+		|| (pread(shm_fd, &ring_header, sizeof(ring_header), 0) != sizeof(ring_header))
+		|| (ring_header.magic != RS_SERVICE_RING_MAGIC)
+		|| (ring_header.version != RS_SERVICE_VERSION)
+		|| (ring_header.nb_symbols_log2 != gf.pwr())
+		|| (ring_header.message_length != evaluation_values.get_evaluation_points().size())
+		|| (ring_header.k != k)
+		|| (ring_header.slot_size != RS_ServiceRing::slot_size(ring_header.nb_symbols_log2, ring_header.message_length, ring_header.k))
+		|| (((size_t) shm_stat.st_size) < RS_ServiceRing::ring_size(ring_header.nb_symbols_log2, ring_header.message_length, ring_header.k, ring_header.nb_slots)))
+	{
+		::close(shm_fd);
+		return false; // not a ring compatible with this service
+	}
+
+	client->ring_size = RS_ServiceRing::ring_size(ring_header.nb_symbols_log2, ring_header.message_length, ring_header.k, ring_header.nb_slots);
+	void *ring = mmap(0, client->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	::close(shm_fd);
+
+	if (ring == MAP_FAILED)
+	{
+		return false;
+	}
+
+	client->geometry = ring_header; // the mapped header stays writable by the client and is not read again
+	client->slot_pending.assign(ring_header.nb_slots, 0);
+	client->ring = ring;
+	return true;
+}
+
+// ================================================================================================
+void RS_DecodeService::finish_job(const Job& job)
+{
+	bool last;
+
+	pthread_mutex_lock(&queue_mutex);
+	job.client->slot_pending[job.slot] = 0;
+	job.client->pending--;
+	last = job.client->closed && (job.client->pending == 0); // decided with the decrement so that exactly one caller deletes
+	pthread_mutex_unlock(&queue_mutex);
+
+	if (last)
+	{
+		delete_client(job.client);
+	}
+}
+
+// ================================================================================================
+void RS_DecodeService::close_client(Client *client)
+{
+	bool last;
+
+	pthread_mutex_lock(&queue_mutex);
+	client->closed = true;
+	last = (client->pending == 0); // otherwise the worker finishing the last job deletes it
+	pthread_mutex_unlock(&queue_mutex);
+
+	if (last)
+	{
+		delete_client(client);
+	}
+}
+
+// ================================================================================================
+void RS_DecodeService::delete_client(Client *client)
+{
+	::close(client->fd);
+
+	if (client->ring)
+	{
+		munmap(client->ring, client->ring_size);
+	}
+
+	pthread_mutex_destroy(&client->write_mutex);
+	delete client;
+}
+
+// ================================================================================================
+void RS_DecodeService::start_workers()
+{
+	stopping = false;
+	workers.resize(nb_workers);
+
+	for (unsigned int i = 0; i < nb_workers; i++)
+	{
+		workers[i].service = this;
+		workers[i].gskv = new GSKV_Interpolation(gf, k, evaluation_values);
+		workers[i].rr = new RR_Factorization(gf, k);
+		workers[i].final_evaluation = new FinalEvaluation(gf, k, evaluation_values);
+		workers[i].batch_relmat = new RS_BatchReliabilityMatrix(gf.pwr(), evaluation_values.get_evaluation_points().size(), batch_size);
+		workers[i].hard_decision = new RS_BatchHardDecision(gf, k, evaluation_values);
+		pthread_create(&workers[i].thread, 0, worker_entry, &workers[i]);
+	}
+}
+
+// ================================================================================================
+void RS_DecodeService::stop_workers()
+{
+	pthread_mutex_lock(&queue_mutex);
+	stopping = true;
+	pthread_cond_broadcast(&queue_cond);
+	pthread_mutex_unlock(&queue_mutex);
+
+	std::vector<Worker>::iterator w_it = workers.begin();
+
+	for (; w_it != workers.end(); ++w_it)
+	{
+		pthread_join(w_it->thread, 0);
+		delete w_it->gskv;
+		delete w_it->rr;
+		delete w_it->final_evaluation;
+		delete w_it->batch_relmat;
+		delete w_it->hard_decision;
+	}
+
+	workers.clear();
+}
+
+// ================================================================================================
+void *RS_DecodeService::worker_entry(void *arg)
+{
+	Worker *worker = (Worker *) arg;
+	worker->service->worker_loop(*worker);
+	return 0;
+}
+
+// ================================================================================================
+void RS_DecodeService::worker_loop(Worker& worker)
+{
+	std::vector<Job> batch;
+
+	pthread_mutex_lock(&queue_mutex);
+
+	while (true)
+	{
+		while (jobs.empty() && !stopping)
+		{
+			pthread_cond_wait(&queue_cond, &queue_mutex);
+		}
+
+		if (stopping)
+		{
+			break;
+		}
+
+		if ((jobs.size() < batch_size) && (batch_timeout_us > 0)) // let the batch fill up
+		{
+			struct timeval now;
+			struct timespec deadline;
+			gettimeofday(&now, 0);
+			unsigned long long deadline_us = ((unsigned long long) now.tv_sec)*1000000ULL + now.tv_usec + batch_timeout_us;
+			deadline.tv_sec = deadline_us / 1000000ULL;
+			deadline.tv_nsec = (deadline_us % 1000000ULL) * 1000;
+
+			while ((jobs.size() < batch_size) && !stopping)
+			{
+				if (pthread_cond_timedwait(&queue_cond, &queue_mutex, &deadline) == ETIMEDOUT)
+				{
+					break;
+				}
+			}
+
+			if (jobs.empty()) // taken by another worker
+			{
+				continue;
+			}
+		}
+
+		while ((batch.size() < batch_size) && !jobs.empty())
+		{
+			batch.push_back(jobs.front());
+			jobs.pop_front();
+		}
+
+		nb_batches++;
+		nb_frames += batch.size();
+		pthread_mutex_unlock(&queue_mutex);
+
+		std::vector<Job>::const_iterator j_it = batch.begin();
+		std::vector<bool> decoded;
+		hard_decision_batch(worker, batch, decoded);
+
+		for (unsigned int i_job = 0; j_it != batch.end(); ++j_it, i_job++)
+		{
+			if (!decoded[i_job])
+			{
+				decode_job(worker, *j_it);
+			}
+		}
+
+		for (j_it = batch.begin(); j_it != batch.end(); ++j_it)
+		{
+			finish_job(*j_it);
+		}
+
+		batch.clear();
+		pthread_mutex_lock(&queue_mutex);
+	}
+
+	pthread_mutex_unlock(&queue_mutex);
+}
+
+// ================================================================================================
+void RS_DecodeService::hard_decision_batch(Worker& worker, const std::vector<Job>& batch, std::vector<bool>& decoded)
+{
+	RS_BatchReliabilityMatrix& batch_relmat = *worker.batch_relmat;
+	unsigned int n = batch_relmat.get_message_length();
+	unsigned int lanes = batch_relmat.get_batch_size();
+	std::vector<unsigned int> rows(n*lanes);
+	std::vector<gf::GFq_Symbol> codewords(n*lanes);
+	std::vector<gf::GFq_Symbol> messages(k*lanes);
+	std::vector<float> scores(lanes);
+	std::vector<unsigned int> counts(lanes);
+	std::vector<bool> valid;
+
+	decoded.assign(batch.size(), false);
+
+	try
+	{
+		for (unsigned int b = 0; b < batch.size(); b++)
+		{
+			RS_ReliabilityMatrix relmat(gf.pwr(), n, RS_ServiceRing::slot_matrix(batch[b].client->ring, batch[b].client->geometry, batch[b].slot));
+			batch_relmat.set_lane(b, relmat);
+		}
+
+		batch_relmat.normalize();
+		batch_relmat.hard_decisions(&rows[0]);
+		worker.hard_decision->symbols(&rows[0], &codewords[0], lanes);
+
+		if (worker.hard_decision->check(&codewords[0], valid, lanes) == 0)
+		{
+			return;
+		}
+
+		worker.hard_decision->messages(&codewords[0], &messages[0], lanes);
+		batch_relmat.score(&rows[0], &scores[0], &counts[0]);
+	}
+	catch (std::exception& e) // leave it to the frame by frame path
+	{
+		DEBUG_OUT(true, "RS_DecodeService: batch hard decision: " << e.what() << std::endl);
+		return;
+	}
+
+	for (unsigned int b = 0; b < batch.size(); b++)
+	{
+		if (valid[b] && (counts[b] > 0)) // hard decision is a codeword hence the most probable one
+		{
+			RS_ServiceSlotHeader *slot_header = RS_ServiceRing::slot_header(batch[b].client->ring, batch[b].client->geometry, batch[b].slot);
+			uint32_t *slot_message = RS_ServiceRing::slot_message(batch[b].client->ring, batch[b].client->geometry, batch[b].slot);
+
+			for (unsigned int i = 0; i < k; i++)
+			{
+				slot_message[i] = messages[i*lanes + b];
+			}
+
+			slot_header->nb_iterations = 0;
+			slot_header->score = scores[b];
+			slot_header->status = RS_ServiceSlot_Decoded;
+			send_result(batch[b].client, batch[b].slot, slot_header);
+			decoded[b] = true;
+		}
+	}
+}
+
+// ================================================================================================
+void RS_DecodeService::decode_job(Worker& worker, const Job& job)
+{
+	RS_ServiceSlotHeader *slot_header = RS_ServiceRing::slot_header(job.client->ring, job.client->geometry, job.slot);
+	uint32_t *slot_message = RS_ServiceRing::slot_message(job.client->ring, job.client->geometry, job.slot);
+	RS_ReliabilityMatrix relmat(gf.pwr(), job.client->geometry.message_length);
+	unsigned int multiplicity = global_multiplicity;
+	unsigned int iterations_max = nb_iterations_max;
+	gf::GFq_MonomialArenaScope monomial_arena; // released in one shot when the frame is done
+
+	slot_header->status = RS_ServiceSlot_Failed;
+	slot_header->nb_iterations = 0;
+	slot_header->score = 0.0;
+	// private copy: the slot stays writable by the client while the frame is decoded
+	memcpy((void *) relmat.get_raw_matrix(), (const void *) RS_ServiceRing::slot_matrix(job.client->ring, job.client->geometry, job.slot),
+		relmat.get_nb_symbols()*relmat.get_message_length()*sizeof(float));
+
+	try
+	{
+		if (policy) // estimate is made on the raw powers
+		{
+			try
+			{
+				const RS_PolicyEntry& policy_entry = policy->lookup(RS_DecodingPolicy::estimate_snr_dB(relmat));
+				multiplicity = policy_entry.global_multiplicity;
+				iterations_max = policy_entry.nb_iterations_max;
+			}
+			catch (RSSoft_Exception& e) // keep the fixed schedule
+			{
+				DEBUG_OUT(true, "RS_DecodeService: slot " << job.slot << ": " << e.what() << std::endl);
+			}
+		}
+
+		relmat.normalize();
+
+		for (unsigned int ni = 1; (ni <= iterations_max) && (slot_header->status == RS_ServiceSlot_Failed); ni++, multiplicity++)
+		{
+			MultiplicityMatrix mat_M(relmat, multiplicity);
+			worker.gskv->init();
+			worker.rr->init();
+			slot_header->nb_iterations = ni;
+
+			const gf::GFq_BivariatePolynomial& Q = worker.gskv->run(mat_M);
+
+			if (!Q.is_in_X())
+			{
+				std::vector<gf::GFq_Polynomial>& res_polys = worker.rr->run(Q);
+
+				if (res_polys.size() > 0)
+				{
+					worker.final_evaluation->init();
+					worker.final_evaluation->run(res_polys, relmat);
+					const ProbabilityCodeword& best_message = worker.final_evaluation->get_messages().front();
+
+					for (unsigned int i = 0; i < k; i++)
+					{
+						slot_message[i] = (i < best_message.get_codeword().size() ? best_message.get_codeword()[i] : 0);
+					}
+
+					slot_header->score = best_message.get_probability_score();
+					slot_header->status = RS_ServiceSlot_Decoded;
+				}
+			}
+		}
+	}
+	catch (std::exception& e)
+	{
+		DEBUG_OUT(true, "RS_DecodeService: slot " << job.slot << ": " << e.what() << std::endl);
+		slot_header->status = RS_ServiceSlot_Error;
+	}
+
+	send_result(job.client, job.slot, slot_header);
+}
+
+// ================================================================================================
+void RS_DecodeService::send_result(Client *client, unsigned int slot, RS_ServiceSlotHeader *slot_header)
+{
+	RS_ServiceMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type = RS_ServiceMessage_Result;
+	message.slot = slot;
+	message.status = slot_header->status;
+	message.score = slot_header->score;
+
+	pthread_mutex_lock(&client->write_mutex);
+	ssize_t written = send(client->fd, &message, sizeof(message), MSG_NOSIGNAL);
+	(void) written; // client may have gone away
+	pthread_mutex_unlock(&client->write_mutex);
+}
+
+// ================================================================================================
+RS_DecodeServiceClient::RS_DecodeServiceClient(unsigned int _nb_symbols_log2, unsigned int _message_length, unsigned int _k, unsigned int _nb_slots) :
+	nb_symbols_log2(_nb_symbols_log2),
+	message_length(_message_length),
+	k(_k),
+	nb_slots(_nb_slots),
+	fd(-1),
+	ring(0),
+	ring_size(0)
+{
+	geometry.magic = RS_SERVICE_RING_MAGIC;
+	geometry.version = RS_SERVICE_VERSION;
+	geometry.nb_symbols_log2 = nb_symbols_log2;
+	geometry.message_length = message_length;
+	geometry.k = k;
+	geometry.nb_slots = nb_slots;
+	geometry.slot_size = RS_ServiceRing::slot_size(nb_symbols_log2, message_length, k);
+	geometry.reserved = 0;
+}
+
+// ================================================================================================
+RS_DecodeServiceClient::~RS_DecodeServiceClient()
+{
+	if (fd >= 0)
+	{
+		::close(fd);
+	}
+
+	if (ring)
+	{
+		munmap(ring, ring_size);
+		shm_unlink(shm_name.c_str());
+	}
+}
+
+// ================================================================================================
+void RS_DecodeServiceClient::connect(const std::string& socket_path)
+{
+	std::ostringstream os;
+	os << "/rssoft_" << getpid() << "_" << this;
+	shm_name = os.str().substr(0, RS_SERVICE_SHM_NAME_SIZE-1);
+	ring_size = RS_ServiceRing::ring_size(nb_symbols_log2, message_length, k, nb_slots);
+
+	int shm_fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if (shm_fd < 0)
+	{
+		throw RSSoft_Exception("Cannot create shared memory ring " + shm_name);
+	}
+
+	if (ftruncate(shm_fd, ring_size) < 0)
+	{
+		::close(shm_fd);
+		shm_unlink(shm_name.c_str());
+		throw RSSoft_Exception("Cannot size shared memory ring " + shm_name);
+	}
+
+	ring = mmap(0, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	::close(shm_fd);
+
+	if (ring == MAP_FAILED)
+	{
+		ring = 0;
+		shm_unlink(shm_name.c_str());
+		throw RSSoft_Exception("Cannot map shared memory ring " + shm_name);
+	}
+
+	*((RS_ServiceRingHeader *) ring) = geometry;
+
+	struct sockaddr_un addr;
+
+	if (socket_path.size() >= sizeof(addr.sun_path))
+	{
+		throw RSSoft_Exception("Service socket path is too long");
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path)-1);
+	fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+
+	if ((fd < 0) || (::connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0))
+	{
+		throw RSSoft_Exception("Cannot connect to service at " + socket_path);
+	}
+
+	RS_ServiceMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type = RS_ServiceMessage_Hello;
+	strncpy(message.shm_name, shm_name.c_str(), RS_SERVICE_SHM_NAME_SIZE-1);
+
+	if (send(fd, &message, sizeof(message), MSG_NOSIGNAL) != sizeof(message))
+	{
+		throw RSSoft_Exception("Cannot send hello to service");
+	}
+}
+
+// ================================================================================================
+void RS_DecodeServiceClient::submit(unsigned int slot)
+{
+	if (slot >= nb_slots)
+	{
+		throw RSSoft_Exception("Invalid slot index");
+	}
+
+	RS_ServiceMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type = RS_ServiceMessage_Submit;
+	message.slot = slot;
+	RS_ServiceRing::slot_header(ring, geometry, slot)->status = RS_ServiceSlot_Pending;
+
+	if (send(fd, &message, sizeof(message), MSG_NOSIGNAL) != sizeof(message))
+	{
+		throw RSSoft_Exception("Cannot submit to service");
+	}
+}
+
+// ================================================================================================
+RS_ServiceSlotStatus RS_DecodeServiceClient::wait_result(unsigned int& slot)
+{
+	RS_ServiceMessage message;
+
+	if (recv(fd, &message, sizeof(message), 0) != sizeof(message))
+	{
+		throw RSSoft_Exception("Connection to service lost");
+	}
+
+	slot = message.slot;
+	return (RS_ServiceSlotStatus) message.status;
+}
+
+} // namespace rssoft
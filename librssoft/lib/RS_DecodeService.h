@@ -0,0 +1,383 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Local decoding service. Clients connect through a Unix domain socket
+	 and exchange frames through a shared memory ring of slots they own.
+	 Only small fixed size control messages go through the socket.
+	 Requests are coalesced into batches processed by a pool of worker
+	 threads each holding its warm decoding objects. Each batch is first
+	 hard decided as a whole and only the frames whose hard decision is not
+	 a codeword go through interpolation and factorization.
+
+ */
+#ifndef __RS_DECODE_SERVICE_H__
+#define __RS_DECODE_SERVICE_H__
+
+#include "GFq.h"
+#include <stdint.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+
+namespace rssoft
+{
+
+class EvaluationValues;
+class GSKV_Interpolation;
+class RR_Factorization;
+class FinalEvaluation;
+class RS_BatchReliabilityMatrix;
+class RS_BatchHardDecision;
+class RS_DecodingPolicy;
+
+static const uint32_t RS_SERVICE_RING_MAGIC = 0x52535352;  //!< "RSSR" marks a valid ring
+static const uint32_t RS_SERVICE_VERSION = 1;              //!< Protocol and ring layout version
+static const unsigned int RS_SERVICE_SHM_NAME_SIZE = 48;   //!< Maximum size of a shared memory name including terminating zero
+
+/**
+ * \brief Type of the messages exchanged on the service socket
+ */
+typedef enum
+{
+	RS_ServiceMessage_Hello = 1,  //!< Client to service: attach the shared memory ring given by name
+	RS_ServiceMessage_Submit,     //!< Client to service: the slot contains a frame to decode
+	RS_ServiceMessage_Result      //!< Service to client: the slot decoding is finished
+} RS_ServiceMessageType;
+
+/**
+ * \brief Status of a slot in the shared memory ring
+ */
+typedef enum
+{
+	RS_ServiceSlot_Free = 0,      //!< Slot can be filled by the client
+	RS_ServiceSlot_Pending,       //!< Slot was submitted and is being processed by the service
+	RS_ServiceSlot_Decoded,       //!< Slot contains a decoded message
+	RS_ServiceSlot_Failed,        //!< No message could be found for this slot
+	RS_ServiceSlot_Error          //!< Invalid request
+} RS_ServiceSlotStatus;
+
+/**
+ * \brief Fixed size control message exchanged on the service socket
+ */
+struct RS_ServiceMessage
+{
+	uint32_t type;   //!< One of RS_ServiceMessageType
+	uint32_t slot;   //!< Slot index in the ring
+	uint32_t status; //!< One of RS_ServiceSlotStatus in result messages
+	float score;     //!< Probability score in dB/symbol of the decoded message in result messages
+	char shm_name[RS_SERVICE_SHM_NAME_SIZE]; //!< Shared memory name in hello messages
+};
+
+/**
+ * \brief Header at the start of the shared memory ring
+ */
+struct RS_ServiceRingHeader
+{
+	uint32_t magic;           //!< RS_SERVICE_RING_MAGIC
+	uint32_t version;         //!< RS_SERVICE_VERSION
+	uint32_t nb_symbols_log2; //!< Log2 of the number of rows of the reliability matrices
+	uint32_t message_length;  //!< Number of columns of the reliability matrices (n)
+	uint32_t k;               //!< k as in RS(n,k)
+	uint32_t nb_slots;        //!< Number of slots in the ring
+	uint32_t slot_size;       //!< Size of a slot in bytes
+	uint32_t reserved;
+};
+
+/**
+ * \brief Header at the start of each slot. It is followed by the reliability matrix data stored column first
+ * (2^m * n floats) and the k decoded message symbols (uint32_t)
+ */
+struct RS_ServiceSlotHeader
+{
+	uint32_t status;          //!< One of RS_ServiceSlotStatus
+	uint32_t nb_iterations;   //!< Number of multiplicity iterations used (0 when the hard decision is a codeword)
+	float score;              //!< Probability score in dB/symbol of the decoded message
+	uint32_t reserved;
+};
+
+/**
+ * \brief Shared memory ring layout helpers used by both sides
+ */
+class RS_ServiceRing
+{
+public:
+	/**
+	 * Size of one slot rounded up to a cache line
+	 */
+	static uint32_t slot_size(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int k);
+
+	/**
+	 * Total size of the ring
+	 */
+	static size_t ring_size(unsigned int nb_symbols_log2, unsigned int message_length, unsigned int k, unsigned int nb_slots);
+
+	/**
+	 * Slot header of the given slot
+	 */
+	static RS_ServiceSlotHeader *slot_header(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot);
+
+	/**
+	 * Reliability matrix data of the given slot
+	 */
+	static float *slot_matrix(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot);
+
+	/**
+	 * Message symbols of the given slot
+	 */
+	static uint32_t *slot_message(void *ring, const RS_ServiceRingHeader& geometry, unsigned int slot);
+};
+
+/**
+ * \brief Local decoding service over a Unix domain socket and client owned shared memory rings
+ */
+class RS_DecodeService
+{
+public:
+	/**
+	 * Constructor
+	 * \param _gf Reference to the Galois Field being used. Shared by all workers.
+	 * \param _k k as in RS(n,k)
+	 * \param _evaluation_values Evaluation X,Y values used for coding. Shared by all workers.
+	 * \param _nb_workers Number of decoding threads
+	 * \param _batch_size Maximum number of requests processed as one batch by a worker
+	 * \param _batch_timeout_us Time in microseconds a worker waits for a batch to fill up
+	 */
+	RS_DecodeService(const gf::GFq& _gf, unsigned int _k, const EvaluationValues& _evaluation_values,
+			unsigned int _nb_workers, unsigned int _batch_size = 8, unsigned int _batch_timeout_us = 200);
+
+	/**
+	 * Destructor. Stops workers and closes all connections.
+	 */
+	~RS_DecodeService();
+
+	/**
+	 * Set multiplicity iterations parameters
+	 * \param _global_multiplicity Global multiplicity at first iteration. It is incremented at each iteration.
+	 * \param _nb_iterations_max Maximum number of iterations
+	 */
+	void set_multiplicity(unsigned int _global_multiplicity, unsigned int _nb_iterations_max)
+	{
+		global_multiplicity = _global_multiplicity;
+		nb_iterations_max = _nb_iterations_max;
+	}
+
+	/**
+	 * Set a decoding policy giving the multiplicity parameters of each frame from its SNR estimate. It overrides
+	 * the parameters given with set_multiplicity except for frames whose SNR cannot be estimated.
+	 * \param _policy Policy owned by the caller and kept alive while the service runs or 0 to use fixed parameters
+	 */
+	void set_policy(const RS_DecodingPolicy *_policy)
+	{
+		policy = _policy;
+	}
+
+	/**
+	 * Create the listening socket. Removes any stale socket file first.
+	 * \param socket_path Path of the Unix domain socket
+	 */
+	void open(const std::string& socket_path);
+
+	/**
+	 * Serve clients until stop() is called. Starts the worker threads.
+	 */
+	void run();
+
+	/**
+	 * Request the run loop to exit. Can be called from any thread or a signal handler.
+	 */
+	void stop();
+
+	/**
+	 * Number of frames processed so far
+	 */
+	unsigned long get_nb_frames() const
+	{
+		return nb_frames;
+	}
+
+	/**
+	 * Number of batches processed so far
+	 */
+	unsigned long get_nb_batches() const
+	{
+		return nb_batches;
+	}
+
+protected:
+	/**
+	 * \brief A connected client
+	 */
+	struct Client
+	{
+		int fd;                      //!< Connection socket
+		void *ring;                  //!< Mapped shared memory ring or 0 until hello is received
+		size_t ring_size;            //!< Size of the mapping
+		RS_ServiceRingHeader geometry; //!< Ring geometry as checked when the ring was attached
+		unsigned int pending;        //!< Number of requests in flight
+		std::vector<unsigned char> slot_pending; //!< 1 for the slots with a request in flight
+		bool closed;                 //!< Connection was closed by the client
+		pthread_mutex_t write_mutex; //!< Serializes result messages
+	};
+
+	/**
+	 * \brief A decoding request
+	 */
+	struct Job
+	{
+		Client *client;
+		unsigned int slot;
+	};
+
+	/**
+	 * \brief Decoding objects owned by one worker. They are reused from frame to frame.
+	 */
+	struct Worker
+	{
+		RS_DecodeService *service;
+		pthread_t thread;
+		GSKV_Interpolation *gskv;
+		RR_Factorization *rr;
+		FinalEvaluation *final_evaluation;
+		RS_BatchReliabilityMatrix *batch_relmat;
+		RS_BatchHardDecision *hard_decision;
+	};
+
+	static void *worker_entry(void *arg);
+	void worker_loop(Worker& worker);
+	void hard_decision_batch(Worker& worker, const std::vector<Job>& batch, std::vector<bool>& decoded);
+	void decode_job(Worker& worker, const Job& job);
+	void send_result(Client *client, unsigned int slot, RS_ServiceSlotHeader *slot_header);
+	void finish_job(const Job& job);
+	void close_client(Client *client);
+	void delete_client(Client *client);
+	bool receive_message(Client *client);
+	bool attach_ring(Client *client, const char *shm_name);
+	void start_workers();
+	void stop_workers();
+
+	const gf::GFq& gf; //!< Galois Field in use
+	unsigned int k; //!< k as in RS(n,k)
+	const EvaluationValues& evaluation_values; //!< Evaluation X,Y values used for coding
+	unsigned int nb_workers; //!< Number of decoding threads
+	unsigned int batch_size; //!< Maximum number of requests in a batch
+	unsigned int batch_timeout_us; //!< Time to wait for a batch to fill up
+	unsigned int global_multiplicity; //!< Global multiplicity at first iteration
+	unsigned int nb_iterations_max; //!< Maximum number of multiplicity iterations
+	const RS_DecodingPolicy *policy; //!< Multiplicity parameters by SNR or 0
+	int listen_fd; //!< Listening socket
+	int wakeup_pipe[2]; //!< Self pipe used to interrupt the run loop
+	std::string socket_path; //!< Path of the listening socket
+	std::list<Client*> clients; //!< Connected clients
+	std::deque<Job> jobs; //!< Requests queue
+	std::vector<Worker> workers; //!< Decoding threads
+	bool stopping; //!< Workers must exit
+	pthread_mutex_t queue_mutex; //!< Protects jobs, stopping and clients pending counts
+	pthread_cond_t queue_cond; //!< Signals new jobs
+	unsigned long nb_frames; //!< Frames processed
+	unsigned long nb_batches; //!< Batches processed
+};
+
+/**
+ * \brief Client side of the local decoding service
+ */
+class RS_DecodeServiceClient
+{
+public:
+	/**
+	 * Constructor
+	 * \param _nb_symbols_log2 Log2 of the number of symbols (m)
+	 * \param _message_length Length of a codeword (n)
+	 * \param _k k as in RS(n,k)
+	 * \param _nb_slots Number of slots in the shared memory ring
+	 */
+	RS_DecodeServiceClient(unsigned int _nb_symbols_log2, unsigned int _message_length, unsigned int _k, unsigned int _nb_slots);
+
+	/**
+	 * Destructor. Closes the connection and removes the shared memory ring.
+	 */
+	~RS_DecodeServiceClient();
+
+	/**
+	 * Create the shared memory ring and connect to the service
+	 * \param socket_path Path of the service Unix domain socket
+	 */
+	void connect(const std::string& socket_path);
+
+	/**
+	 * Reliability matrix storage of a slot. Data is entered column first with 2^m rows per column
+	 * and can be wrapped by a RS_ReliabilityMatrix without copy.
+	 */
+	float *get_slot_matrix(unsigned int slot)
+	{
+		return RS_ServiceRing::slot_matrix(ring, geometry, slot);
+	}
+
+	/**
+	 * Decoded message symbols of a slot. Valid when the slot status is decoded.
+	 */
+	const uint32_t *get_slot_message(unsigned int slot) const
+	{
+		return RS_ServiceRing::slot_message(ring, geometry, slot);
+	}
+
+	/**
+	 * Slot header of a slot
+	 */
+	const RS_ServiceSlotHeader& get_slot_header(unsigned int slot) const
+	{
+		return *RS_ServiceRing::slot_header(ring, geometry, slot);
+	}
+
+	/**
+	 * Submit the frame stored in a slot for decoding. Returns immediately.
+	 */
+	void submit(unsigned int slot);
+
+	/**
+	 * Wait for the next result
+	 * \param slot Slot that was processed
+	 * \return Status of the slot
+	 */
+	RS_ServiceSlotStatus wait_result(unsigned int& slot);
+
+	/**
+	 * Number of slots in the ring
+	 */
+	unsigned int get_nb_slots() const
+	{
+		return nb_slots;
+	}
+
+protected:
+	unsigned int nb_symbols_log2; //!< Log2 of the number of symbols (m)
+	unsigned int message_length; //!< Length of a codeword (n)
+	unsigned int k; //!< k as in RS(n,k)
+	unsigned int nb_slots; //!< Number of slots in the ring
+	int fd; //!< Connection socket
+	void *ring; //!< Mapped shared memory ring
+	size_t ring_size; //!< Size of the mapping
+	RS_ServiceRingHeader geometry; //!< Ring geometry as written in the ring header
+	std::string shm_name; //!< Name of the shared memory object
+};
+
+} // namespace rssoft
+
+#endif // __RS_DECODE_SERVICE_H__
@@ -0,0 +1,221 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Decoding policy: parameters of the multiplicity schedule by SNR bucket.
+
+ */
+
+#include "RS_DecodingPolicy.h"
+#include "RS_ReliabilityMatrix.h"
+#include "RSSoft_Exception.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace rssoft
+{
+
+// ================================================================================================
+RS_DecodingPolicy::RS_DecodingPolicy()
+{}
+
+// ================================================================================================
+RS_DecodingPolicy::~RS_DecodingPolicy()
+{}
+
+// ================================================================================================
+void RS_DecodingPolicy::add_entry(const RS_PolicyEntry& entry)
+{
+	if ((entry.global_multiplicity == 0) || (entry.nb_iterations_max == 0))
+	{
+		throw RSSoft_Exception("Policy multiplicity and number of iterations must be positive");
+	}
+
+	std::vector<RS_PolicyEntry>::iterator e_it = std::lower_bound(entries.begin(), entries.end(), entry);
+
+	if ((e_it != entries.end()) && (e_it->snr_dB == entry.snr_dB))
+	{
+		*e_it = entry;
+	}
+	else
+	{
+		entries.insert(e_it, entry);
+	}
+}
+
+// ================================================================================================
+void RS_DecodingPolicy::load(const std::string& filename)
+{
+	std::ifstream policy_file(filename.c_str());
+
+	if (!policy_file.is_open())
+	{
+		throw RSSoft_Exception("Cannot open policy file " + filename);
+	}
+
+	load(policy_file);
+}
+
+// ================================================================================================
+void RS_DecodingPolicy::load(std::istream& is)
+{
+	std::string line;
+	bool header_seen = false;
+
+	entries.clear();
+
+	while (std::getline(is, line))
+	{
+		std::istringstream line_stream(line);
+		std::string first_word;
+
+		if (!(line_stream >> first_word) || (first_word[0] == '#')) // blank or comment
+		{
+			continue;
+		}
+
+		if (!header_seen)
+		{
+			unsigned int file_version;
+
+			if ((first_word != "rssoft-policy") || !(line_stream >> file_version) || (file_version != version))
+			{
+				throw RSSoft_Exception("Not a supported decoding policy file");
+			}
+
+			header_seen = true;
+		}
+		else
+		{
+			RS_PolicyEntry entry;
+			std::istringstream snr_stream(first_word);
+
+			if (!(snr_stream >> entry.snr_dB) || !(line_stream >> entry.global_multiplicity >> entry.nb_iterations_max))
+			{
+				throw RSSoft_Exception("Invalid decoding policy line: " + line);
+			}
+
+			add_entry(entry);
+		}
+	}
+
+	if (entries.size() == 0)
+	{
+		throw RSSoft_Exception("Decoding policy has no entries");
+	}
+}
+
+// ================================================================================================
+void RS_DecodingPolicy::save(const std::string& filename) const
+{
+	std::ofstream policy_file(filename.c_str());
+
+	if (!policy_file.is_open())
+	{
+		throw RSSoft_Exception("Cannot create policy file " + filename);
+	}
+
+	save(policy_file);
+}
+
+// ================================================================================================
+void RS_DecodingPolicy::save(std::ostream& os) const
+{
+	std::vector<RS_PolicyEntry>::const_iterator e_it = entries.begin();
+
+	os << "rssoft-policy " << version << std::endl;
+	os << "# snr_dB global_multiplicity nb_iterations_max" << std::endl;
+
+	for (; e_it != entries.end(); ++e_it)
+	{
+		os << e_it->snr_dB << " " << e_it->global_multiplicity << " " << e_it->nb_iterations_max << std::endl;
+	}
+}
+
+// ================================================================================================
+const RS_PolicyEntry& RS_DecodingPolicy::lookup(float snr_dB) const
+{
+	if (entries.size() == 0)
+	{
+		throw RSSoft_Exception("Decoding policy has no entries");
+	}
+
+	std::vector<RS_PolicyEntry>::const_iterator e_it = std::upper_bound(entries.begin(), entries.end(), RS_PolicyEntry(snr_dB));
+
+	if (e_it == entries.begin()) // below first bucket
+	{
+		return *e_it;
+	}
+	else
+	{
+		return *(e_it-1);
+	}
+}
+
+// ================================================================================================
+float RS_DecodingPolicy::estimate_snr_dB(const RS_ReliabilityMatrix& relmat)
+{
+	double signal_sum = 0.0;
+	double noise_sum = 0.0;
+	unsigned int nb_columns = 0;
+
+	for (unsigned int ic = 0; ic < relmat.get_message_length(); ic++)
+	{
+		float col_max = 0.0;
+		double col_sum = 0.0;
+
+		for (unsigned int ir = 0; ir < relmat.get_nb_symbols(); ir++)
+		{
+			col_sum += relmat(ir, ic);
+			col_max = (relmat(ir, ic) > col_max ? relmat(ir, ic) : col_max);
+		}
+
+		if (col_sum != 0.0) // not erased
+		{
+			signal_sum += col_max;
+			noise_sum += col_sum - col_max;
+			nb_columns++;
+		}
+	}
+
+	if ((nb_columns == 0) || (relmat.get_nb_symbols() < 2))
+	{
+		throw RSSoft_Exception("Cannot estimate SNR without non erased symbols");
+	}
+
+	double noise = noise_sum / (nb_columns*(relmat.get_nb_symbols()-1));
+	double signal = signal_sum / nb_columns - noise;
+
+	if (noise <= 0.0) // noiseless
+	{
+		return 99.0;
+	}
+	else if (signal <= noise*1e-6) // nothing but noise
+	{
+		return -30.0;
+	}
+	else
+	{
+		return 5.0 * log10(signal / noise); // power AWGN standard deviation is 10^(-SNR/10)
+	}
+}
+
+} // namespace rssoft
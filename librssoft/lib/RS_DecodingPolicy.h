@@ -0,0 +1,143 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Decoding policy: parameters of the multiplicity schedule by SNR bucket.
+
+ A policy is produced offline by the RS_Tuner tool which sweeps the
+ parameters on synthetic frames and keeps for each SNR the cheapest set
+ that meets a target frame error rate. Decoders load it at startup and
+ look up the parameters of each frame from an SNR estimate made on the
+ raw power reliability matrix.
+
+ File format is plain text. Lines starting with # are comments. The
+ first other line is "rssoft-policy <version>" and each following line
+ is one bucket: "<snr_dB> <global_multiplicity> <nb_iterations_max>".
+ A bucket applies from its SNR up to the SNR of the next bucket.
+
+ */
+#ifndef __RS_DECODING_POLICY_H__
+#define __RS_DECODING_POLICY_H__
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace rssoft
+{
+
+class RS_ReliabilityMatrix;
+
+/**
+ * \brief Decoding parameters of one SNR bucket
+ */
+struct RS_PolicyEntry
+{
+	RS_PolicyEntry(float _snr_dB = 0.0, unsigned int _global_multiplicity = 1, unsigned int _nb_iterations_max = 1) :
+		snr_dB(_snr_dB),
+		global_multiplicity(_global_multiplicity),
+		nb_iterations_max(_nb_iterations_max)
+	{}
+
+	bool operator<(const RS_PolicyEntry& other) const
+	{
+		return snr_dB < other.snr_dB;
+	}
+
+	float snr_dB;                     //!< Lower SNR bound of the bucket
+	unsigned int global_multiplicity; //!< Global multiplicity at first iteration
+	unsigned int nb_iterations_max;   //!< Maximum number of multiplicity iterations
+};
+
+/**
+ * \brief Decoding parameters by SNR bucket
+ */
+class RS_DecodingPolicy
+{
+public:
+	static const unsigned int version = 1; //!< File format version
+
+	/**
+	 * Constructs an empty policy
+	 */
+	RS_DecodingPolicy();
+
+	/**
+	 * Destructor
+	 */
+	~RS_DecodingPolicy();
+
+	/**
+	 * Add or replace the bucket starting at the entry SNR
+	 */
+	void add_entry(const RS_PolicyEntry& entry);
+
+	/**
+	 * Read policy from a file. Replaces current entries.
+	 * \param filename Path of the policy file
+	 */
+	void load(const std::string& filename);
+
+	/**
+	 * Read policy from a stream. Replaces current entries.
+	 */
+	void load(std::istream& is);
+
+	/**
+	 * Write policy to a file
+	 * \param filename Path of the policy file
+	 */
+	void save(const std::string& filename) const;
+
+	/**
+	 * Write policy to a stream
+	 */
+	void save(std::ostream& os) const;
+
+	/**
+	 * Get the parameters for a frame. Frames below the first bucket use the first bucket.
+	 * \param snr_dB SNR estimate of the frame
+	 */
+	const RS_PolicyEntry& lookup(float snr_dB) const;
+
+	/**
+	 * Get all buckets in increasing SNR order
+	 */
+	const std::vector<RS_PolicyEntry>& get_entries() const
+	{
+		return entries;
+	}
+
+	/**
+	 * Estimate the SNR of a frame from its reliability matrix before normalization. Entries are expected to be
+	 * powers of the symbols amplitudes with unit amplitude on the sent symbol and AWGN of standard deviation
+	 * 10^(-SNR/10) on every symbol (the channel model of the test programs). The largest power of each column is
+	 * taken as signal plus noise and the others as noise only. Erased columns are ignored.
+	 * \param relmat Power reliability matrix (not normalized)
+	 * \return SNR estimate in dB
+	 */
+	static float estimate_snr_dB(const RS_ReliabilityMatrix& relmat);
+
+protected:
+	std::vector<RS_PolicyEntry> entries; //!< Buckets sorted by increasing SNR
+};
+
+} // namespace rssoft
+
+#endif // __RS_DECODING_POLICY_H__
@@ -34,7 +34,15 @@ RS_Encoding::RS_Encoding(const gf::GFq& _gf, unsigned int _k, const EvaluationVa
 	gf(_gf),
 	k(_k),
 	evaluation_values(_evaluation_values)
-{}
+{
+	const std::vector<gf::GFq_Element>& evaluation_points = evaluation_values.get_evaluation_points();
+	std::vector<gf::GFq_Element>::const_iterator evp_it = evaluation_points.begin();
+
+	for (; evp_it != evaluation_points.end(); ++evp_it)
+	{
+		evaluation_symbols.push_back(evp_it->poly());
+	}
+}
 
 // ================================================================================================
 RS_Encoding::~RS_Encoding()
@@ -43,29 +51,65 @@ RS_Encoding::~RS_Encoding()
 // ================================================================================================
 void RS_Encoding::run(const std::vector<gf::GFq_Symbol>& message, std::vector<gf::GFq_Symbol>& codeword) const
 {
-	if (message.size() != k)
+	if ((message.size() != k) || (k == 0))
 	{
 		throw RSSoft_Exception("Invalid message length");
 	}
 	else
 	{
-		std::vector<gf::GFq_Symbol>::const_iterator s_it = message.begin();
-		std::vector<gf::GFq_Element> encoding_coefficients;
+		codeword.resize(evaluation_symbols.size());
+		encode(&message[0], &codeword[0], 1, 1);
+	}
+}
 
-		for(; s_it != message.end(); ++s_it)
+// ================================================================================================
+void RS_Encoding::run(const uint8_t *message, uint8_t *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	encode(message, codeword, message_stride, codeword_stride);
+}
+
+// ================================================================================================
+void RS_Encoding::run(const uint16_t *message, uint16_t *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	encode(message, codeword, message_stride, codeword_stride);
+}
+
+// ================================================================================================
+template<typename T_Symbol>
+void RS_Encoding::encode(const T_Symbol *message, T_Symbol *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	if ((k == 0) || (message == 0) || (codeword == 0))
+	{
+		throw RSSoft_Exception("Invalid message or codeword buffer");
+	}
+
+	if (gf.pwr() > 8*sizeof(T_Symbol))
+	{
+		throw RSSoft_Exception("Field symbols do not fit in the buffer symbols");
+	}
+
+	for (unsigned int i=0; i<k; i++) // symbols index the field tables
+	{
+		if (message[i*message_stride] > gf.size())
 		{
-			encoding_coefficients.push_back(gf::GFq_Element(gf, *s_it));
+			throw RSSoft_Exception("Message symbol is not in the field");
 		}
+	}
 
-		gf::GFq_Polynomial encoding_polynomial(gf, encoding_coefficients);
-		codeword.clear();
-		const std::vector<gf::GFq_Element>& evaluation_points = evaluation_values.get_evaluation_points();
-		std::vector<gf::GFq_Element>::const_iterator evp_it = evaluation_points.begin();
+	std::vector<gf::GFq_Symbol>::const_iterator evs_it = evaluation_symbols.begin();
 
-		for (; evp_it != evaluation_points.end(); ++evp_it)
+	for (; evs_it != evaluation_symbols.end(); ++evs_it, codeword += codeword_stride)
+	{
+		const T_Symbol *message_symbol = message + (k-1)*message_stride;
+		gf::GFq_Symbol value = *message_symbol;
+
+		for (unsigned int i=1; i<k; i++) // Horner
 		{
-			codeword.push_back(encoding_polynomial(*evp_it).poly());
+			message_symbol -= message_stride;
+			value = gf.add(gf.mul(value, *evs_it), *message_symbol);
 		}
+
+		*codeword = value;
 	}
 }
 
@@ -30,6 +30,7 @@
 #include "GFq.h"
 #include "GFq_Element.h"
 #include <vector>
+#include <stdint.h>
 
 namespace rssoft
 {
@@ -64,6 +65,28 @@ public:
 	 */
 	void run(const std::vector<gf::GFq_Symbol>& message, std::vector<gf::GFq_Symbol>& codeword) const;
 
+	/**
+	 * Runs an encoding directly on caller owned buffers of packed 8 bit symbols. Strides
+	 * allow to read and write frames interleaved in the same buffers.
+	 * Throws an exception if the field symbols do not fit in 8 bits or a message symbol is not in the field.
+	 * \param message Buffer of the k message symbols
+	 * \param codeword Buffer receiving the n codeword symbols
+	 * \param message_stride Distance in symbols between two successive message symbols
+	 * \param codeword_stride Distance in symbols between two successive codeword symbols
+	 */
+	void run(const uint8_t *message, uint8_t *codeword, unsigned int message_stride = 1, unsigned int codeword_stride = 1) const;
+
+	/**
+	 * Runs an encoding directly on caller owned buffers of packed 16 bit symbols. Strides
+	 * allow to read and write frames interleaved in the same buffers.
+	 * Throws an exception if the field symbols do not fit in 16 bits or a message symbol is not in the field.
+	 * \param message Buffer of the k message symbols
+	 * \param codeword Buffer receiving the n codeword symbols
+	 * \param message_stride Distance in symbols between two successive message symbols
+	 * \param codeword_stride Distance in symbols between two successive codeword symbols
+	 */
+	void run(const uint16_t *message, uint16_t *codeword, unsigned int message_stride = 1, unsigned int codeword_stride = 1) const;
+
 	/**
 	 * Runs a systematic encoding
 	 * \param initial power of alpha
@@ -73,9 +96,16 @@ public:
 	void run_systematic(unsigned int init_pow, const std::vector<gf::GFq_Symbol>& message, std::vector<gf::GFq_Symbol>& codeword) const;
 
 protected:
+	/**
+	 * Evaluates the message polynomial at the evaluation points with symbol arithmetic
+	 */
+	template<typename T_Symbol>
+	void encode(const T_Symbol *message, T_Symbol *codeword, unsigned int message_stride, unsigned int codeword_stride) const;
+
 	const gf::GFq& gf; //!< Galois Field in use
 	unsigned int k; //!< k as in RS(n,k). n is the "size" of the Galois Field
 	const EvaluationValues& evaluation_values; //!< Evaluation X,Y values of the code
+	std::vector<gf::GFq_Symbol> evaluation_symbols; //!< Evaluation points as symbols
 };
 
 
@@ -0,0 +1,382 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Iterative soft decoding of two dimensional Reed-Solomon product codes
+
+ */
+
+#include "RS_ProductDecoder.h"
+#include "RSSoft_Exception.h"
+#include "EvaluationValues.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "GSKV_Interpolation.h"
+#include "RR_Factorization.h"
+#include "FinalEvaluation.h"
+#include "RS_BatchHardDecision.h"
+#include "RR_TaskPool.h"
+#include "GFq_MonomialArena.h"
+#include "Debug.h"
+
+#include <algorithm>
+
+namespace rssoft
+{
+
+/**
+ * \brief Decoding of one row or column run by the pool
+ */
+class RS_ProductComponentTask : public RR_Task
+{
+public:
+	RS_ProductComponentTask(RS_ProductDecoder& _decoder, bool _column, unsigned int _index) :
+		decoder(_decoder),
+		column(_column),
+		index(_index)
+	{}
+
+	virtual void run(unsigned int worker_index)
+	{
+		decoder.decode_component(worker_index, column, index);
+	}
+
+protected:
+	RS_ProductDecoder& decoder;
+	bool column;
+	unsigned int index;
+};
+
+// ================================================================================================
+RS_ProductDecoder::RS_ProductDecoder(const gf::GFq& _gf,
+		unsigned int _row_k, const EvaluationValues& _row_evaluation_values,
+		unsigned int _col_k, const EvaluationValues& _col_evaluation_values,
+		unsigned int nb_workers) :
+	gf(_gf),
+	row_k(_row_k),
+	col_k(_col_k),
+	row_evaluation_values(_row_evaluation_values),
+	col_evaluation_values(_col_evaluation_values),
+	nb_rows(_col_evaluation_values.get_evaluation_points().size()),
+	nb_columns(_row_evaluation_values.get_evaluation_points().size()),
+	nb_symbols(_gf.size()+1),
+	global_multiplicity(3),
+	nb_multiplicity_iterations_max(1),
+	nb_iterations_max(4),
+	decision_weight(0.5),
+	task_pool(0),
+	symbol_rows(_gf.size()+1, 0),
+	nb_iterations(0),
+	nb_component_decodes(0),
+	nb_component_skips(0)
+{
+	const std::vector<gf::GFq_Element>& row_y_values = row_evaluation_values.get_y_values();
+	const std::vector<gf::GFq_Element>& col_y_values = col_evaluation_values.get_y_values();
+
+	if ((row_y_values.size() != nb_symbols) || (col_y_values.size() != nb_symbols))
+	{
+		throw RSSoft_Exception("Product code components must map all symbols to reliability matrix rows");
+	}
+
+	for (unsigned int i = 0; i < nb_symbols; i++)
+	{
+		if (row_y_values[i] != col_y_values[i])
+		{
+			throw RSSoft_Exception("Product code components must use the same symbols order");
+		}
+
+		row_symbols.push_back(row_y_values[i].poly());
+		symbol_rows[row_y_values[i].poly()] = i;
+	}
+
+	task_pool = new RR_TaskPool(nb_workers > 0 ? nb_workers : 1);
+	workers.resize(task_pool->get_nb_workers());
+
+	std::vector<Worker>::iterator w_it = workers.begin();
+
+	for (; w_it != workers.end(); ++w_it)
+	{
+		create_component(w_it->row, row_k, row_evaluation_values);
+		create_component(w_it->col, col_k, col_evaluation_values);
+		w_it->relmat_data.resize(nb_symbols*(nb_rows > nb_columns ? nb_rows : nb_columns));
+		w_it->codeword.resize(nb_rows > nb_columns ? nb_rows : nb_columns);
+	}
+}
+
+// ================================================================================================
+RS_ProductDecoder::~RS_ProductDecoder()
+{
+	delete task_pool;
+
+	std::vector<Worker>::iterator w_it = workers.begin();
+
+	for (; w_it != workers.end(); ++w_it)
+	{
+		delete_component(w_it->row);
+		delete_component(w_it->col);
+	}
+}
+
+// ================================================================================================
+void RS_ProductDecoder::create_component(Component& component, unsigned int k, const EvaluationValues& evaluation_values)
+{
+	component.gskv = new GSKV_Interpolation(gf, k, evaluation_values);
+	component.rr = new RR_Factorization(gf, k);
+	component.final_evaluation = new FinalEvaluation(gf, k, evaluation_values);
+	component.hard_decision = new RS_BatchHardDecision(gf, k, evaluation_values);
+}
+
+// ================================================================================================
+void RS_ProductDecoder::delete_component(Component& component)
+{
+	delete component.gskv;
+	delete component.rr;
+	delete component.final_evaluation;
+	delete component.hard_decision;
+}
+
+// ================================================================================================
+bool RS_ProductDecoder::run(const float *channel, gf::GFq_Symbol *symbols)
+{
+	unsigned int nb_positions = nb_rows*nb_columns;
+	std::vector<unsigned char> row_dirty(nb_rows, 1);
+	std::vector<unsigned char> col_dirty(nb_columns, 1);
+	std::vector<int> previous_decisions;
+	bool converged = false;
+
+	channel_relmat.assign(channel, channel + nb_positions*nb_symbols);
+	RS_ReliabilityMatrix channel_matrix(gf.pwr(), nb_positions, &channel_relmat[0]); // all rows seen as one long message
+	channel_matrix.normalize();
+	row_decisions.assign(nb_positions, -1);
+	col_decisions.assign(nb_positions, -1);
+	nb_iterations = 0;
+	nb_component_decodes = 0;
+	nb_component_skips = 0;
+
+	while ((nb_iterations < nb_iterations_max) && !converged)
+	{
+		nb_iterations++;
+
+		// rows: a column is decoded again when a row decision changed to a symbol it does not agree with
+		previous_decisions = row_decisions;
+		nb_component_decodes += decode_phase(false, row_dirty);
+
+		for (unsigned int i = 0; i < nb_positions; i++)
+		{
+			if ((row_decisions[i] != previous_decisions[i]) && (row_decisions[i] != col_decisions[i]))
+			{
+				col_dirty[i % nb_columns] = 1;
+			}
+		}
+
+		// columns: same the other way round
+		previous_decisions = col_decisions;
+		nb_component_decodes += decode_phase(true, col_dirty);
+
+		for (unsigned int i = 0; i < nb_positions; i++)
+		{
+			if ((col_decisions[i] != previous_decisions[i]) && (col_decisions[i] != row_decisions[i]))
+			{
+				row_dirty[i / nb_columns] = 1;
+			}
+		}
+
+		converged = true;
+
+		for (unsigned int i = 0; (i < nb_positions) && converged; i++)
+		{
+			converged = (row_decisions[i] >= 0) && (row_decisions[i] == col_decisions[i]);
+		}
+
+		if (!converged)
+		{
+			bool stalled = true;
+
+			for (unsigned int r = 0; (r < nb_rows) && stalled; r++)
+			{
+				stalled = (row_dirty[r] == 0);
+			}
+
+			if (stalled) // nothing new to feed the row decoders
+			{
+				break;
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < nb_positions; i++)
+	{
+		if (col_decisions[i] >= 0) // columns were decoded last
+		{
+			symbols[i] = col_decisions[i];
+		}
+		else if (row_decisions[i] >= 0)
+		{
+			symbols[i] = row_decisions[i];
+		}
+		else
+		{
+			unsigned int i_row;
+			unsigned int best_row = 0;
+
+			for (i_row = 1; i_row < nb_symbols; i_row++)
+			{
+				if (channel_relmat[i*nb_symbols + i_row] > channel_relmat[i*nb_symbols + best_row])
+				{
+					best_row = i_row;
+				}
+			}
+
+			symbols[i] = row_symbols[best_row];
+		}
+	}
+
+	return converged;
+}
+
+// ================================================================================================
+unsigned int RS_ProductDecoder::decode_phase(bool column, std::vector<unsigned char>& dirty)
+{
+	std::vector<RS_ProductComponentTask> tasks;
+	std::vector<RR_Task*> task_pointers;
+
+	tasks.reserve(dirty.size());
+
+	for (unsigned int i = 0; i < dirty.size(); i++)
+	{
+		if (dirty[i])
+		{
+			tasks.push_back(RS_ProductComponentTask(*this, column, i));
+			dirty[i] = 0;
+		}
+		else
+		{
+			nb_component_skips++;
+		}
+	}
+
+	for (unsigned int i = 0; i < tasks.size(); i++)
+	{
+		task_pointers.push_back(&tasks[i]);
+	}
+
+	if (task_pointers.size() > 0)
+	{
+		task_pool->run(task_pointers);
+	}
+
+	return tasks.size();
+}
+
+// ================================================================================================
+void RS_ProductDecoder::decode_component(unsigned int worker_index, bool column, unsigned int index)
+{
+	Worker& worker = workers[worker_index];
+	Component& component = (column ? worker.col : worker.row);
+	unsigned int n = (column ? nb_rows : nb_columns);
+	std::vector<int>& decisions = (column ? col_decisions : row_decisions);
+	const std::vector<int>& other_decisions = (column ? row_decisions : col_decisions);
+	RS_ReliabilityMatrix relmat(gf.pwr(), n, &worker.relmat_data[0]);
+	std::vector<bool> valid;
+	bool decoded = false;
+
+	// channel reliability mixed with the decisions of the other dimension
+	for (unsigned int j = 0; j < n; j++)
+	{
+		unsigned int pos = (column ? position(j, index) : position(index, j));
+		const float *channel_column = &channel_relmat[pos*nb_symbols];
+		float *relmat_column = &worker.relmat_data[j*nb_symbols];
+		unsigned int best_row = 0;
+
+		for (unsigned int i_row = 0; i_row < nb_symbols; i_row++)
+		{
+			relmat_column[i_row] = channel_column[i_row];
+		}
+
+		if (other_decisions[pos] >= 0)
+		{
+			for (unsigned int i_row = 0; i_row < nb_symbols; i_row++)
+			{
+				relmat_column[i_row] *= (1.0 - decision_weight);
+			}
+
+			relmat_column[symbol_rows[other_decisions[pos]]] += decision_weight;
+		}
+
+		for (unsigned int i_row = 1; i_row < nb_symbols; i_row++)
+		{
+			if (relmat_column[i_row] > relmat_column[best_row])
+			{
+				best_row = i_row;
+			}
+		}
+
+		worker.codeword[j] = row_symbols[best_row];
+	}
+
+	relmat.normalize(); // channel erasures get a decision only
+
+	try
+	{
+		if (component.hard_decision->check(&worker.codeword[0], valid, 1) > 0) // hard decision is already a codeword
+		{
+			decoded = true;
+		}
+		else
+		{
+			unsigned int multiplicity = global_multiplicity;
+			gf::GFq_MonomialArenaScope monomial_arena;
+
+			for (unsigned int ni = 1; (ni <= nb_multiplicity_iterations_max) && !decoded; ni++, multiplicity++)
+			{
+				MultiplicityMatrix mat_M(relmat, multiplicity);
+				component.gskv->init();
+				component.rr->init();
+
+				const gf::GFq_BivariatePolynomial& Q = component.gskv->run(mat_M);
+
+				if (!Q.is_in_X())
+				{
+					std::vector<gf::GFq_Polynomial>& res_polys = component.rr->run(Q);
+
+					if (res_polys.size() > 0)
+					{
+						component.final_evaluation->init();
+						component.final_evaluation->run(res_polys, relmat);
+						const std::vector<gf::GFq_Symbol>& best_codeword = component.final_evaluation->get_best_codeword();
+						std::copy(best_codeword.begin(), best_codeword.begin() + n, worker.codeword.begin());
+						decoded = true;
+					}
+				}
+			}
+		}
+	}
+	catch (std::exception& e) // includes allocation failures: nothing may escape the worker thread
+	{
+		DEBUG_OUT(true, "RS_ProductDecoder: " << (column ? "column " : "row ") << index << ": " << e.what() << std::endl);
+	}
+
+	for (unsigned int j = 0; j < n; j++)
+	{
+		unsigned int pos = (column ? position(j, index) : position(index, j));
+		decisions[pos] = (decoded ? (int) worker.codeword[j] : -1);
+	}
+}
+
+} // namespace rssoft
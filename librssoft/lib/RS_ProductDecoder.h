@@ -0,0 +1,243 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Iterative soft decoding of two dimensional Reed-Solomon product codes.
+
+	 The codeword is an array of n_col rows by n_row columns of symbols where
+	 each row is a codeword of the row code and each column a codeword of the
+	 column code. Rows and columns are decoded alternately with the usual
+	 interpolation, factorization and final evaluation pipeline. Each phase
+	 runs its component codes in parallel on a pool of workers each holding
+	 its own decoding objects.
+
+	 Soft information is exchanged through the reliability matrices: the
+	 reliability of a symbol position seen by a column decoder is the channel
+	 reliability mixed with the decision of the row decoder at that position
+	 and vice versa. A component code is decoded again only when a decision
+	 of the other dimension changed on one of its positions to a symbol it
+	 does not agree with. Iterations stop when row and column decisions agree everywhere
+	 or when nothing is left to decode.
+
+ */
+#ifndef __RS_PRODUCT_DECODER_H__
+#define __RS_PRODUCT_DECODER_H__
+
+#include "GFq.h"
+#include <vector>
+
+namespace rssoft
+{
+
+class EvaluationValues;
+class GSKV_Interpolation;
+class RR_Factorization;
+class FinalEvaluation;
+class RS_BatchHardDecision;
+class RR_TaskPool;
+
+/**
+ * \brief Iterative row and column soft decoder of RS product codes
+ */
+class RS_ProductDecoder
+{
+public:
+	/**
+	 * Constructor
+	 * \param _gf Reference to the Galois Field being used. Both component codes use the same field.
+	 * \param _row_k k of the code of the rows
+	 * \param _row_evaluation_values Evaluation X,Y values of the code of the rows. Its number of points is the number of columns.
+	 * \param _col_k k of the code of the columns
+	 * \param _col_evaluation_values Evaluation X,Y values of the code of the columns. Its number of points is the number of rows.
+	 * \param nb_workers Number of workers decoding component codes in parallel including the calling thread
+	 */
+	RS_ProductDecoder(const gf::GFq& _gf,
+			unsigned int _row_k, const EvaluationValues& _row_evaluation_values,
+			unsigned int _col_k, const EvaluationValues& _col_evaluation_values,
+			unsigned int nb_workers = 1);
+
+	/**
+	 * Destructor
+	 */
+	~RS_ProductDecoder();
+
+	/**
+	 * Set multiplicity iterations parameters of the component decodings
+	 * \param _global_multiplicity Global multiplicity at first iteration. It is incremented at each iteration.
+	 * \param _nb_multiplicity_iterations_max Maximum number of multiplicity iterations
+	 */
+	void set_multiplicity(unsigned int _global_multiplicity, unsigned int _nb_multiplicity_iterations_max)
+	{
+		global_multiplicity = _global_multiplicity;
+		nb_multiplicity_iterations_max = _nb_multiplicity_iterations_max;
+	}
+
+	/**
+	 * Set the maximum number of row and column iterations
+	 */
+	void set_nb_iterations_max(unsigned int _nb_iterations_max)
+	{
+		nb_iterations_max = _nb_iterations_max;
+	}
+
+	/**
+	 * Set the weight given to the decision of the other dimension when it is mixed with the channel reliability
+	 * \param _decision_weight Weight between 0 (decisions are ignored) and 1 (decisions replace the channel data)
+	 */
+	void set_decision_weight(float _decision_weight)
+	{
+		decision_weight = _decision_weight;
+	}
+
+	/**
+	 * Decode a product codeword
+	 * \param channel Channel reliability data. Row r of the product codeword comes first at offset r*2^m*n_row as
+	 * a reliability matrix of the row code stored column first. Data is normalized internally.
+	 * \param symbols Receives the n_col*n_row decoded symbols row after row. Positions where no component decoding
+	 * succeeded are given the channel hard decision.
+	 * \return true if row and column decisions agree on all positions
+	 */
+	bool run(const float *channel, gf::GFq_Symbol *symbols);
+
+	/**
+	 * Number of rows of the product codeword i.e. n of the code of the columns
+	 */
+	unsigned int get_nb_rows() const
+	{
+		return nb_rows;
+	}
+
+	/**
+	 * Number of columns of the product codeword i.e. n of the code of the rows
+	 */
+	unsigned int get_nb_columns() const
+	{
+		return nb_columns;
+	}
+
+	/**
+	 * Number of row and column iterations of the last run
+	 */
+	unsigned int get_nb_iterations() const
+	{
+		return nb_iterations;
+	}
+
+	/**
+	 * Number of component codes decoded in the last run
+	 */
+	unsigned int get_nb_component_decodes() const
+	{
+		return nb_component_decodes;
+	}
+
+	/**
+	 * Number of component codes skipped in the last run because none of their positions changed
+	 */
+	unsigned int get_nb_component_skips() const
+	{
+		return nb_component_skips;
+	}
+
+	/**
+	 * Decode one row or column. Called by the pool workers.
+	 * \param worker_index Index of the worker whose decoding objects are used
+	 * \param column true to decode a column, false to decode a row
+	 * \param index Index of the row or column
+	 */
+	void decode_component(unsigned int worker_index, bool column, unsigned int index);
+
+protected:
+	/**
+	 * \brief Decoding objects of one component code
+	 */
+	struct Component
+	{
+		GSKV_Interpolation *gskv;
+		RR_Factorization *rr;
+		FinalEvaluation *final_evaluation;
+		RS_BatchHardDecision *hard_decision;
+	};
+
+	/**
+	 * \brief Decoding objects owned by one worker
+	 */
+	struct Worker
+	{
+		Component row;
+		Component col;
+		std::vector<float> relmat_data; //!< Reliability matrix of the component being decoded
+		std::vector<gf::GFq_Symbol> codeword; //!< Hard decision of the component being decoded
+	};
+
+	/**
+	 * Create the decoding objects of a component code
+	 */
+	void create_component(Component& component, unsigned int k, const EvaluationValues& evaluation_values);
+
+	/**
+	 * Delete the decoding objects of a component code
+	 */
+	void delete_component(Component& component);
+
+	/**
+	 * Run the pool on the components whose dirty flag is set then clear these flags
+	 * \return Number of components decoded
+	 */
+	unsigned int decode_phase(bool column, std::vector<unsigned char>& dirty);
+
+	/**
+	 * Offset of the symbol position at row r and column c in decision arrays
+	 */
+	unsigned int position(unsigned int r, unsigned int c) const
+	{
+		return r*nb_columns + c;
+	}
+
+	const gf::GFq& gf; //!< Galois Field in use
+	unsigned int row_k; //!< k of the code of the rows
+	unsigned int col_k; //!< k of the code of the columns
+	const EvaluationValues& row_evaluation_values; //!< Evaluation X,Y values of the code of the rows
+	const EvaluationValues& col_evaluation_values; //!< Evaluation X,Y values of the code of the columns
+	unsigned int nb_rows; //!< Number of rows (n of the code of the columns)
+	unsigned int nb_columns; //!< Number of columns (n of the code of the rows)
+	unsigned int nb_symbols; //!< Number of reliability matrix rows (2^m)
+	unsigned int global_multiplicity; //!< Global multiplicity at first multiplicity iteration
+	unsigned int nb_multiplicity_iterations_max; //!< Maximum number of multiplicity iterations
+	unsigned int nb_iterations_max; //!< Maximum number of row and column iterations
+	float decision_weight; //!< Weight of the decision of the other dimension in the reliability data
+	RR_TaskPool *task_pool; //!< Pool of workers
+	std::vector<Worker> workers; //!< Decoding objects by worker
+	std::vector<gf::GFq_Symbol> row_symbols; //!< Symbol of each reliability matrix row
+	std::vector<unsigned int> symbol_rows; //!< Reliability matrix row of each symbol
+	std::vector<float> channel_relmat; //!< Normalized channel reliability data in the layout of the input
+	std::vector<int> row_decisions; //!< Symbols decided by the row decoders or -1
+	std::vector<int> col_decisions; //!< Symbols decided by the column decoders or -1
+	unsigned int nb_iterations; //!< Row and column iterations of the last run
+	unsigned int nb_component_decodes; //!< Component codes decoded in the last run
+	unsigned int nb_component_skips; //!< Component codes skipped in the last run
+
+private:
+	RS_ProductDecoder(const RS_ProductDecoder&);
+	RS_ProductDecoder& operator=(const RS_ProductDecoder&);
+};
+
+} // namespace rssoft
+
+#endif // __RS_PRODUCT_DECODER_H__
@@ -0,0 +1,127 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+ Kernels working on the columns of a reliability matrix stored column
+ first: column sums, normalization, maximum search, log2 conversion and
+ fill.
+
+ Kernels are written on 16 float blocks with the GCC vector extensions
+ and compiled once per instruction set (SSE2, AVX2, AVX-512). The set
+ matching the CPU is picked at run time the first time the kernels are
+ requested. Blocks have the same width and the same order of operations
+ whatever the instruction set so that sums and normalized values are
+ identical on all machines. Only log2 may differ in the last bit where
+ the compiler contracts multiply-adds.
+
+ */
+#ifndef __RS_RELIABILITY_KERNELS_H__
+#define __RS_RELIABILITY_KERNELS_H__
+
+namespace rssoft
+{
+
+/**
+ * \brief Table of reliability matrix kernels compiled for one instruction set
+ */
+struct RS_ReliabilityKernels
+{
+	typedef enum
+	{
+		RS_Kernels_Generic = 0, //!< Compiler default target
+		RS_Kernels_SSE2,        //!< x86 SSE2
+		RS_Kernels_AVX2,        //!< x86 AVX2
+		RS_Kernels_AVX512,      //!< x86 AVX-512F
+		RS_Kernels_NbSets       //!< Number of instruction sets
+	} InstructionSet;
+
+	/**
+	 * Kernels for the best instruction set supported by the CPU
+	 */
+	static const RS_ReliabilityKernels& get();
+
+	/**
+	 * Kernels for a given instruction set
+	 * \param instruction_set Instruction set
+	 * \return 0 if the library was not built for it or the CPU does not support it
+	 */
+	static const RS_ReliabilityKernels *get(InstructionSet instruction_set);
+
+	/**
+	 * Indexes of the k largest values of a column in decreasing order of value. Ties are ordered by increasing index.
+	 * Values not greater than zero are not considered.
+	 * \param column Pointer to the column values
+	 * \param nb_rows Number of values in the column
+	 * \param k Number of values to retrieve
+	 * \param rows Receives up to k row indexes
+	 * \return Number of row indexes stored in rows
+	 */
+	unsigned int top_k(const float *column, unsigned int nb_rows, unsigned int k, unsigned int *rows) const;
+
+	InstructionSet instruction_set; //!< Instruction set the kernels were compiled for
+	const char *name;               //!< Name of the instruction set
+
+	/**
+	 * Sum of each column
+	 * \param matrix Matrix stored column first
+	 * \param nb_rows Number of rows
+	 * \param nb_cols Number of columns
+	 * \param sums Receives the nb_cols sums
+	 */
+	void (*column_sums)(const float *matrix, unsigned int nb_rows, unsigned int nb_cols, float *sums);
+
+	/**
+	 * Divide each column by its sum. Columns summing to zero (erasures) are left unchanged.
+	 */
+	void (*normalize)(float *matrix, unsigned int nb_rows, unsigned int nb_cols);
+
+	/**
+	 * Largest of floor and the values
+	 */
+	float (*max_value)(const float *values, unsigned int nb_values, float floor);
+
+	/**
+	 * Largest of floor and the values lower than bound
+	 */
+	float (*max_value_below)(const float *values, unsigned int nb_values, float floor, float bound);
+
+	/**
+	 * Index of the first value equal to value or nb_values if there is none
+	 */
+	unsigned int (*find_first)(const float *values, unsigned int nb_values, float value);
+
+	/**
+	 * Index of the last value equal to value or nb_values if there is none
+	 */
+	unsigned int (*find_last)(const float *values, unsigned int nb_values, float value);
+
+	/**
+	 * Log2 of the values. Output may be the input.
+	 */
+	void (*log2)(const float *values, unsigned int nb_values, float *log2_values);
+
+	/**
+	 * Sets all values to value. This is used to erase columns.
+	 */
+	void (*fill)(float *values, unsigned int nb_values, float value);
+};
+
+} // namespace rssoft
+
+#endif // __RS_RELIABILITY_KERNELS_H__
@@ -22,6 +22,7 @@
  */
 
 #include "RS_ReliabilityMatrix.h"
+#include "RS_ReliabilityKernels.h"
 #include <iomanip>
 #include <cstring>
 
@@ -33,7 +34,8 @@ RS_ReliabilityMatrix::RS_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigne
 		_nb_symbols_log2(nb_symbols_log2),
 		_nb_symbols(1<<nb_symbols_log2),
 		_message_length(message_length),
-		_message_symbol_count(0)
+		_message_symbol_count(0),
+		_matrix_owner(true)
 {
 	_matrix = new float[_nb_symbols*_message_length];
 
@@ -43,12 +45,23 @@ RS_ReliabilityMatrix::RS_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigne
 	}
 }
 
+// ================================================================================================
+RS_ReliabilityMatrix::RS_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, float *external_matrix) :
+		_nb_symbols_log2(nb_symbols_log2),
+		_nb_symbols(1<<nb_symbols_log2),
+		_message_length(message_length),
+		_message_symbol_count(0),
+		_matrix(external_matrix),
+		_matrix_owner(false)
+{}
+
 // ================================================================================================
 RS_ReliabilityMatrix::RS_ReliabilityMatrix(const RS_ReliabilityMatrix& relmat) : 
 		_nb_symbols_log2(relmat.get_nb_symbols_log2()),
 		_nb_symbols(relmat.get_nb_symbols()),
 		_message_length(relmat.get_message_length()),
-		_message_symbol_count(0)
+		_message_symbol_count(0),
+		_matrix_owner(true)
 {
     _matrix = new float[_nb_symbols*_message_length];
     memcpy((void *) _matrix, (void *) relmat.get_raw_matrix(), _nb_symbols*_message_length*sizeof(float));
@@ -57,7 +70,10 @@ RS_ReliabilityMatrix::RS_ReliabilityMatrix(const RS_ReliabilityMatrix& relmat) :
 // ================================================================================================
 RS_ReliabilityMatrix::~RS_ReliabilityMatrix()
 {
-	delete[] _matrix;
+	if (_matrix_owner)
+	{
+		delete[] _matrix;
+	}
 }
 
 // ================================================================================================
@@ -84,11 +100,7 @@ void RS_ReliabilityMatrix::enter_erasure()
 {
 	if (_message_symbol_count < _message_length)
 	{
-        for (unsigned int i=0; i<_nb_symbols; i++)
-        {
-            _matrix[_message_symbol_count*_nb_symbols + i] = 0.0;
-        }
-        
+        RS_ReliabilityKernels::get().fill(&_matrix[_message_symbol_count*_nb_symbols], _nb_symbols, 0.0);
         _message_symbol_count++;
     }    
 }
@@ -98,62 +110,31 @@ void RS_ReliabilityMatrix::enter_erasure(unsigned int message_symbol_index)
 {
 	if (message_symbol_index < _message_length)
 	{
-        for (unsigned int i=0; i<_nb_symbols; i++)
-        {
-            _matrix[message_symbol_index*_nb_symbols + i] = 0.0;
-        }
+        RS_ReliabilityKernels::get().fill(&_matrix[message_symbol_index*_nb_symbols], _nb_symbols, 0.0);
     }
 }
 
 // ================================================================================================
 void RS_ReliabilityMatrix::normalize()
 {
-	float col_sum = 0;
-	float last_col_sum;
-
-	for (unsigned int ic = 0; ic < _message_length+1; ic++)
-	{
-		last_col_sum = col_sum;
-		col_sum = 0;
-
-		for (unsigned int ir = 0; ir < _nb_symbols; ir++)
-		{
-			if (ic < _message_length)
-			{
-				col_sum += _matrix[ic*_nb_symbols + ir];
-			}
-
-			if (ic > 0)
-			{
-                if (last_col_sum != 0.0)
-                {
-                    _matrix[(ic-1)*_nb_symbols + ir] /= last_col_sum;
-                }
-			}
-		}
-	}
+	RS_ReliabilityKernels::get().normalize(_matrix, _nb_symbols, _message_length);
 }
 
 // ================================================================================================
 float RS_ReliabilityMatrix::find_max(unsigned int& i_row, unsigned int& i_col) const
 {
-    float max = 0.0;
+    const RS_ReliabilityKernels& kernels = RS_ReliabilityKernels::get();
+    float max = kernels.max_value(_matrix, _nb_symbols*_message_length, 0.0);
     i_row = 0; // prevent core dump if all items are 0
     i_col = 0;
 
-    for (unsigned int ic = 0; ic < _message_length; ic++)
+    if (max > 0.0)
     {
-        for (unsigned int ir = 0; ir < _nb_symbols; ir++)
-        {
-            if (_matrix[ic*_nb_symbols + ir] > max)
-            {
-                max = _matrix[ic*_nb_symbols + ir];
-                i_row = ir;
-                i_col = ic;
-            }
-        }
+        unsigned int index = kernels.find_first(_matrix, _nb_symbols*_message_length, max);
+        i_row = index % _nb_symbols;
+        i_col = index / _nb_symbols;
     }
-    
+
     return max;
 }
 
@@ -42,6 +42,15 @@ public:
 	 * \param message_length Length of one message block to be decoded
 	 */
 	RS_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length);
+
+	/**
+	 * Constructor over caller owned storage. The matrix is not copied and the storage is not freed at destruction.
+	 * It is the caller's responsibility to keep it alive during the lifetime of this object.
+	 * \param nb_symbols_log2 Log2 of the number of symbols used (number of symbols is a power of two)
+	 * \param message_length Length of one message block to be decoded
+	 * \param external_matrix Pointer to the storage of nb_symbols*message_length floats stored column first
+	 */
+	RS_ReliabilityMatrix(unsigned int nb_symbols_log2, unsigned int message_length, float *external_matrix);
     
     /**
      * Copy Constructor
@@ -162,6 +171,7 @@ protected:
 	unsigned int _message_length;
 	unsigned int _message_symbol_count; //!< incremented each time a new message symbol data is entered
 	float *_matrix; //!< The reliability matrix stored column first
+	bool _matrix_owner; //!< True if the matrix storage was allocated by this object
 };
 
 
@@ -23,6 +23,7 @@
 #include "RS_SystematicEncoding.h"
 #include "GFq.h"
 #include "RSSoft_Exception.h"
+#include "RS_TableBundle.h"
 
 namespace rssoft
 {
@@ -34,8 +35,39 @@ RS_SystematicEncoding::RS_SystematicEncoding(const gf::GFq& _gf, unsigned int _k
 	init_power(_init_power),
 	G(_gf)
 {
-	// Construct generator polynomial
+	make_generator();
+}
+
+// ================================================================================================
+RS_SystematicEncoding::RS_SystematicEncoding(const gf::GFq& _gf, unsigned int _k, unsigned int _init_power, const RS_TableBundle& bundle) :
+	gf(_gf),
+	k(_k),
+	init_power(_init_power),
+	G(_gf)
+{
+	const gf::GFq_Symbol *bundle_symbols = bundle.find_generator(gf, k, init_power);
+
+	if (bundle_symbols)
+	{
+		std::vector<gf::GFq_Element> ge;
+		generator_symbols.assign(bundle_symbols, bundle_symbols + gf.size() - k + 1);
+
+		for (unsigned int i = 0; i < generator_symbols.size(); i++)
+		{
+			ge.push_back(gf::GFq_Element(gf, generator_symbols[i]));
+		}
+
+		G.init(ge);
+	}
+	else
+	{
+		make_generator();
+	}
+}
 
+// ================================================================================================
+void RS_SystematicEncoding::make_generator()
+{
 	// X-a^i
 	std::vector<gf::GFq_Element> xe;
 	xe.push_back(gf::GFq_Element(gf,gf.alpha(init_power)));
@@ -50,6 +82,8 @@ RS_SystematicEncoding::RS_SystematicEncoding(const gf::GFq& _gf, unsigned int _k
 		X.init(xe);
 		G *= X;
 	}
+
+	G.get_poly_symbols(generator_symbols);
 }
 
 // ================================================================================================
@@ -59,30 +93,76 @@ RS_SystematicEncoding::~RS_SystematicEncoding()
 // ================================================================================================
 void RS_SystematicEncoding::run(const std::vector<gf::GFq_Symbol>& message, std::vector<gf::GFq_Symbol>& codeword) const
 {
-	if (message.size() != k)
+	if ((message.size() != k) || (k == 0))
 	{
 		throw RSSoft_Exception("Invalid message length");
 	}
 	else
 	{
-		std::cout << "G(X) = " << G << std::endl;
-		std::vector<gf::GFq_Symbol>::const_iterator s_it = message.begin();
-		std::vector<gf::GFq_Element> encoding_coefficients;
+		codeword.resize(gf.size());
+		encode(&message[0], &codeword[0], 1, 1);
+	}
+}
+
+// ================================================================================================
+void RS_SystematicEncoding::run(const uint8_t *message, uint8_t *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	encode(message, codeword, message_stride, codeword_stride);
+}
 
-		for(; s_it != message.end(); ++s_it)
+// ================================================================================================
+void RS_SystematicEncoding::run(const uint16_t *message, uint16_t *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	encode(message, codeword, message_stride, codeword_stride);
+}
+
+// ================================================================================================
+template<typename T_Symbol>
+void RS_SystematicEncoding::encode(const T_Symbol *message, T_Symbol *codeword, unsigned int message_stride, unsigned int codeword_stride) const
+{
+	if ((k == 0) || (k >= gf.size()) || (message == 0) || (codeword == 0))
+	{
+		throw RSSoft_Exception("Invalid message or codeword buffer");
+	}
+
+	if (gf.pwr() > 8*sizeof(T_Symbol))
+	{
+		throw RSSoft_Exception("Field symbols do not fit in the buffer symbols");
+	}
+
+	for (unsigned int i=0; i<k; i++) // symbols index the field tables
+	{
+		if (message[i*message_stride] > gf.size())
 		{
-			encoding_coefficients.push_back(gf::GFq_Element(gf, *s_it));
+			throw RSSoft_Exception("Message symbol is not in the field");
 		}
+	}
 
-		gf::GFq_Polynomial encoding_polynomial(gf, encoding_coefficients);
-		gf::GFq_Polynomial X_nk(gf::GFq_Element(gf,1), gf.size() - k);
-		gf::GFq_Polynomial shifted_encoding_polynomial = X_nk*encoding_polynomial;
-		std::pair<gf::GFq_Polynomial, gf::GFq_Polynomial> Q_R = gf::div(shifted_encoding_polynomial, G);
-		gf::GFq_Polynomial codeword_polynomial = Q_R.second + shifted_encoding_polynomial;
-		codeword_polynomial.get_poly_symbols(codeword);
+	unsigned int nb_parity = gf.size() - k;
+
+	// remainder of X^(n-k)*m(X) divided by G(X) in the parity positions of the codeword
+	for (unsigned int j=0; j<nb_parity; j++)
+	{
+		codeword[j*codeword_stride] = 0;
 	}
-}
 
+	for (int i=k-1; i>=0; i--)
+	{
+		gf::GFq_Symbol feedback = gf.add(message[i*message_stride], codeword[(nb_parity-1)*codeword_stride]);
+
+		for (unsigned int j=nb_parity-1; j>0; j--)
+		{
+			codeword[j*codeword_stride] = gf.add(codeword[(j-1)*codeword_stride], gf.mul(feedback, generator_symbols[j]));
+		}
+
+		codeword[0] = gf.mul(feedback, generator_symbols[0]);
+	}
+
+	for (unsigned int i=0; i<k; i++)
+	{
+		codeword[(nb_parity+i)*codeword_stride] = message[i*message_stride];
+	}
+}
 
 // ================================================================================================
 /*
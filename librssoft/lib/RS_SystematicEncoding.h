@@ -31,10 +31,13 @@
 #include "GFq_Element.h"
 #include "GFq_Polynomial.h"
 #include <vector>
+#include <stdint.h>
 
 namespace rssoft
 {
 
+class RS_TableBundle;
+
 /**
  * \brief Does the Reed-Solomon systematic encoding of a message. his is the genuine, straightforward, non-systematic encoding that
  * takes message symbols to build the successive coefficients of the encoding polynomial. Then this polynomial is evaluated at the
@@ -51,11 +54,28 @@ public:
 	 */
 	RS_SystematicEncoding(const gf::GFq& _gf, unsigned int _k, unsigned int _init_power);
 
+	/**
+	 * Constructor taking the generator polynomial from a table bundle. It is computed if the bundle does not have it.
+	 * \param _gf Galois Field in use
+	 * \param _k k as in RS(n,k). n is the "size" of the Galois Field
+	 * \param _init_power Initial power of alpha
+	 * \param bundle Mapped table bundle
+	 */
+	RS_SystematicEncoding(const gf::GFq& _gf, unsigned int _k, unsigned int _init_power, const RS_TableBundle& bundle);
+
 	/**
 	 * Destructor. Nothing special.
 	 */
 	~RS_SystematicEncoding();
 
+	/**
+	 * Coefficients of the generator polynomial as symbols lowest degree first
+	 */
+	const std::vector<gf::GFq_Symbol>& get_generator_symbols() const
+	{
+		return generator_symbols;
+	}
+
 	/**
 	 * Runs an encoding
 	 * \param message Message symbols to be encoded
@@ -63,11 +83,47 @@ public:
 	 */
 	void run(const std::vector<gf::GFq_Symbol>& message, std::vector<gf::GFq_Symbol>& codeword) const;
 
+	/**
+	 * Runs an encoding directly on caller owned buffers of packed 8 bit symbols. The codeword has the
+	 * n-k parity symbols first followed by the k message symbols. Strides allow to read and write frames
+	 * interleaved in the same buffers.
+	 * Throws an exception if the field symbols do not fit in 8 bits or a message symbol is not in the field.
+	 * \param message Buffer of the k message symbols
+	 * \param codeword Buffer receiving the n codeword symbols
+	 * \param message_stride Distance in symbols between two successive message symbols
+	 * \param codeword_stride Distance in symbols between two successive codeword symbols
+	 */
+	void run(const uint8_t *message, uint8_t *codeword, unsigned int message_stride = 1, unsigned int codeword_stride = 1) const;
+
+	/**
+	 * Runs an encoding directly on caller owned buffers of packed 16 bit symbols. The codeword has the
+	 * n-k parity symbols first followed by the k message symbols. Strides allow to read and write frames
+	 * interleaved in the same buffers.
+	 * Throws an exception if the field symbols do not fit in 16 bits or a message symbol is not in the field.
+	 * \param message Buffer of the k message symbols
+	 * \param codeword Buffer receiving the n codeword symbols
+	 * \param message_stride Distance in symbols between two successive message symbols
+	 * \param codeword_stride Distance in symbols between two successive codeword symbols
+	 */
+	void run(const uint16_t *message, uint16_t *codeword, unsigned int message_stride = 1, unsigned int codeword_stride = 1) const;
+
 protected:
+	/**
+	 * Builds the generator polynomial as the product of the X-a^i
+	 */
+	void make_generator();
+
+	/**
+	 * Computes the parity symbols with a shift register using the generator polynomial coefficients
+	 */
+	template<typename T_Symbol>
+	void encode(const T_Symbol *message, T_Symbol *codeword, unsigned int message_stride, unsigned int codeword_stride) const;
+
 	const gf::GFq& gf; //!< Galois Field in use
 	unsigned int k; //!< k as in RS(n,k). n is the "size" of the Galois Field
 	unsigned int init_power; //!< Initial power of alpha
 	gf::GFq_Polynomial G; //!< Generator polynomial
+	std::vector<gf::GFq_Symbol> generator_symbols; //!< Coefficients of the generator polynomial as symbols
 };
 
 
@@ -0,0 +1,272 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Bundle of precomputed tables that can be mapped read only at startup
+
+ */
+
+#include "RS_TableBundle.h"
+#include "RS_SystematicEncoding.h"
+#include "RSSoft_Exception.h"
+#include "GF2_Polynomial.h"
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace rssoft
+{
+
+// ================================================================================================
+RS_TableBundle::RS_TableBundle(const std::string& path) :
+	bundle(0),
+	bundle_size(0),
+	header(0),
+	sections(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	struct stat bundle_stat;
+
+	if (fd < 0)
+	{
+		throw RSSoft_Exception("Cannot open table bundle " + path);
+	}
+
+	if ((fstat(fd, &bundle_stat) < 0) || (((size_t) bundle_stat.st_size) < sizeof(RS_TableBundleHeader)))
+	{
+		::close(fd);
+		throw RSSoft_Exception("Invalid table bundle " + path);
+	}
+
+	bundle_size = bundle_stat.st_size;
+	bundle = mmap(0, bundle_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (bundle == MAP_FAILED)
+	{
+		bundle = 0;
+		throw RSSoft_Exception("Cannot map table bundle " + path);
+	}
+
+	header = (const RS_TableBundleHeader *) bundle;
+	sections = (const RS_TableBundleSection *) (((const char *) bundle) + sizeof(RS_TableBundleHeader));
+	bool valid = (header->magic == RS_TABLE_BUNDLE_MAGIC)
+			&& (header->version == RS_TABLE_BUNDLE_VERSION)
+			&& (header->symbol_size == sizeof(gf::GFq_Symbol))
+			&& (header->bundle_size == bundle_size)
+			&& (sizeof(RS_TableBundleHeader) + ((size_t) header->nb_sections)*sizeof(RS_TableBundleSection) <= bundle_size);
+
+	for (unsigned int i = 0; valid && (i < header->nb_sections); i++)
+	{
+		valid = (sections[i].offset % sizeof(gf::GFq_Symbol) == 0)
+				&& (sections[i].offset <= bundle_size)
+				&& (((uint64_t) sections[i].nb_symbols)*sizeof(gf::GFq_Symbol) <= bundle_size - sections[i].offset)
+				&& ((sections[i].type != RS_TableBundle_Field)
+					|| ((sections[i].pwr >= RS_TABLE_BUNDLE_MIN_PWR) && (sections[i].pwr <= RS_TABLE_BUNDLE_MAX_PWR) // before sizing the tables
+						&& (sections[i].nb_symbols == gf::GFq::tables_size(sections[i].pwr))));
+	}
+
+	if (!valid)
+	{
+		munmap(bundle, bundle_size);
+		bundle = 0;
+		throw RSSoft_Exception("Invalid table bundle " + path);
+	}
+}
+
+// ================================================================================================
+RS_TableBundle::~RS_TableBundle()
+{
+	if (bundle)
+	{
+		munmap(bundle, bundle_size);
+	}
+}
+
+// ================================================================================================
+uint32_t RS_TableBundle::primitive_poly_mask(const gf::GF2_Polynomial& primitive_poly)
+{
+	uint32_t mask = 0;
+
+	for (unsigned int i = 0; (i <= primitive_poly.deg()) && (i < 32); i++)
+	{
+		if (primitive_poly[i] != 0)
+		{
+			mask |= (1U << i);
+		}
+	}
+
+	return mask;
+}
+
+// ================================================================================================
+bool RS_TableBundle::find_field(unsigned int pwr, const gf::GF2_Polynomial& primitive_poly, gf::GFq_Tables& tables) const
+{
+	uint32_t mask = primitive_poly_mask(primitive_poly);
+
+	for (unsigned int i = 0; i < header->nb_sections; i++)
+	{
+		if ((sections[i].type == RS_TableBundle_Field) && (sections[i].pwr == pwr) && (sections[i].primitive_poly == mask))
+		{
+			tables = gf::GFq::map_tables(pwr, (const gf::GFq_Symbol *) (((const char *) bundle) + sections[i].offset));
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ================================================================================================
+gf::GFq *RS_TableBundle::create_field(unsigned int pwr, const gf::GF2_Polynomial& primitive_poly) const
+{
+	gf::GFq_Tables tables;
+
+	if (find_field(pwr, primitive_poly, tables))
+	{
+		return new gf::GFq(pwr, primitive_poly, tables);
+	}
+	else
+	{
+		return new gf::GFq(pwr, primitive_poly);
+	}
+}
+
+// ================================================================================================
+const gf::GFq_Symbol *RS_TableBundle::find_generator(const gf::GFq& gf, unsigned int k, unsigned int init_power) const
+{
+	uint32_t mask = primitive_poly_mask(gf.get_primitive_poly());
+
+	for (unsigned int i = 0; i < header->nb_sections; i++)
+	{
+		if ((sections[i].type == RS_TableBundle_Generator) && (sections[i].pwr == gf.pwr()) && (sections[i].primitive_poly == mask)
+			&& (sections[i].k == k) && (sections[i].init_power == init_power) && (sections[i].nb_symbols == gf.size() - k + 1))
+		{
+			return (const gf::GFq_Symbol *) (((const char *) bundle) + sections[i].offset);
+		}
+	}
+
+	return 0;
+}
+
+// ================================================================================================
+RS_TableBundleWriter::RS_TableBundleWriter()
+{}
+
+// ================================================================================================
+RS_TableBundleWriter::~RS_TableBundleWriter()
+{}
+
+// ================================================================================================
+void RS_TableBundleWriter::add_field(const gf::GFq& gf)
+{
+	if ((gf.pwr() < RS_TABLE_BUNDLE_MIN_PWR) || (gf.pwr() > RS_TABLE_BUNDLE_MAX_PWR))
+	{
+		throw RSSoft_Exception("Field size not supported by table bundles");
+	}
+
+	RS_TableBundleSection section;
+	memset(&section, 0, sizeof(section));
+	section.type = RS_TableBundle_Field;
+	section.pwr = gf.pwr();
+	section.primitive_poly = RS_TableBundle::primitive_poly_mask(gf.get_primitive_poly());
+	section.nb_symbols = gf::GFq::tables_size(gf.pwr());
+
+	section_data.push_back(std::vector<gf::GFq_Symbol>());
+	gf.get_tables(section_data.back());
+	sections.push_back(section);
+}
+
+// ================================================================================================
+void RS_TableBundleWriter::add_generator(const gf::GFq& gf, unsigned int k, unsigned int init_power)
+{
+	RS_SystematicEncoding encoding(gf, k, init_power);
+	RS_TableBundleSection section;
+	memset(&section, 0, sizeof(section));
+	section.type = RS_TableBundle_Generator;
+	section.pwr = gf.pwr();
+	section.primitive_poly = RS_TableBundle::primitive_poly_mask(gf.get_primitive_poly());
+	section.k = k;
+	section.init_power = init_power;
+
+	section_data.push_back(encoding.get_generator_symbols());
+	section.nb_symbols = section_data.back().size();
+	sections.push_back(section);
+}
+
+// ================================================================================================
+void RS_TableBundleWriter::write(const std::string& path) const
+{
+	RS_TableBundleHeader header;
+	std::vector<RS_TableBundleSection> directory(sections);
+	uint64_t offset = sizeof(RS_TableBundleHeader) + directory.size()*sizeof(RS_TableBundleSection);
+
+	for (unsigned int i = 0; i < directory.size(); i++)
+	{
+		offset = (offset + RS_TABLE_BUNDLE_PAGE_SIZE - 1) & ~((uint64_t) RS_TABLE_BUNDLE_PAGE_SIZE - 1);
+		directory[i].offset = offset;
+		offset += ((uint64_t) directory[i].nb_symbols)*sizeof(gf::GFq_Symbol);
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic = RS_TABLE_BUNDLE_MAGIC;
+	header.version = RS_TABLE_BUNDLE_VERSION;
+	header.page_size = RS_TABLE_BUNDLE_PAGE_SIZE;
+	header.symbol_size = sizeof(gf::GFq_Symbol);
+	header.nb_sections = directory.size();
+	header.bundle_size = offset;
+
+	std::ostringstream os;
+	os << path << ".tmp" << getpid();
+	std::string tmp_path = os.str();
+	FILE *bundle_file = fopen(tmp_path.c_str(), "wb");
+
+	if (!bundle_file)
+	{
+		throw RSSoft_Exception("Cannot create table bundle " + tmp_path);
+	}
+
+	bool ok = (fwrite(&header, sizeof(header), 1, bundle_file) == 1);
+
+	if (ok && (directory.size() > 0))
+	{
+		ok = (fwrite(&directory[0], sizeof(RS_TableBundleSection), directory.size(), bundle_file) == directory.size());
+	}
+
+	for (unsigned int i = 0; ok && (i < directory.size()); i++)
+	{
+		ok = (fseek(bundle_file, directory[i].offset, SEEK_SET) == 0)
+				&& (fwrite(&section_data[i][0], sizeof(gf::GFq_Symbol), section_data[i].size(), bundle_file) == section_data[i].size());
+	}
+
+	ok = (fclose(bundle_file) == 0) && ok;
+
+	if (!ok || (rename(tmp_path.c_str(), path.c_str()) != 0))
+	{
+		unlink(tmp_path.c_str());
+		throw RSSoft_Exception("Cannot write table bundle " + path);
+	}
+}
+
+} // namespace rssoft
@@ -0,0 +1,201 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Bundle of precomputed tables that can be mapped read only at startup.
+
+	 A bundle holds the LUTs of Galois Fields and the generator polynomials
+	 of systematic RS codes. It is written once by the TableBundle tool. Each
+	 section starts on a page boundary so that the mapped tables are used in
+	 place and shared by all processes through the page cache:
+
+	 - header (RS_TableBundleHeader)
+	 - directory of nb_sections RS_TableBundleSection
+	 - page aligned sections of nb_symbols GFq_Symbol
+
+	 Field sections contain the flat LUTs as given by GFq::get_tables. Fields
+	 are identified by m and the bit mask of their primitive polynomial.
+
+ */
+#ifndef __RS_TABLE_BUNDLE_H__
+#define __RS_TABLE_BUNDLE_H__
+
+#include "GFq.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace rssoft
+{
+
+static const uint32_t RS_TABLE_BUNDLE_MAGIC = 0x52535442;  //!< "RSTB" marks a valid bundle
+static const uint32_t RS_TABLE_BUNDLE_VERSION = 1;         //!< Layout version
+static const uint32_t RS_TABLE_BUNDLE_PAGE_SIZE = 4096;    //!< Alignment of sections
+static const uint32_t RS_TABLE_BUNDLE_MIN_PWR = 2;         //!< Smallest m of a field section
+static const uint32_t RS_TABLE_BUNDLE_MAX_PWR = 16;        //!< Largest m of a field section
+
+/**
+ * \brief Type of a bundle section
+ */
+typedef enum
+{
+	RS_TableBundle_Field = 1,    //!< LUTs of a Galois Field
+	RS_TableBundle_Generator     //!< Generator polynomial coefficients of a systematic code, lowest degree first
+} RS_TableBundleSectionType;
+
+/**
+ * \brief Header at the start of a bundle
+ */
+struct RS_TableBundleHeader
+{
+	uint32_t magic;         //!< RS_TABLE_BUNDLE_MAGIC
+	uint32_t version;       //!< RS_TABLE_BUNDLE_VERSION
+	uint32_t page_size;     //!< Alignment of sections
+	uint32_t symbol_size;   //!< Size of a symbol in bytes
+	uint32_t nb_sections;   //!< Number of entries in the directory
+	uint32_t reserved;
+	uint64_t bundle_size;   //!< Size of the bundle file
+};
+
+/**
+ * \brief Directory entry of a bundle section
+ */
+struct RS_TableBundleSection
+{
+	uint32_t type;           //!< One of RS_TableBundleSectionType
+	uint32_t pwr;            //!< m as in GF(2^m)
+	uint32_t primitive_poly; //!< Bit mask of the primitive polynomial coefficients, bit i for X^i
+	uint32_t k;              //!< k of a systematic code or 0
+	uint32_t init_power;     //!< Initial power of alpha of a systematic code or 0
+	uint32_t nb_symbols;     //!< Number of symbols in the section
+	uint64_t offset;         //!< Offset of the section from the start of the bundle
+};
+
+/**
+ * \brief Read only mapping of a table bundle
+ */
+class RS_TableBundle
+{
+public:
+	/**
+	 * Map a bundle file. Throws RSSoft_Exception if the file cannot be mapped or is not a valid bundle.
+	 * \param path Path of the bundle file
+	 */
+	RS_TableBundle(const std::string& path);
+
+	/**
+	 * Destructor. Unmaps the bundle. Objects using its tables must be destroyed first.
+	 */
+	~RS_TableBundle();
+
+	/**
+	 * Bit mask of the coefficients of a primitive polynomial as stored in the directory
+	 */
+	static uint32_t primitive_poly_mask(const gf::GF2_Polynomial& primitive_poly);
+
+	/**
+	 * Find the LUTs of a field
+	 * \param pwr m as in GF(2^m)
+	 * \param primitive_poly Primitive polynomial of the field
+	 * \param tables Receives pointers to the mapped LUTs
+	 * \return true if the field is in the bundle
+	 */
+	bool find_field(unsigned int pwr, const gf::GF2_Polynomial& primitive_poly, gf::GFq_Tables& tables) const;
+
+	/**
+	 * Create a field using the mapped LUTs if it is in the bundle or generating them if not
+	 * \param pwr m as in GF(2^m)
+	 * \param primitive_poly Primitive polynomial of the field
+	 * \return Field to be deleted by the caller before the bundle
+	 */
+	gf::GFq *create_field(unsigned int pwr, const gf::GF2_Polynomial& primitive_poly) const;
+
+	/**
+	 * Find the generator polynomial of a systematic code
+	 * \param gf Field of the code
+	 * \param k k as in RS(n,k)
+	 * \param init_power Initial power of alpha
+	 * \return Pointer to the n-k+1 coefficients lowest degree first or 0 if the code is not in the bundle
+	 */
+	const gf::GFq_Symbol *find_generator(const gf::GFq& gf, unsigned int k, unsigned int init_power) const;
+
+	/**
+	 * Directory of the bundle
+	 */
+	const RS_TableBundleSection *get_sections() const
+	{
+		return sections;
+	}
+
+	/**
+	 * Number of sections in the bundle
+	 */
+	unsigned int get_nb_sections() const
+	{
+		return header->nb_sections;
+	}
+
+protected:
+	void *bundle;                          //!< Mapped bundle
+	size_t bundle_size;                    //!< Size of the mapping
+	const RS_TableBundleHeader *header;    //!< Bundle header
+	const RS_TableBundleSection *sections; //!< Directory
+
+private:
+	RS_TableBundle(const RS_TableBundle&);
+	RS_TableBundle& operator=(const RS_TableBundle&);
+};
+
+/**
+ * \brief Builds and writes a table bundle
+ */
+class RS_TableBundleWriter
+{
+public:
+	RS_TableBundleWriter();
+	~RS_TableBundleWriter();
+
+	/**
+	 * Add the LUTs of a field
+	 */
+	void add_field(const gf::GFq& gf);
+
+	/**
+	 * Add the generator polynomial of a systematic code
+	 * \param gf Field of the code
+	 * \param k k as in RS(n,k)
+	 * \param init_power Initial power of alpha
+	 */
+	void add_generator(const gf::GFq& gf, unsigned int k, unsigned int init_power);
+
+	/**
+	 * Write the bundle. The file is written under a temporary name and renamed so that processes
+	 * mapping the previous bundle are not disturbed.
+	 * \param path Path of the bundle file
+	 */
+	void write(const std::string& path) const;
+
+protected:
+	std::vector<RS_TableBundleSection> sections;           //!< Directory with offsets not set yet
+	std::vector<std::vector<gf::GFq_Symbol> > section_data; //!< Symbols of each section
+};
+
+} // namespace rssoft
+
+#endif // __RS_TABLE_BUNDLE_H__
@@ -0,0 +1,250 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Local decoding service daemon
+
+*/
+
+#include "GFq.h"
+#include "GF_Exception.h"
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "EvaluationValues.h"
+#include "RS_DecodeService.h"
+#include "RS_DecodingPolicy.h"
+#include <iostream>
+#include <cstring>
+#include <csignal>
+#include <getopt.h>
+#include <boost/lexical_cast.hpp>
+
+static rssoft::RS_DecodeService *the_service = 0;
+
+// ================================================================================================
+// stop the service cleanly on SIGINT or SIGTERM
+extern "C" void stop_handler(int)
+{
+    if (the_service)
+    {
+        the_service->stop();
+    }
+}
+
+// ================================================================================================
+// template to extract information from getopt more easily
+template<typename TOpt, typename TField> bool extract_option(TField& field, char short_option)
+{
+    TOpt option_value;
+
+    try
+    {
+        option_value = boost::lexical_cast<TOpt>(optarg);
+        field = option_value;
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong argument for -" << short_option << ": " << optarg << " leave default (" << field << ")";
+        std::cout << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+struct Options
+{
+public:
+    Options() :
+        m(3),
+        k(5),
+        global_multiplicity(1<<3),
+        iterations(1),
+        nb_workers(2),
+        batch_size(8),
+        batch_timeout_us(200),
+        socket_path("/tmp/rssoft.sock")
+    {
+        // http://theory.cs.uvic.ca/gen/poly.html
+        rssoft::gf::GF2_Element pp_gf8[4]   = {1,1,0,1};
+        rssoft::gf::GF2_Element pp_gf16[5]  = {1,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf32[6]  = {1,0,0,1,0,1};
+        rssoft::gf::GF2_Element pp_gf64[7]  = {1,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf128[8] = {1,0,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf256[9] = {1,0,0,0,1,1,1,0,1};
+
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(4,pp_gf8));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(5,pp_gf16));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(6,pp_gf32));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(7,pp_gf64));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(8,pp_gf128));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(9,pp_gf256));
+    }
+
+    const rssoft::gf::GF2_Polynomial& get_ppoly() const
+    {
+        return ppolys[m-3];
+    }
+
+    bool get_options(int argc, char *argv[]);
+
+    unsigned int m;
+    unsigned int k;
+    unsigned int global_multiplicity;
+    unsigned int iterations; //!< Maximum number of retry iterations
+    unsigned int nb_workers; //!< Number of decoding threads
+    unsigned int batch_size; //!< Maximum number of frames in a batch
+    unsigned int batch_timeout_us; //!< Batch fill up time
+    std::string socket_path; //!< Service socket
+    std::string policy_filename; //!< Decoding policy file or empty for fixed multiplicity parameters
+private:
+    std::vector<rssoft::gf::GF2_Polynomial> ppolys;
+};
+
+// ================================================================================================
+bool Options::get_options(int argc, char *argv[])
+{
+    int c;
+    bool status = true;
+
+    while (true)
+    {
+        static struct option long_options[] =
+        {
+            {"log2-n", required_argument, 0, 'm'},
+            {"k", required_argument, 0, 'k'},
+            {"global-multiplicity", required_argument, 0, 'M'},
+            {"nb-iterations-max", required_argument, 0, 'i'},
+            {"nb-workers", required_argument, 0, 'w'},
+            {"batch-size", required_argument, 0, 'b'},
+            {"batch-timeout", required_argument, 0, 't'},
+            {"socket", required_argument, 0, 'S'},
+            {"policy", required_argument, 0, 'P'},
+            {0, 0, 0, 0}
+        };
+
+        int option_index = 0;
+        c = getopt_long (argc, argv, "m:k:M:i:w:b:t:S:P:", long_options, &option_index);
+
+        if (c == -1) // end of options
+        {
+            break;
+        }
+
+        switch(c)
+        {
+            case 'm':
+                status = extract_option<int, unsigned int>(m, 'm');
+                break;
+            case 'k':
+                status = extract_option<int, unsigned int>(k, 'k');
+                break;
+            case 'M':
+                status = extract_option<int, unsigned int>(global_multiplicity, 'M');
+                break;
+            case 'i':
+                status = extract_option<int, unsigned int>(iterations, 'i');
+                break;
+            case 'w':
+                status = extract_option<int, unsigned int>(nb_workers, 'w');
+                break;
+            case 'b':
+                status = extract_option<int, unsigned int>(batch_size, 'b');
+                break;
+            case 't':
+                status = extract_option<int, unsigned int>(batch_timeout_us, 't');
+                break;
+            case 'S':
+                socket_path = std::string(optarg);
+                break;
+            case 'P':
+                policy_filename = std::string(optarg);
+                break;
+            case '?':
+                status = false;
+                break;
+        }
+    }
+
+    if (status)
+    {
+        unsigned int n = (1<<m) - 1;
+
+        if ((m < 3) || (m > 8))
+        {
+            std::cout << "Not implemented for GF(2^" << m << ") fields" << std::endl;
+            status = false;
+        }
+        else if ((k > (n-2)) || (k < 2))
+        {
+            std::cout << "Cannot work with RS(" << n << "," << k << ")" << std::endl;
+            status = false;
+        }
+    }
+
+    return status;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    if (options.get_options(argc, argv))
+    {
+        try
+        {
+            rssoft::gf::GFq gfq(options.m, options.get_ppoly());
+            rssoft::EvaluationValues evaluation_values(gfq); // use default
+            rssoft::RS_DecodeService service(gfq, options.k, evaluation_values, options.nb_workers, options.batch_size, options.batch_timeout_us);
+            rssoft::RS_DecodingPolicy policy;
+            service.set_multiplicity(options.global_multiplicity, options.iterations);
+
+            if (options.policy_filename.size() > 0)
+            {
+                policy.load(options.policy_filename);
+                service.set_policy(&policy);
+            }
+
+            service.open(options.socket_path);
+
+            the_service = &service;
+            signal(SIGINT, stop_handler);
+            signal(SIGTERM, stop_handler);
+
+            std::cout << "Serving RS(" << (1<<options.m)-1 << "," << options.k << ") on " << options.socket_path
+                << " with " << options.nb_workers << " worker(s)" << std::endl;
+            service.run();
+            the_service = 0;
+
+            std::cout << service.get_nb_frames() << " frame(s) in " << service.get_nb_batches() << " batch(es)" << std::endl;
+        }
+        catch (std::exception& e)
+        {
+            std::cout << "Service error: " << e.what() << std::endl;
+            return -1;
+        }
+
+        return 0;
+    }
+    else
+    {
+        std::cout << "Wrong options" << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,120 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Test of the local decoding service. The service runs in a thread of this
+	 process and frames of the Part 2 document example are submitted through
+	 the client interface.
+
+*/
+
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GF_Utils.h"
+#include "EvaluationValues.h"
+#include "RS_DecodeService.h"
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <unistd.h>
+#include <pthread.h>
+
+float pwr_S[7][8] = {
+    {2.163577, 0.003943, 0.064378, 0.000117, 0.021512, 0.000038, 0.000640, 0.000002},
+    {0.459689, 0.012363, 0.011172, 0.000300, 1.580876, 0.042520, 0.038420, 0.001032},
+    {0.009034, 0.000001, 0.000245, 0.000001, 1.603912, 0.000010, 0.043565, 0.000001},
+    {0.736172, 0.838307, 0.005258, 0.005987, 0.005077, 0.005782, 0.000037, 0.000042},
+    {0.001144, 0.912521, 0.000128, 0.102537, 0.000001, 0.000312, 0.000001, 0.000036},
+    {0.000708, 0.036403, 0.026054, 1.339624, 0.000001, 0.000004, 0.000003, 0.000129},
+    {1.507900, 0.000456, 0.045338, 0.000013, 0.607732, 0.000183, 0.018272, 0.000007}
+};
+
+uint32_t expected_message[] = {7, 0, 4, 5, 0}; // as found by Decode_UnitTest with the same data and multiplicity
+
+rssoft::gf::GF2_Element ppe[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly(4,ppe);
+rssoft::gf::GFq gf8(3,ppoly);
+
+// ================================================================================================
+void *service_entry(void *arg)
+{
+    ((rssoft::RS_DecodeService *) arg)->run();
+    return 0;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    rssoft::EvaluationValues evaluation_values(gf8); // use default
+    rssoft::RS_DecodeService service(gf8, 5, evaluation_values, 2, 4, 1000);
+    std::ostringstream os;
+    os << "/tmp/rssoft_test_" << getpid() << ".sock";
+    unsigned int nb_frames = 8;
+    unsigned int nb_found = 0;
+    pthread_t service_thread;
+
+    service.set_multiplicity(12, 1);
+    service.open(os.str());
+    pthread_create(&service_thread, 0, service_entry, &service);
+
+    {
+        rssoft::RS_DecodeServiceClient client(3, 7, 5, nb_frames);
+        client.connect(os.str());
+
+        for (unsigned int slot = 0; slot < nb_frames; slot++)
+        {
+            float *slot_matrix = client.get_slot_matrix(slot);
+
+            for (unsigned int ic = 0; ic < 7; ic++)
+            {
+                memcpy(&slot_matrix[ic*8], pwr_S[ic], 8*sizeof(float)); // stored column first
+            }
+
+            client.submit(slot);
+        }
+
+        for (unsigned int i = 0; i < nb_frames; i++)
+        {
+            unsigned int slot;
+            rssoft::RS_ServiceSlotStatus status = client.wait_result(slot);
+            const uint32_t *message = client.get_slot_message(slot);
+            bool found = (status == rssoft::RS_ServiceSlot_Decoded) && (memcmp(message, expected_message, 5*sizeof(uint32_t)) == 0);
+
+            std::cout << "Slot " << slot << ": status " << status << " score " << client.get_slot_header(slot).score << " message";
+
+            for (unsigned int j = 0; j < 5; j++)
+            {
+                std::cout << " " << message[j];
+            }
+
+            std::cout << (found ? " OK" : " KO") << std::endl;
+
+            if (found)
+            {
+                nb_found++;
+            }
+        }
+    }
+
+    service.stop();
+    pthread_join(service_thread, 0);
+    std::cout << service.get_nb_frames() << " frame(s) in " << service.get_nb_batches() << " batch(es)" << std::endl;
+
+    return (nb_found == nb_frames ? 0 : 1);
+}
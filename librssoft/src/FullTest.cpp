@@ -28,12 +28,18 @@
 #include "GF_Utils.h"
 #include "EvaluationValues.h"
 #include "RS_ReliabilityMatrix.h"
+#include "RS_ChannelModel.h"
 #include "MultiplicityMatrix.h"
 #include "GSKV_Interpolation.h"
+#include "RS_DecodabilityPredictor.h"
 #include "RR_Factorization.h"
+#include "HL_Factorization.h"
 #include "FinalEvaluation.h"
+#include "RS_DecodingPolicy.h"
 #include "RS_Encoding.h"
 #include "RS_SystematicEncoding.h"
+#include "RS_TableBundle.h"
+#include "GFq_MonomialArena.h"
 #include "URandom.h"
 #include <iostream>
 #include <iomanip>
@@ -111,9 +117,20 @@ public:
         print_sagemath(false),
         iterations(1),
         nb_erasures(0),
+        nb_rr_threads(1),
         _indicator_int(0),
         message_symbols_given(false),
-        systematic_coding(false)
+        systematic_coding(false),
+        hensel_factorization(false),
+        plain_hasse(false),
+        predict(false),
+        bpsk(false),
+        fading(rssoft::RS_ChannelModel::RS_Fading_None),
+        rician_factor(4.0),
+        fading_block(1),
+        burst(rssoft::RS_ChannelModel::RS_Burst_None),
+        p_good_to_bad(0.0),
+        p_bad_to_good(1.0)
     {
         // http://theory.cs.uvic.ca/gen/poly.html
         rssoft::gf::GF2_Element pp_gf8[4]   = {1,1,0,1};
@@ -137,6 +154,8 @@ public:
     }
     
     bool get_options(int argc, char *argv[]);
+    bool extract_channel(const std::string& channel_str);
+    bool extract_burst(const std::string& burst_str);
     
     bool make_noise;
     float snr_dB;
@@ -151,10 +170,23 @@ public:
     bool print_sagemath; //!< Print input for Sage Math script
     unsigned int iterations; //!< Maximum number of retry iterations
     unsigned int nb_erasures; //!< Number of erasures
+    unsigned int nb_rr_threads; //!< Number of threads for the factorization
     int _indicator_int;
     std::vector<rssoft::gf::GFq_Symbol> message_symbols;
     bool message_symbols_given;
     bool systematic_coding; //!< use systematic coding scheme
+    bool hensel_factorization; //!< use Hensel lifting instead of Roth-Ruckenstein factorization
+    bool plain_hasse; //!< evaluate the interpolation Hasse derivatives at each iteration instead of using the shifted basis
+    bool predict; //!< predict decodability and try frames predicted hopeless at the first global multiplicity only
+    std::string policy_filename; //!< Decoding policy file giving multiplicity parameters from the estimated SNR
+    std::string bundle_filename; //!< Table bundle to take the field LUTs and generator polynomial from
+    bool bpsk; //!< Send the symbol bits with BPSK instead of MFSK
+    rssoft::RS_ChannelModel::Fading fading;
+    float rician_factor;
+    unsigned int fading_block; //!< Number of symbols seeing the same fading gain
+    rssoft::RS_ChannelModel::Burst burst;
+    float p_good_to_bad; //!< Probability to enter a burst
+    float p_bad_to_good; //!< Probability to leave a burst
 private:
     std::vector<rssoft::gf::GF2_Polynomial> ppolys;
 };
@@ -211,6 +243,37 @@ std::ostream& operator<<(std::ostream& os, const StatOutput& st)
 }
 
 
+// ================================================================================================
+// Field built from a table bundle when one is given. It outlives all objects using the field.
+struct FieldHolder
+{
+public:
+    FieldHolder(const Options& options) :
+        table_bundle(0),
+        gfq(0)
+    {
+        if (options.bundle_filename.size() > 0)
+        {
+            table_bundle = new rssoft::RS_TableBundle(options.bundle_filename);
+            gfq = table_bundle->create_field(options.m, options.get_ppoly());
+        }
+        else
+        {
+            gfq = new rssoft::gf::GFq(options.m, options.get_ppoly());
+        }
+    }
+
+    ~FieldHolder()
+    {
+        delete gfq;
+        delete table_bundle;
+    }
+
+    rssoft::RS_TableBundle *table_bundle;
+    rssoft::gf::GFq *gfq;
+};
+
+
 // ================================================================================================
 bool Options::get_options(int argc, char *argv[])
 {
@@ -226,6 +289,10 @@ bool Options::get_options(int argc, char *argv[])
             {"print-stats", no_argument, &_indicator_int, 1},
             {"sagemath", no_argument, &_indicator_int, 1},
             {"systematic", no_argument, &_indicator_int, 1},
+            {"hensel", no_argument, &_indicator_int, 1},
+            {"plain-hasse", no_argument, &_indicator_int, 1},
+            {"predict", no_argument, &_indicator_int, 1},
+            {"bpsk", no_argument, &_indicator_int, 1},
             // these options do not set a flag
             {"snr", required_argument, 0, 'n'},        
             {"log2-n", required_argument, 0, 'm'},      
@@ -235,10 +302,16 @@ bool Options::get_options(int argc, char *argv[])
             {"seed", required_argument, 0, 's'},              
             {"nb-iterations-max", required_argument, 0, 'i'},
             {"nb-erasures", required_argument, 0, 'e'},
+            {"rr-threads", required_argument, 0, 'T'},
+            {"policy", required_argument, 0, 'P'},
+            {"bundle", required_argument, 0, 'B'},
+            {"channel", required_argument, 0, 'C'},
+            {"fading-block", required_argument, 0, 'F'},
+            {"burst", required_argument, 0, 'b'},
         };    
         
         int option_index = 0;
-        c = getopt_long (argc, argv, "n:m:k:M:v:s:i:e:c:", long_options, &option_index);
+        c = getopt_long (argc, argv, "n:m:k:M:v:s:i:e:c:T:P:B:C:F:b:", long_options, &option_index);
         
         if (c == -1) // end of options
         {
@@ -264,6 +337,22 @@ bool Options::get_options(int argc, char *argv[])
                 {
                     systematic_coding = true;
                 }
+                if (strcmp("hensel", long_options[option_index].name) == 0)
+                {
+                    hensel_factorization = true;
+                }
+                if (strcmp("plain-hasse", long_options[option_index].name) == 0)
+                {
+                    plain_hasse = true;
+                }
+                if (strcmp("predict", long_options[option_index].name) == 0)
+                {
+                    predict = true;
+                }
+                if (strcmp("bpsk", long_options[option_index].name) == 0)
+                {
+                    bpsk = true;
+                }
                 _indicator_int = 0;
                 break;
             case 'n':
@@ -292,6 +381,24 @@ bool Options::get_options(int argc, char *argv[])
             case 'e':
                 status = extract_option<int, unsigned int>(nb_erasures, 'e');
                 break;
+            case 'T':
+                status = extract_option<int, unsigned int>(nb_rr_threads, 'T');
+                break;
+            case 'P':
+                policy_filename = std::string(optarg);
+                break;
+            case 'B':
+                bundle_filename = std::string(optarg);
+                break;
+            case 'C':
+                status = extract_channel(std::string(optarg));
+                break;
+            case 'F':
+                status = extract_option<int, unsigned int>(fading_block, 'F');
+                break;
+            case 'b':
+                status = extract_burst(std::string(optarg));
+                break;
             case 'c':
             	status = extract_vector<rssoft::gf::GFq_Symbol>(message_symbols, std::string(optarg));
             	message_symbols_given = true;
@@ -328,12 +435,96 @@ bool Options::get_options(int argc, char *argv[])
         {
             std::cout << "The number of erasures (" << nb_erasures << ") cannot exceed the number of symbols - 2 (" << n-2 << ")" << std::endl;
         }
+
+        if (fading_block == 0)
+        {
+            std::cout << "The fading block must be at least one symbol" << std::endl;
+            status = false;
+        }
     }
     
     return status;
 }
 
 
+// ================================================================================================
+// Channel specification: awgn, rayleigh or rician with an optional K factor (ex: rician:10)
+bool Options::extract_channel(const std::string& channel_str)
+{
+    std::string::size_type colon_pos = channel_str.find(':');
+    std::string model_str = channel_str.substr(0, colon_pos);
+
+    if (model_str == "awgn")
+    {
+        fading = rssoft::RS_ChannelModel::RS_Fading_None;
+    }
+    else if (model_str == "rayleigh")
+    {
+        fading = rssoft::RS_ChannelModel::RS_Fading_Rayleigh;
+    }
+    else if (model_str == "rician")
+    {
+        fading = rssoft::RS_ChannelModel::RS_Fading_Rician;
+
+        if (colon_pos != std::string::npos)
+        {
+            std::vector<float> factor;
+
+            if (!extract_vector<float>(factor, channel_str.substr(colon_pos+1)) || (factor.size() != 1))
+            {
+                std::cout << "wrong Rician factor: " << channel_str << std::endl;
+                return false;
+            }
+
+            rician_factor = factor[0];
+        }
+    }
+    else
+    {
+        std::cout << "unknown channel: " << channel_str << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+// ================================================================================================
+// Burst specification: erasure or error followed by the probabilities to enter and leave a burst (ex: erasure:0.01,0.2)
+bool Options::extract_burst(const std::string& burst_str)
+{
+    std::string::size_type colon_pos = burst_str.find(':');
+    std::string type_str = burst_str.substr(0, colon_pos);
+    std::vector<float> probabilities;
+
+    if (type_str == "erasure")
+    {
+        burst = rssoft::RS_ChannelModel::RS_Burst_Erasure;
+    }
+    else if (type_str == "error")
+    {
+        burst = rssoft::RS_ChannelModel::RS_Burst_Error;
+    }
+    else
+    {
+        std::cout << "unknown burst type: " << burst_str << std::endl;
+        return false;
+    }
+
+    if ((colon_pos == std::string::npos)
+        || !extract_vector<float>(probabilities, burst_str.substr(colon_pos+1))
+        || (probabilities.size() != 2))
+    {
+        std::cout << "burst needs the probabilities to enter and leave a burst: " << burst_str << std::endl;
+        return false;
+    }
+
+    p_good_to_bad = probabilities[0];
+    p_bad_to_good = probabilities[1];
+    return true;
+}
+
+
 // ================================================================================================
 int main(int argc, char *argv[])
 {
@@ -343,11 +534,11 @@ int main(int argc, char *argv[])
     {
         unsigned int q = (1<<options.m);
         unsigned int n = q - 1;
-        double std_dev  = 1.0 / pow(10.0, (options.snr_dB/10.0)); // Standard deviation for power AWGN
         StatOutput stat_output;
         std::set<unsigned int> erased_indexes;
 
-        rssoft::gf::GFq gfq(options.m, options.get_ppoly());
+        FieldHolder field_holder(options);
+        rssoft::gf::GFq& gfq = *field_holder.gfq;
         
         URandom ur;
         
@@ -386,7 +577,9 @@ int main(int argc, char *argv[])
         std::cout << std::endl;
         rssoft::EvaluationValues evaluation_values(gfq); // use default
         rssoft::RS_Encoding rs_encoding(gfq, options.k, evaluation_values);
-        rssoft::RS_SystematicEncoding rs_systematic_encoding(gfq, options.k, 0);
+        rssoft::RS_SystematicEncoding rs_systematic_encoding(field_holder.table_bundle ?
+        		rssoft::RS_SystematicEncoding(gfq, options.k, 0, *field_holder.table_bundle) :
+        		rssoft::RS_SystematicEncoding(gfq, options.k, 0));
         std::vector<rssoft::gf::GFq_Symbol> codeword;
         std::vector<unsigned int> row_indexes;
 
@@ -417,42 +610,55 @@ int main(int argc, char *argv[])
         rssoft::gf::print_symbols_and_erasures(std::cout, codeword, erased_indexes);
         std::cout << std::endl;
 
-        // Simulate reception behind noisy channel. Reliability matrix is created with noisy power samples.
+        // Simulate reception behind noisy channel. Reliability matrix is created with noisy power samples
+        // or with the probabilities of the symbol bits sent with BPSK.
 
+        rssoft::RS_ChannelModel channel(options.bpsk ? rssoft::RS_ChannelModel::RS_Modulation_BPSK : rssoft::RS_ChannelModel::RS_Modulation_MFSK,
+                options.make_noise ? options.snr_dB : INFINITY, options.fading);
+        channel.set_rician_factor(options.rician_factor);
+        channel.set_fading_block(options.fading_block);
+        channel.set_burst(options.burst, options.p_good_to_bad, options.p_bad_to_good);
+        rssoft::RS_RandomStream channel_stream(ur.rand_uword());
         rssoft::RS_ReliabilityMatrix mat_Pi(options.m,n);
         std::vector<rssoft::gf::GFq_Symbol> hard_decision;
+        std::vector<unsigned char> burst_symbols;
         unsigned int hard_decision_errors = 0;
-        float *mat_Pi_col = new float[q];
 
         for (unsigned int c=0; c<n; c++)
         {
-        	float max_pwr = 0;
-        	unsigned int r_max = 0;
+            unsigned int r = 0;
+
+            while (evaluation_values.get_y_values()[r] != codeword[c]) // evaluation point
+            {
+                r++;
+            }
+
+            row_indexes.push_back(r);
+        }
+
+        channel.transmit(row_indexes, mat_Pi, channel_stream, &burst_symbols);
+
+        for (unsigned int c=0; c<n; c++)
+        {
+            if ((options.burst == rssoft::RS_ChannelModel::RS_Burst_Erasure) && burst_symbols[c])
+            {
+                erased_indexes.insert(c);
+            }
 
             if (erased_indexes.find(c) == erased_indexes.end()) // symbol not erased
             {
+                float max_pwr = 0;
+                unsigned int r_max = 0;
+
                 for (unsigned int r=0; r<q; r++)
                 {
-                    if (evaluation_values.get_y_values()[r] == codeword[c]) // evaluation point
-                    {
-                        row_indexes.push_back(r);
-                        mat_Pi_col[r] = 1.0 + (options.make_noise ? std_dev * ur.rand_gaussian() : 0.0);
-                        mat_Pi_col[r] *= mat_Pi_col[r];
-                    }
-                    else
-                    {
-                        mat_Pi_col[r] = 0.0 + (options.make_noise ? std_dev * ur.rand_gaussian() : 0.0);
-                        mat_Pi_col[r] *= mat_Pi_col[r];
-                    }
-
-                    if (mat_Pi_col[r] > max_pwr)
+                    if (mat_Pi(r,c) > max_pwr)
                     {
-                        max_pwr = mat_Pi_col[r];
+                        max_pwr = mat_Pi(r,c);
                         r_max = r;
                     }
                 }
 
-                mat_Pi.enter_symbol_data(mat_Pi_col);
                 hard_decision.push_back(evaluation_values.get_y_values()[r_max].poly());
 
                 if (hard_decision.back() != codeword[c])
@@ -462,18 +668,15 @@ int main(int argc, char *argv[])
             }
             else // erased symbol
             {
-                mat_Pi.enter_erasure();
-                row_indexes.push_back(0);
+                mat_Pi.enter_erasure(c);
                 hard_decision.push_back(0);
             }
         }
 
-        delete[] mat_Pi_col;
-
         std::cout << "Hard-dec: (n=" << codeword.size() << ") ";
         rssoft::gf::print_symbols_and_erasures(std::cout, hard_decision, erased_indexes);
         std::cout << std::endl;
-        std::cout << " -> " << hard_decision_errors << " errors, " << options.nb_erasures << " erasures: " << ((2*hard_decision_errors)+options.nb_erasures < (n-options.k) ? "correctable" : "uncorrectable") << " with hard decision" << std::endl;
+        std::cout << " -> " << hard_decision_errors << " errors, " << erased_indexes.size() << " erasures: " << ((2*hard_decision_errors)+erased_indexes.size() < (n-options.k) ? "correctable" : "uncorrectable") << " with hard decision" << std::endl;
 
         if (options.verbosity > 0)
         {
@@ -482,6 +685,21 @@ int main(int argc, char *argv[])
         	std::cout << std::endl;
         }
 
+        unsigned int global_multiplicity = options.global_multiplicity;
+        unsigned int nb_iterations_max = options.iterations;
+
+        if (options.policy_filename.size() > 0)
+        {
+            rssoft::RS_DecodingPolicy policy;
+            policy.load(options.policy_filename);
+            float snr_estimate = rssoft::RS_DecodingPolicy::estimate_snr_dB(mat_Pi);
+            const rssoft::RS_PolicyEntry& policy_entry = policy.lookup(snr_estimate);
+            global_multiplicity = policy_entry.global_multiplicity;
+            nb_iterations_max = policy_entry.nb_iterations_max;
+            std::cout << "Policy: SNR estimate " << snr_estimate << " dB: global multiplicity " << global_multiplicity
+                      << ", " << nb_iterations_max << " iteration(s) max" << std::endl;
+        }
+
         mat_Pi.normalize();
         float codeword_score = 0.0;
         unsigned int codeword_count = 0;
@@ -520,14 +738,38 @@ int main(int argc, char *argv[])
         stat_output.snr_dB = options.snr_dB;
         stat_output.codeword_average_score = codeword_score / codeword_count;
         stat_output.nb_hard_errors = hard_decision_errors;
-        stat_output.nb_erasures = options.nb_erasures;
+        stat_output.nb_erasures = erased_indexes.size();
 
         std::cout << "Codeword score: " << codeword_score / codeword_count << " dB/symbol (best = " << best_score << ", worst = " << worst_score << ")" << std::endl;
+
+        if (options.predict)
+        {
+            rssoft::RS_DecodabilityPredictor predictor(options.k);
+            predictor.set_power_matrix(!options.bpsk); // MFSK matrices are normalized powers
+            rssoft::RS_DecodabilityPredictor::Prediction prediction = predictor.predict(mat_Pi, global_multiplicity, nb_iterations_max);
+            std::cout << "Prediction: " << rssoft::RS_DecodabilityPredictor::get_name(prediction.decodability)
+                      << ", expected errors " << prediction.expected_errors << ", " << prediction.nb_erasures << " erasures";
+
+            if (prediction.decodability != rssoft::RS_DecodabilityPredictor::RS_Decodable_Hard)
+            {
+                std::cout << ", global multiplicity " << prediction.global_multiplicity << " cost " << prediction.cost
+                          << " score " << prediction.expected_score << " +/- " << prediction.score_deviation
+                          << " threshold " << prediction.score_threshold;
+            }
+
+            std::cout << std::endl;
+
+            if (prediction.decodability == rssoft::RS_DecodabilityPredictor::RS_Decodable_Hopeless)
+            {
+                nb_iterations_max = (nb_iterations_max > 1 ? 1 : nb_iterations_max); // down-tier to the cheapest attempt
+            }
+        }
+
         bool found = false;
-        unsigned int global_multiplicity = options.global_multiplicity;
 
-        for (unsigned int ni=1; (ni<=options.iterations) && (!found); ni++)
+        for (unsigned int ni=1; (ni<=nb_iterations_max) && (!found); ni++)
         {
+            rssoft::gf::GFq_MonomialArenaScope monomial_arena; // monomials of this iteration are released at once at the end
    			std::cout << std::endl;
 			rssoft::MultiplicityMatrix mat_M(mat_Pi, global_multiplicity);
 
@@ -544,7 +786,11 @@ int main(int argc, char *argv[])
 			rssoft::GSKV_Interpolation gskv(gfq, options.k, evaluation_values);
 			rssoft::RR_Factorization rr(gfq, options.k);
 			gskv.set_verbosity(options.verbosity);
+			gskv.set_shifted_basis(!options.plain_hasse);
 			rr.set_verbosity(options.verbosity);
+			rr.set_nb_threads(options.nb_rr_threads);
+			rssoft::HL_Factorization hl(gfq, options.k);
+			hl.set_verbosity(options.verbosity);
 
 			const rssoft::gf::GFq_BivariatePolynomial& Q = gskv.run(mat_M);
 			std::cout << "Q(X,Y) = " << Q << std::endl;
@@ -555,7 +801,7 @@ int main(int argc, char *argv[])
 			}
 			else
 			{
-				std::vector<rssoft::gf::GFq_Polynomial>& res_polys = rr.run(Q);
+				std::vector<rssoft::gf::GFq_Polynomial>& res_polys = (options.hensel_factorization ? hl.run(Q) : rr.run(Q));
 
 				std::cout << res_polys.size() << " result(s)" << std::endl;
 
@@ -675,6 +921,7 @@ int main(int argc, char *argv[])
 			stat_output.nb_iterations = ni;
 			gskv.init();
 			rr.init();
+			hl.init();
         } // retry iterations
 
         if (options.print_stats)
@@ -0,0 +1,215 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the flat representation of polynomials in GF(8)[X,Y] against
+	 the map representation and of the unchecked arithmetic tier
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include "GFq.h"
+#include "GFq_Element.h"
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq_BivariateMonomial.h"
+#include "GFq_BivariatePolynomial.h"
+#include "GFq_BivariateFlatPolynomial.h"
+#include "GF_Exception.h"
+
+/*
+   P(X) = X^3+X+1
+*/
+rssoft::gf::GF2_Element ppe[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly(4,ppe);
+rssoft::gf::GFq gf8(3,ppoly);
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// compare a flat polynomial with the map representation
+void check(const char *title, const rssoft::gf::GFq_BivariateFlatPolynomial& flat, const rssoft::gf::GFq_BivariatePolynomial& poly)
+{
+	rssoft::gf::GFq_BivariateFlatPolynomial ref(gf8, poly);
+	bool ok = (flat == ref);
+
+	std::cout << title << " = " << flat << (ok ? " OK" : " KO") << std::endl;
+
+	if (!ok)
+	{
+		std::cout << "    expected " << poly << std::endl;
+		nb_errors++;
+	}
+}
+
+// ================================================================================================
+// random polynomial with given number of monomials
+rssoft::gf::GFq_BivariatePolynomial random_polynomial(unsigned int k, unsigned int nb_monomials, unsigned int max_x, unsigned int max_y)
+{
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos;
+
+	for (unsigned int i = 0; i < nb_monomials; i++)
+	{
+		monos.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8, 1 + rand() % 7), rand() % (max_x+1), rand() % (max_y+1)));
+	}
+
+	rssoft::gf::GFq_BivariatePolynomial P(1,k-1);
+	P.init(monos);
+	return P;
+}
+
+// ================================================================================================
+// map representation of the child polynomial of the Roth-Ruckenstein factorization <<P(X,X*Y+ry)>>
+rssoft::gf::GFq_BivariatePolynomial child_polynomial(const rssoft::gf::GFq_BivariatePolynomial& P, const rssoft::gf::GFq_Element& ry)
+{
+	rssoft::gf::GFq_BivariatePolynomial X1Y0(P.get_weights());
+	X1Y0.init_x_pow(gf8, 1); // X1Y0(X,Y) = X
+	rssoft::gf::GFq_BivariatePolynomial Yv(P.get_weights()); // Yv(X,Y) = X*Y + ry
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos_Yv;
+	monos_Yv.push_back(rssoft::gf::GFq_BivariateMonomial(ry,0,0));
+	monos_Yv.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),1,1)); // X*Y
+	Yv.init(monos_Yv);
+	return star(P(X1Y0,Yv));
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	unsigned int k = 3;
+
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos_P;
+	monos_P.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),1,1)); // X*Y
+	monos_P.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),2,0)); // X^2
+	monos_P.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),0,0)); // 1
+	monos_P.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,2),3,0)); // a*X^3
+	rssoft::gf::GFq_BivariatePolynomial P(1,k-1);
+	P.init(monos_P);
+
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos_Q;
+	monos_Q.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,2),1,1)); // a*X*Y
+	monos_Q.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),0,2)); // Y^2
+	rssoft::gf::GFq_BivariatePolynomial Q(1,k-1);
+	Q.init(monos_Q);
+
+	rssoft::gf::GFq_BivariateFlatPolynomial fP(gf8, P);
+	rssoft::gf::GFq_BivariateFlatPolynomial fQ(gf8, Q);
+
+	check("P", fP, P);
+	check("Q", fQ, Q);
+	check("P+Q", fP+fQ, P+Q);
+	check("P*Q", fP*fQ, P*Q);
+	check("P*P", fP*fP, P*P);
+	check("Q*Q*Q", fQ*fQ*fQ, Q*Q*Q);
+
+	rssoft::gf::GFq_Element a(gf8,2);
+	rssoft::gf::GFq_Element one(gf8,1);
+	bool eval_ok = (fP(2, gf8.alpha(2)) == P(a,a^2).poly()) && (fP(2, 1) == P(a,one).poly());
+	std::cout << "P(a,a^2) = " << fP(2, gf8.alpha(2)) << (eval_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (eval_ok ? 0 : 1);
+
+	bool lookup_ok = (fP.coeff(3,0) == 2) && (fP.coeff(1,1) == 1) && (fP.coeff(0,1) == 0);
+	std::cout << "coefficient lookup" << (lookup_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (lookup_ok ? 0 : 1);
+
+	rssoft::gf::GFq_BivariatePolynomial P_back(1,k-1);
+	fP.get_bivariate(P_back);
+	std::cout << "P back to map = " << P_back << (P_back == P ? " OK" : " KO") << std::endl;
+	nb_errors += (P_back == P ? 0 : 1);
+
+	rssoft::gf::GFq_BivariateFlatPolynomial fPv(fP);
+	fPv.make_Y_substitution(2).make_star();
+	check("<<P(X,XY+a)>>", fPv, child_polynomial(P, a));
+	check("<<Q(X,XY+a)>>", star(fQ.make_Y_substitution(2)), child_polynomial(Q, a));
+
+	bool v_0_ok = (fP.get_X_0() == P.get_X_0()) && (fP.get_0_Y() == P.get_0_Y());
+	std::cout << "P(X,0) = " << fP.get_X_0() << " P(0,Y) = " << fP.get_0_Y() << (v_0_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (v_0_ok ? 0 : 1);
+
+	rssoft::gf::GFq_BivariateFlatPolynomial fZero(gf8, 1, k-1);
+	bool zero_ok = fZero.get_X_0().is_zero() && fZero.get_0_Y().is_zero() && star(fZero).is_zero();
+	std::cout << "zero = " << fZero << (zero_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (zero_ok ? 0 : 1);
+
+	srand(1);
+
+	for (unsigned int i = 0; i < 50; i++)
+	{
+		rssoft::gf::GFq_BivariatePolynomial A = random_polynomial(k, 1 + rand() % 12, 10, 4);
+		rssoft::gf::GFq_BivariatePolynomial B = random_polynomial(k, 1 + rand() % 12, 10, 4);
+		rssoft::gf::GFq_BivariateFlatPolynomial fA(gf8, A);
+		rssoft::gf::GFq_BivariateFlatPolynomial fB(gf8, B);
+		rssoft::gf::GFq_BivariatePolynomial AB = A*B;
+		rssoft::gf::GFq_BivariatePolynomial ApB = A+B;
+		rssoft::gf::GFq_BivariateFlatPolynomial fAB = fA*fB;
+		rssoft::gf::GFq_BivariateFlatPolynomial fApB = fA+fB;
+
+		if ((fAB != rssoft::gf::GFq_BivariateFlatPolynomial(gf8, AB)) || (fApB != rssoft::gf::GFq_BivariateFlatPolynomial(gf8, ApB)))
+		{
+			std::cout << "random #" << i << " KO: A = " << A << " B = " << B << std::endl;
+			nb_errors++;
+		}
+
+		rssoft::gf::GFq_BivariatePolynomial uAB(A);
+		rssoft::gf::GFq_BivariatePolynomial uApB(A);
+		uAB.multiply_unchecked(B);
+		uApB.add_unchecked(B);
+		rssoft::gf::GFq_Element x(gf8, rand() % 8);
+		rssoft::gf::GFq_Element y(gf8, rand() % 8);
+
+		if ((uAB != AB) || (uApB != ApB) || (A.evaluate_unchecked(x, y) != A(x, y)))
+		{
+			std::cout << "random unchecked #" << i << " KO: A = " << A << " B = " << B << std::endl;
+			nb_errors++;
+		}
+
+		// operations of the Roth-Ruckenstein factorization
+		rssoft::gf::GFq_Element ry(gf8, rand() % 8);
+		rssoft::gf::GFq_BivariateFlatPolynomial fAv(fA);
+		fAv.make_Y_substitution(ry.poly()).make_star();
+
+		if ((fAv != rssoft::gf::GFq_BivariateFlatPolynomial(gf8, child_polynomial(A, ry)))
+				|| (star(fA) != rssoft::gf::GFq_BivariateFlatPolynomial(gf8, star(A)))
+				|| (fA.get_X_0() != A.get_X_0()) || (fA.get_0_Y() != A.get_0_Y()))
+		{
+			std::cout << "random factorization #" << i << " KO: A = " << A << " ry = " << ry << std::endl;
+			nb_errors++;
+		}
+	}
+
+	// the checked tier still rejects operands of different weights
+	bool weights_checked = false;
+
+	try
+	{
+		rssoft::gf::GFq_BivariatePolynomial P_other(1,k);
+		P_other.init(monos_P);
+		P*P_other;
+	}
+	catch (rssoft::gf::GF_Exception& e)
+	{
+		weights_checked = true;
+	}
+
+	std::cout << "weights check" << (weights_checked ? " OK" : " KO") << std::endl;
+	nb_errors += (weights_checked ? 0 : 1);
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
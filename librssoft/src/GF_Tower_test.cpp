@@ -0,0 +1,151 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the tower field representation against the field LUTs
+	 in polynomial basis
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Tower.h"
+#include "GF_Exception.h"
+
+rssoft::gf::GF2_Element pp_gf8[4]   = {1,1,0,1};
+rssoft::gf::GF2_Element pp_gf16[5]  = {1,0,0,1,1};
+rssoft::gf::GF2_Element pp_gf64[7]  = {1,0,0,0,0,1,1};
+rssoft::gf::GF2_Element pp_gf256[9] = {1,0,0,0,1,1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly8(4, pp_gf8);
+rssoft::gf::GF2_Polynomial ppoly16(5, pp_gf16);
+rssoft::gf::GF2_Polynomial ppoly64(7, pp_gf64);
+rssoft::gf::GF2_Polynomial ppoly256(9, pp_gf256);
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void check(const std::string& title, bool ok)
+{
+	std::cout << title << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// all products, inverses and the maps of a field
+void check_field(const char *title, const rssoft::gf::GFq& gf)
+{
+	rssoft::gf::GFq_Tower tower(gf);
+	unsigned int q = gf.size() + 1;
+	std::vector<bool> hit(q, false);
+	bool maps_ok = (tower.to_tower(0) == 0) && (tower.to_tower(1) == 1);
+
+	for (rssoft::gf::GFq_Symbol a = 0; a < q; a++)
+	{
+		rssoft::gf::GFq_Symbol t = tower.to_tower(a);
+		maps_ok = maps_ok && (t < q) && !hit[t] && (tower.from_tower(t) == a);
+		hit[t] = true;
+	}
+
+	check(std::string(title) + " maps", maps_ok);
+	bool mul_ok = true;
+	bool inverse_ok = true;
+
+	for (rssoft::gf::GFq_Symbol a = 0; a < q; a++)
+	{
+		for (rssoft::gf::GFq_Symbol b = 0; b < q; b++)
+		{
+			mul_ok = mul_ok && (tower.from_tower(tower.mul(tower.to_tower(a), tower.to_tower(b))) == gf.mul(a, b));
+		}
+
+		if (a != 0)
+		{
+			inverse_ok = inverse_ok && (tower.from_tower(tower.inverse(tower.to_tower(a))) == gf.inverse(a));
+		}
+	}
+
+	check(std::string(title) + " products", mul_ok);
+	check(std::string(title) + " inverses", inverse_ok && (tower.inverse(0) == 0));
+
+	// multiply-accumulate of a vector by each constant. The vector size is not a multiple of the block size.
+	std::vector<rssoft::gf::GFq_Symbol> in(q), out(q), result(q);
+	std::vector<unsigned char> tower_in(q), tower_out(q);
+
+	for (rssoft::gf::GFq_Symbol a = 0; a < q; a++)
+	{
+		in[a] = a;
+		out[a] = rand() % q;
+	}
+
+	tower.to_tower(&in[0], &tower_in[0], q);
+	tower.to_tower(&out[0], &tower_out[0], q);
+
+	for (rssoft::gf::GFq_Symbol c = 0; c < q; c++)
+	{
+		tower.mul_add(tower.to_tower(c), &tower_in[0], &tower_out[0], q-3);
+
+		for (rssoft::gf::GFq_Symbol a = 0; a < q-3; a++)
+		{
+			out[a] ^= gf.mul(c, in[a]);
+		}
+	}
+
+	tower.from_tower(&tower_out[0], &result[0], q);
+	check(std::string(title) + " multiply-accumulate", result == out);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	srand(1);
+
+	try
+	{
+		rssoft::gf::GFq gf16(4, ppoly16);
+		rssoft::gf::GFq gf64(6, ppoly64);
+		rssoft::gf::GFq gf256(8, ppoly256);
+		check_field("GF((2^2)^2)", gf16);
+		check_field("GF((2^3)^2)", gf64);
+		check_field("GF((2^4)^2)", gf256);
+
+		rssoft::gf::GFq gf8(3, ppoly8);
+		bool thrown = false;
+
+		try
+		{
+			rssoft::gf::GFq_Tower tower(gf8);
+		}
+		catch (rssoft::gf::GF_Exception& e)
+		{
+			thrown = true;
+		}
+
+		check("odd power", thrown);
+	}
+	catch (rssoft::gf::GF_Exception& e)
+	{
+		std::cout << "GF exception caught: " << e.what() << std::endl;
+		nb_errors++;
+	}
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
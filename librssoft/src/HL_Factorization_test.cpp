@@ -0,0 +1,260 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the Hensel lifting factorization against known factors and
+	 against the Roth-Ruckenstein factorization
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Polynomial.h"
+#include "GFq_BivariatePolynomial.h"
+#include "EvaluationValues.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "GSKV_Interpolation.h"
+#include "RR_Factorization.h"
+#include "HL_Factorization.h"
+
+float pwr_S0[8] = {2.163577, 0.003943, 0.064378, 0.000117, 0.021512, 0.000038, 0.000640, 0.000002};
+float pwr_S1[8] = {0.459689, 0.012363, 0.011172, 0.000300, 1.580876, 0.042520, 0.038420, 0.001032};
+float pwr_S2[8] = {0.009034, 0.000001, 0.000245, 0.000001, 1.603912, 0.000010, 0.043565, 0.000001};
+float pwr_S3[8] = {0.736172, 0.838307, 0.005258, 0.005987, 0.005077, 0.005782, 0.000037, 0.000042};
+float pwr_S4[8] = {0.001144, 0.912521, 0.000128, 0.102537, 0.000001, 0.000312, 0.000001, 0.000036};
+float pwr_S5[8] = {0.000708, 0.036403, 0.026054, 1.339624, 0.000001, 0.000004, 0.000003, 0.000129};
+float pwr_S6[8] = {1.507900, 0.000456, 0.045338, 0.000013, 0.607732, 0.000183, 0.018272, 0.000007};
+
+/*
+   P(X) = X^3+X+1
+*/
+rssoft::gf::GF2_Element ppe[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly(4,ppe);
+rssoft::gf::GFq gf8(3,ppoly);
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// polynomial without its high order zero coefficients
+rssoft::gf::GFq_Polynomial trimmed(const rssoft::gf::GFq_Polynomial& f)
+{
+	rssoft::gf::GFq_Polynomial f_trimmed(f);
+	rssoft::gf::simplify(f_trimmed);
+	return f_trimmed;
+}
+
+// ================================================================================================
+// Y - f(X) as a bivariate polynomial
+rssoft::gf::GFq_BivariatePolynomial y_minus(const rssoft::gf::GFq_Polynomial& f, unsigned int k)
+{
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos;
+	monos.push_back(rssoft::gf::GFq_BivariateMonomial(rssoft::gf::GFq_Element(gf8,1),0,1));
+
+	for (unsigned int i = 0; i < f.get_poly().size(); i++)
+	{
+		if (!f.get_poly()[i].is_zero())
+		{
+			monos.push_back(rssoft::gf::GFq_BivariateMonomial(f.get_poly()[i],i,0));
+		}
+	}
+
+	rssoft::gf::GFq_BivariatePolynomial P(1,k-1);
+	P.init(monos);
+	return P;
+}
+
+// ================================================================================================
+// tells if f is in the list of results
+bool found(const std::vector<rssoft::gf::GFq_Polynomial>& F, const rssoft::gf::GFq_Polynomial& f)
+{
+	for (unsigned int i = 0; i < F.size(); i++)
+	{
+		if (trimmed(F[i]) == trimmed(f))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ================================================================================================
+// tells if Y - f(X) divides Q(X,Y) by substitution
+bool is_root(const rssoft::gf::GFq_BivariatePolynomial& Q, const rssoft::gf::GFq_Polynomial& f, unsigned int k)
+{
+	if (trimmed(f).is_zero())
+	{
+		return Q.get_X_0().is_zero(); // Q(X,0) = 0
+	}
+
+	rssoft::gf::GFq_BivariatePolynomial X1Y0(1,k-1);
+	X1Y0.init_x_pow(gf8, 1);
+	rssoft::gf::GFq_BivariatePolynomial FY0 = y_minus(f, k) + y_minus(rssoft::gf::GFq_Polynomial(gf8), k); // (Y + f(X)) + Y = f(X)
+	return !Q(X1Y0, FY0).is_valid();
+}
+
+// ================================================================================================
+// factorization of a product of known factors
+void check_factors(const char *title, const std::vector<rssoft::gf::GFq_Polynomial>& factors, const rssoft::gf::GFq_BivariatePolynomial& cofactor, unsigned int k)
+{
+	rssoft::gf::GFq_BivariatePolynomial Q(cofactor);
+
+	for (unsigned int i = 0; i < factors.size(); i++)
+	{
+		Q *= y_minus(factors[i], k);
+	}
+
+	rssoft::HL_Factorization hl(gf8, k);
+	std::vector<rssoft::gf::GFq_Polynomial>& F = hl.run(Q);
+	bool ok = true;
+
+	for (unsigned int i = 0; i < factors.size(); i++)
+	{
+		ok = ok && found(F, factors[i]);
+	}
+
+	for (unsigned int i = 0; i < F.size(); i++)
+	{
+		ok = ok && is_root(Q, F[i], k);
+	}
+
+	std::cout << title << ": " << F.size() << " result(s), " << hl.get_nb_lifts() << " lift(s), " << hl.get_nb_expansions() << " expansion(s)" << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// Roth-Ruckenstein results that are exact roots are found and all results are exact roots.
+// Roth-Ruckenstein may return candidates that are not roots which are eliminated at final evaluation.
+// The interpolation polynomial does not depend on the shifted basis mode.
+void check_matrix(const char *title, rssoft::RS_ReliabilityMatrix& mat_Pi, unsigned int k, unsigned int global_multiplicity)
+{
+	rssoft::EvaluationValues evaluation_values(gf8);
+	rssoft::MultiplicityMatrix mat_M(mat_Pi, global_multiplicity);
+	rssoft::GSKV_Interpolation gskv(gf8, k, evaluation_values);
+	const rssoft::gf::GFq_BivariatePolynomial& Q = gskv.run(mat_M);
+	rssoft::GSKV_Interpolation gskv_plain(gf8, k, evaluation_values);
+	gskv_plain.set_shifted_basis(false); // Hasse derivatives evaluated at each iteration give the same polynomial
+	bool ok = (gskv_plain.run(mat_M) == Q);
+
+	rssoft::RR_Factorization rr(gf8, k);
+	rssoft::HL_Factorization hl(gf8, k);
+	std::vector<rssoft::gf::GFq_Polynomial>& F_rr = rr.run(Q);
+	std::vector<rssoft::gf::GFq_Polynomial>& F_hl = hl.run(Q);
+
+	for (unsigned int i = 0; i < F_rr.size(); i++)
+	{
+		ok = ok && (!is_root(Q, F_rr[i], k) || found(F_hl, F_rr[i]));
+	}
+
+	for (unsigned int i = 0; i < F_hl.size(); i++)
+	{
+		ok = ok && is_root(Q, F_hl[i], k);
+	}
+
+	std::cout << title << ": " << F_rr.size() << " RR result(s), " << F_hl.size() << " HL result(s)" << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	unsigned int k = 3;
+	rssoft::gf::GFq_Element one(gf8,1);
+	rssoft::gf::GFq_Element a(gf8,2);
+	rssoft::gf::GFq_Element a3(gf8,3);
+
+	std::vector<rssoft::gf::GFq_Element> coeffs1; // a + X + a^3*X^2
+	coeffs1.push_back(a);
+	coeffs1.push_back(one);
+	coeffs1.push_back(a3);
+	std::vector<rssoft::gf::GFq_Element> coeffs2; // a + a*X
+	coeffs2.push_back(a);
+	coeffs2.push_back(a);
+	std::vector<rssoft::gf::GFq_Element> coeffs3; // 0
+	coeffs3.push_back(rssoft::gf::GFq_Element(gf8,0));
+	rssoft::gf::GFq_Polynomial f1(gf8, coeffs1);
+	rssoft::gf::GFq_Polynomial f2(gf8, coeffs2);
+	rssoft::gf::GFq_Polynomial f3(gf8, coeffs3);
+
+	std::vector<rssoft::gf::GFq_BivariateMonomial> monos_C; // X*Y^2 + X^4 + 1
+	monos_C.push_back(rssoft::gf::GFq_BivariateMonomial(one,1,2));
+	monos_C.push_back(rssoft::gf::GFq_BivariateMonomial(one,4,0));
+	monos_C.push_back(rssoft::gf::GFq_BivariateMonomial(one,0,0));
+	rssoft::gf::GFq_BivariatePolynomial C(1,k-1);
+	C.init(monos_C);
+	rssoft::gf::GFq_BivariatePolynomial one_biv(1,k-1);
+	one_biv.init_x_pow(gf8, 0);
+
+	std::vector<rssoft::gf::GFq_Polynomial> factors;
+	factors.push_back(f1);
+	factors.push_back(f2);
+	check_factors("simple roots", factors, one_biv, k);
+	check_factors("simple roots with cofactor", factors, C, k);
+	factors.push_back(f2);
+	check_factors("double root", factors, C, k);
+	factors.push_back(f3);
+	factors.push_back(f3);
+	factors.push_back(f3);
+	check_factors("triple zero root", factors, C, k);
+
+	rssoft::RS_ReliabilityMatrix mat_Pi(3,7);
+	mat_Pi.enter_symbol_data(pwr_S0);
+	mat_Pi.enter_symbol_data(pwr_S1);
+	mat_Pi.enter_symbol_data(pwr_S2);
+	mat_Pi.enter_symbol_data(pwr_S3);
+	mat_Pi.enter_symbol_data(pwr_S4);
+	mat_Pi.enter_symbol_data(pwr_S5);
+	mat_Pi.enter_symbol_data(pwr_S6);
+	mat_Pi.normalize();
+
+	check_matrix("unit test matrix M=12", mat_Pi, 5, 12);
+	check_matrix("unit test matrix M=40", mat_Pi, 5, 40);
+	check_matrix("unit test matrix M=40 k=3", mat_Pi, 3, 40);
+
+	srand(1);
+
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		rssoft::RS_ReliabilityMatrix mat_rand(3,7);
+		float pwr[8];
+
+		for (unsigned int i_col = 0; i_col < 7; i_col++)
+		{
+			for (unsigned int i_row = 0; i_row < 8; i_row++)
+			{
+				pwr[i_row] = (rand() % 1000) / 1000.0;
+			}
+
+			pwr[rand() % 8] += 1.0; // make one symbol dominant
+			mat_rand.enter_symbol_data(pwr);
+		}
+
+		mat_rand.normalize();
+		std::cout << "random #" << i << " ";
+		check_matrix("M=30", mat_rand, 2 + (i % 3), 30);
+	}
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
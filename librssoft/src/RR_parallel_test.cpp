@@ -0,0 +1,146 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the parallel exploration of Roth-Ruckenstein branches against
+	 the sequential exploration
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Polynomial.h"
+#include "GFq_BivariatePolynomial.h"
+#include "EvaluationValues.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "GSKV_Interpolation.h"
+#include "RR_Factorization.h"
+
+float pwr_S0[8] = {2.163577, 0.003943, 0.064378, 0.000117, 0.021512, 0.000038, 0.000640, 0.000002};
+float pwr_S1[8] = {0.459689, 0.012363, 0.011172, 0.000300, 1.580876, 0.042520, 0.038420, 0.001032};
+float pwr_S2[8] = {0.009034, 0.000001, 0.000245, 0.000001, 1.603912, 0.000010, 0.043565, 0.000001};
+float pwr_S3[8] = {0.736172, 0.838307, 0.005258, 0.005987, 0.005077, 0.005782, 0.000037, 0.000042};
+float pwr_S4[8] = {0.001144, 0.912521, 0.000128, 0.102537, 0.000001, 0.000312, 0.000001, 0.000036};
+float pwr_S5[8] = {0.000708, 0.036403, 0.026054, 1.339624, 0.000001, 0.000004, 0.000003, 0.000129};
+float pwr_S6[8] = {1.507900, 0.000456, 0.045338, 0.000013, 0.607732, 0.000183, 0.018272, 0.000007};
+
+/*
+   P(X) = X^3+X+1
+*/
+rssoft::gf::GF2_Element ppe[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly(4,ppe);
+rssoft::gf::GFq gf8(3,ppoly);
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// factorize with the given number of threads and compare with the sequential results
+void check(const rssoft::gf::GFq_BivariatePolynomial& Q, unsigned int k, const std::vector<rssoft::gf::GFq_Polynomial>& F_seq, unsigned int nb_threads)
+{
+	rssoft::RR_Factorization rr(gf8, k);
+	rr.set_nb_threads(nb_threads);
+
+	for (unsigned int i = 0; i < 10; i++) // reuse the pool between runs
+	{
+		rr.init();
+		std::vector<rssoft::gf::GFq_Polynomial>& F_par = rr.run(Q);
+		bool ok = (F_par.size() == F_seq.size());
+
+		for (unsigned int j = 0; ok && (j < F_seq.size()); j++)
+		{
+			ok = (F_par[j] == F_seq[j]);
+		}
+
+		if (!ok)
+		{
+			std::cout << "    " << nb_threads << " threads run #" << i << " KO: " << F_par.size() << " result(s)" << std::endl;
+			nb_errors++;
+			break;
+		}
+	}
+}
+
+// ================================================================================================
+// interpolate the reliability matrix and check factorization with 2 to 4 threads
+void check_matrix(const char *title, rssoft::RS_ReliabilityMatrix& mat_Pi, unsigned int k, unsigned int global_multiplicity)
+{
+	rssoft::EvaluationValues evaluation_values(gf8);
+	rssoft::MultiplicityMatrix mat_M(mat_Pi, global_multiplicity);
+	rssoft::GSKV_Interpolation gskv(gf8, k, evaluation_values);
+	const rssoft::gf::GFq_BivariatePolynomial& Q = gskv.run(mat_M);
+
+	rssoft::RR_Factorization rr(gf8, k);
+	std::vector<rssoft::gf::GFq_Polynomial> F_seq = rr.run(Q);
+	unsigned int nb_errors_before = nb_errors;
+
+	for (unsigned int nb_threads = 2; nb_threads <= 4; nb_threads++)
+	{
+		check(Q, k, F_seq, nb_threads);
+	}
+
+	std::cout << title << ": lmY = " << Q.lmY() << ", " << F_seq.size() << " result(s)" << (nb_errors == nb_errors_before ? " OK" : " KO") << std::endl;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	rssoft::RS_ReliabilityMatrix mat_Pi(3,7);
+	mat_Pi.enter_symbol_data(pwr_S0);
+	mat_Pi.enter_symbol_data(pwr_S1);
+	mat_Pi.enter_symbol_data(pwr_S2);
+	mat_Pi.enter_symbol_data(pwr_S3);
+	mat_Pi.enter_symbol_data(pwr_S4);
+	mat_Pi.enter_symbol_data(pwr_S5);
+	mat_Pi.enter_symbol_data(pwr_S6);
+	mat_Pi.normalize();
+
+	check_matrix("unit test matrix M=12", mat_Pi, 5, 12);
+	check_matrix("unit test matrix M=40", mat_Pi, 5, 40);
+	check_matrix("unit test matrix M=40 k=3", mat_Pi, 3, 40);
+
+	srand(1);
+
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		rssoft::RS_ReliabilityMatrix mat_rand(3,7);
+		float pwr[8];
+
+		for (unsigned int i_col = 0; i_col < 7; i_col++)
+		{
+			for (unsigned int i_row = 0; i_row < 8; i_row++)
+			{
+				pwr[i_row] = (rand() % 1000) / 1000.0;
+			}
+
+			pwr[rand() % 8] += 1.0; // make one symbol dominant
+			mat_rand.enter_symbol_data(pwr);
+		}
+
+		mat_rand.normalize();
+		std::cout << "random #" << i << " ";
+		check_matrix("M=30", mat_rand, 2 + (i % 3), 30);
+	}
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
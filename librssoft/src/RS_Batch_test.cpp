@@ -0,0 +1,251 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Tests of the batch kernels over codewords interleaved by codeword
+	 against the processing of each codeword alone
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Element.h"
+#include "GFq_Polynomial.h"
+#include "EvaluationValues.h"
+#include "RS_Encoding.h"
+#include "RS_ReliabilityMatrix.h"
+#include "RS_BatchReliabilityMatrix.h"
+#include "RS_BatchHardDecision.h"
+#include "MultiplicityMatrix.h"
+#include "FinalEvaluation.h"
+
+/*
+   P(X) = X^4+X+1
+*/
+rssoft::gf::GF2_Element ppe[5] = {1,1,0,0,1};
+rssoft::gf::GF2_Polynomial ppoly(5,ppe);
+rssoft::gf::GFq gf16(4,ppoly);
+
+static const unsigned int n = 15;
+static const unsigned int k = 5;
+static const unsigned int nb_lanes = 7;
+
+typedef std::map<std::pair<unsigned int, unsigned int>, unsigned int, rssoft::MultiplicityMatrix_SparseOrdering> SparseMatrix;
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void report(const char *title, bool ok)
+{
+	std::cout << title << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// compare dense interleaved multiplicities with the multiplicity matrix of each codeword
+bool same_multiplicities(const std::vector<rssoft::RS_ReliabilityMatrix*>& relmats, const std::vector<unsigned int>& multiplicities,
+		const std::vector<unsigned int>& costs, unsigned int multiplicity, float lambda)
+{
+	bool ok = true;
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		rssoft::MultiplicityMatrix reference = (lambda > 0.0 ? rssoft::MultiplicityMatrix(*relmats[b], lambda) : rssoft::MultiplicityMatrix(*relmats[b], multiplicity));
+		rssoft::MultiplicityMatrix from_batch(4, n, &multiplicities[b], nb_lanes);
+
+		ok = ok && (static_cast<const SparseMatrix&>(reference) == static_cast<const SparseMatrix&>(from_batch));
+		ok = ok && (reference.cost() == costs[b]) && (from_batch.cost() == costs[b]);
+	}
+
+	return ok;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	rssoft::EvaluationValues evaluation_values(gf16);
+	rssoft::RS_Encoding encoding(gf16, k, evaluation_values);
+	rssoft::RS_BatchReliabilityMatrix batch_relmat(4, n, nb_lanes);
+	rssoft::RS_BatchHardDecision hard_decision(gf16, k, evaluation_values);
+	std::vector<rssoft::RS_ReliabilityMatrix*> relmats;
+	std::vector<std::vector<rssoft::gf::GFq_Symbol> > messages(nb_lanes);
+	std::vector<bool> expected_valid(nb_lanes);
+	float symbol_data[16];
+
+	srand(1);
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		std::vector<rssoft::gf::GFq_Symbol> codeword;
+		unsigned int nb_symbol_errors = (b % 3 == 1 ? 1 + b % 2 : 0); // some codewords have errors
+		relmats.push_back(new rssoft::RS_ReliabilityMatrix(4, n));
+
+		for (unsigned int i = 0; i < k; i++)
+		{
+			messages[b].push_back(rand() % 16);
+		}
+
+		encoding.run(messages[b], codeword);
+		expected_valid[b] = (nb_symbol_errors == 0) && ((b != 3) || (codeword[n-1] == 0)); // erased position is decided as symbol 0
+
+		for (unsigned int ic = 0; ic < n; ic++)
+		{
+			for (unsigned int ir = 0; ir < 16; ir++)
+			{
+				symbol_data[ir] = (rand() % 100) / 1000.0;
+			}
+
+			if (ic < nb_symbol_errors)
+			{
+				symbol_data[codeword[ic] ^ (1 + rand() % 15)] = 2.0;
+			}
+			else
+			{
+				symbol_data[codeword[ic]] = 1.0 + (rand() % 100) / 100.0;
+			}
+
+			if ((b == 3) && (ic == n-1))
+			{
+				relmats.back()->enter_erasure();
+				batch_relmat.enter_erasure(b, ic);
+			}
+			else
+			{
+				relmats.back()->enter_symbol_data(symbol_data);
+				batch_relmat.enter_symbol_data(b, ic, symbol_data);
+			}
+		}
+	}
+
+	// normalization
+	batch_relmat.normalize();
+	bool ok = true;
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		rssoft::RS_ReliabilityMatrix lane_relmat(4, n);
+		relmats[b]->normalize();
+		batch_relmat.get_lane(b, lane_relmat);
+
+		for (unsigned int i = 0; i < 16*n; i++)
+		{
+			ok = ok && (lane_relmat.get_raw_matrix()[i] == relmats[b]->get_raw_matrix()[i]);
+		}
+	}
+
+	report("normalize", ok);
+
+	// hard decisions against the hard decision multiplicity matrix
+	std::vector<unsigned int> rows(n*nb_lanes);
+	batch_relmat.hard_decisions(&rows[0]);
+	ok = true;
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		const rssoft::MultiplicityMatrix hard_matrix(*relmats[b], 1, false);
+
+		for (unsigned int ic = 0; ic < n; ic++)
+		{
+			ok = ok && (hard_matrix(rows[ic*nb_lanes + b], ic) == 1);
+		}
+	}
+
+	report("hard decisions", ok);
+
+	// multiplicity assignments
+	std::vector<unsigned int> multiplicities(batch_relmat.get_size());
+	std::vector<unsigned int> costs(nb_lanes);
+	batch_relmat.multiplicities(3*n, &multiplicities[0], &costs[0]);
+	report("multiplicities (long)", same_multiplicities(relmats, multiplicities, costs, 3*n, 0.0));
+	batch_relmat.multiplicities(4.5f, &multiplicities[0], &costs[0]);
+	report("multiplicities (short)", same_multiplicities(relmats, multiplicities, costs, 0, 4.5f));
+
+	// syndrome check and message recovery
+	std::vector<rssoft::gf::GFq_Symbol> codewords(n*nb_lanes);
+	std::vector<rssoft::gf::GFq_Symbol> batch_messages(k*nb_lanes);
+	std::vector<bool> valid;
+	hard_decision.symbols(&rows[0], &codewords[0], nb_lanes);
+	unsigned int nb_valid = hard_decision.check(&codewords[0], valid, nb_lanes);
+	hard_decision.messages(&codewords[0], &batch_messages[0], nb_lanes);
+	report("syndromes", valid == expected_valid);
+	std::cout << nb_valid << " valid hard decision codeword(s) out of " << nb_lanes << std::endl;
+	ok = true;
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		for (unsigned int i = 0; valid[b] && (i < k); i++)
+		{
+			ok = ok && (batch_messages[i*nb_lanes + b] == messages[b][i]);
+		}
+	}
+
+	report("messages", ok);
+
+	// same syndromes and messages with the products in the tower field representation
+	std::vector<rssoft::gf::GFq_Symbol> syndrome_values((n-k)*nb_lanes), tower_syndrome_values((n-k)*nb_lanes);
+	std::vector<rssoft::gf::GFq_Symbol> tower_messages(k*nb_lanes);
+	hard_decision.syndromes(&codewords[0], &syndrome_values[0], nb_lanes);
+	hard_decision.set_tower_field(true);
+	hard_decision.syndromes(&codewords[0], &tower_syndrome_values[0], nb_lanes);
+	hard_decision.messages(&codewords[0], &tower_messages[0], nb_lanes);
+	hard_decision.set_tower_field(false);
+	report("tower field", (tower_syndrome_values == syndrome_values) && (tower_messages == batch_messages));
+
+	// scores against the final evaluation of the message polynomial
+	std::vector<float> scores(nb_lanes);
+	std::vector<unsigned int> counts(nb_lanes);
+	batch_relmat.score(&rows[0], &scores[0], &counts[0]);
+	rssoft::FinalEvaluation final_evaluation(gf16, k, evaluation_values);
+	ok = true;
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		if (valid[b])
+		{
+			std::vector<rssoft::gf::GFq_Element> coefficients;
+
+			for (unsigned int i = 0; i < k; i++)
+			{
+				coefficients.push_back(rssoft::gf::GFq_Element(gf16, messages[b][i]));
+			}
+
+			std::vector<rssoft::gf::GFq_Polynomial> polynomials(1, rssoft::gf::GFq_Polynomial(gf16, coefficients));
+			final_evaluation.init();
+			final_evaluation.run(polynomials, *relmats[b]);
+			ok = ok && (final_evaluation.get_codewords().front().get_probability_score() == scores[b]);
+			ok = ok && (counts[b] == (b == 3 ? n-1 : n));
+		}
+	}
+
+	report("scores", ok);
+
+	for (unsigned int b = 0; b < nb_lanes; b++)
+	{
+		delete relmats[b];
+	}
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
@@ -0,0 +1,272 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the channel models: random stream statistics and
+	 reproducibility, noise and fading powers, bursts and batches
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "RS_ChannelModel.h"
+#include "RS_ReliabilityMatrix.h"
+#include "RS_BatchReliabilityMatrix.h"
+#include "RS_DecodabilityPredictor.h"
+#include "RSSoft_Exception.h"
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void check(const char *title, bool ok)
+{
+	std::cout << title << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// mean power of the sent rows and of the other rows of MFSK columns
+void mfsk_powers(const rssoft::RS_ChannelModel& channel, unsigned int nb_symbols_log2, unsigned int nb_symbols, float& sent_power, float& other_power)
+{
+	unsigned int nb_rows = 1<<nb_symbols_log2;
+	std::vector<unsigned int> rows(nb_symbols);
+	std::vector<float> powers(nb_symbols*nb_rows);
+	rssoft::RS_RandomStream stream(7);
+
+	for (unsigned int i = 0; i < nb_symbols; i++)
+	{
+		rows[i] = (i*37) % nb_rows;
+	}
+
+	channel.run(&rows[0], nb_symbols, nb_symbols_log2, &powers[0], stream);
+	double sent_sum = 0.0, other_sum = 0.0;
+
+	for (unsigned int i = 0; i < nb_symbols; i++)
+	{
+		for (unsigned int r = 0; r < nb_rows; r++)
+		{
+			(r == rows[i] ? sent_sum : other_sum) += powers[i*nb_rows + r];
+		}
+	}
+
+	sent_power = sent_sum / nb_symbols;
+	other_power = other_sum / (nb_symbols*(nb_rows-1));
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	try
+	{
+		std::cout << "kernels: " << rssoft::RS_ChannelModel::get_kernels_name() << std::endl;
+
+		// streams are reproducible and independent
+		std::vector<float> a(1000), b(1000), c(1000);
+		rssoft::RS_RandomStream stream_a(42, 0), stream_b(42, 0), stream_c(42, 1);
+		stream_a.gaussian(&a[0], 1000);
+		stream_b.gaussian(&b[0], 1000);
+		stream_c.gaussian(&c[0], 1000);
+		check("reproducible streams", (a == b) && (a != c));
+
+		// uniform and gaussian moments
+		unsigned int nb_values = 1<<18;
+		std::vector<float> values(nb_values);
+		stream_a.uniform(&values[0], nb_values);
+		double sum = 0.0, sum2 = 0.0;
+		bool in_range = true;
+
+		for (unsigned int i = 0; i < nb_values; i++)
+		{
+			in_range = in_range && (values[i] > 0.0) && (values[i] < 1.0);
+			sum += values[i];
+		}
+
+		check("uniform", in_range && (fabs(sum/nb_values - 0.5) < 0.005));
+		stream_a.gaussian(&values[0], nb_values - 5); // tail of a pair of blocks
+		sum = 0.0;
+
+		for (unsigned int i = 0; i < nb_values - 5; i++)
+		{
+			sum += values[i];
+			sum2 += values[i]*values[i];
+		}
+
+		double mean = sum/(nb_values - 5);
+		double variance = sum2/(nb_values - 5) - mean*mean;
+		check("gaussian", (fabs(mean) < 0.01) && (fabs(variance - 1.0) < 0.01));
+
+		// AWGN and fading powers: sent row 1+sigma^2, others sigma^2
+		float sent_power, other_power;
+		rssoft::RS_ChannelModel awgn(rssoft::RS_ChannelModel::RS_Modulation_MFSK, 5.0);
+		float sigma2 = awgn.get_noise_std_dev()*awgn.get_noise_std_dev();
+		mfsk_powers(awgn, 4, 20000, sent_power, other_power);
+		check("awgn powers", (fabs(sent_power - 1.0 - sigma2) < 0.02) && (fabs(other_power - sigma2) < 0.01));
+
+		rssoft::RS_ChannelModel rayleigh(rssoft::RS_ChannelModel::RS_Modulation_MFSK, 5.0, rssoft::RS_ChannelModel::RS_Fading_Rayleigh);
+		rayleigh.set_fading_block(4);
+		mfsk_powers(rayleigh, 4, 40000, sent_power, other_power);
+		check("rayleigh powers", (fabs(sent_power - 1.0 - sigma2) < 0.05) && (fabs(other_power - sigma2) < 0.01));
+
+		rssoft::RS_ChannelModel rician(rssoft::RS_ChannelModel::RS_Modulation_MFSK, 5.0, rssoft::RS_ChannelModel::RS_Fading_Rician);
+		rician.set_rician_factor(10.0);
+		mfsk_powers(rician, 4, 40000, sent_power, other_power);
+		check("rician powers", (fabs(sent_power - 1.0 - sigma2) < 0.05) && (fabs(other_power - sigma2) < 0.01));
+
+		// erasure bursts: stationary bad state probability and erased columns
+		rssoft::RS_ChannelModel bursty(rssoft::RS_ChannelModel::RS_Modulation_MFSK, 10.0);
+		bursty.set_burst(rssoft::RS_ChannelModel::RS_Burst_Erasure, 0.02, 0.18);
+		unsigned int nb_symbols = 50000;
+		std::vector<unsigned int> rows(nb_symbols, 3);
+		std::vector<float> powers(nb_symbols*8);
+		std::vector<unsigned char> bad(nb_symbols);
+		rssoft::RS_RandomStream stream(3);
+		unsigned int nb_bad = bursty.run(&rows[0], nb_symbols, 3, &powers[0], stream, &bad[0]);
+		bool erased_ok = true;
+
+		for (unsigned int i = 0; i < nb_symbols; i++)
+		{
+			erased_ok = erased_ok && ((powers[i*8 + 3] == 0.0) == (bad[i] != 0));
+		}
+
+		check("erasure bursts", erased_ok && (fabs(nb_bad / (float) nb_symbols - 0.1) < 0.02));
+
+		// BPSK into a matrix: columns are probabilities and the sent row wins at high SNR
+		rssoft::RS_ChannelModel bpsk(rssoft::RS_ChannelModel::RS_Modulation_BPSK, 10.0);
+		rssoft::RS_ReliabilityMatrix relmat(4, 15);
+		std::vector<unsigned int> codeword_rows;
+
+		for (unsigned int i = 0; i < 15; i++)
+		{
+			codeword_rows.push_back((i*7) % 16);
+		}
+
+		bpsk.transmit(codeword_rows, relmat, stream);
+		bool bpsk_ok = true;
+
+		for (unsigned int ic = 0; ic < 15; ic++)
+		{
+			double col_sum = 0.0;
+			unsigned int r_max = 0;
+
+			for (unsigned int r = 0; r < 16; r++)
+			{
+				col_sum += relmat(r, ic);
+				r_max = (relmat(r, ic) > relmat(r_max, ic) ? r : r_max);
+			}
+
+			bpsk_ok = bpsk_ok && (fabs(col_sum - 1.0) < 1e-4) && (r_max == codeword_rows[ic]);
+		}
+
+		check("bpsk matrix", bpsk_ok);
+
+		// batch: same values as the frames run one after the other
+		rssoft::RS_BatchReliabilityMatrix batch(3, 7, 5);
+		std::vector<unsigned int> batch_rows(35);
+		std::vector<float> frame_powers(35*8);
+
+		for (unsigned int i = 0; i < 35; i++)
+		{
+			batch_rows[i] = i % 8;
+		}
+
+		rssoft::RS_RandomStream batch_stream(11), run_stream(11);
+		awgn.transmit(batch_rows, batch, batch_stream);
+		awgn.run(&batch_rows[0], 35, 3, &frame_powers[0], run_stream);
+		bool batch_ok = true;
+
+		for (unsigned int i = 0; i < 35; i++)
+		{
+			for (unsigned int r = 0; r < 8; r++)
+			{
+				batch_ok = batch_ok && (batch(r, i % 7, i / 7) == frame_powers[i*8 + r]);
+			}
+		}
+
+		check("batch", batch_ok);
+
+		// decodability: posteriors of AWGN power matrices match the hard decision errors on average
+		rssoft::RS_DecodabilityPredictor predictor(5);
+		predictor.set_power_matrix(true);
+		double expected_errors = 0.0;
+		unsigned int nb_hard_errors = 0;
+
+		for (unsigned int f = 0; f < 200; f++)
+		{
+			rssoft::RS_ReliabilityMatrix frame(4, 15);
+			awgn.transmit(codeword_rows, frame, stream);
+			frame.normalize();
+			expected_errors += predictor.predict(frame, 3, 1).expected_errors;
+
+			for (unsigned int ic = 0; ic < 15; ic++)
+			{
+				unsigned int r_max = 0;
+
+				for (unsigned int r = 0; r < 16; r++)
+				{
+					r_max = (frame(r, ic) > frame(r_max, ic) ? r : r_max);
+				}
+
+				nb_hard_errors += (r_max == codeword_rows[ic] ? 0 : 1);
+			}
+		}
+
+		check("posterior errors", fabs(expected_errors - nb_hard_errors) < 0.25*nb_hard_errors);
+
+		// clean frame is hard decodable, flat frame is hopeless, thresholds of RS(n,2) are triangular numbers
+		rssoft::RS_ChannelModel clean(rssoft::RS_ChannelModel::RS_Modulation_MFSK, 20.0);
+		rssoft::RS_ReliabilityMatrix clean_frame(4, 15), flat_frame(4, 15);
+		clean.transmit(codeword_rows, clean_frame, stream);
+		clean_frame.normalize();
+
+		for (unsigned int ic = 0; ic < 15; ic++)
+		{
+			for (unsigned int r = 0; r < 16; r++)
+			{
+				flat_frame(r, ic) = 1.0/16;
+			}
+		}
+
+		check("decodability classes",
+				(predictor.predict(clean_frame, 3, 3).decodability == rssoft::RS_DecodabilityPredictor::RS_Decodable_Hard)
+				&& (predictor.predict(flat_frame, 3, 3).decodability == rssoft::RS_DecodabilityPredictor::RS_Decodable_Hopeless)
+				&& (rssoft::RS_DecodabilityPredictor::score_threshold(2, 5) == 2)
+				&& (rssoft::RS_DecodabilityPredictor::score_threshold(2, 6) == 3));
+
+		bool thrown = false;
+
+		try
+		{
+			awgn.transmit(batch_rows, relmat, stream);
+		}
+		catch (rssoft::RSSoft_Exception& e)
+		{
+			thrown = true;
+		}
+
+		check("size check", thrown);
+	}
+	catch (rssoft::RSSoft_Exception& e)
+	{
+		std::cout << "RSSoft exception caught: " << e.what() << std::endl;
+		nb_errors++;
+	}
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
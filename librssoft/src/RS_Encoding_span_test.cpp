@@ -0,0 +1,246 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the encodings into caller owned packed buffers against the
+	 encodings into vectors and the polynomial systematic encoding
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Element.h"
+#include "GFq_Polynomial.h"
+#include "EvaluationValues.h"
+#include "RS_Encoding.h"
+#include "RS_SystematicEncoding.h"
+#include "RSSoft_Exception.h"
+
+/*
+   P(X) = X^4+X+1
+*/
+rssoft::gf::GF2_Element ppe[5] = {1,1,0,0,1};
+rssoft::gf::GF2_Polynomial ppoly(5,ppe);
+rssoft::gf::GFq gf16(4,ppoly);
+
+/*
+   P(X) = X^9+X^4+1
+*/
+rssoft::gf::GF2_Element ppe512[10] = {1,0,0,0,1,0,0,0,0,1};
+rssoft::gf::GF2_Polynomial ppoly512(10,ppe512);
+rssoft::gf::GFq gf512(9,ppoly512);
+
+static const unsigned int n = 15;
+static const unsigned int k = 9;
+static const unsigned int stride = 2;
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+// systematic codeword computed with polynomial division
+void systematic_reference(const rssoft::gf::GFq_Polynomial& G, const std::vector<rssoft::gf::GFq_Symbol>& message, std::vector<rssoft::gf::GFq_Symbol>& codeword)
+{
+	std::vector<rssoft::gf::GFq_Element> encoding_coefficients;
+
+	for (unsigned int i = 0; i < message.size(); i++)
+	{
+		encoding_coefficients.push_back(rssoft::gf::GFq_Element(gf16, message[i]));
+	}
+
+	rssoft::gf::GFq_Polynomial encoding_polynomial(gf16, encoding_coefficients);
+	rssoft::gf::GFq_Polynomial X_nk(rssoft::gf::GFq_Element(gf16,1), n - k);
+	rssoft::gf::GFq_Polynomial shifted_encoding_polynomial = X_nk*encoding_polynomial;
+	std::pair<rssoft::gf::GFq_Polynomial, rssoft::gf::GFq_Polynomial> Q_R = rssoft::gf::div(shifted_encoding_polynomial, G);
+	rssoft::gf::GFq_Polynomial codeword_polynomial = Q_R.second + shifted_encoding_polynomial;
+	codeword_polynomial.get_poly_symbols(codeword, n);
+}
+
+// ================================================================================================
+// run an encoder on a vector, a packed 8 bit buffer and an interleaved 16 bit buffer and compare
+template<typename T_Encoding>
+bool check_encoding(const T_Encoding& encoding, const std::vector<rssoft::gf::GFq_Symbol>& message, const std::vector<rssoft::gf::GFq_Symbol>& expected)
+{
+	std::vector<rssoft::gf::GFq_Symbol> codeword;
+	uint8_t message_packed[k];
+	uint8_t codeword_packed[n];
+	uint16_t message_interleaved[k*stride];
+	uint16_t codeword_interleaved[n*stride];
+
+	for (unsigned int i = 0; i < k; i++)
+	{
+		message_packed[i] = message[i];
+		message_interleaved[i*stride] = message[i];
+		message_interleaved[i*stride+1] = 0xFFFF;
+	}
+
+	for (unsigned int i = 0; i < n*stride; i++)
+	{
+		codeword_interleaved[i] = 0xFFFF;
+	}
+
+	encoding.run(message, codeword);
+	encoding.run(message_packed, codeword_packed);
+	encoding.run(message_interleaved, codeword_interleaved+1, stride, stride);
+	bool ok = (codeword == expected);
+
+	for (unsigned int i = 0; ok && (i < n); i++)
+	{
+		ok = (codeword_packed[i] == expected[i])
+			&& (codeword_interleaved[i*stride] == 0xFFFF)
+			&& (codeword_interleaved[i*stride+1] == expected[i]);
+	}
+
+	return ok;
+}
+
+// ================================================================================================
+// tells if an encoding of 8 bit buffers is rejected
+template<typename T_Encoding>
+bool is_rejected(const T_Encoding& encoding, const uint8_t *message)
+{
+	uint8_t codeword[n];
+
+	try
+	{
+		encoding.run(message, codeword);
+	}
+	catch (rssoft::RSSoft_Exception& e)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	rssoft::EvaluationValues evaluation_values(gf16);
+	rssoft::RS_Encoding rs_encoding(gf16, k, evaluation_values);
+	rssoft::RS_SystematicEncoding rs_systematic_encoding(gf16, k, 0);
+
+	// generator polynomial as built by the systematic encoder
+	std::vector<rssoft::gf::GFq_Element> xe;
+	xe.push_back(rssoft::gf::GFq_Element(gf16,gf16.alpha(0)));
+	xe.push_back(rssoft::gf::GFq_Element(gf16,1));
+	rssoft::gf::GFq_Polynomial G(gf16, xe);
+
+	for (unsigned int i = 1; i < n - k; i++)
+	{
+		xe[0] = rssoft::gf::GFq_Element(gf16,gf16.alpha(i));
+		G *= rssoft::gf::GFq_Polynomial(gf16, xe);
+	}
+
+	srand(1);
+
+	for (unsigned int t = 0; t < 100; t++)
+	{
+		std::vector<rssoft::gf::GFq_Symbol> message;
+
+		for (unsigned int i = 0; i < k; i++)
+		{
+			message.push_back(rand() % (n+1));
+		}
+
+		if (t == 0)
+		{
+			message[k-1] = 0; // high order coefficient zero
+		}
+
+		std::vector<rssoft::gf::GFq_Element> encoding_coefficients;
+
+		for (unsigned int i = 0; i < k; i++)
+		{
+			encoding_coefficients.push_back(rssoft::gf::GFq_Element(gf16, message[i]));
+		}
+
+		rssoft::gf::GFq_Polynomial encoding_polynomial(gf16, encoding_coefficients);
+		std::vector<rssoft::gf::GFq_Symbol> expected;
+		const std::vector<rssoft::gf::GFq_Element>& evaluation_points = evaluation_values.get_evaluation_points();
+
+		for (unsigned int i = 0; i < evaluation_points.size(); i++)
+		{
+			expected.push_back(encoding_polynomial(evaluation_points[i]).poly());
+		}
+
+		if (!check_encoding(rs_encoding, message, expected))
+		{
+			std::cout << "encoding #" << t << " KO" << std::endl;
+			nb_errors++;
+		}
+
+		std::vector<rssoft::gf::GFq_Symbol> codeword;
+		rs_systematic_encoding.run(message, codeword);
+		bool systematic_ok = true;
+
+		for (unsigned int i = 0; i < n - k; i++) // syndromes at the roots of the generator polynomial are zero
+		{
+			rssoft::gf::GFq_Symbol syndrome = 0;
+
+			for (int j = n-1; j >= 0; j--)
+			{
+				syndrome = gf16.add(gf16.mul(syndrome, gf16.alpha(i)), codeword[j]);
+			}
+
+			systematic_ok = systematic_ok && (syndrome == 0);
+		}
+
+		for (unsigned int i = 0; i < k; i++) // message follows parity symbols
+		{
+			systematic_ok = systematic_ok && (codeword[n-k+i] == message[i]);
+		}
+
+		if (message[k-1] != 0) // polynomial division needs a non zero leading coefficient
+		{
+			systematic_reference(G, message, expected);
+		}
+		else
+		{
+			expected = codeword;
+		}
+
+		if (!systematic_ok || !check_encoding(rs_systematic_encoding, message, expected))
+		{
+			std::cout << "systematic encoding #" << t << " KO" << std::endl;
+			nb_errors++;
+		}
+	}
+
+	// symbols outside of the field are rejected before they index the field tables
+	uint8_t message_packed[k] = {1,2,3,4,5,6,7,8,9};
+	bool reject_ok = !is_rejected(rs_encoding, message_packed) && !is_rejected(rs_systematic_encoding, message_packed);
+	message_packed[3] = n+1;
+	reject_ok = reject_ok && is_rejected(rs_encoding, message_packed) && is_rejected(rs_systematic_encoding, message_packed);
+
+	// fields with symbols wider than the buffer symbols are rejected
+	rssoft::EvaluationValues evaluation_values512(gf512);
+	message_packed[3] = 4;
+	reject_ok = reject_ok && is_rejected(rssoft::RS_Encoding(gf512, k, evaluation_values512), message_packed)
+		&& is_rejected(rssoft::RS_SystematicEncoding(gf512, k, 0), message_packed);
+
+	std::cout << "rejections" << (reject_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (reject_ok ? 0 : 1);
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
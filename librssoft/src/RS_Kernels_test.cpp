@@ -0,0 +1,205 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+	 Tests of the reliability matrix kernels of every instruction set supported
+	 by the CPU against plain loops
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdlib.h>
+#include "RS_ReliabilityKernels.h"
+#include "RS_ReliabilityMatrix.h"
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void check(const char *kernels_name, const char *title, bool ok)
+{
+	if (!ok)
+	{
+		std::cout << kernels_name << " " << title << " KO" << std::endl;
+		nb_errors++;
+	}
+}
+
+// ================================================================================================
+// runs all kernels of a set on a random matrix with a few erased columns and ties
+void test_kernels(const rssoft::RS_ReliabilityKernels& kernels, const rssoft::RS_ReliabilityKernels& generic, unsigned int nb_rows, unsigned int nb_cols)
+{
+	std::vector<float> matrix(nb_rows*nb_cols);
+
+	for (unsigned int ic = 0; ic < nb_cols; ic++)
+	{
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			matrix[ic*nb_rows + ir] = (ic % 5 == 3 ? 0.0 : (rand() % 1000) / 100.0);
+		}
+	}
+
+	// column sums
+	std::vector<float> sums(nb_cols), generic_sums(nb_cols);
+	kernels.column_sums(&matrix[0], nb_rows, nb_cols, &sums[0]);
+	generic.column_sums(&matrix[0], nb_rows, nb_cols, &generic_sums[0]);
+	bool sums_ok = (sums == generic_sums);
+
+	for (unsigned int ic = 0; ic < nb_cols; ic++)
+	{
+		double sum = 0.0;
+
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			sum += matrix[ic*nb_rows + ir];
+		}
+
+		sums_ok = sums_ok && (fabs(sums[ic] - sum) <= 1e-5*sum);
+	}
+
+	check(kernels.name, "column sums", sums_ok);
+
+	// normalization
+	std::vector<float> normalized(matrix), generic_normalized(matrix);
+	kernels.normalize(&normalized[0], nb_rows, nb_cols);
+	generic.normalize(&generic_normalized[0], nb_rows, nb_cols);
+	bool normalize_ok = (normalized == generic_normalized);
+
+	for (unsigned int ic = 0; ic < nb_cols; ic++)
+	{
+		for (unsigned int ir = 0; ir < nb_rows; ir++)
+		{
+			float expected = (sums[ic] == 0.0 ? 0.0 : matrix[ic*nb_rows + ir] / sums[ic]);
+			normalize_ok = normalize_ok && (normalized[ic*nb_rows + ir] == expected);
+		}
+	}
+
+	check(kernels.name, "normalize", normalize_ok);
+
+	// maximum search with a tie on the maximum
+	unsigned int size = nb_rows*nb_cols;
+	matrix[size/3] = 10.0;
+	matrix[size/2] = 10.0;
+	float max = kernels.max_value(&matrix[0], size, 0.0);
+	float max_below = kernels.max_value_below(&matrix[0], size, 0.0, max);
+	float expected_below = 0.0;
+
+	for (unsigned int i = 0; i < size; i++)
+	{
+		expected_below = ((matrix[i] < max) && (matrix[i] > expected_below) ? matrix[i] : expected_below);
+	}
+
+	check(kernels.name, "max", (max == 10.0) && (max_below == expected_below));
+	check(kernels.name, "find", (kernels.find_first(&matrix[0], size, max) == size/3) && (kernels.find_last(&matrix[0], size, max) == size/2)
+			&& (kernels.find_first(&matrix[0], size, -1.0) == size) && (kernels.find_last(&matrix[0], size, -1.0) == size));
+
+	// top k of a column with ties
+	std::vector<float> column(nb_rows, 0.0);
+	column[nb_rows-1] = 3.0;
+	column[1] = 2.0;
+	column[nb_rows/2] = 2.0;
+	column[0] = 1.0;
+	unsigned int rows[4];
+	unsigned int nb_top = kernels.top_k(&column[0], nb_rows, 4, rows);
+	check(kernels.name, "top k", (nb_top == 4) && (rows[0] == nb_rows-1) && (rows[1] == 1) && (rows[2] == nb_rows/2) && (rows[3] == 0)
+			&& (kernels.top_k(&column[0], nb_rows, 2, rows) == 2) && (rows[1] == 1));
+
+	// log2 including zeros and denormals
+	std::vector<float> log2_values(size);
+	matrix[1] = 1e-40;
+	kernels.log2(&matrix[0], size, &log2_values[0]);
+	bool log2_ok = true;
+
+	for (unsigned int i = 0; i < size; i++)
+	{
+		float expected = log2f(matrix[i]);
+		log2_ok = log2_ok && ((expected == log2_values[i]) || (fabs(expected - log2_values[i]) <= 1e-6*(1.0 + fabs(expected))));
+	}
+
+	check(kernels.name, "log2", log2_ok);
+
+	// fill of an erased column
+	float before = matrix[nb_rows-1];
+	float after = matrix[2*nb_rows];
+	kernels.fill(&matrix[nb_rows], nb_rows, 0.0);
+	float fill_max = kernels.max_value(&matrix[nb_rows], nb_rows, -1.0);
+	check(kernels.name, "fill", (fill_max == 0.0) && (kernels.max_value_below(&matrix[nb_rows], nb_rows, -1.0, 0.0) == -1.0)
+			&& (matrix[nb_rows-1] == before) && (matrix[2*nb_rows] == after));
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	srand(1);
+	const rssoft::RS_ReliabilityKernels *generic = rssoft::RS_ReliabilityKernels::get(rssoft::RS_ReliabilityKernels::RS_Kernels_Generic);
+	std::cout << "selected kernels: " << rssoft::RS_ReliabilityKernels::get().name << std::endl;
+
+	for (unsigned int set = 0; set < rssoft::RS_ReliabilityKernels::RS_Kernels_NbSets; set++)
+	{
+		const rssoft::RS_ReliabilityKernels *kernels = rssoft::RS_ReliabilityKernels::get((rssoft::RS_ReliabilityKernels::InstructionSet) set);
+
+		if (!kernels)
+		{
+			continue;
+		}
+
+		unsigned int nb_errors_before = nb_errors;
+		test_kernels(*kernels, *generic, 8, 7);     // GF(8): tails only
+		test_kernels(*kernels, *generic, 37, 11);   // blocks and tails
+		test_kernels(*kernels, *generic, 256, 255); // GF(256)
+		std::cout << kernels->name << (nb_errors == nb_errors_before ? " OK" : " KO") << std::endl;
+	}
+
+	// matrix with an erasure
+	rssoft::RS_ReliabilityMatrix relmat(8, 255);
+	std::vector<float> symbol_data(256);
+
+	for (unsigned int ic = 0; ic < 255; ic++)
+	{
+		if (ic == 7)
+		{
+			relmat.enter_erasure();
+			continue;
+		}
+
+		for (unsigned int ir = 0; ir < 256; ir++)
+		{
+			symbol_data[ir] = (ir == ic ? 20.0 : (rand() % 100) / 100.0);
+		}
+
+		relmat.enter_symbol_data(&symbol_data[0]);
+	}
+
+	relmat.normalize();
+	double col_sum = 0.0;
+
+	for (unsigned int ir = 0; ir < 256; ir++)
+	{
+		col_sum += relmat(ir, 3);
+	}
+
+	unsigned int i_row, i_col;
+	float max = relmat.find_max(i_row, i_col);
+	bool relmat_ok = (fabs(col_sum - 1.0) < 1e-5) && (relmat(0, 7) == 0.0) && (max == relmat(i_row, i_col)) && (i_row == i_col);
+	std::cout << "normalized matrix" << (relmat_ok ? " OK" : " KO") << std::endl;
+	nb_errors += (relmat_ok ? 0 : 1);
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
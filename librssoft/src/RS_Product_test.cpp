@@ -0,0 +1,158 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Test of the iterative decoding of a RS(7,3)xRS(7,3) product code in GF(8).
+	 Rows carry more errors than the row code can correct so that the
+	 product codeword can only be recovered through the column decodings.
+
+*/
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "GFq_Element.h"
+#include "EvaluationValues.h"
+#include "RS_Encoding.h"
+#include "RS_BatchHardDecision.h"
+#include "RS_ProductDecoder.h"
+
+/*
+   P(X) = X^3+X+1
+*/
+rssoft::gf::GF2_Element ppe[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly(4,ppe);
+rssoft::gf::GFq gf8(3,ppoly);
+
+static const unsigned int n = 7;
+static const unsigned int k = 3;
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void report(const char *title, bool ok)
+{
+	std::cout << title << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// decode with the given number of workers and compare with the product codeword
+void decode(const char *title, const rssoft::EvaluationValues& evaluation_values, const std::vector<float>& channel,
+		const std::vector<rssoft::gf::GFq_Symbol>& product_codeword, unsigned int nb_workers)
+{
+	rssoft::RS_ProductDecoder decoder(gf8, k, evaluation_values, k, evaluation_values, nb_workers);
+	std::vector<rssoft::gf::GFq_Symbol> symbols(n*n);
+
+	decoder.set_multiplicity(3, 1);
+	bool converged = decoder.run(&channel[0], &symbols[0]);
+
+	std::cout << title << ": " << decoder.get_nb_iterations() << " iteration(s) "
+			<< decoder.get_nb_component_decodes() << " decode(s) "
+			<< decoder.get_nb_component_skips() << " skip(s)" << std::endl;
+	report("    converged", converged);
+	report("    product codeword", symbols == product_codeword);
+	report("    components skipped", decoder.get_nb_component_skips() > 0);
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	rssoft::EvaluationValues evaluation_values(gf8); // row r of reliability matrices is symbol r
+	rssoft::RS_Encoding encoding(gf8, k, evaluation_values);
+	std::vector<rssoft::gf::GFq_Symbol> product_codeword(n*n);
+	std::vector<std::vector<rssoft::gf::GFq_Symbol> > row_codewords(k);
+	std::vector<float> channel(n*n*8);
+
+	srand(7);
+
+	// encode k rows then all columns
+	for (unsigned int r = 0; r < k; r++)
+	{
+		std::vector<rssoft::gf::GFq_Symbol> message;
+
+		for (unsigned int c = 0; c < k; c++)
+		{
+			message.push_back(rand() % 8);
+		}
+
+		encoding.run(message, row_codewords[r]);
+	}
+
+	for (unsigned int c = 0; c < n; c++)
+	{
+		std::vector<rssoft::gf::GFq_Symbol> message;
+		std::vector<rssoft::gf::GFq_Symbol> codeword;
+
+		for (unsigned int r = 0; r < k; r++)
+		{
+			message.push_back(row_codewords[r][c]);
+		}
+
+		encoding.run(message, codeword);
+
+		for (unsigned int r = 0; r < n; r++)
+		{
+			product_codeword[r*n + c] = codeword[r];
+		}
+	}
+
+	rssoft::RS_BatchHardDecision hard_decision(gf8, k, evaluation_values);
+	std::vector<bool> valid;
+	unsigned int nb_valid_rows = 0;
+
+	for (unsigned int r = 0; r < n; r++)
+	{
+		nb_valid_rows += hard_decision.check(&product_codeword[r*n], valid, 1);
+	}
+
+	report("rows are codewords", nb_valid_rows == n);
+
+	// channel: correct symbol likely except on a few positions where a wrong symbol is preferred
+	for (unsigned int r = 0; r < n; r++)
+	{
+		for (unsigned int c = 0; c < n; c++)
+		{
+			unsigned int pos = r*n + c;
+			bool error = ((r == 1) && (c < 4)) || ((r == 4) && (c >= 3));
+			rssoft::gf::GFq_Symbol wrong = product_codeword[pos] ^ (1 + rand() % 7);
+
+			for (unsigned int s = 0; s < 8; s++)
+			{
+				channel[pos*8 + s] = 0.02 + 0.01*(rand() % 3);
+			}
+
+			channel[pos*8 + product_codeword[pos]] += (error ? 0.05 : 0.7);
+
+			if (error)
+			{
+				channel[pos*8 + wrong] += 0.8;
+			}
+		}
+	}
+
+	decode("single worker", evaluation_values, channel, product_codeword, 1);
+	decode("three workers", evaluation_values, channel, product_codeword, 3);
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}
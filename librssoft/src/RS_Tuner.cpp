@@ -0,0 +1,467 @@
+/*
+     Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+     This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Offline tuner of the multiplicity schedule. Sweeps the global
+	 multiplicity and the number of iterations on synthetic AWGN frames
+	 for each SNR, measures the frame error rate and the CPU time and
+	 writes a decoding policy with the cheapest parameters meeting the
+	 target frame error rate at each SNR.
+
+*/
+
+#include "GFq.h"
+#include "GF_Exception.h"
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GF_Utils.h"
+#include "EvaluationValues.h"
+#include "RS_ReliabilityMatrix.h"
+#include "MultiplicityMatrix.h"
+#include "GSKV_Interpolation.h"
+#include "RR_Factorization.h"
+#include "FinalEvaluation.h"
+#include "RS_Encoding.h"
+#include "RS_DecodingPolicy.h"
+#include "RSSoft_Exception.h"
+#include "GFq_MonomialArena.h"
+#include "URandom.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+#include <getopt.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+
+// ================================================================================================
+// template to extract information from getopt more easily
+template<typename TOpt, typename TField> bool extract_option(TField& field, char short_option)
+{
+    TOpt option_value;
+    
+    try
+    {
+        option_value = boost::lexical_cast<TOpt>(optarg);
+        field = option_value;
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong argument for -" << short_option << ": " << optarg << " leave default (" << field << ")";
+        std::cout << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+// template to extract a vector of elements from a comma separated string
+template<typename TElement> bool extract_vector(std::vector<TElement>& velements, std::string cs_string)
+{
+    std::string element_str;
+    TElement element;
+
+    boost::char_separator<char> sep(",");
+    boost::tokenizer<boost::char_separator<char> > tokens(cs_string, sep);
+
+    boost::tokenizer<boost::char_separator<char> >::iterator tok_iter = tokens.begin();
+    boost::tokenizer<boost::char_separator<char> >::iterator toks_end = tokens.end();
+
+    velements.clear();
+
+    try
+    {
+        for (; tok_iter != toks_end; ++tok_iter)
+        {
+            element = boost::lexical_cast<TElement>(*tok_iter);
+            velements.push_back(element);
+        }
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong element in comma separated string argument: " << *tok_iter << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+struct Options
+{
+public:
+    Options() :
+        m(4),
+        k(7),
+        nb_frames(100),
+        target_fer(0.01),
+        seed(0),
+        has_seed(false)
+    {
+        // http://theory.cs.uvic.ca/gen/poly.html
+        rssoft::gf::GF2_Element pp_gf8[4]   = {1,1,0,1};
+        rssoft::gf::GF2_Element pp_gf16[5]  = {1,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf32[6]  = {1,0,0,1,0,1};
+        rssoft::gf::GF2_Element pp_gf64[7]  = {1,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf128[8] = {1,0,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf256[9] = {1,0,0,0,1,1,1,0,1};
+    
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(4,pp_gf8));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(5,pp_gf16));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(6,pp_gf32));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(7,pp_gf64));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(8,pp_gf128));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(9,pp_gf256));
+
+        snr_values.push_back(5.0);
+        snr_values.push_back(7.0);
+        snr_values.push_back(9.0);
+        multiplicities.push_back(1<<m);
+        multiplicities.push_back(2<<m);
+        nb_iterations.push_back(1);
+        nb_iterations.push_back(2);
+    }
+
+    const rssoft::gf::GF2_Polynomial& get_ppoly() const
+    {
+        return ppolys[m-3];
+    }
+    
+    bool get_options(int argc, char *argv[]);
+    
+    unsigned int m;
+    unsigned int k;
+    unsigned int nb_frames; //!< Number of frames per SNR point
+    float target_fer; //!< Target frame error rate
+    unsigned int seed;
+    bool has_seed;
+    std::vector<float> snr_values; //!< SNR points of the sweep
+    std::vector<unsigned int> multiplicities; //!< Global multiplicities at first iteration to try
+    std::vector<unsigned int> nb_iterations; //!< Maximum numbers of iterations to try
+    std::string policy_filename; //!< Output policy file or empty for standard output
+private:
+    std::vector<rssoft::gf::GF2_Polynomial> ppolys;
+};
+
+// ================================================================================================
+bool Options::get_options(int argc, char *argv[])
+{
+    int c;
+    bool status = true;
+
+    while (true)
+    {
+        static struct option long_options[] =
+        {
+            {"log2-n", required_argument, 0, 'm'},
+            {"k", required_argument, 0, 'k'},
+            {"snr", required_argument, 0, 'n'},
+            {"global-multiplicity", required_argument, 0, 'M'},
+            {"nb-iterations-max", required_argument, 0, 'i'},
+            {"nb-frames", required_argument, 0, 'f'},
+            {"target-fer", required_argument, 0, 'F'},
+            {"seed", required_argument, 0, 's'},
+            {"output", required_argument, 0, 'o'},
+            {0, 0, 0, 0}
+        };
+        
+        int option_index = 0;
+        c = getopt_long (argc, argv, "m:k:n:M:i:f:F:s:o:", long_options, &option_index);
+        
+        if (c == -1) // end of options
+        {
+            break;
+        }
+
+        switch(c)
+        {
+            case 'm':
+                status = extract_option<int, unsigned int>(m, 'm');
+                break;
+            case 'k':
+                status = extract_option<int, unsigned int>(k, 'k');
+                break;
+            case 'n':
+                status = extract_vector<float>(snr_values, std::string(optarg));
+                break;
+            case 'M':
+                status = extract_vector<unsigned int>(multiplicities, std::string(optarg));
+                break;
+            case 'i':
+                status = extract_vector<unsigned int>(nb_iterations, std::string(optarg));
+                break;
+            case 'f':
+                status = extract_option<int, unsigned int>(nb_frames, 'f');
+                break;
+            case 'F':
+                status = extract_option<double, float>(target_fer, 'F');
+                break;
+            case 's':
+                status = extract_option<int, unsigned int>(seed, 's');
+                has_seed = true;
+                break;
+            case 'o':
+                policy_filename = std::string(optarg);
+                break;
+            case '?':
+                status = false;
+                break;
+        }
+    }
+    
+    if (status)
+    {
+        unsigned int n = (1<<m) - 1;
+        
+        if ((m < 3) || (m > 8))
+        {
+            std::cout << "Not implemented for GF(2^" << m << ") fields" << std::endl;
+            status = false;
+        }
+        else if ((k > (n-2)) || (k < 2))
+        {
+            std::cout << "Cannot work with RS(" << n << "," << k << ")" << std::endl;
+            status = false;
+        }
+        else if ((snr_values.size() == 0) || (multiplicities.size() == 0) || (nb_iterations.size() == 0) || (nb_frames == 0))
+        {
+            std::cout << "Nothing to sweep" << std::endl;
+            status = false;
+        }
+        else if ((std::find(multiplicities.begin(), multiplicities.end(), 0) != multiplicities.end())
+            || (std::find(nb_iterations.begin(), nb_iterations.end(), 0) != nb_iterations.end()))
+        {
+            std::cout << "Multiplicities and numbers of iterations must be positive" << std::endl;
+            status = false;
+        }
+    }
+    
+    return status;
+}
+
+// ================================================================================================
+// synthetic frame behind the AWGN power channel of FullTest
+struct Frame
+{
+    std::vector<rssoft::gf::GFq_Symbol> message;
+    std::vector<float> powers; //!< Reliability matrix before normalization
+};
+
+// ================================================================================================
+// outcome of the decoding of one frame with a multiplicity schedule
+struct FrameOutcome
+{
+    unsigned int found_iteration; //!< Iteration at which the message was found or 0
+    std::vector<double> cpu_seconds; //!< Cumulative CPU time at the end of each iteration
+};
+
+// ================================================================================================
+void make_frame(Frame& frame, URandom& ur, const rssoft::RS_Encoding& rs_encoding, const rssoft::EvaluationValues& evaluation_values,
+        unsigned int q, unsigned int k, float snr_dB)
+{
+    double std_dev  = 1.0 / pow(10.0, (snr_dB/10.0)); // Standard deviation for power AWGN
+    std::vector<rssoft::gf::GFq_Symbol> codeword;
+
+    frame.message.clear();
+
+    for (unsigned int i=0; i<k; i++)
+    {
+        frame.message.push_back(ur.rand_int(q));
+    }
+
+    rs_encoding.run(frame.message, codeword);
+    frame.powers.resize(q*codeword.size());
+
+    for (unsigned int c=0; c<codeword.size(); c++)
+    {
+        for (unsigned int r=0; r<q; r++)
+        {
+            float amplitude = (evaluation_values.get_y_values()[r] == codeword[c] ? 1.0 : 0.0) + std_dev * ur.rand_gaussian();
+            frame.powers[c*q + r] = amplitude * amplitude;
+        }
+    }
+}
+
+// ================================================================================================
+// decode with the multiplicity schedule starting at global_multiplicity for at most nb_iterations_max iterations
+void decode_frame(FrameOutcome& outcome, const Frame& frame, const rssoft::RS_ReliabilityMatrix& mat_Pi, unsigned int global_multiplicity,
+        unsigned int nb_iterations_max, rssoft::GSKV_Interpolation& gskv, rssoft::RR_Factorization& rr, rssoft::FinalEvaluation& final_evaluation)
+{
+    std::clock_t start = std::clock();
+    outcome.found_iteration = 0;
+    outcome.cpu_seconds.clear();
+
+    for (unsigned int ni=1; ni<=nb_iterations_max; ni++, global_multiplicity++)
+    {
+        if (outcome.found_iteration == 0)
+        {
+            rssoft::gf::GFq_MonomialArenaScope monomial_arena;
+            rssoft::MultiplicityMatrix mat_M(mat_Pi, global_multiplicity);
+            gskv.init();
+            rr.init();
+            const rssoft::gf::GFq_BivariatePolynomial& Q = gskv.run(mat_M);
+
+            if (!Q.is_in_X())
+            {
+                std::vector<rssoft::gf::GFq_Polynomial>& res_polys = rr.run(Q);
+
+                if (res_polys.size() > 0)
+                {
+                    final_evaluation.init();
+                    final_evaluation.run(res_polys, mat_Pi);
+                    std::vector<rssoft::ProbabilityCodeword>::const_iterator ms_it = final_evaluation.get_messages().begin();
+
+                    for (; ms_it != final_evaluation.get_messages().end(); ++ms_it)
+                    {
+                        if (rssoft::gf::compare_symbol_vectors(ms_it->get_codeword(), frame.message))
+                        {
+                            outcome.found_iteration = ni;
+                        }
+                    }
+                }
+            }
+        }
+
+        outcome.cpu_seconds.push_back(((double) (std::clock() - start)) / CLOCKS_PER_SEC);
+    }
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    Options options;
+    
+    if (!options.get_options(argc, argv))
+    {
+        std::cout << "Wrong options" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        unsigned int q = (1<<options.m);
+        unsigned int n = q - 1;
+        unsigned int max_iterations = *std::max_element(options.nb_iterations.begin(), options.nb_iterations.end());
+        rssoft::gf::GFq gfq(options.m, options.get_ppoly());
+        rssoft::EvaluationValues evaluation_values(gfq); // use default
+        rssoft::RS_Encoding rs_encoding(gfq, options.k, evaluation_values);
+        rssoft::GSKV_Interpolation gskv(gfq, options.k, evaluation_values);
+        rssoft::RR_Factorization rr(gfq, options.k);
+        rssoft::FinalEvaluation final_evaluation(gfq, options.k, evaluation_values);
+        rssoft::RS_DecodingPolicy policy;
+        URandom ur;
+        Frame frame;
+        FrameOutcome outcome;
+
+        if (options.has_seed)
+        {
+            ur.set_seed(options.seed);
+        }
+
+        std::cerr << "# snr_dB snr_estimate_dB global_multiplicity nb_iterations_max fer cpu_ms_per_frame" << std::endl;
+
+        std::vector<float>::const_iterator snr_it = options.snr_values.begin();
+
+        for (; snr_it != options.snr_values.end(); ++snr_it)
+        {
+            // same frames for all parameters so that they are compared on the same noise
+            std::vector<Frame> frames(options.nb_frames);
+            double snr_estimate_sum = 0.0;
+
+            for (unsigned int i_f = 0; i_f < options.nb_frames; i_f++)
+            {
+                make_frame(frames[i_f], ur, rs_encoding, evaluation_values, q, options.k, *snr_it);
+                rssoft::RS_ReliabilityMatrix raw_Pi(options.m, n, &frames[i_f].powers[0]);
+                snr_estimate_sum += rssoft::RS_DecodingPolicy::estimate_snr_dB(raw_Pi);
+            }
+
+            float snr_estimate = snr_estimate_sum / options.nb_frames;
+            bool best_meets_target = false;
+            float best_fer = 2.0;
+            double best_cpu = 0.0;
+            rssoft::RS_PolicyEntry best_entry(snr_estimate);
+
+            std::vector<unsigned int>::const_iterator m_it = options.multiplicities.begin();
+
+            for (; m_it != options.multiplicities.end(); ++m_it)
+            {
+                // schedules with fewer iterations are prefixes of the longest one
+                std::vector<unsigned int> nb_found(max_iterations+1, 0);
+                std::vector<double> cpu_seconds(max_iterations+1, 0.0);
+
+                for (unsigned int i_f = 0; i_f < options.nb_frames; i_f++)
+                {
+                    rssoft::RS_ReliabilityMatrix mat_Pi(options.m, n, &frames[i_f].powers[0]);
+                    rssoft::RS_ReliabilityMatrix norm_Pi(mat_Pi);
+                    norm_Pi.normalize();
+                    decode_frame(outcome, frames[i_f], norm_Pi, *m_it, max_iterations, gskv, rr, final_evaluation);
+
+                    for (unsigned int ni = 1; ni <= max_iterations; ni++)
+                    {
+                        bool found = (outcome.found_iteration > 0) && (outcome.found_iteration <= ni);
+                        nb_found[ni] += (found ? 1 : 0);
+                        cpu_seconds[ni] += outcome.cpu_seconds[found ? outcome.found_iteration-1 : ni-1];
+                    }
+                }
+
+                std::vector<unsigned int>::const_iterator i_it = options.nb_iterations.begin();
+
+                for (; i_it != options.nb_iterations.end(); ++i_it)
+                {
+                    unsigned int nb_failed = options.nb_frames - nb_found[*i_it];
+                    float fer = ((float) nb_failed) / options.nb_frames;
+                    double cpu = cpu_seconds[*i_it] / options.nb_frames;
+                    bool meets_target = (nb_failed <= options.target_fer * options.nb_frames + 1e-6); // on counts to avoid rounding
+
+                    std::cerr << *snr_it << " " << snr_estimate << " " << *m_it << " " << *i_it << " " << fer << " " << cpu*1000.0 << std::endl;
+
+                    // cheapest among those meeting the target else the lowest error rate
+                    if ((meets_target && (!best_meets_target || (cpu < best_cpu)))
+                        || (!meets_target && !best_meets_target && ((fer < best_fer) || ((fer == best_fer) && (cpu < best_cpu)))))
+                    {
+                        best_meets_target = meets_target;
+                        best_fer = fer;
+                        best_cpu = cpu;
+                        best_entry.global_multiplicity = *m_it;
+                        best_entry.nb_iterations_max = *i_it;
+                    }
+                }
+            }
+
+            policy.add_entry(best_entry);
+        }
+
+        if (options.policy_filename.size() > 0)
+        {
+            policy.save(options.policy_filename);
+        }
+        else
+        {
+            policy.save(std::cout);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Exception caught: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
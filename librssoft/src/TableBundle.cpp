@@ -0,0 +1,278 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Writes a bundle of precomputed field LUTs and systematic code generator
+	 polynomials that programs can map at startup instead of generating
+	 them. Lists the contents of an existing bundle.
+
+*/
+
+#include "GFq.h"
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "RS_TableBundle.h"
+#include "RSSoft_Exception.h"
+#include "GF_Exception.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+
+// ================================================================================================
+// template to extract information from getopt more easily
+template<typename TOpt, typename TField> bool extract_option(TField& field, char short_option)
+{
+    TOpt option_value;
+    
+    try
+    {
+        option_value = boost::lexical_cast<TOpt>(optarg);
+        field = option_value;
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong argument for -" << short_option << ": " << optarg << " leave default (" << field << ")";
+        std::cout << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+// template to extract a vector of elements from a comma separated string
+template<typename TElement> bool extract_vector(std::vector<TElement>& velements, std::string cs_string)
+{
+    std::string element_str;
+    TElement element;
+
+    boost::char_separator<char> sep(",");
+    boost::tokenizer<boost::char_separator<char> > tokens(cs_string, sep);
+
+    boost::tokenizer<boost::char_separator<char> >::iterator tok_iter = tokens.begin();
+    boost::tokenizer<boost::char_separator<char> >::iterator toks_end = tokens.end();
+
+    velements.clear();
+
+    try
+    {
+        for (; tok_iter != toks_end; ++tok_iter)
+        {
+            element = boost::lexical_cast<TElement>(*tok_iter);
+            velements.push_back(element);
+        }
+        return true;
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+        std::cout << "wrong element in comma separated string argument: " << *tok_iter << std::endl;
+        return false;
+    }
+}
+
+// ================================================================================================
+struct Options
+{
+public:
+    Options() :
+        init_power(0)
+    {
+        // http://theory.cs.uvic.ca/gen/poly.html
+        rssoft::gf::GF2_Element pp_gf8[4]   = {1,1,0,1};
+        rssoft::gf::GF2_Element pp_gf16[5]  = {1,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf32[6]  = {1,0,0,1,0,1};
+        rssoft::gf::GF2_Element pp_gf64[7]  = {1,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf128[8] = {1,0,0,0,0,0,1,1};
+        rssoft::gf::GF2_Element pp_gf256[9] = {1,0,0,0,1,1,1,0,1};
+    
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(4,pp_gf8));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(5,pp_gf16));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(6,pp_gf32));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(7,pp_gf64));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(8,pp_gf128));
+        ppolys.push_back(rssoft::gf::GF2_Polynomial(9,pp_gf256));
+
+        for (unsigned int m = 3; m <= 8; m++)
+        {
+            m_values.push_back(m);
+        }
+    }
+
+    const rssoft::gf::GF2_Polynomial& get_ppoly(unsigned int m) const
+    {
+        return ppolys[m-3];
+    }
+    
+    bool get_options(int argc, char *argv[]);
+    
+    std::vector<unsigned int> m_values; //!< Fields to put in the bundle
+    std::vector<unsigned int> k_values; //!< Systematic codes to put in the bundle for each field
+    unsigned int init_power; //!< Initial power of alpha of the systematic codes
+    std::string output_filename; //!< Bundle to write
+    std::string list_filename; //!< Bundle to list
+private:
+    std::vector<rssoft::gf::GF2_Polynomial> ppolys;
+};
+
+// ================================================================================================
+bool Options::get_options(int argc, char *argv[])
+{
+    int c;
+    bool status = true;
+
+    while (true)
+    {
+        static struct option long_options[] =
+        {
+            {"log2-n", required_argument, 0, 'm'},
+            {"k", required_argument, 0, 'k'},
+            {"init-power", required_argument, 0, 'i'},
+            {"output", required_argument, 0, 'o'},
+            {"list", required_argument, 0, 'l'},
+            {0, 0, 0, 0}
+        };
+        
+        int option_index = 0;
+        c = getopt_long (argc, argv, "m:k:i:o:l:", long_options, &option_index);
+        
+        if (c == -1) // end of options
+        {
+            break;
+        }
+
+        switch(c)
+        {
+            case 'm':
+                status = extract_vector<unsigned int>(m_values, std::string(optarg));
+                break;
+            case 'k':
+                status = extract_vector<unsigned int>(k_values, std::string(optarg));
+                break;
+            case 'i':
+                status = extract_option<int, unsigned int>(init_power, 'i');
+                break;
+            case 'o':
+                output_filename = std::string(optarg);
+                break;
+            case 'l':
+                list_filename = std::string(optarg);
+                break;
+            case '?':
+                status = false;
+                break;
+        }
+    }
+
+    if (status)
+    {
+        for (unsigned int i = 0; i < m_values.size(); i++)
+        {
+            if ((m_values[i] < 3) || (m_values[i] > 8))
+            {
+                std::cout << "Not implemented for GF(2^" << m_values[i] << ") fields" << std::endl;
+                status = false;
+            }
+        }
+
+        if (output_filename.empty() == list_filename.empty())
+        {
+            std::cout << "Give either a bundle to write (-o) or a bundle to list (-l)" << std::endl;
+            status = false;
+        }
+    }
+
+    return status;
+}
+
+// ================================================================================================
+void list_bundle(const std::string& filename)
+{
+    rssoft::RS_TableBundle bundle(filename);
+    const rssoft::RS_TableBundleSection *sections = bundle.get_sections();
+
+    for (unsigned int i = 0; i < bundle.get_nb_sections(); i++)
+    {
+        if (sections[i].type == rssoft::RS_TableBundle_Field)
+        {
+            std::cout << "GF(2^" << sections[i].pwr << ") P=0x" << std::hex << sections[i].primitive_poly << std::dec;
+        }
+        else
+        {
+            std::cout << "generator GF(2^" << sections[i].pwr << ") P=0x" << std::hex << sections[i].primitive_poly << std::dec
+                    << " k=" << sections[i].k << " init power=" << sections[i].init_power;
+        }
+
+        std::cout << ": " << sections[i].nb_symbols << " symbols at " << sections[i].offset << std::endl;
+    }
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+    Options options;
+    
+    if (!options.get_options(argc, argv))
+    {
+        std::cout << "Wrong options" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        if (!options.list_filename.empty())
+        {
+            list_bundle(options.list_filename);
+            return 0;
+        }
+
+        rssoft::RS_TableBundleWriter writer;
+
+        for (unsigned int i = 0; i < options.m_values.size(); i++)
+        {
+            unsigned int m = options.m_values[i];
+            rssoft::gf::GFq gfq(m, options.get_ppoly(m));
+            writer.add_field(gfq);
+
+            for (unsigned int j = 0; j < options.k_values.size(); j++)
+            {
+                if ((options.k_values[j] > 0) && (options.k_values[j] < gfq.size()))
+                {
+                    writer.add_generator(gfq, options.k_values[j], options.init_power);
+                }
+            }
+        }
+
+        writer.write(options.output_filename);
+        list_bundle(options.output_filename);
+    }
+    catch (rssoft::RSSoft_Exception& e)
+    {
+        std::cout << "RSSoft exception caught: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (rssoft::gf::GF_Exception& e)
+    {
+        std::cout << "GF exception caught: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
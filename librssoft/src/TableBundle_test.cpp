@@ -0,0 +1,191 @@
+/*
+ Copyright 2013 Edouard Griffiths <f4exb at free dot fr>
+
+ This file is part of RSSoft. A Reed-Solomon Soft Decoding library
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Boston, MA  02110-1301  USA
+
+
+	 Tests of the table bundle: fields and systematic encodings built from
+	 the mapped tables must behave exactly as the ones generated at startup
+
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <stdlib.h>
+#include <stddef.h>
+#include <unistd.h>
+#include "GF2_Element.h"
+#include "GF2_Polynomial.h"
+#include "GFq.h"
+#include "RS_SystematicEncoding.h"
+#include "RS_TableBundle.h"
+#include "RSSoft_Exception.h"
+
+/*
+   P(X) = X^3+X+1 and P(X) = X^4+X+1
+*/
+rssoft::gf::GF2_Element ppe8[4] = {1,1,0,1};
+rssoft::gf::GF2_Polynomial ppoly8(4,ppe8);
+rssoft::gf::GF2_Element ppe16[5] = {1,1,0,0,1};
+rssoft::gf::GF2_Polynomial ppoly16(5,ppe16);
+rssoft::gf::GF2_Element ppe32[6] = {1,0,1,0,0,1};
+rssoft::gf::GF2_Polynomial ppoly32(6,ppe32);
+
+unsigned int nb_errors = 0;
+
+// ================================================================================================
+void report(const char *title, bool ok)
+{
+	std::cout << title << (ok ? " OK" : " KO") << std::endl;
+	nb_errors += (ok ? 0 : 1);
+}
+
+// ================================================================================================
+// compare all operations of two fields
+bool same_field(const rssoft::gf::GFq& a, const rssoft::gf::GFq& b)
+{
+	bool ok = (a == b) && (a.size() == b.size());
+
+	for (unsigned int i = 0; ok && (i < a.size()+1); i++)
+	{
+		ok = (a.alpha(i) == b.alpha(i)) && (a.index(i) == b.index(i)) && (a.inverse(i) == b.inverse(i));
+
+		for (unsigned int j = 0; ok && (j < a.size()+1); j++)
+		{
+			ok = (a.mul(i,j) == b.mul(i,j)) && (a.div(i,j) == b.div(i,j)) && (a.exp(i,j) == b.exp(i,j));
+		}
+	}
+
+	return ok;
+}
+
+// ================================================================================================
+bool is_rejected(const std::string& bundle_path)
+{
+	try
+	{
+		rssoft::RS_TableBundle bundle(bundle_path);
+	}
+	catch (rssoft::RSSoft_Exception& e)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+// ================================================================================================
+int main(int argc, char *argv[])
+{
+	rssoft::gf::GFq gf8(3, ppoly8);
+	rssoft::gf::GFq gf16(4, ppoly16);
+	std::ostringstream os;
+	os << "/tmp/rssoft_bundle_" << getpid() << ".bin";
+	std::string bundle_path = os.str();
+
+	rssoft::RS_TableBundleWriter writer;
+	writer.add_field(gf8);
+	writer.add_field(gf16);
+	writer.add_generator(gf16, 11, 0);
+	writer.add_generator(gf16, 7, 1);
+	writer.write(bundle_path);
+
+	{
+		rssoft::RS_TableBundle bundle(bundle_path);
+		rssoft::gf::GFq_Tables tables;
+
+		report("sections", bundle.get_nb_sections() == 4);
+
+		bool aligned = true;
+
+		for (unsigned int i = 0; i < bundle.get_nb_sections(); i++)
+		{
+			aligned = aligned && (bundle.get_sections()[i].offset % rssoft::RS_TABLE_BUNDLE_PAGE_SIZE == 0);
+		}
+
+		report("page aligned sections", aligned);
+		report("field not in bundle", !bundle.find_field(5, ppoly32, tables));
+
+		rssoft::gf::GFq *bgf8 = bundle.create_field(3, ppoly8);
+		rssoft::gf::GFq *bgf16 = bundle.create_field(4, ppoly16);
+		rssoft::gf::GFq *bgf32 = bundle.create_field(5, ppoly32); // generated
+		rssoft::gf::GFq gf32(5, ppoly32);
+
+		report("GF(8) from bundle", same_field(*bgf8, gf8));
+		report("GF(16) from bundle", same_field(*bgf16, gf16));
+		report("GF(32) not in bundle", same_field(*bgf32, gf32));
+
+		rssoft::gf::GFq copy16(*bgf16); // deep copy of mapped tables
+		report("copy of mapped field", same_field(copy16, gf16));
+
+		bool same_codewords = true;
+		unsigned int k_values[] = {11, 7, 5}; // last one is not in the bundle
+		unsigned int init_powers[] = {0, 1, 0};
+		srand(3);
+
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			rssoft::RS_SystematicEncoding reference(gf16, k_values[i], init_powers[i]);
+			rssoft::RS_SystematicEncoding from_bundle(*bgf16, k_values[i], init_powers[i], bundle);
+			std::vector<rssoft::gf::GFq_Symbol> message;
+			std::vector<rssoft::gf::GFq_Symbol> codeword_reference;
+			std::vector<rssoft::gf::GFq_Symbol> codeword_bundle;
+
+			for (unsigned int j = 0; j < k_values[i]; j++)
+			{
+				message.push_back(rand() % 16);
+			}
+
+			reference.run(message, codeword_reference);
+			from_bundle.run(message, codeword_bundle);
+			same_codewords = same_codewords && (codeword_reference == codeword_bundle)
+					&& (reference.get_generator_symbols() == from_bundle.get_generator_symbols());
+		}
+
+		report("systematic encodings", same_codewords);
+
+		delete bgf8;
+		delete bgf16;
+		delete bgf32;
+	}
+
+	// field size out of range in the first section
+	FILE *bundle_file = fopen(bundle_path.c_str(), "r+b");
+	long pwr_offset = sizeof(rssoft::RS_TableBundleHeader) + offsetof(rssoft::RS_TableBundleSection, pwr);
+	uint32_t pwr;
+	fseek(bundle_file, pwr_offset, SEEK_SET);
+	fread(&pwr, sizeof(pwr), 1, bundle_file);
+	uint32_t bad_pwr = 40;
+	fseek(bundle_file, pwr_offset, SEEK_SET);
+	fwrite(&bad_pwr, sizeof(bad_pwr), 1, bundle_file);
+	fclose(bundle_file);
+	report("field size out of range rejected", (pwr == 3) && is_rejected(bundle_path));
+
+	bundle_file = fopen(bundle_path.c_str(), "r+b");
+	fseek(bundle_file, pwr_offset, SEEK_SET);
+	fwrite(&pwr, sizeof(pwr), 1, bundle_file);
+	fseek(bundle_file, 0, SEEK_SET);
+	fputc('X', bundle_file);
+	fclose(bundle_file);
+	report("corrupted bundle rejected", is_rejected(bundle_path));
+	unlink(bundle_path.c_str());
+
+	std::cout << nb_errors << " error(s)" << std::endl;
+	return (nb_errors == 0 ? 0 : 1);
+}